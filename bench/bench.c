@@ -0,0 +1,545 @@
+/**
+ * @file bench.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Parametric benchmark circuits, also the workload trained on by the
+ * PGO build.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimbuild.h"
+#include "logsimcircuit.h"
+#include "logsimcone.h"
+#include "logsimfault.h"
+#include "logsimlib.h"
+#include "logsimlut.h"
+#include "logsimopt.h"
+#include "logsimvm.h"
+#include "logsimxsim.h"
+
+/*************** Structures ***************/
+
+typedef enum bench_kind { BENCH_RANDOM, BENCH_MULTIPLIER } bench_kind_t;
+
+typedef struct bench_options {
+  bench_kind_t kind;
+  int size; /* Gates of a random circuit, operand bits of a multiplier */
+
+  int inputs; /* Of a random circuit */
+  int window; /* Earlier nets a random gate may read, 0 for a 16th of them */
+
+  int runs;        /* Of the bytecode, 64 vectors each */
+  long patterns;   /* Graded by the fault simulator */
+  int fault_gates; /* Gates of the largest circuit graded */
+  int threads;
+  uint64_t seed;
+} bench_options_t;
+
+/* Netlist in the arrays taken by the bulk builder */
+typedef struct bench_netlist {
+  int gates;
+  int inputs;
+  int edges;
+
+  logic_block_type_t *types;
+  int *arities;
+  int *sources;
+
+  int outputs;
+  int *output_gates;
+} bench_netlist_t;
+
+/*************** Function Definitions ***************/
+
+static uint64_t bench_random(uint64_t *state) {
+  /* xorshift64* */
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+
+  return *state * 0x2545F4914F6CDD1DULL;
+}
+
+static double bench_now() {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+static int bench_netlist_alloc(bench_netlist_t *netlist, int gates,
+                               int inputs, int edges) {
+  memset(netlist, 0, sizeof(*netlist));
+
+  netlist->inputs = inputs;
+  netlist->types = malloc(gates * sizeof(logic_block_type_t));
+  netlist->arities = malloc(gates * sizeof(int));
+  netlist->sources = malloc(edges * sizeof(int));
+  netlist->output_gates = malloc(gates * sizeof(int));
+
+  if (netlist->types == NULL || netlist->arities == NULL ||
+      netlist->sources == NULL || netlist->output_gates == NULL) {
+    return -1;
+  }
+
+  return 0;
+}
+
+static void bench_netlist_free(bench_netlist_t *netlist) {
+  free(netlist->types);
+  free(netlist->arities);
+  free(netlist->sources);
+  free(netlist->output_gates);
+}
+
+static int bench_add_gate(bench_netlist_t *netlist, logic_block_type_t type,
+                          int a, int b) {
+  netlist->types[netlist->gates] = type;
+  netlist->arities[netlist->gates] = type == NOT ? 1 : 2;
+  netlist->sources[netlist->edges++] = a;
+
+  if (type != NOT) {
+    netlist->sources[netlist->edges++] = b;
+  }
+
+  return netlist->gates++;
+}
+
+/* Gates reading the last window nets, the unread gates are the outputs */
+static int bench_random_netlist(const bench_options_t *options,
+                                bench_netlist_t *netlist) {
+  int gates = options->size;
+  int inputs = options->inputs;
+
+  if (bench_netlist_alloc(netlist, gates, inputs, 4 * gates) != 0) {
+    return -1;
+  }
+
+  static const logic_block_type_t types[] = {AND, OR, XOR, NOT};
+  uint64_t state = options->seed;
+  char *read = calloc(gates, 1);
+
+  if (read == NULL) {
+    return -1;
+  }
+
+  int window = options->window > 0 ? options->window : gates / 16 + 1;
+
+  for (int g = 0; g < gates; g++) {
+    int nets = inputs + g;
+    int reach = window < nets ? window : nets;
+
+    logic_block_type_t type = types[bench_random(&state) % 4];
+    int arity = type == NOT ? 1 : 2 + bench_random(&state) % 3;
+
+    netlist->types[g] = type;
+    netlist->arities[g] = arity;
+
+    for (int i = 0; i < arity; i++) {
+      int net = nets - 1 - bench_random(&state) % reach;
+
+      if (net < inputs) {
+        netlist->sources[netlist->edges++] = LOGIC_BUILD_INPUT(net);
+      } else {
+        netlist->sources[netlist->edges++] = net - inputs;
+        read[net - inputs] = 1;
+      }
+    }
+  }
+
+  netlist->gates = gates;
+
+  for (int g = 0; g < gates; g++) {
+    if (!read[g]) {
+      netlist->output_gates[netlist->outputs++] = g;
+    }
+  }
+
+  free(read);
+
+  return 0;
+}
+
+/* Sum and carry of up to three operands, -1 standing for a constant 0 */
+static void bench_add_bits(bench_netlist_t *netlist, int x, int y, int z,
+                           int *sum, int *carry) {
+  int operands[3];
+  int count = 0;
+
+  if (x >= 0) {
+    operands[count++] = x;
+  }
+  if (y >= 0) {
+    operands[count++] = y;
+  }
+  if (z >= 0) {
+    operands[count++] = z;
+  }
+
+  *sum = count > 0 ? operands[0] : -1;
+  *carry = -1;
+
+  if (count == 2) {
+    *sum = bench_add_gate(netlist, XOR, operands[0], operands[1]);
+    *carry = bench_add_gate(netlist, AND, operands[0], operands[1]);
+  } else if (count == 3) {
+    int half = bench_add_gate(netlist, XOR, operands[0], operands[1]);
+    int both = bench_add_gate(netlist, AND, operands[0], operands[1]);
+    int carried = bench_add_gate(netlist, AND, half, operands[2]);
+
+    *sum = bench_add_gate(netlist, XOR, half, operands[2]);
+    *carry = bench_add_gate(netlist, OR, both, carried);
+  }
+}
+
+/* Array multiplier, every partial product row rippled into the sum */
+static int bench_multiplier_netlist(const bench_options_t *options,
+                                    bench_netlist_t *netlist) {
+  int bits = options->size;
+  int gates = bits * bits * 6;
+
+  if (bench_netlist_alloc(netlist, gates, 2 * bits, 2 * gates) != 0) {
+    return -1;
+  }
+
+  int *sum = malloc(2 * bits * sizeof(int));
+
+  if (sum == NULL) {
+    return -1;
+  }
+
+  for (int c = 0; c < 2 * bits; c++) {
+    sum[c] = -1;
+  }
+
+  for (int i = 0; i < bits; i++) {
+    int carry = -1;
+
+    for (int j = 0; j < bits; j++) {
+      int product = bench_add_gate(netlist, AND, LOGIC_BUILD_INPUT(i),
+                                   LOGIC_BUILD_INPUT(bits + j));
+
+      bench_add_bits(netlist, sum[i + j], product, carry, &sum[i + j],
+                     &carry);
+    }
+
+    sum[i + bits] = carry;
+  }
+
+  for (int c = 0; c < 2 * bits; c++) {
+    if (sum[c] >= 0) {
+      netlist->output_gates[netlist->outputs++] = sum[c];
+    }
+  }
+
+  free(sum);
+
+  return 0;
+}
+
+static void bench_print_row(const char *phase, double ms, double gate_evals) {
+  if (gate_evals > 0) {
+    printf("| %-10s | %10.2f | %13.1f |\n", phase, ms,
+           gate_evals / (ms * 1e3));
+  } else {
+    printf("| %-10s | %10.2f | %13s |\n", phase, ms, "-");
+  }
+}
+
+static void bench_random_inputs(logic_circuit_t *circuit, uint64_t *state) {
+  for (int i = 0; i < circuit->primary_inputs; i++) {
+    logic_circuit_set_input(circuit, i, bench_random(state));
+  }
+}
+
+static double bench_run_vm(logic_circuit_t *circuit,
+                           const logic_vm_program_t *program, int runs,
+                           uint64_t *state) {
+  double start = bench_now();
+
+  for (int r = 0; r < runs; r++) {
+    bench_random_inputs(circuit, state);
+    logic_vm_run(program, circuit->values);
+  }
+
+  return bench_now() - start;
+}
+
+static int bench_circuit(const bench_options_t *options) {
+  bench_netlist_t netlist;
+  int status = options->kind == BENCH_RANDOM
+                   ? bench_random_netlist(options, &netlist)
+                   : bench_multiplier_netlist(options, &netlist);
+
+  if (status != 0) {
+    fprintf(stderr, "ERROR: Out of memory.\n");
+    bench_netlist_free(&netlist);
+    return -1;
+  }
+
+  logic_sim_t *sim = logic_sim_create();
+  double start = bench_now();
+
+  logic_builder_t *builder =
+      logic_builder_create(sim, netlist.gates, netlist.inputs, netlist.edges);
+  logic_circuit_t *circuit = NULL;
+
+  if (builder != NULL &&
+      logic_builder_add_inputs(builder, netlist.inputs, NULL) >= 0 &&
+      logic_builder_add_gates(builder, netlist.gates, netlist.types,
+                              netlist.arities, netlist.sources, NULL) >= 0) {
+    circuit = logic_builder_compile(builder, netlist.outputs,
+                                    netlist.output_gates);
+  }
+
+  double build_ms = bench_now() - start;
+
+  logic_builder_free(builder);
+  bench_netlist_free(&netlist);
+
+  if (circuit == NULL) {
+    fprintf(stderr, "ERROR: The benchmark circuit did not compile.\n");
+    logic_sim_free(sim);
+    return -1;
+  }
+
+  printf("%s of %d: %d gates, %d inputs, %d outputs, %d levels\n\n",
+         options->kind == BENCH_RANDOM ? "Random logic" : "Multiplier",
+         options->size, circuit->gates, circuit->primary_inputs,
+         circuit->outputs, circuit->levels);
+
+  printf("| %-10s | %10s | %13s |\n", "Phase", "ms", "Mgate evals/s");
+  printf("|------------|------------|---------------|\n");
+  bench_print_row("build", build_ms, 0);
+
+  uint64_t state = options->seed;
+  double lanes = (double)circuit->gates * LOGIC_LANES;
+
+  start = bench_now();
+  logic_vm_program_t *program = logic_vm_compile(circuit);
+  bench_print_row("vm compile", bench_now() - start, 0);
+
+  if (program != NULL) {
+    double ms = bench_run_vm(circuit, program, options->runs, &state);
+
+    bench_print_row("vm run", ms, lanes * options->runs);
+    logic_vm_free(program);
+  }
+
+  /* One output at a time, the cones are cached after the first query */
+  start = bench_now();
+  long cone_gates = 0;
+
+  for (int r = 0; r < options->runs; r++) {
+    int output = bench_random(&state) % circuit->outputs;
+
+    logic_cone_t *cone = logic_cone_get(circuit, 1, &output);
+
+    if (cone == NULL) {
+      break;
+    }
+
+    bench_random_inputs(circuit, &state);
+    logic_cone_evaluate(circuit, cone);
+    cone_gates += cone->gates;
+  }
+
+  bench_print_row("cones", bench_now() - start,
+                  (double)cone_gates * LOGIC_LANES);
+
+  start = bench_now();
+  logic_xsim_t *xsim = logic_xsim_create(circuit);
+
+  if (xsim != NULL) {
+    int runs = options->runs / 4 + 1;
+
+    for (int r = 0; r < runs; r++) {
+      for (int i = 0; i < circuit->primary_inputs; i++) {
+        logic_word_t one = bench_random(&state);
+        logic_word_t x = bench_random(&state) & bench_random(&state);
+        logic_xword_t xword = {~one | x, one | x};
+
+        logic_xsim_set_input(xsim, i, xword);
+      }
+
+      logic_xsim_run(xsim);
+    }
+
+    bench_print_row("x sim", bench_now() - start, lanes * runs);
+    logic_xsim_free(xsim);
+  }
+
+  double coverage = -1;
+  long words = (options->patterns + LOGIC_LANES - 1) / LOGIC_LANES;
+  logic_word_t *patterns =
+      malloc(words * circuit->primary_inputs * sizeof(logic_word_t));
+
+  if (patterns != NULL && circuit->gates <= options->fault_gates) {
+    for (long i = 0; i < words * circuit->primary_inputs; i++) {
+      patterns[i] = bench_random(&state);
+    }
+
+    start = bench_now();
+    logic_fault_sim_t *fault_sim =
+        logic_fault_sim_create(circuit, options->threads);
+    logic_fault_report_t report;
+
+    if (fault_sim != NULL &&
+        logic_fault_sim_run(fault_sim, patterns, options->patterns, &report) ==
+            0) {
+      bench_print_row("fault sim", bench_now() - start, 0);
+      coverage = report.coverage;
+    }
+
+    logic_fault_sim_free(fault_sim);
+  }
+
+  free(patterns);
+
+  /* The optimized and mapped circuit, run again */
+  start = bench_now();
+  logic_circuit_optimize(circuit, NULL, NULL);
+  bench_print_row("optimize", bench_now() - start, 0);
+
+  logic_lut_options_t lut_options = {4, 8};
+
+  start = bench_now();
+  int mapped = logic_circuit_map_luts(circuit, &lut_options, NULL);
+  bench_print_row("lut map", bench_now() - start, 0);
+
+  program = mapped == 0 ? logic_vm_compile(circuit) : NULL;
+
+  if (program != NULL) {
+    double ms = bench_run_vm(circuit, program, options->runs, &state);
+
+    bench_print_row("lut run", ms,
+                    (double)circuit->gates * LOGIC_LANES * options->runs);
+    logic_vm_free(program);
+  }
+
+  if (coverage >= 0) {
+    printf("\nStuck-at coverage of %ld patterns: %.2f%%\n", options->patterns,
+           coverage);
+  }
+
+  printf("\n");
+
+  logic_circuit_free(circuit);
+  logic_sim_free(sim);
+
+  return 0;
+}
+
+static void bench_usage(const char *name) {
+  fprintf(stderr,
+          "Usage: %s [-k random|multiplier] [-n size] [-i inputs]\n"
+          "       [-w window] [-r runs] [-p patterns] [-f fault_gates]\n"
+          "       [-t threads] [-s seed]\n\n"
+          "Without -k every benchmark circuit is run.\n",
+          name);
+}
+
+int main(int argc, char *argv[]) {
+  bench_options_t options = {BENCH_RANDOM, 0, 256, 0, 256, 256, 8192, 1, 1};
+  bool all = true;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "k:n:i:w:r:p:f:t:s:")) != -1) {
+    switch (opt) {
+    case 'k':
+      all = false;
+
+      if (strcmp(optarg, "random") == 0) {
+        options.kind = BENCH_RANDOM;
+      } else if (strcmp(optarg, "multiplier") == 0) {
+        options.kind = BENCH_MULTIPLIER;
+      } else {
+        bench_usage(argv[0]);
+        return 1;
+      }
+      break;
+    case 'n':
+      options.size = atoi(optarg);
+      break;
+    case 'i':
+      options.inputs = atoi(optarg);
+      break;
+    case 'w':
+      options.window = atoi(optarg);
+      break;
+    case 'r':
+      options.runs = atoi(optarg);
+      break;
+    case 'p':
+      options.patterns = atol(optarg);
+      break;
+    case 'f':
+      options.fault_gates = atoi(optarg);
+      break;
+    case 't':
+      options.threads = atoi(optarg);
+      break;
+    case 's':
+      options.seed = strtoull(optarg, NULL, 0);
+      break;
+    default:
+      bench_usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (options.inputs < 1 || options.window < 0 || options.runs < 1 ||
+      options.patterns < 1 || options.fault_gates < 0 ||
+      options.threads < 1 || options.size < 0 || options.seed == 0) {
+    bench_usage(argv[0]);
+    return 1;
+  }
+
+  if (!all) {
+    if (options.size == 0) {
+      options.size = options.kind == BENCH_RANDOM ? 65536 : 32;
+    }
+
+    return bench_circuit(&options) == 0 ? 0 : 1;
+  }
+
+  /* Small, cache resident and large circuits of both kinds */
+  static const int random_sizes[] = {4096, 32768, 131072};
+  static const int multiplier_sizes[] = {16, 32, 64};
+
+  for (int i = 0; i < 3; i++) {
+    options.kind = BENCH_RANDOM;
+    options.size = random_sizes[i];
+
+    if (bench_circuit(&options) != 0) {
+      return 1;
+    }
+
+    options.kind = BENCH_MULTIPLIER;
+    options.size = multiplier_sizes[i];
+
+    if (bench_circuit(&options) != 0) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -20,21 +20,23 @@
 int main() {
   printf("LOG: Creating the logic block.\n");
 
-  logic_graph_init("and");
-  logic_utility_init("and.log");
+  logic_sim_t *sim = logic_sim_create();
+
+  logic_graph_init(sim, "and");
+  logic_utility_init(sim, "and.log");
 
   /* Create logic block */
-  logic_block_t *lb = logic_create_logic_block(AND, 2, 1, "lb", NULL);
+  logic_block_t *lb = logic_create_logic_block(sim, AND, 2, 1, "lb", NULL);
 
   printf("LOG: Creating input blocks.\n");
 
   /* Create data block */
-  logic_data_t *input_a = logic_create_data_block(INPUT, 1);
-  logic_data_t *input_b = logic_create_data_block(INPUT, 0);
+  logic_data_t *input_a = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *input_b = logic_create_data_block(sim, INPUT, 0);
 
   printf("LOG: Creating output blocks.\n");
 
-  logic_data_t *output = logic_create_data_block(OUTPUT, 0);
+  logic_data_t *output = logic_create_data_block(sim, OUTPUT, 0);
 
   printf("LOG: Connecting input blocks.\n");
 
@@ -49,10 +51,11 @@ int main() {
   /* Evaluate */
   printf("LOG: Evaluating all blocks .\n");
 
-  logic_evaluate(1, lb);
+  logic_evaluate(sim, 1, lb);
 
-  logic_graph_export("and.svg");
-  logic_utility_terminate();
+  logic_graph_export(sim, "and.svg");
+  logic_utility_terminate(sim);
+  logic_sim_free(sim);
 
   return 0;
 }
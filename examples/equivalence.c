@@ -0,0 +1,115 @@
+/**
+ * @file equivalence.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Example for equivalence checking of two XOR implementations.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimcircuit.h"
+#include "logsimequiv.h"
+#include "logsimlib.h"
+
+/*************** Function Definitions ***************/
+
+int main() {
+  printf("LOG: Creating the logic block.\n");
+
+  logic_sim_t *sim = logic_sim_create();
+
+  /*
+   *               XOR
+   * A -------------|===|
+   *            |   | 1 |----- SUM
+   * B ----|----|---|===|
+   *
+   *               OR
+   * A -------------|===|
+   *            |   | 3 |-----|         AND
+   * B ----|----|---|===|     |--------|===|
+   *                                   | 2 |----- SUM
+   *               AND        NOT  |---|===|
+   * A -------------|===|    |===| |
+   *            |   | 4 |----| 5 |--
+   * B ----|----|---|===|    |===|
+   */
+
+  /************************ Create 5 blocks ************************/
+  printf("LOG: Creating logic blocks.\n");
+
+  logic_block_t *lb_1 = logic_create_logic_block(sim, XOR, 2, 1, "lb_1", "SUM");
+  logic_block_t *lb_2 = logic_create_logic_block(sim, AND, 2, 1, "lb_2", "SUM");
+  logic_block_t *lb_3 = logic_create_logic_block(sim, OR, 2, 1, "lb_3", NULL);
+  logic_block_t *lb_4 = logic_create_logic_block(sim, AND, 2, 1, "lb_4", NULL);
+  logic_block_t *lb_5 = logic_create_logic_block(sim, NOT, 1, 1, "lb_5", NULL);
+
+  /************************ Create 2 input blocks ************************/
+
+  printf("LOG: Creating data blocks.\n");
+
+  /* Both circuits share the inputs, so they are matched one to one */
+  logic_data_t *input_a = logic_create_data_block(sim, INPUT, 0);
+  logic_data_t *input_b = logic_create_data_block(sim, INPUT, 0);
+
+  /************************ Create 5 output blocks ************************/
+
+  logic_data_t *lb_o_1_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_2_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_3_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_4_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_5_1 = logic_create_data_block(sim, OUTPUT, 0);
+
+  /************************ Connections ************************/
+
+  printf("LOG: Connecting logic-data blocks.\n");
+
+  logic_block_data_connect(lb_1, input_a);
+  logic_block_data_connect(lb_1, input_b);
+  logic_block_data_connect(lb_1, lb_o_1_1);
+
+  logic_block_block_connect(lb_2, lb_3);
+  logic_block_block_connect(lb_2, lb_5);
+  logic_block_data_connect(lb_2, lb_o_2_1);
+
+  logic_block_data_connect(lb_3, input_a);
+  logic_block_data_connect(lb_3, input_b);
+  logic_block_data_connect(lb_3, lb_o_3_1);
+
+  logic_block_data_connect(lb_4, input_a);
+  logic_block_data_connect(lb_4, input_b);
+  logic_block_data_connect(lb_4, lb_o_4_1);
+
+  logic_block_block_connect(lb_5, lb_4);
+  logic_block_data_connect(lb_5, lb_o_5_1);
+
+  /************************ Compare ************************/
+
+  printf("LOG: Comparing circuits.\n");
+
+  logic_circuit_t *circuit_a = logic_circuit_compile(1, &lb_1);
+  logic_circuit_t *circuit_b = logic_circuit_compile(1, &lb_2);
+
+  logic_equiv_options_t options = {16, 1024, 1, true};
+  logic_equiv_result_t result;
+
+  logic_equiv_check(circuit_a, circuit_b, &options, &result);
+  logic_equiv_print_result(&result, stdout);
+
+  logic_equiv_result_free(&result);
+  logic_circuit_free(circuit_a);
+  logic_circuit_free(circuit_b);
+  logic_sim_free(sim);
+
+  return 0;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
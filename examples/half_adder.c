@@ -20,8 +20,10 @@
 int main() {
   printf("LOG: Creating the logic block.\n");
 
-  logic_graph_init("half_adder");
-  logic_utility_init("half_adder.log");
+  logic_sim_t *sim = logic_sim_create();
+
+  logic_graph_init(sim, "half_adder");
+  logic_utility_init(sim, "half_adder.log");
 
   /*
    *               XOR
@@ -38,23 +40,25 @@ int main() {
   /************************ Create 3 blocks ************************/
   printf("LOG: Creating logic blocks.\n");
 
-  logic_block_t *lb_1 = logic_create_logic_block(XOR, 2, 1, "lb_1", "SUM");
-  logic_block_t *lb_2 = logic_create_logic_block(AND, 2, 1, "lb_2", "CARRY");
+  logic_block_t *lb_1 = logic_create_logic_block(sim, XOR, 2, 1, "lb_1", "SUM");
+
+  logic_block_t *lb_2 =
+      logic_create_logic_block(sim, AND, 2, 1, "lb_2", "CARRY");
 
   /************************ Create 6 input blocks ************************/
 
   printf("LOG: Creating data blocks.\n");
 
-  logic_data_t *lb_i_1_1 = logic_create_data_block(INPUT, 1);
-  logic_data_t *lb_i_1_2 = logic_create_data_block(INPUT, 1);
+  logic_data_t *lb_i_1_1 = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *lb_i_1_2 = logic_create_data_block(sim, INPUT, 1);
 
-  logic_data_t *lb_i_2_1 = logic_create_data_block(INPUT, 1);
-  logic_data_t *lb_i_2_2 = logic_create_data_block(INPUT, 1);
+  logic_data_t *lb_i_2_1 = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *lb_i_2_2 = logic_create_data_block(sim, INPUT, 1);
 
   /************************ Create 3 output blocks ************************/
 
-  logic_data_t *lb_o_1_1 = logic_create_data_block(OUTPUT, 0);
-  logic_data_t *lb_o_2_1 = logic_create_data_block(OUTPUT, 0);
+  logic_data_t *lb_o_1_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_2_1 = logic_create_data_block(sim, OUTPUT, 0);
 
   /************************ Connect block 1 ************************/
 
@@ -78,10 +82,11 @@ int main() {
 
   /************************ Evaluate ************************/
 
-  logic_evaluate(2, lb_1, lb_2);
+  logic_evaluate(sim, 2, lb_1, lb_2);
 
-  logic_graph_export("half_adder.svg");
-  logic_utility_terminate();
+  logic_graph_export(sim, "half_adder.svg");
+  logic_utility_terminate(sim);
+  logic_sim_free(sim);
 
   return 0;
 }
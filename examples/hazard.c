@@ -0,0 +1,119 @@
+/**
+ * @file hazard.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Example for a static hazard seen by the timing simulator.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimcircuit.h"
+#include "logsimlib.h"
+#include "logsimtiming.h"
+
+/*************** Function Definitions ***************/
+
+static void on_change(void *user, int net, int value, uint64_t time) {
+  int output_net = *(int *)user;
+
+  if (net == output_net) {
+    printf("LOG: t = %3llu Y = %d\n", (unsigned long long)time, value);
+  }
+}
+
+int main() {
+  printf("LOG: Creating the logic block.\n");
+
+  logic_sim_t *sim = logic_sim_create();
+
+  /*
+   *                 AND
+   * A ----|--------|===|
+   *       |        | 2 |-----|       OR
+   * B -------------|===|     |------|===|
+   *       |                         | 1 |----- Y
+   *       |  NOT       AND   |------|===|
+   *       |-|===|    |===|   |
+   *         | 4 |----| 3 |---|
+   *         |===|  |-|===|
+   * C -------------|
+   */
+
+  /************************ Create 4 blocks ************************/
+  printf("LOG: Creating logic blocks.\n");
+
+  logic_block_t *lb_1 = logic_create_logic_block(sim, OR, 2, 1, "lb_1", "Y");
+  logic_block_t *lb_2 = logic_create_logic_block(sim, AND, 2, 1, "lb_2", NULL);
+  logic_block_t *lb_3 = logic_create_logic_block(sim, AND, 2, 1, "lb_3", NULL);
+  logic_block_t *lb_4 = logic_create_logic_block(sim, NOT, 1, 1, "lb_4", NULL);
+
+  /************************ Create 3 input blocks ************************/
+
+  printf("LOG: Creating data blocks.\n");
+
+  logic_data_t *input_a = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *input_b = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *input_c = logic_create_data_block(sim, INPUT, 1);
+
+  /************************ Connections ************************/
+
+  printf("LOG: Connecting logic-data blocks.\n");
+
+  logic_block_block_connect(lb_1, lb_2);
+  logic_block_block_connect(lb_1, lb_3);
+
+  logic_block_data_connect(lb_2, input_a);
+  logic_block_data_connect(lb_2, input_b);
+
+  logic_block_block_connect(lb_3, lb_4);
+  logic_block_data_connect(lb_3, input_c);
+
+  logic_block_data_connect(lb_4, input_a);
+
+  /************************ Simulate ************************/
+
+  logic_circuit_t *circuit = logic_circuit_compile(1, &lb_1);
+  int output_net = circuit->output_nets[0];
+
+  /* The inverter is slower than the path through lb_2 */
+  logic_timing_options_t options = {
+      LOGIC_DELAY_TRANSPORT,
+      {[AND] = {1, 1}, [OR] = {4, 4}, [NOT] = {3, 3}, [XOR] = {1, 1}},
+      on_change,
+      &output_net};
+
+  printf("LOG: A falls at t = 10, transport delays.\n");
+
+  logic_timing_t *timing = logic_timing_create(circuit, &options);
+
+  logic_timing_set_input(timing, 0, 0, 10);
+  logic_timing_run(timing, UINT64_MAX);
+  logic_timing_free(timing);
+
+  printf("LOG: A falls at t = 10, inertial delays.\n");
+
+  options.mode = LOGIC_DELAY_INERTIAL;
+  timing = logic_timing_create(circuit, &options);
+
+  logic_timing_set_input(timing, 0, 0, 10);
+  logic_timing_run(timing, UINT64_MAX);
+
+  printf("LOG: Y settles to %d, %ld events cancelled.\n",
+         logic_timing_value(timing, output_net), timing->cancelled);
+
+  logic_timing_free(timing);
+  logic_circuit_free(circuit);
+  logic_sim_free(sim);
+
+  return 0;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
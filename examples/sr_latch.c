@@ -0,0 +1,104 @@
+/**
+ * @file sr_latch.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Example for a NOR latch, a circuit with a feedback loop.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimlib.h"
+
+/*************** Function Definitions ***************/
+
+int main() {
+  printf("LOG: Creating the logic block.\n");
+
+  logic_sim_t *sim = logic_sim_create();
+
+  logic_graph_init(sim, "sr_latch");
+  logic_utility_init(sim, "sr_latch.log");
+
+  /*
+   *          OR      NOT
+   * R ----|===|    |===|
+   *       | 1 |----| 2 |---|------- Q
+   *    |--|===|    |===|   |
+   *    |                   |
+   *    |---------------|   |
+   *                    |   |
+   *    |---------------|---|
+   *    |     OR      NOT   |
+   *    |--|===|    |===|   |
+   *       | 3 |----| 4 |---|------- QB
+   * S ----|===|    |===|
+   */
+
+  /************************ Create 4 blocks ************************/
+
+  printf("LOG: Creating logic blocks.\n");
+
+  logic_block_t *lb_1 = logic_create_logic_block(sim, OR, 2, 1, "lb_1", NULL);
+  logic_block_t *lb_2 = logic_create_logic_block(sim, NOT, 1, 1, "lb_2", "Q");
+  logic_block_t *lb_3 = logic_create_logic_block(sim, OR, 2, 1, "lb_3", NULL);
+  logic_block_t *lb_4 = logic_create_logic_block(sim, NOT, 1, 1, "lb_4", "QB");
+
+  /************************ Create data blocks ************************/
+
+  printf("LOG: Creating data blocks.\n");
+
+  logic_data_t *input_s = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *input_r = logic_create_data_block(sim, INPUT, 0);
+
+  logic_data_t *output_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *output_q = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *output_3 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *output_qb = logic_create_data_block(sim, OUTPUT, 0);
+
+  /************************ Connections ************************/
+
+  printf("LOG: Connecting logic-data blocks.\n");
+
+  logic_block_data_connect(lb_1, input_r);
+  logic_block_block_connect(lb_1, lb_4);
+  logic_block_data_connect(lb_1, output_1);
+  logic_block_block_connect(lb_2, lb_1);
+  logic_block_data_connect(lb_2, output_q);
+
+  logic_block_data_connect(lb_3, input_s);
+  logic_block_block_connect(lb_3, lb_2);
+  logic_block_data_connect(lb_3, output_3);
+  logic_block_block_connect(lb_4, lb_3);
+  logic_block_data_connect(lb_4, output_qb);
+
+  /************************ Evaluate ************************/
+
+  /* The latch keeps its state between evaluations while S and R are 0 */
+  int sequence[][2] = {{1, 0}, {0, 0}, {0, 1}, {0, 0}};
+
+  for (int i = 0; i < 4; i++) {
+    input_s->data = sequence[i][0];
+    input_r->data = sequence[i][1];
+
+    logic_evaluate(sim, 1, lb_2);
+
+    printf("LOG: S = %d R = %d Q = %d QB = %d\n", input_s->data,
+           input_r->data, output_q->data, output_qb->data);
+  }
+
+  logic_graph_export(sim, "sr_latch.svg");
+  logic_utility_terminate(sim);
+  logic_sim_free(sim);
+
+  return 0;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
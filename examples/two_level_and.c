@@ -20,8 +20,10 @@
 int main() {
   printf("LOG: Creating the logic block.\n");
 
-  logic_graph_init("two_level_and");
-  logic_utility_init("two_level_and.log");
+  logic_sim_t *sim = logic_sim_create();
+
+  logic_graph_init(sim, "two_level_and");
+  logic_utility_init(sim, "two_level_and.log");
 
   /*
    * ---|===|
@@ -37,25 +39,25 @@ int main() {
   /************************ Create 3 blocks ************************/
   printf("LOG: Creating logic blocks.\n");
 
-  logic_block_t *lb_1 = logic_create_logic_block(AND, 2, 1, "lb_1", "OUT");
-  logic_block_t *lb_2 = logic_create_logic_block(AND, 2, 1, "lb_2", NULL);
-  logic_block_t *lb_3 = logic_create_logic_block(AND, 2, 1, "lb_3", NULL);
+  logic_block_t *lb_1 = logic_create_logic_block(sim, AND, 2, 1, "lb_1", "OUT");
+  logic_block_t *lb_2 = logic_create_logic_block(sim, AND, 2, 1, "lb_2", NULL);
+  logic_block_t *lb_3 = logic_create_logic_block(sim, AND, 2, 1, "lb_3", NULL);
 
   /************************ Create 6 input blocks ************************/
 
   printf("LOG: Creating data blocks.\n");
 
-  logic_data_t *lb_i_2_1 = logic_create_data_block(INPUT, 1);
-  logic_data_t *lb_i_2_2 = logic_create_data_block(INPUT, 1);
+  logic_data_t *lb_i_2_1 = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *lb_i_2_2 = logic_create_data_block(sim, INPUT, 1);
 
-  logic_data_t *lb_i_3_1 = logic_create_data_block(INPUT, 0);
-  logic_data_t *lb_i_3_2 = logic_create_data_block(INPUT, 1);
+  logic_data_t *lb_i_3_1 = logic_create_data_block(sim, INPUT, 0);
+  logic_data_t *lb_i_3_2 = logic_create_data_block(sim, INPUT, 1);
 
   /************************ Create 3 output blocks ************************/
 
-  logic_data_t *lb_o_1_1 = logic_create_data_block(OUTPUT, 0);
-  logic_data_t *lb_o_2_1 = logic_create_data_block(OUTPUT, 0);
-  logic_data_t *lb_o_3_1 = logic_create_data_block(OUTPUT, 0);
+  logic_data_t *lb_o_1_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_2_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_3_1 = logic_create_data_block(sim, OUTPUT, 0);
 
   /************************ Connect block 1 ************************/
 
@@ -89,10 +91,11 @@ int main() {
 
   /************************ Evaluate ************************/
 
-  logic_evaluate(1, lb_1);
+  logic_evaluate(sim, 1, lb_1);
 
-  logic_graph_export("two_level_and.svg");
-  logic_utility_terminate();
+  logic_graph_export(sim, "two_level_and.svg");
+  logic_utility_terminate(sim);
+  logic_sim_free(sim);
 
   return 0;
 }
@@ -20,8 +20,10 @@
 int main() {
   printf("LOG: Creating the logic block.\n");
 
-  logic_graph_init("two_output_two_level");
-  logic_utility_init("two_output_two_level.log");
+  logic_sim_t *sim = logic_sim_create();
+
+  logic_graph_init(sim, "two_output_two_level");
+  logic_utility_init(sim, "two_output_two_level.log");
 
   /*
    * ---|===|
@@ -42,32 +44,37 @@ int main() {
   /************************ Create 3 blocks ************************/
   printf("LOG: Creating logic blocks.\n");
 
-  logic_block_t *lb_1 = logic_create_logic_block(AND, 2, 1, "lb_1", "OUT 1");
-  logic_block_t *lb_2 = logic_create_logic_block(AND, 2, 1, "lb_2", "OUT 2");
-  logic_block_t *lb_3 = logic_create_logic_block(AND, 2, 1, "lb_3", NULL);
-  logic_block_t *lb_4 = logic_create_logic_block(AND, 2, 1, "lb_4", NULL);
-  logic_block_t *lb_5 = logic_create_logic_block(AND, 2, 1, "lb_5", NULL);
+  logic_block_t *lb_1 =
+      logic_create_logic_block(sim, AND, 2, 1, "lb_1", "OUT 1");
+  logic_block_t *lb_2 =
+      logic_create_logic_block(sim, AND, 2, 1, "lb_2", "OUT 2");
+  logic_block_t *lb_3 = logic_create_logic_block(sim, AND, 2, 1, "lb_3", NULL);
+
+  logic_block_t *lb_4 = logic_create_logic_block(sim, AND, 2, 1, "lb_4", NULL);
+
+  logic_block_t *lb_5 = logic_create_logic_block(sim, AND, 2, 1, "lb_5", NULL);
+
 
   /************************ Create 6 input blocks ************************/
 
   printf("LOG: Creating data blocks.\n");
 
-  logic_data_t *lb_i_3_1 = logic_create_data_block(INPUT, 1);
-  logic_data_t *lb_i_3_2 = logic_create_data_block(INPUT, 1);
+  logic_data_t *lb_i_3_1 = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *lb_i_3_2 = logic_create_data_block(sim, INPUT, 1);
 
-  logic_data_t *lb_i_4_1 = logic_create_data_block(INPUT, 0);
-  logic_data_t *lb_i_4_2 = logic_create_data_block(INPUT, 1);
+  logic_data_t *lb_i_4_1 = logic_create_data_block(sim, INPUT, 0);
+  logic_data_t *lb_i_4_2 = logic_create_data_block(sim, INPUT, 1);
 
-  logic_data_t *lb_i_5_1 = logic_create_data_block(INPUT, 0);
-  logic_data_t *lb_i_5_2 = logic_create_data_block(INPUT, 1);
+  logic_data_t *lb_i_5_1 = logic_create_data_block(sim, INPUT, 0);
+  logic_data_t *lb_i_5_2 = logic_create_data_block(sim, INPUT, 1);
 
   /************************ Create 3 output blocks ************************/
 
-  logic_data_t *lb_o_1_1 = logic_create_data_block(OUTPUT, 0);
-  logic_data_t *lb_o_2_1 = logic_create_data_block(OUTPUT, 0);
-  logic_data_t *lb_o_3_1 = logic_create_data_block(OUTPUT, 0);
-  logic_data_t *lb_o_4_1 = logic_create_data_block(OUTPUT, 0);
-  logic_data_t *lb_o_5_1 = logic_create_data_block(OUTPUT, 0);
+  logic_data_t *lb_o_1_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_2_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_3_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_4_1 = logic_create_data_block(sim, OUTPUT, 0);
+  logic_data_t *lb_o_5_1 = logic_create_data_block(sim, OUTPUT, 0);
 
   /************************ Connect block 1 ************************/
 
@@ -111,10 +118,11 @@ int main() {
 
   /************************ Evaluate ************************/
 
-  logic_evaluate(2, lb_1, lb_2);
+  logic_evaluate(sim, 2, lb_1, lb_2);
 
-  logic_graph_export("two_output_two_level_and.svg");
-  logic_utility_terminate();
+  logic_graph_export(sim, "two_output_two_level_and.svg");
+  logic_utility_terminate(sim);
+  logic_sim_free(sim);
 
   return 0;
 }
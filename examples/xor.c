@@ -20,21 +20,23 @@
 int main() {
   printf("LOG: Creating the logic block.\n");
 
-  logic_graph_init("xor");
-  logic_utility_init("xor.log");
+  logic_sim_t *sim = logic_sim_create();
+
+  logic_graph_init(sim, "xor");
+  logic_utility_init(sim, "xor.log");
 
   /* Create logic block */
-  logic_block_t *lb = logic_create_logic_block(XOR, 2, 1, "lb", NULL);
+  logic_block_t *lb = logic_create_logic_block(sim, XOR, 2, 1, "lb", NULL);
 
   printf("LOG: Creating input blocks.\n");
 
   /* Create data block */
-  logic_data_t *input_a = logic_create_data_block(INPUT, 1);
-  logic_data_t *input_b = logic_create_data_block(INPUT, 0);
+  logic_data_t *input_a = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *input_b = logic_create_data_block(sim, INPUT, 0);
 
   printf("LOG: Creating output blocks.\n");
 
-  logic_data_t *output = logic_create_data_block(OUTPUT, 0);
+  logic_data_t *output = logic_create_data_block(sim, OUTPUT, 0);
 
   printf("LOG: Connecting input blocks.\n");
 
@@ -49,10 +51,11 @@ int main() {
   /* Evaluate */
   printf("LOG: Evaluating all blocks .\n");
 
-  logic_evaluate(1, lb);
+  logic_evaluate(sim, 1, lb);
 
-  logic_graph_export("xor.svg");
-  logic_utility_terminate();
+  logic_graph_export(sim, "xor.svg");
+  logic_utility_terminate(sim);
+  logic_sim_free(sim);
 
   return 0;
 }
@@ -0,0 +1,177 @@
+/**
+ * @file logsimaig.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief And-Inverter Graph form of compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_AIG_H
+#define LOG_SIM_AIG_H
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+/* A literal is a node index shifted left with the complement in bit 0 */
+#define LOGIC_AIG_FALSE 0u
+#define LOGIC_AIG_TRUE 1u
+
+#define LOGIC_AIG_LITERAL(node, complement)                                    \
+  (((logic_aig_literal_t)(node) << 1) | (logic_aig_literal_t)(complement))
+#define LOGIC_AIG_NODE(literal) ((literal) >> 1)
+#define LOGIC_AIG_IS_COMPLEMENT(literal) ((literal) & 1u)
+#define LOGIC_AIG_NOT(literal) ((literal) ^ 1u)
+
+/*************** Structures ***************/
+
+typedef uint32_t logic_aig_literal_t;
+
+/* Two input AND node, 8 bytes */
+typedef struct logic_aig_node {
+  logic_aig_literal_t fanin0;
+  logic_aig_literal_t fanin1;
+} logic_aig_node_t;
+
+typedef struct logic_aig {
+  /* Node 0 is constant false, nodes 1 to inputs are the primary inputs */
+  int nodes;
+  int inputs;
+  int outputs;
+  int capacity;
+
+  logic_aig_node_t *node_list;
+  logic_aig_literal_t *output_list;
+
+  /* Literal of every net of the circuit the graph was lowered from */
+  int nets;
+  logic_aig_literal_t *net_literals;
+
+  /* Structural hash of the AND nodes */
+  int table_size;
+  uint32_t *table;
+
+  logic_word_t *values;
+
+  /* An allocation failed, literals built since then are meaningless */
+  bool failed;
+} logic_aig_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Create an empty graph.
+ *
+ * @param inputs
+ * @return logic_aig_t*
+ */
+logic_aig_t *logic_aig_create(int inputs);
+
+/**
+ * @brief Lower a compiled circuit to an And-Inverter Graph.
+ *
+ * Circuits with feedback loops cannot be lowered.
+ *
+ * @param circuit
+ * @return logic_aig_t*
+ */
+logic_aig_t *logic_aig_from_circuit(const logic_circuit_t *circuit);
+
+/**
+ * @brief Literal of a primary input.
+ *
+ * @param aig
+ * @param input
+ * @return logic_aig_literal_t
+ */
+logic_aig_literal_t logic_aig_input(const logic_aig_t *aig, int input);
+
+/**
+ * @brief Add a structurally hashed AND node.
+ *
+ * When the node or hash table cannot grow the graph is marked failed, and
+ * this and every later call return LOGIC_AIG_FALSE. Outputs cannot be added
+ * to a failed graph, nor can it be simulated.
+ *
+ * @param aig
+ * @param a
+ * @param b
+ * @return logic_aig_literal_t
+ */
+logic_aig_literal_t logic_aig_and(logic_aig_t *aig, logic_aig_literal_t a,
+                                  logic_aig_literal_t b);
+
+/**
+ * @brief Add an OR as an AND of the complemented inputs.
+ *
+ * @param aig
+ * @param a
+ * @param b
+ * @return logic_aig_literal_t
+ */
+logic_aig_literal_t logic_aig_or(logic_aig_t *aig, logic_aig_literal_t a,
+                                 logic_aig_literal_t b);
+
+/**
+ * @brief Add an XOR as three AND nodes.
+ *
+ * @param aig
+ * @param a
+ * @param b
+ * @return logic_aig_literal_t
+ */
+logic_aig_literal_t logic_aig_xor(logic_aig_t *aig, logic_aig_literal_t a,
+                                  logic_aig_literal_t b);
+
+/**
+ * @brief Mark a literal as a graph output.
+ *
+ * @param aig
+ * @param literal
+ * @return int
+ */
+int logic_aig_add_output(logic_aig_t *aig, logic_aig_literal_t literal);
+
+/**
+ * @brief Simulate 64 vectors, one word per primary input.
+ *
+ * @param aig
+ * @param inputs
+ * @return int
+ */
+int logic_aig_simulate(logic_aig_t *aig, const logic_word_t *inputs);
+
+/**
+ * @brief Simulated lanes of a literal.
+ *
+ * @param aig
+ * @param literal
+ * @return logic_word_t
+ */
+logic_word_t logic_aig_value(const logic_aig_t *aig,
+                             logic_aig_literal_t literal);
+
+/**
+ * @brief Copy the simulated lanes into the nets of the source circuit.
+ *
+ * @param aig
+ * @param circuit
+ * @return int
+ */
+int logic_aig_store(const logic_aig_t *aig, logic_circuit_t *circuit);
+
+/**
+ * @brief Free the graph.
+ *
+ * @param aig
+ */
+void logic_aig_free(logic_aig_t *aig);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
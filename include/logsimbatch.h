@@ -0,0 +1,94 @@
+/**
+ * @file logsimbatch.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Batch regression over forked worker processes.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_BATCH_H
+#define LOG_SIM_BATCH_H
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+#include "logsimvm.h"
+
+/*************** Structures ***************/
+
+/* Fills the input words of one step, called in the worker owning the step */
+typedef void (*logic_batch_generator_t)(void *user, long step,
+                                        logic_word_t *inputs);
+
+typedef struct logic_batch {
+  /* Compiled once, shared copy-on-write with every worker */
+  logic_circuit_t *circuit;
+  logic_vm_program_t *program;
+
+  int workers;
+  bool sequential; /* Stateful circuit, every step runs in the caller */
+
+  /* Of the last run */
+  int failed_workers;
+  long failed_steps;
+} logic_batch_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Compile the circuit for batch runs, workers 0 uses every core.
+ *
+ * @param circuit
+ * @param workers
+ * @return logic_batch_t*
+ */
+logic_batch_t *logic_batch_create(logic_circuit_t *circuit, int workers);
+
+/**
+ * @brief Run the steps on the workers, each one a contiguous slice.
+ *
+ * Stimulus holds one word per primary input for every step, responses
+ * receive one word per circuit output for every step. The number of
+ * workers that crashed or failed is returned, their steps read 0.
+ *
+ * Circuits with feedback loops or memory write ports run every step in
+ * order in the calling process instead. Loops start from the circuit
+ * values and carry their state from step to step, and memories keep the
+ * writes.
+ *
+ * @param batch
+ * @param stimulus
+ * @param steps
+ * @param responses
+ * @return int
+ */
+int logic_batch_run(logic_batch_t *batch, const logic_word_t *stimulus,
+                    long steps, logic_word_t *responses);
+
+/**
+ * @brief Run the steps on the workers, the stimulus made by the workers.
+ *
+ * @param batch
+ * @param generator
+ * @param user
+ * @param steps
+ * @param responses
+ * @return int
+ */
+int logic_batch_run_generated(logic_batch_t *batch,
+                              logic_batch_generator_t generator, void *user,
+                              long steps, logic_word_t *responses);
+
+/**
+ * @brief Free the batch runner, the circuit is not owned.
+ *
+ * @param batch
+ */
+void logic_batch_free(logic_batch_t *batch);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
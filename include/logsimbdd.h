@@ -0,0 +1,339 @@
+/**
+ * @file logsimbdd.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Reduced ordered binary decision diagrams of circuit outputs.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_BDD_H
+#define LOG_SIM_BDD_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+/* An edge is a node index shifted left with the complement in bit 0 */
+#define LOGIC_BDD_FALSE 0u
+#define LOGIC_BDD_TRUE 1u
+
+/* Returned when the node limit is reached */
+#define LOGIC_BDD_INVALID UINT32_MAX
+
+#define LOGIC_BDD_NODE(edge) ((edge) >> 1)
+#define LOGIC_BDD_IS_COMPLEMENT(edge) ((edge) & 1u)
+#define LOGIC_BDD_NOT(edge) ((edge) ^ 1u)
+
+/*************** Structures ***************/
+
+typedef uint32_t logic_bdd_edge_t;
+
+/* Node 0 is the constant false, every other node tests one variable */
+typedef struct logic_bdd_node {
+  uint32_t var;
+  uint32_t refs; /* Parent nodes and external references */
+
+  logic_bdd_edge_t high; /* Never complemented */
+  logic_bdd_edge_t low;
+
+  uint32_t next; /* In the bucket of its subtable, or the free list */
+} logic_bdd_node_t;
+
+/* Unique table of the nodes of one variable */
+typedef struct logic_bdd_subtable {
+  int nodes;
+  uint32_t mask;
+  uint32_t *buckets;
+} logic_bdd_subtable_t;
+
+typedef struct logic_bdd_entry {
+  logic_bdd_edge_t f;
+  logic_bdd_edge_t g;
+  uint32_t op;
+  logic_bdd_edge_t result;
+} logic_bdd_entry_t;
+
+typedef struct logic_bdd_options {
+  int max_nodes;  /* Operations fail past this many nodes */
+  int cache_bits; /* Computed table of 2^cache_bits entries */
+
+  bool reorder;      /* Sift the variables as the diagrams grow */
+  int reorder_nodes; /* Live nodes triggering the first sifting */
+} logic_bdd_options_t;
+
+typedef struct logic_bdd {
+  int vars;
+  int *var_levels; /* Level of each variable, the constant sits at vars */
+  int *level_vars;
+  logic_bdd_subtable_t *subtable_list;
+
+  int capacity;
+  logic_bdd_node_t *node_list;
+  uint32_t free_list;
+
+  int live; /* Nodes in the subtables */
+  int dead; /* Of them, unreferenced ones left for the next collection */
+  int peak;
+
+  uint32_t cache_mask;
+  logic_bdd_entry_t *cache;
+
+  /* Visit stamps of the traversals, and the values they computed */
+  uint32_t stamp;
+  uint32_t *stamp_list;
+  double *value_list;
+
+  logic_bdd_options_t options;
+  int next_reorder;
+
+  int collections;
+  int reorders;
+} logic_bdd_t;
+
+/* Properties of one circuit output */
+typedef struct logic_bdd_output {
+  int nodes;
+  int support; /* Inputs the output depends on */
+
+  double satisfying; /* Input vectors setting the output */
+
+  int constant;    /* 0 or 1, -1 when the output depends on its inputs */
+  int equivalent;  /* First earlier output of the same function, or -1 */
+  bool complement; /* The equivalent output computes the complement */
+} logic_bdd_output_t;
+
+typedef struct logic_bdd_report {
+  int inputs;
+
+  int outputs;
+  logic_bdd_output_t *output_list;
+
+  int nodes; /* Shared by every output */
+  int peak_nodes;
+  int collections;
+  int reorders;
+} logic_bdd_report_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Create a manager of the given number of variables.
+ *
+ * Variable i starts on level i, options may be NULL for the defaults.
+ *
+ * @param vars
+ * @param options
+ * @return logic_bdd_t*
+ */
+logic_bdd_t *logic_bdd_create(int vars, const logic_bdd_options_t *options);
+
+/**
+ * @brief Diagram of a single variable.
+ *
+ * @param bdd
+ * @param var
+ * @return logic_bdd_edge_t
+ */
+logic_bdd_edge_t logic_bdd_var(logic_bdd_t *bdd, int var);
+
+/**
+ * @brief Conjunction of two diagrams.
+ *
+ * Results are unreferenced, reference the ones kept before the next
+ * collection or reordering.
+ *
+ * @param bdd
+ * @param f
+ * @param g
+ * @return logic_bdd_edge_t
+ */
+logic_bdd_edge_t logic_bdd_and(logic_bdd_t *bdd, logic_bdd_edge_t f,
+                               logic_bdd_edge_t g);
+
+/**
+ * @brief Disjunction of two diagrams.
+ *
+ * @param bdd
+ * @param f
+ * @param g
+ * @return logic_bdd_edge_t
+ */
+logic_bdd_edge_t logic_bdd_or(logic_bdd_t *bdd, logic_bdd_edge_t f,
+                              logic_bdd_edge_t g);
+
+/**
+ * @brief Exclusive or of two diagrams.
+ *
+ * @param bdd
+ * @param f
+ * @param g
+ * @return logic_bdd_edge_t
+ */
+logic_bdd_edge_t logic_bdd_xor(logic_bdd_t *bdd, logic_bdd_edge_t f,
+                               logic_bdd_edge_t g);
+
+/**
+ * @brief If f then g else h.
+ *
+ * @param bdd
+ * @param f
+ * @param g
+ * @param h
+ * @return logic_bdd_edge_t
+ */
+logic_bdd_edge_t logic_bdd_ite(logic_bdd_t *bdd, logic_bdd_edge_t f,
+                               logic_bdd_edge_t g, logic_bdd_edge_t h);
+
+/**
+ * @brief Keep a diagram through collections and reorderings.
+ *
+ * @param bdd
+ * @param edge
+ */
+void logic_bdd_ref(logic_bdd_t *bdd, logic_bdd_edge_t edge);
+
+/**
+ * @brief Drop a reference, the nodes are freed by the next collection.
+ *
+ * @param bdd
+ * @param edge
+ */
+void logic_bdd_deref(logic_bdd_t *bdd, logic_bdd_edge_t edge);
+
+/**
+ * @brief Free the unreferenced nodes, the number freed is returned.
+ *
+ * @param bdd
+ * @return int
+ */
+int logic_bdd_collect(logic_bdd_t *bdd);
+
+/**
+ * @brief Sift every variable to the level minimizing the live nodes.
+ *
+ * Referenced diagrams keep their edges, only their shape changes.
+ *
+ * @param bdd
+ * @return int
+ */
+int logic_bdd_reorder(logic_bdd_t *bdd);
+
+/**
+ * @brief Nodes of a diagram, the constant included.
+ *
+ * @param bdd
+ * @param edge
+ * @return int
+ */
+int logic_bdd_size(logic_bdd_t *bdd, logic_bdd_edge_t edge);
+
+/**
+ * @brief Variables a diagram depends on.
+ *
+ * @param bdd
+ * @param edge
+ * @return int
+ */
+int logic_bdd_support(logic_bdd_t *bdd, logic_bdd_edge_t edge);
+
+/**
+ * @brief Assignments of every variable satisfying a diagram.
+ *
+ * Exact up to 53 variables, the precision of a double.
+ *
+ * @param bdd
+ * @param edge
+ * @return double
+ */
+double logic_bdd_sat_count(logic_bdd_t *bdd, logic_bdd_edge_t edge);
+
+/**
+ * @brief Store one satisfying assignment, 0 for the free variables.
+ *
+ * Fails on the constant false.
+ *
+ * @param bdd
+ * @param edge
+ * @param assignment
+ * @return int
+ */
+int logic_bdd_pick(const logic_bdd_t *bdd, logic_bdd_edge_t edge,
+                   int *assignment);
+
+/**
+ * @brief Value of a diagram under an assignment of every variable.
+ *
+ * @param bdd
+ * @param edge
+ * @param assignment
+ * @return bool
+ */
+bool logic_bdd_evaluate(const logic_bdd_t *bdd, logic_bdd_edge_t edge,
+                        const int *assignment);
+
+/**
+ * @brief Build the diagram of every output of a circuit.
+ *
+ * Input i of the circuit is variable input_vars[i], or variable i when
+ * input_vars is NULL. Gates are visited in order and the diagram of a net
+ * is dropped after its last reader, collecting and reordering in between.
+ * The output diagrams are stored referenced. Circuits with feedback loops
+ * or word level cells other than lookup tables are rejected.
+ *
+ * @param bdd
+ * @param circuit
+ * @param input_vars
+ * @param outputs
+ * @return int
+ */
+int logic_bdd_build(logic_bdd_t *bdd, const logic_circuit_t *circuit,
+                    const int *input_vars, logic_bdd_edge_t *outputs);
+
+/**
+ * @brief Free the manager and every diagram in it.
+ *
+ * @param bdd
+ */
+void logic_bdd_free(logic_bdd_t *bdd);
+
+/**
+ * @brief Exact properties of every output, without enumerating vectors.
+ *
+ * Inputs are ordered as the gates first read them, then sifted.
+ *
+ * @param circuit
+ * @param options
+ * @param report
+ * @return int
+ */
+int logic_bdd_analyze(const logic_circuit_t *circuit,
+                      const logic_bdd_options_t *options,
+                      logic_bdd_report_t *report);
+
+/**
+ * @brief Print the properties of every output.
+ *
+ * @param report
+ * @param stream
+ */
+void logic_bdd_print_report(const logic_bdd_report_t *report, FILE *stream);
+
+/**
+ * @brief Free the arrays held by a report.
+ *
+ * @param report
+ */
+void logic_bdd_report_free(logic_bdd_report_t *report);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
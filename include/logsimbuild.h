@@ -0,0 +1,136 @@
+/**
+ * @file logsimbuild.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Bulk netlist construction with capacity reserved up front.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_BUILD_H
+#define LOG_SIM_BUILD_H
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+/* Source of a gate input, gates are numbered from 0 and inputs below -1 */
+#define LOGIC_BUILD_INPUT(i) (-2 - (i))
+#define LOGIC_BUILD_IS_INPUT(source) ((source) <= -2)
+
+/*************** Structures ***************/
+
+typedef struct logic_builder {
+  logic_sim_t *sim;
+
+  /* Reserved when the builder is created, adding past them fails */
+  int gate_capacity;
+  int input_capacity;
+  int edge_capacity;
+
+  int gates;
+  int inputs;
+  int edges;
+
+  /* Blocks and streams live in arrays of the context, one per kind */
+  logic_block_t *gate_list;
+  logic_data_t *input_list;
+  logic_data_t *output_list; /* OUTPUT data block of each gate */
+  logic_top_block_t *stream_list;
+  logic_top_block_t **stream_pointers;
+} logic_builder_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Reserve the blocks of a netlist in the context.
+ *
+ * Every gate, input and edge is placed in arrays allocated here, adding
+ * them later allocates nothing but their interned names.
+ *
+ * @param sim
+ * @param gates
+ * @param inputs
+ * @param edges
+ * @return logic_builder_t*
+ */
+logic_builder_t *logic_builder_create(logic_sim_t *sim, int gates, int inputs,
+                                      int edges);
+
+/**
+ * @brief Add INPUT data blocks, the index of the first is returned.
+ *
+ * @param builder
+ * @param count
+ * @param values
+ * @return int
+ */
+int logic_builder_add_inputs(logic_builder_t *builder, int count,
+                             const int *values);
+
+/**
+ * @brief Add gates and wire their inputs, the index of the first is returned.
+ *
+ * Sources hold the inputs of every gate in turn, arities[g] of them for
+ * gate g, either a gate index or LOGIC_BUILD_INPUT(i). Gates may read any
+ * gate added so far or in the same call, so loops are added in one call.
+ * Types, arities and sources are checked before anything is wired, a
+ * rejected call adds nothing. Names may be NULL, gates are then named
+ * "g<index>".
+ *
+ * @param builder
+ * @param count
+ * @param types
+ * @param arities
+ * @param sources
+ * @param names
+ * @return int
+ */
+int logic_builder_add_gates(logic_builder_t *builder, int count,
+                            const logic_block_type_t *types,
+                            const int *arities, const int *sources,
+                            const char *const *names);
+
+/**
+ * @brief Get the block of a gate.
+ *
+ * @param builder
+ * @param gate
+ * @return logic_block_t*
+ */
+logic_block_t *logic_builder_gate(logic_builder_t *builder, int gate);
+
+/**
+ * @brief Get the data block of an input.
+ *
+ * @param builder
+ * @param input
+ * @return logic_data_t*
+ */
+logic_data_t *logic_builder_input(logic_builder_t *builder, int input);
+
+/**
+ * @brief Compile the cones of the output gates.
+ *
+ * @param builder
+ * @param outputs
+ * @param output_gates
+ * @return logic_circuit_t*
+ */
+logic_circuit_t *logic_builder_compile(logic_builder_t *builder, int outputs,
+                                       const int *output_gates);
+
+/**
+ * @brief Free the builder, its blocks stay with the context.
+ *
+ * @param builder
+ */
+void logic_builder_free(logic_builder_t *builder);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
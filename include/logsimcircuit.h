@@ -0,0 +1,86 @@
+/**
+ * @file logsimcircuit.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Compiled, levelized form of a LogSim block graph.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_CIRCUIT_H
+#define LOG_SIM_CIRCUIT_H
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+/* Net of the i-th primary input */
+#define LOGIC_INPUT_NET(i) (LOGIC_NET_RESERVED + (i))
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Compile the cones of the output blocks into a levelized circuit.
+ *
+ * @param total_logic_blocks
+ * @param logic_blocks
+ * @return logic_circuit_t*
+ */
+logic_circuit_t *logic_circuit_compile(int total_logic_blocks,
+                                       logic_block_t **logic_blocks);
+
+/**
+ * @brief Get the net holding the result of a block, -1 if not compiled in.
+ *
+ * Blocks are found by id without a search, see logic_find_block() for
+ * finding them by path.
+ *
+ * @param circuit
+ * @param logic_block
+ * @return int
+ */
+int logic_circuit_block_net(const logic_circuit_t *circuit,
+                            const logic_block_t *logic_block);
+
+/**
+ * @brief Free a compiled circuit.
+ *
+ * @param circuit
+ */
+void logic_circuit_free(logic_circuit_t *circuit);
+
+/**
+ * @brief Broadcast the data block values to every lane of the input nets.
+ *
+ * @param circuit
+ * @return int
+ */
+int logic_circuit_load_inputs(logic_circuit_t *circuit);
+
+/**
+ * @brief Set the lanes of a primary input.
+ *
+ * @param circuit
+ * @param input
+ * @param word
+ * @return int
+ */
+int logic_circuit_set_input(logic_circuit_t *circuit, int input,
+                            logic_word_t word);
+
+/**
+ * @brief Copy one lane of the net values back into the output data blocks.
+ *
+ * @param circuit
+ * @param lane
+ * @return int
+ */
+int logic_circuit_write_back(logic_circuit_t *circuit, int lane);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
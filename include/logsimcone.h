@@ -0,0 +1,82 @@
+/**
+ * @file logsimcone.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Output selective evaluation over cached cone schedules.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_CONE_H
+#define LOG_SIM_CONE_H
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Structures ***************/
+
+/* Union cone of influence of a set of circuit outputs */
+typedef struct logic_cone {
+  uint64_t key;
+
+  int outputs;
+  int *output_list; /* Sorted output IDs */
+
+  int gates;
+  int *gate_list; /* Gate indices in circuit order */
+
+  struct logic_cone *next;
+} logic_cone_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Get the cached schedule for a set of output IDs, building it on
+ * first use.
+ *
+ * Output IDs index circuit->output_nets, one per bit of the blocks the
+ * circuit was compiled from, so a cell takes one ID per bit. Circuits with
+ * feedback loops have no cone schedules.
+ *
+ * @param circuit
+ * @param total_outputs
+ * @param outputs
+ * @return logic_cone_t*
+ */
+logic_cone_t *logic_cone_get(logic_circuit_t *circuit, int total_outputs,
+                             const int *outputs);
+
+/**
+ * @brief Evaluate the gates of a cone not yet evaluated for the current
+ * inputs.
+ *
+ * @param circuit
+ * @param cone
+ * @return int
+ */
+int logic_cone_evaluate(logic_circuit_t *circuit, const logic_cone_t *cone);
+
+/**
+ * @brief Evaluate only the cone of the given output IDs.
+ *
+ * @param circuit
+ * @param total_outputs
+ * @param outputs
+ * @return int
+ */
+int logic_circuit_evaluate_outputs(logic_circuit_t *circuit,
+                                   int total_outputs, const int *outputs);
+
+/**
+ * @brief Drop the cached schedules, needed whenever the gates change.
+ *
+ * @param circuit
+ */
+void logic_cone_clear(logic_circuit_t *circuit);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,103 @@
+/**
+ * @file logsimdot.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Streaming DOT export of compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_DOT_H
+#define LOG_SIM_DOT_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+#include <sys/types.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Enums ***************/
+
+typedef enum logic_dot_cluster {
+  LOGIC_DOT_CLUSTER_NONE,
+  LOGIC_DOT_CLUSTER_LEVELS, /* One cluster per logic level */
+  LOGIC_DOT_CLUSTER_PREFIX  /* One cluster per block prefix */
+} logic_dot_cluster_t;
+
+/*************** Structures ***************/
+
+typedef struct logic_dot_options {
+  logic_dot_cluster_t cluster;
+
+  /* Fanin cone of a single net, -1 for the whole circuit */
+  int cone_net;
+  int max_depth; /* Levels of the cone below the net, 0 for all */
+
+  /* Gates beyond the limit are left out, their readers drawn dashed */
+  int max_gates;
+} logic_dot_options_t;
+
+typedef struct logic_dot_render {
+  pid_t pid; /* Of the dot process */
+} logic_dot_render_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Write the circuit as DOT text, options NULL writes everything.
+ *
+ * @param circuit
+ * @param options
+ * @param name
+ * @param stream
+ * @return int
+ */
+int logic_dot_write(const logic_circuit_t *circuit,
+                    const logic_dot_options_t *options, const char *name,
+                    FILE *stream);
+
+/**
+ * @brief Write the circuit as DOT text into a file.
+ *
+ * @param circuit
+ * @param options
+ * @param name
+ * @param path
+ * @return int
+ */
+int logic_dot_write_file(const logic_circuit_t *circuit,
+                         const logic_dot_options_t *options, const char *name,
+                         const char *path);
+
+/**
+ * @brief Lay out and render a DOT file in a background dot process.
+ *
+ * graphviz keeps global parser and error state, so the render does not
+ * share the process with the cgraph calls of the simulation. The dot
+ * program has to be on the PATH, format is its -T output type.
+ *
+ * @param dot_path
+ * @param output_path
+ * @param format
+ * @return logic_dot_render_t*
+ */
+logic_dot_render_t *logic_dot_render_start(const char *dot_path,
+                                           const char *output_path,
+                                           const char *format);
+
+/**
+ * @brief Wait for a background render and free it.
+ *
+ * @param render
+ * @return int
+ */
+int logic_dot_render_wait(logic_dot_render_t *render);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
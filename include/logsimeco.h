@@ -0,0 +1,105 @@
+/**
+ * @file logsimeco.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Engineering change orders on compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_ECO_H
+#define LOG_SIM_ECO_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Structures ***************/
+
+typedef struct logic_eco_report {
+  int edited_gates; /* Gates whose inputs were read again */
+  int added_gates;
+  int added_inputs;
+
+  int moved_gates; /* Gates whose index changed */
+  int first_gate;  /* Gates before it were left untouched */
+} logic_eco_report_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Leave one input stream of a block unconnected.
+ *
+ * The next connect fills it again.
+ *
+ * @param logic_block
+ * @param input
+ * @return int
+ */
+int logic_block_disconnect(logic_block_t *logic_block, int input);
+
+/**
+ * @brief Make every block of the context reading a block read the
+ * replacement instead, the number of streams rewired is returned.
+ *
+ * The replacement keeps reading the block, so a gate can be inserted behind
+ * it. Circuit outputs compiled from the block stay on it.
+ *
+ * @param sim
+ * @param logic_block
+ * @param replacement
+ * @return int
+ */
+int logic_block_replace(logic_sim_t *sim, logic_block_t *logic_block,
+                        logic_block_t *replacement);
+
+/**
+ * @brief Bring a compiled circuit up to date with the edits of its blocks.
+ *
+ * Only gates of blocks connected or disconnected since the last compile or
+ * update read their inputs again. Blocks they newly read are compiled in
+ * behind the existing gates, and gates now reading a later gate are moved
+ * after it, so nothing before the first edited gate is rewritten. Levels
+ * are recomputed from there, net values are kept and cached cone schedules
+ * are kept unless they hold an edited gate. Gates no longer read stay until
+ * the next compile. Circuits with feedback loops, optimized or mapped
+ * circuits and edits closing a loop are rejected, leaving the circuit as it
+ * was.
+ *
+ * @param circuit
+ * @param report
+ * @return int
+ */
+int logic_circuit_update(logic_circuit_t *circuit, logic_eco_report_t *report);
+
+/**
+ * @brief Evaluate again only what the updates since the last evaluation
+ * may have changed.
+ *
+ * Edited and added gates are evaluated, then every later gate reading a
+ * net whose value changed, the others keep their values. Write ports
+ * evaluated again are committed to their memories at the end, as
+ * logic_vm_run() does. The number of gates evaluated is returned.
+ *
+ * @param circuit
+ * @return int
+ */
+int logic_circuit_evaluate_edits(logic_circuit_t *circuit);
+
+/**
+ * @brief Print the gates an update touched.
+ *
+ * @param report
+ * @param stream
+ */
+void logic_eco_print_report(const logic_eco_report_t *report, FILE *stream);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,93 @@
+/**
+ * @file logsimequiv.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Simulation based equivalence checking of two circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_EQUIV_H
+#define LOG_SIM_EQUIV_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Structures ***************/
+
+typedef struct logic_equiv_options {
+  int exhaustive_inputs; /* Enumerate every vector up to this many inputs */
+  long random_words;     /* Otherwise simulate this many words of vectors */
+  uint64_t seed;
+
+  bool match_internal; /* Collect candidate equivalent internal nets */
+} logic_equiv_options_t;
+
+/* Internal nets whose signatures agree over every simulated vector */
+typedef struct logic_equiv_pair {
+  int net_a;
+  int net_b;
+  bool complement;
+} logic_equiv_pair_t;
+
+typedef struct logic_equiv_result {
+  bool equivalent; /* No mismatch, a proof when exhaustive */
+  bool exhaustive;
+  long vectors;
+
+  int output; /* First mismatching output ID, -1 if none */
+  int inputs;
+  int *counterexample; /* Input values of circuit a */
+
+  int outputs;
+  uint64_t *signatures; /* Per output signature of circuit a */
+
+  int candidates;
+  logic_equiv_pair_t *candidate_list;
+} logic_equiv_result_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Drive both circuits with the same vectors and compare outputs.
+ *
+ * Inputs are matched through shared data blocks, or by position when the
+ * circuits share none. Circuits sharing only some of their inputs are
+ * rejected, as are circuits with feedback loops. Outputs are matched by ID.
+ *
+ * @param circuit_a
+ * @param circuit_b
+ * @param options
+ * @param result
+ * @return int
+ */
+int logic_equiv_check(logic_circuit_t *circuit_a, logic_circuit_t *circuit_b,
+                      const logic_equiv_options_t *options,
+                      logic_equiv_result_t *result);
+
+/**
+ * @brief Print the verdict and the counterexample if any.
+ *
+ * @param result
+ * @param stream
+ */
+void logic_equiv_print_result(const logic_equiv_result_t *result,
+                              FILE *stream);
+
+/**
+ * @brief Free the arrays held by a result.
+ *
+ * @param result
+ */
+void logic_equiv_result_free(logic_equiv_result_t *result);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
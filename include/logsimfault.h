@@ -0,0 +1,120 @@
+/**
+ * @file logsimfault.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Parallel pattern stuck-at fault simulation.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_FAULT_H
+#define LOG_SIM_FAULT_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+#include "logsimvm.h"
+
+/*************** Macros ***************/
+
+/* Pin of a fault on the gate output rather than one of its inputs */
+#define LOGIC_FAULT_OUTPUT -1
+
+/*************** Structures ***************/
+
+typedef struct logic_fault {
+  int gate;
+  int pin;
+  int stuck_at;
+
+  bool detected;
+  long pattern; /* First pattern detecting the fault */
+} logic_fault_t;
+
+typedef struct logic_fault_report {
+  long patterns;
+
+  int faults;
+  int detected;     /* Over every pattern set run so far */
+  int new_detected; /* By the last pattern set */
+
+  double coverage;
+} logic_fault_report_t;
+
+typedef struct logic_fault_sim {
+  logic_circuit_t *circuit;
+  logic_vm_program_t *program;
+
+  int faults;
+  int detected;
+  logic_fault_t *fault_list;
+
+  int threads;
+  long patterns;
+
+  /* Gates reading each net */
+  int *fanout_offsets;
+  int *fanout_list;
+
+  int *net_drivers;
+  bool *output_nets;
+
+  /* Gates of every level are queued in their own segment */
+  int *level_offsets;
+} logic_fault_sim_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Enumerate the stuck-at faults of every gate input and output.
+ *
+ * Circuits with feedback loops are rejected.
+ *
+ * @param circuit
+ * @param threads
+ * @return logic_fault_sim_t*
+ */
+logic_fault_sim_t *logic_fault_sim_create(logic_circuit_t *circuit,
+                                          int threads);
+
+/**
+ * @brief Grade a pattern set, undetected faults only.
+ *
+ * Patterns are packed 64 per word, one word per primary input for every
+ * block of 64 patterns.
+ *
+ * @param fault_sim
+ * @param patterns
+ * @param total_patterns
+ * @param report
+ * @return int
+ */
+int logic_fault_sim_run(logic_fault_sim_t *fault_sim,
+                        const logic_word_t *patterns, long total_patterns,
+                        logic_fault_report_t *report);
+
+/**
+ * @brief Print the coverage of the last pattern set.
+ *
+ * @param report
+ * @param stream
+ */
+void logic_fault_print_report(const logic_fault_report_t *report,
+                              FILE *stream);
+
+/**
+ * @brief Free the fault simulator, the circuit is not owned.
+ *
+ * @param fault_sim
+ */
+void logic_fault_sim_free(logic_fault_sim_t *fault_sim);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
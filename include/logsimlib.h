@@ -21,44 +21,130 @@
 
 /*************** Function Prototypes ***************/
 
+/**
+ * @brief Create a simulation context, results are printed to stdout.
+ *
+ * Every block and sink belongs to one context, separate contexts can be
+ * evaluated on separate threads.
+ *
+ * @return logic_sim_t*
+ */
+logic_sim_t *logic_sim_create();
+
+/**
+ * @brief Free the context, the blocks created through it and its sinks.
+ *
+ * @param sim
+ */
+void logic_sim_free(logic_sim_t *sim);
+
+/**
+ * @brief Allocate zeroed memory owned by the context, freed with it.
+ *
+ * @param sim
+ * @param size
+ * @return void*
+ */
+void *logic_sim_alloc(logic_sim_t *sim, size_t size);
+
+/**
+ * @brief Intern the names of a new block and give it an id and a path.
+ *
+ * Blocks placed in memory of their own, see logsimbuild.h, are registered
+ * with the context through this call.
+ *
+ * @param sim
+ * @param logic_block
+ * @param name
+ * @param prefix
+ * @return int
+ */
+int logic_sim_name_block(logic_sim_t *sim, logic_block_t *logic_block,
+                         const char *name, const char *prefix);
+
+/**
+ * @brief Enter a scope, blocks created until it is left are named in it.
+ *
+ * Scopes nest, a block named "lb_3" created inside "adder" in "top" has the
+ * path "top/adder/lb_3".
+ *
+ * @param sim
+ * @param name
+ * @return int
+ */
+int logic_sim_enter(logic_sim_t *sim, const char *name);
+
+/**
+ * @brief Leave the innermost scope.
+ *
+ * @param sim
+ * @return int
+ */
+int logic_sim_leave(logic_sim_t *sim);
+
+/**
+ * @brief Find a block by its path, NULL if no block has it.
+ *
+ * Paths are interned, the lookup is one hash probe sequence. A block
+ * created with a name already taken in its scope gets a "#2", "#3", ...
+ * suffix.
+ *
+ * @param sim
+ * @param path
+ * @return logic_block_t*
+ */
+logic_block_t *logic_find_block(const logic_sim_t *sim, const char *path);
+
 /**
  * @brief Initialize graphviz.
  *
+ * @param sim
  * @param name
  */
-void logic_graph_init(char *name);
+void logic_graph_init(logic_sim_t *sim, char *name);
 
 /**
  * @brief Export graph as SVG.
  *
+ * @param sim
  * @param name
  */
-void logic_graph_export(char *name);
+void logic_graph_export(logic_sim_t *sim, char *name);
 
 /**
- * @brief Utility function.
+ * @brief Open the block log DIR_LOG/name and the debug log beside it,
+ * name with its extension replaced by ".debug.log".
  *
+ * @param sim
  * @param name
  */
-void logic_utility_init(char *name);
+void logic_utility_init(logic_sim_t *sim, char *name);
 
 /**
  * @brief Close all the resources.
+ *
+ * @param sim
  */
-void logic_utility_terminate();
+void logic_utility_terminate(logic_sim_t *sim);
 
 /**
  * @brief Create a top level logic block.
  *
+ * @param sim
  * @param logic_top_block_type
  * @return logic_top_block_t*
  */
 logic_top_block_t *
-logic_create_top_block(logic_top_block_type_t logic_top_block_type);
+logic_create_top_block(logic_sim_t *sim,
+                       logic_top_block_type_t logic_top_block_type);
 
 /**
  * @brief Create a logic block.
  *
+ * Name and prefix are copied into the context, the block is named in the
+ * innermost entered scope.
+ *
+ * @param sim
  * @param logic_block_type
  * @param inputs
  * @param outputs
@@ -66,23 +152,28 @@ logic_create_top_block(logic_top_block_type_t logic_top_block_type);
  * @param prefix
  * @return logic_block_t*
  */
-logic_block_t *logic_create_logic_block(logic_block_type_t logic_block_type,
-                                        int inputs, int outputs, char *name,
-                                        char *prefix);
+logic_block_t *logic_create_logic_block(logic_sim_t *sim,
+                                        logic_block_type_t logic_block_type,
+                                        int inputs, int outputs,
+                                        const char *name, const char *prefix);
 
 /**
  * @brief Create a logic data block.
  *
+ * @param sim
  * @param logic_data_type
  * @param data
  * @return logic_data_t*
  */
-logic_data_t *logic_create_data_block(logic_data_type_t logic_data_type,
+logic_data_t *logic_create_data_block(logic_sim_t *sim,
+                                      logic_data_type_t logic_data_type,
                                       int data);
 
 /**
  * @brief Connect a logical block with data block.
  *
+ * Fails once every input, or output, of the block is connected.
+ *
  * @param logic_block
  * @param logic_data
  * @return int
@@ -93,6 +184,8 @@ int logic_block_data_connect(logic_block_t *logic_block,
 /**
  * @brief Connect a logical block with logical block.
  *
+ * Fails once every input of the block is connected.
+ *
  * @param logic_block
  * @param logic_block_in
  * @return int
@@ -100,6 +193,16 @@ int logic_block_data_connect(logic_block_t *logic_block,
 int logic_block_block_connect(logic_block_t *logic_block,
                               logic_block_t *logic_block_in);
 
+/**
+ * @brief Record an input stream just connected.
+ *
+ * Bumps the revision of the block and moves to its next free input stream,
+ * for the connect functions of every module.
+ *
+ * @param logic_block
+ */
+void logic_block_input_connected(logic_block_t *logic_block);
+
 /**
  * @brief Process logic data.
  *
@@ -122,29 +225,32 @@ int logic_get_initalization_value(logic_block_type_t type);
 /**
  * @brief Evaluate all the connected blocks.
  *
+ * @param sim
  * @param logic_block
  * @param previous_node
  * @return int
  */
-int logic_evaluate_single_block(logic_block_t *logic_block,
+int logic_evaluate_single_block(logic_sim_t *sim, logic_block_t *logic_block,
                                 Agnode_t *previous_node);
 
 /**
  * @brief Evaluate all the output blocks.
  *
+ * @param sim
  * @param total_logic_blocks
  * @param ...
  * @return int
  */
-int logic_evaluate(int total_logic_blocks, ...);
+int logic_evaluate(logic_sim_t *sim, int total_logic_blocks, ...);
 
 /**
  * @brief Print the data field to console.
  *
+ * @param sim
  * @param logic_data
  * @return int
  */
-int logic_console(logic_block_t *logic_data);
+int logic_console(logic_sim_t *sim, logic_block_t *logic_data);
 
 #endif
 
@@ -0,0 +1,159 @@
+/**
+ * @file logsimlut.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Lookup table blocks and the pass mapping gates onto them.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_LUT_H
+#define LOG_SIM_LUT_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_LUT_INPUTS 6
+
+/* Upper bound on the micro-program of a table of LOGIC_LUT_INPUTS inputs */
+#define LOGIC_LUT_OPS 40
+
+#define LOGIC_LUT_INVERT_HIGH 1
+#define LOGIC_LUT_INVERT_LOW 2
+
+/*************** Structures ***************/
+
+/*
+ * dst = select ? high : low, with high and low read inverted as flagged.
+ * Register 0 holds 0, registers 1 to inputs the inputs, the others are
+ * temporaries. AND, OR, XOR, NOT and constants are all such selects, so a
+ * micro-program runs without branching on the operation.
+ */
+typedef struct logic_lut_op {
+  uint8_t dst;
+  uint8_t select;
+  uint8_t high;
+  uint8_t low;
+  uint8_t invert;
+} logic_lut_op_t;
+
+typedef struct logic_lut_options {
+  int inputs; /* Largest table, 2 to LOGIC_LUT_INPUTS */
+  int cuts;   /* Cuts kept per net while enumerating */
+} logic_lut_options_t;
+
+typedef struct logic_lut_report {
+  int gates_before;
+  int gates_after;
+  int luts; /* Gates of the result that are lookup tables */
+
+  int levels_before;
+  int levels_after;
+
+  int fanins_before; /* Net reads per evaluation */
+  int fanins_after;
+} logic_lut_report_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Create a lookup table of up to LOGIC_LUT_INPUTS inputs.
+ *
+ * Bit i of the truth table is the output when input j is bit j of i.
+ *
+ * @param sim
+ * @param inputs
+ * @param truth_table
+ * @param name
+ * @param prefix
+ * @return logic_block_t*
+ */
+logic_block_t *logic_create_lut(logic_sim_t *sim, int inputs,
+                                uint64_t truth_table, const char *name,
+                                const char *prefix);
+
+/**
+ * @brief Evaluate a truth table on every lane of its input nets.
+ *
+ * @param truth_table
+ * @param inputs
+ * @param fanins
+ * @param values
+ * @return logic_word_t
+ */
+logic_word_t logic_lut_evaluate(uint64_t truth_table, int inputs,
+                                const int *fanins, const logic_word_t *values);
+
+/**
+ * @brief Decompose a truth table into a micro-program.
+ *
+ * Shannon expansion, picking the input whose cofactors leave an AND, OR or
+ * XOR over the rest before falling back to a MUX, shared cofactors are
+ * emitted once. The register holding the output is stored in result, the
+ * number of operations, at most LOGIC_LUT_OPS, is returned.
+ *
+ * @param truth_table
+ * @param inputs
+ * @param op_list
+ * @param result
+ * @return int
+ */
+int logic_lut_compile(uint64_t truth_table, int inputs, logic_lut_op_t *op_list,
+                      int *result);
+
+/**
+ * @brief Run a micro-program on every lane of its input nets.
+ *
+ * @param op_list
+ * @param ops
+ * @param result
+ * @param inputs
+ * @param fanins
+ * @param values
+ * @return logic_word_t
+ */
+logic_word_t logic_lut_run(const logic_lut_op_t *op_list, int ops, int result,
+                           int inputs, const int *fanins,
+                           const logic_word_t *values);
+
+/**
+ * @brief Cover the gates of a circuit with lookup tables, in place.
+ *
+ * Cuts of up to options->inputs nets are enumerated bottom up, each gate
+ * keeps the ones of lowest area flow, fewer leaves then lower depth breaking
+ * ties, and the cover is taken from the circuit outputs. Area is counted in
+ * bytecode instructions, micro-program operations included, and a gate is
+ * kept when its table costs at least as many as the gates it replaces.
+ * Gates inside a table are swept and their blocks no longer written back.
+ * Circuits with feedback loops or word level cells are rejected, the tables
+ * count as cells afterwards.
+ *
+ * @param circuit
+ * @param options
+ * @param report
+ * @return int
+ */
+int logic_circuit_map_luts(logic_circuit_t *circuit,
+                           const logic_lut_options_t *options,
+                           logic_lut_report_t *report);
+
+/**
+ * @brief Print the gates, levels and net reads before and after mapping.
+ *
+ * @param report
+ * @param stream
+ */
+void logic_lut_print_report(const logic_lut_report_t *report, FILE *stream);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
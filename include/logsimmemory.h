@@ -0,0 +1,196 @@
+/**
+ * @file logsimmemory.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief RAM and ROM primitives with packed and paged storage.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_MEMORY_H
+#define LOG_SIM_MEMORY_H
+
+/*************** C Standard Headers ***************/
+
+#include <stddef.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+/* Memories larger than this are stored in pages allocated on first write */
+#define LOGIC_MEMORY_DENSE_BYTES (1 << 20)
+#define LOGIC_MEMORY_PAGE_BYTES 4096
+
+/*************** Enums ***************/
+
+typedef enum logic_memory_kind {
+  LOGIC_MEMORY_RAM,
+  LOGIC_MEMORY_ROM,
+} logic_memory_kind_t;
+
+typedef enum logic_memory_format {
+  /* Whitespace separated hex words, @address moves on, // and # comment */
+  LOGIC_MEMORY_HEX,
+  /* Words back to back, (width + 7) / 8 bytes each, least significant first */
+  LOGIC_MEMORY_BINARY,
+} logic_memory_format_t;
+
+/*************** Structures ***************/
+
+typedef struct logic_memory_page {
+  uint64_t index; /* UINT64_MAX for an empty slot */
+  uint64_t *bits;
+} logic_memory_page_t;
+
+/* Inputs of a write port as last evaluated, applied by a commit */
+typedef struct logic_memory_port {
+  bool pending;
+  logic_word_t *words; /* Enable, address bits, then data bits */
+} logic_memory_port_t;
+
+typedef struct logic_memory {
+  logic_memory_kind_t kind;
+
+  int width;
+  int address_bits;
+  uint64_t depth;
+
+  /* Words packed back to back, word i from bit i * width on */
+  uint64_t *bits; /* NULL when paged */
+
+  /* Open addressing on the page index, pages read as 0 until written */
+  int pages;
+  int page_capacity;
+  logic_memory_page_t *page_list;
+  logic_memory_page_t *last_page;
+
+  int ports;
+  int port_capacity;
+  logic_memory_port_t *port_list;
+} logic_memory_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Create a memory of depth words of width bits, all 0.
+ *
+ * @param kind
+ * @param width
+ * @param depth
+ * @return logic_memory_t*
+ */
+logic_memory_t *logic_memory_create(logic_memory_kind_t kind, int width,
+                                    uint64_t depth);
+
+/**
+ * @brief Fill a memory from a file, from address 0 on.
+ *
+ * The file is mapped rather than read, words equal to 0 are skipped so a
+ * paged memory only allocates the pages the image uses.
+ *
+ * @param memory
+ * @param path
+ * @param format
+ * @return int
+ */
+int logic_memory_load(logic_memory_t *memory, const char *path,
+                      logic_memory_format_t format);
+
+/**
+ * @brief Read a word, (width + 63) / 64 words of 64 bits.
+ *
+ * @param memory
+ * @param address
+ * @param word
+ * @return int
+ */
+int logic_memory_read(logic_memory_t *memory, uint64_t address,
+                      uint64_t *word);
+
+/**
+ * @brief Write a word, (width + 63) / 64 words of 64 bits.
+ *
+ * @param memory
+ * @param address
+ * @param word
+ * @return int
+ */
+int logic_memory_write(logic_memory_t *memory, uint64_t address,
+                       const uint64_t *word);
+
+/**
+ * @brief Create a read port, address bits in and width bits out.
+ *
+ * Reads are combinational and see the memory as it was before the writes
+ * of the current run.
+ *
+ * @param sim
+ * @param memory
+ * @param name
+ * @param prefix
+ * @return logic_block_t*
+ */
+logic_block_t *logic_create_memory_read(logic_sim_t *sim,
+                                        logic_memory_t *memory,
+                                        const char *name, const char *prefix);
+
+/**
+ * @brief Create a write port of a RAM, enable, address and data bits in.
+ *
+ * Writes are applied when the run ends, lane by lane and port by port in
+ * creation order, for the lanes where enable is 1. A write port has no
+ * outputs, so no output cone reaches it: pass it as a root to
+ * logic_circuit_compile() or logic_evaluate(), or its writes are dropped.
+ * Compiling a memory without all of its write ports logs a warning.
+ *
+ * @param sim
+ * @param memory
+ * @param name
+ * @param prefix
+ * @return logic_block_t*
+ */
+logic_block_t *logic_create_memory_write(logic_sim_t *sim,
+                                         logic_memory_t *memory,
+                                         const char *name, const char *prefix);
+
+/**
+ * @brief Evaluate a memory port on every lane.
+ *
+ * @param gate
+ * @param fanins
+ * @param values
+ */
+void logic_memory_evaluate(const logic_gate_t *gate, const int *fanins,
+                           logic_word_t *values);
+
+/**
+ * @brief Apply the writes of the last run, called by logic_vm_run().
+ *
+ * @param memory
+ * @return int
+ */
+int logic_memory_commit(logic_memory_t *memory);
+
+/**
+ * @brief Bytes of storage allocated.
+ *
+ * @param memory
+ * @return size_t
+ */
+size_t logic_memory_footprint(const logic_memory_t *memory);
+
+/**
+ * @brief Free a memory, after the blocks of its ports.
+ *
+ * @param memory
+ */
+void logic_memory_free(logic_memory_t *memory);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,134 @@
+/**
+ * @file logsimnuma.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Huge page backed circuit arrays, NUMA topology and worker pinning.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_NUMA_H
+#define LOG_SIM_NUMA_H
+
+/*************** C Standard Headers ***************/
+
+#include <stddef.h>
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+
+/*************** Enums ***************/
+
+/* Flags, combined with | */
+typedef enum logic_placement {
+  /* Transparent huge pages, requested with madvise */
+  LOGIC_PLACE_HUGE_PAGES = 1,
+  /* Pages of the hugetlbfs pool, transparent ones when it is empty */
+  LOGIC_PLACE_EXPLICIT_HUGE_PAGES = 2,
+  /* Batch, partition and fault workers pinned to a processor each */
+  LOGIC_PLACE_PIN_WORKERS = 4,
+} logic_placement_t;
+
+/*************** Structures ***************/
+
+/* Processors this process may run on, grouped by NUMA node */
+typedef struct logic_topology {
+  int nodes;
+  int *node_ids;     /* Number of each node under /sys/devices/system/node */
+  int *node_offsets; /* Into the processor list, nodes + 1 entries */
+
+  int cpus;
+  int *cpu_list;
+} logic_topology_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Allocate zeroed, cache line aligned memory.
+ *
+ * With one of the huge page flags, blocks of half a huge page or more are
+ * mapped on huge pages. Pages are placed on the node of the thread touching
+ * them first, so a worker allocates the arrays it writes after pinning.
+ *
+ * @param size
+ * @param placement
+ * @return void*
+ */
+void *logic_numa_alloc(size_t size, int placement);
+
+/**
+ * @brief Free memory of logic_numa_alloc().
+ *
+ * @param memory
+ */
+void logic_numa_free(void *memory);
+
+/**
+ * @brief Move the gate, fanin and value arrays of a circuit to memory of
+ * the placement, later passes keep it.
+ *
+ * @param circuit
+ * @param placement
+ * @return int
+ */
+int logic_circuit_place(logic_circuit_t *circuit, int placement);
+
+/**
+ * @brief Read the nodes and their processors from /sys/devices/system/node.
+ *
+ * Only processors of the affinity mask are listed. Without the sysfs tree
+ * every processor is put on a single node.
+ *
+ * @return logic_topology_t*
+ */
+logic_topology_t *logic_topology_create(void);
+
+/**
+ * @brief Processor of a worker.
+ *
+ * Spread deals the workers out over the nodes in turn, for independent
+ * workers bound by memory bandwidth. Otherwise a node is filled before the
+ * next, keeping workers that talk to their neighbours on one node.
+ *
+ * @param topology
+ * @param worker
+ * @param spread
+ * @return int
+ */
+int logic_topology_cpu(const logic_topology_t *topology, int worker,
+                       bool spread);
+
+/**
+ * @brief Pin the calling thread to a processor.
+ *
+ * @param cpu
+ * @return int
+ */
+int logic_topology_pin(int cpu);
+
+/**
+ * @brief Print the nodes and their processors.
+ *
+ * @param topology
+ * @param stream
+ */
+void logic_topology_print(const logic_topology_t *topology, FILE *stream);
+
+/**
+ * @brief Free the topology.
+ *
+ * @param topology
+ */
+void logic_topology_free(logic_topology_t *topology);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,71 @@
+/**
+ * @file logsimopt.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Netlist optimization passes run on compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_OPT_H
+#define LOG_SIM_OPT_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Structures ***************/
+
+typedef struct logic_opt_options {
+  bool propagate_constants;
+  bool structural_hashing;
+  bool sweep_dead_gates;
+
+  /* Fold the INPUT data block values in, the inputs can no longer be set */
+  bool constant_inputs;
+} logic_opt_options_t;
+
+typedef struct logic_opt_report {
+  int gates_before;
+  int gates_after;
+
+  int folded; /* Gates reduced to a constant or to one of their fanins */
+  int merged; /* Gates structurally identical to an earlier gate */
+  int dead;   /* Gates outside the cone of the circuit outputs */
+} logic_opt_report_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Run the optimization passes in place, all of them when options is
+ * NULL.
+ *
+ * Blocks whose gate is swept are no longer written back. Circuits with
+ * feedback loops are rejected.
+ *
+ * @param circuit
+ * @param options
+ * @param report
+ * @return int
+ */
+int logic_circuit_optimize(logic_circuit_t *circuit,
+                           const logic_opt_options_t *options,
+                           logic_opt_report_t *report);
+
+/**
+ * @brief Print the gates removed by each pass.
+ *
+ * @param report
+ * @param stream
+ */
+void logic_opt_print_report(const logic_opt_report_t *report, FILE *stream);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
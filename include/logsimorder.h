@@ -0,0 +1,90 @@
+/**
+ * @file logsimorder.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Gate and net reordering of compiled circuits for memory locality.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_ORDER_H
+#define LOG_SIM_ORDER_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Enums ***************/
+
+/* Every order keeps gates after their fanins */
+typedef enum logic_order_method {
+  /* Depth first from the outputs, fanins placed just before their reader */
+  LOGIC_ORDER_DFS,
+  /* Level by level, depth first order within a level */
+  LOGIC_ORDER_LEVEL,
+  /* Breadth first from the inputs, readers of fewest fanouts first */
+  LOGIC_ORDER_CUTHILL_MCKEE,
+  /* Readers placed right after the driver that makes them ready */
+  LOGIC_ORDER_FANOUT,
+} logic_order_method_t;
+
+/*************** Structures ***************/
+
+/* Distances between a gate output net and the gate driven nets it reads */
+typedef struct logic_order_report {
+  double distance_before; /* Mean */
+  double distance_after;
+
+  int bandwidth_before; /* Largest */
+  int bandwidth_after;
+} logic_order_report_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Mean and largest distance between the output net of a gate and the
+ * gate driven nets it reads.
+ *
+ * Reads of primary inputs and constants are not counted, their nets never
+ * move.
+ *
+ * @param circuit
+ * @param bandwidth
+ * @return double
+ */
+double logic_circuit_locality(const logic_circuit_t *circuit, int *bandwidth);
+
+/**
+ * @brief Renumber the gates and the nets they drive, in place.
+ *
+ * The gate list, fanins, values, output and block nets all follow the new
+ * numbering, and gate nets are laid out in gate order so a gate reads nets
+ * close to the one it writes. Circuits with feedback loops are rejected.
+ *
+ * @param circuit
+ * @param method
+ * @param report
+ * @return int
+ */
+int logic_circuit_reorder(logic_circuit_t *circuit,
+                          logic_order_method_t method,
+                          logic_order_report_t *report);
+
+/**
+ * @brief Print the locality before and after reordering.
+ *
+ * @param report
+ * @param stream
+ */
+void logic_order_print_report(const logic_order_report_t *report,
+                              FILE *stream);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
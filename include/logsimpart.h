@@ -0,0 +1,92 @@
+/**
+ * @file logsimpart.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Min-cut partitioning and multi-process simulation of circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_PART_H
+#define LOG_SIM_PART_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Structures ***************/
+
+typedef struct logic_partition {
+  int parts;
+  int *gate_parts; /* Part of each gate */
+
+  /* Fanins evaluated per part, the balanced quantity */
+  int *part_weights;
+
+  /* Nets read in a part other than the one driving them */
+  int boundary_nets;
+  int messages; /* Words sent between parts per step */
+} logic_partition_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Split the gates into balanced parts cutting as few nets as
+ * possible.
+ *
+ * Multilevel recursive bisection of the gate hypergraph, heavy edge
+ * coarsening and Fiduccia-Mattheyses refinement on every level. Imbalance
+ * is the fraction each part may exceed its share by, 0.05 if not positive.
+ * Circuits with feedback loops are rejected.
+ *
+ * @param circuit
+ * @param parts
+ * @param imbalance
+ * @return logic_partition_t*
+ */
+logic_partition_t *logic_partition_create(const logic_circuit_t *circuit,
+                                          int parts, double imbalance);
+
+/**
+ * @brief Simulate every part in its own process, boundary nets are passed
+ * through shared memory rings.
+ *
+ * Stimulus holds one word per primary input for every step, responses
+ * receive one word per circuit output for every step.
+ *
+ * @param circuit
+ * @param partition
+ * @param stimulus
+ * @param steps
+ * @param responses
+ * @return int
+ */
+int logic_partition_simulate(const logic_circuit_t *circuit,
+                             const logic_partition_t *partition,
+                             const logic_word_t *stimulus, long steps,
+                             logic_word_t *responses);
+
+/**
+ * @brief Print the part sizes and the cut.
+ *
+ * @param partition
+ * @param stream
+ */
+void logic_partition_print(const logic_partition_t *partition, FILE *stream);
+
+/**
+ * @brief Free the partition.
+ *
+ * @param partition
+ */
+void logic_partition_free(logic_partition_t *partition);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,145 @@
+/**
+ * @file logsimpower.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Toggle activity and switching power estimation.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_POWER_H
+#define LOG_SIM_POWER_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+#include "logsimvm.h"
+
+/*************** Enums ***************/
+
+typedef enum logic_activity_mode {
+  LOGIC_ACTIVITY_LANES, /* Lanes are consecutive vectors of one stream */
+  LOGIC_ACTIVITY_CYCLES /* Every lane is its own stream, one step per run */
+} logic_activity_mode_t;
+
+/*************** Structures ***************/
+
+/* Toggle counters of one thread, merge them once the threads are done */
+typedef struct logic_activity {
+  const logic_circuit_t *circuit;
+  logic_activity_mode_t mode;
+
+  bool primed;
+  long transitions; /* Observed per net */
+
+  logic_word_t *previous; /* Values of the last run */
+  uint64_t *toggles;      /* Per net */
+} logic_activity_t;
+
+typedef struct logic_power_options {
+  /* Load switched by a toggle of a net, by driving gate type */
+  double capacitance[LOGIC_BLOCK_TYPES];
+  double input_capacitance;
+
+  double voltage;
+  double frequency; /* Vectors per second */
+} logic_power_options_t;
+
+typedef struct logic_power_report {
+  long transitions;
+  uint64_t toggles;
+
+  double switched_capacitance; /* Per vector */
+  double power;
+} logic_power_report_t;
+
+/*************** Function Definitions ***************/
+
+/* Called by the bytecode on every final write of a net */
+static inline void logic_activity_count(logic_activity_t *activity, int net,
+                                        logic_word_t word) {
+  logic_word_t previous = activity->previous[net];
+  logic_word_t changed =
+      activity->mode == LOGIC_ACTIVITY_LANES
+          ? word ^ ((word << 1) | (previous >> (LOGIC_LANES - 1)))
+          : word ^ previous;
+
+  activity->toggles[net] += (uint64_t)__builtin_popcountll(changed);
+  activity->previous[net] = word;
+}
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Create zeroed toggle counters for a circuit.
+ *
+ * @param circuit
+ * @param mode
+ * @return logic_activity_t*
+ */
+logic_activity_t *logic_activity_create(const logic_circuit_t *circuit,
+                                        logic_activity_mode_t mode);
+
+/**
+ * @brief Run the program over the loaded inputs and count the toggles.
+ *
+ * The first run only primes the counters with the starting values.
+ *
+ * @param activity
+ * @param program
+ * @param values
+ * @return int
+ */
+int logic_activity_run(logic_activity_t *activity,
+                       const logic_vm_program_t *program, logic_word_t *values);
+
+/**
+ * @brief Add the counters of another thread.
+ *
+ * @param activity
+ * @param other
+ * @return int
+ */
+int logic_activity_merge(logic_activity_t *activity,
+                         const logic_activity_t *other);
+
+/**
+ * @brief Estimate the dynamic power, options NULL counts plain toggles.
+ *
+ * @param activity
+ * @param options
+ * @param report
+ * @return int
+ */
+int logic_power_estimate(const logic_activity_t *activity,
+                         const logic_power_options_t *options,
+                         logic_power_report_t *report);
+
+/**
+ * @brief Print the nets switching the most capacitance, by block name.
+ *
+ * @param activity
+ * @param options
+ * @param count
+ * @param stream
+ */
+void logic_power_print_hottest(const logic_activity_t *activity,
+                               const logic_power_options_t *options,
+                               int count, FILE *stream);
+
+/**
+ * @brief Free the toggle counters.
+ *
+ * @param activity
+ */
+void logic_activity_free(logic_activity_t *activity);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
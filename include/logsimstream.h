@@ -0,0 +1,99 @@
+/**
+ * @file logsimstream.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief File driven simulation with prefetched stimulus and background
+ * response writes.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_STREAM_H
+#define LOG_SIM_STREAM_H
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_STREAM_MAGIC "LSV1"
+
+/* Records held by each of the two buffers of a file */
+#define LOGIC_STREAM_BATCH 1024
+
+/*************** Structures ***************/
+
+typedef enum logic_stream_format {
+  /* Header, then one record of column words per 64 vectors */
+  LOGIC_STREAM_BINARY,
+  /* One vector per line, a 0 or 1 per column, # starts a comment */
+  LOGIC_STREAM_TEXT,
+} logic_stream_format_t;
+
+/* Words are stored in host byte order */
+typedef struct logic_stream_header {
+  char magic[4];
+  uint32_t columns;
+  uint64_t vectors; /* 0 when not known, every record is then full */
+} logic_stream_header_t;
+
+typedef struct logic_stream_options {
+  logic_stream_format_t stimulus_format;
+  logic_stream_format_t response_format;
+
+  long batch; /* Records per buffer, LOGIC_STREAM_BATCH if not positive */
+} logic_stream_options_t;
+
+typedef struct logic_stream_report {
+  long vectors;
+  long records;
+
+  /* Times the simulation found its next buffer not ready */
+  long read_stalls;
+  long write_stalls;
+
+  long oscillating; /* Records with a feedback loop that did not settle */
+} logic_stream_report_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Simulate every vector of the stimulus file into the response file.
+ *
+ * Stimulus columns are the primary inputs of the circuit, response columns
+ * its outputs, both in compile order. An I/O thread reads the stimulus into
+ * one buffer while the other is simulated, and a writer thread drains the
+ * responses the same way. Vectors are independent, 64 are simulated at a
+ * time. Options may be NULL for binary files.
+ *
+ * @param circuit
+ * @param stimulus_path
+ * @param response_path
+ * @param options
+ * @param report
+ * @return int
+ */
+int logic_stream_simulate(logic_circuit_t *circuit, const char *stimulus_path,
+                          const char *response_path,
+                          const logic_stream_options_t *options,
+                          logic_stream_report_t *report);
+
+/**
+ * @brief Print the vectors simulated and the I/O stalls.
+ *
+ * @param report
+ * @param stream
+ */
+void logic_stream_print_report(const logic_stream_report_t *report,
+                               FILE *stream);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
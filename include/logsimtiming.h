@@ -0,0 +1,175 @@
+/**
+ * @file logsimtiming.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Event driven timing simulation over a hierarchical timing wheel.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_TIMING_H
+#define LOG_SIM_TIMING_H
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+/* Four wheels of 256 slots cover 2^32 ticks ahead of the current time */
+#define LOGIC_TIMING_WHEELS 4
+#define LOGIC_TIMING_SLOTS 256
+
+/*************** Enums ***************/
+
+typedef enum logic_delay_mode {
+  LOGIC_DELAY_INERTIAL, /* Pulses shorter than the gate delay are swallowed */
+  LOGIC_DELAY_TRANSPORT /* Every pulse reaches the output */
+} logic_delay_mode_t;
+
+/*************** Structures ***************/
+
+/* Ticks until a gate output reaches 1 (rise) or 0 (fall), at least 1 */
+typedef struct logic_delay {
+  uint32_t rise;
+  uint32_t fall;
+} logic_delay_t;
+
+typedef struct logic_timing_options {
+  logic_delay_mode_t mode;
+  logic_delay_t type_delays[4]; /* Indexed by logic_block_type_t */
+
+  /* Called for every net change, may be NULL */
+  void (*on_change)(void *user, int net, int value, uint64_t time);
+  void *user;
+} logic_timing_options_t;
+
+typedef struct logic_timing_event {
+  uint64_t time;
+
+  int net;
+  int gate; /* -1 for primary inputs */
+  int next; /* Next event of the slot, or of the free list */
+
+  /* Events still pending on the same gate output, oldest first */
+  int previous_pending;
+  int next_pending;
+
+  uint8_t value;
+  bool cancelled;
+} logic_timing_event_t;
+
+typedef struct logic_timing {
+  logic_circuit_t *circuit;
+  logic_timing_options_t options;
+
+  uint64_t now;
+  uint8_t *values;
+  logic_delay_t *delays; /* Per gate */
+
+  /* Gates reading each net */
+  int *fanout_offsets;
+  int *fanout_list;
+
+  /* Latest pending event of each gate output */
+  int *pending;
+
+  /* Gates already queued for the current time */
+  int *queue;
+  uint32_t stamp;
+  uint32_t *gate_stamps;
+
+  int events;
+  int capacity;
+  int free_list;
+  logic_timing_event_t *event_list;
+
+  int slot_heads[LOGIC_TIMING_WHEELS][LOGIC_TIMING_SLOTS];
+  int slot_tails[LOGIC_TIMING_WHEELS][LOGIC_TIMING_SLOTS];
+  uint64_t slot_bits[LOGIC_TIMING_WHEELS][LOGIC_TIMING_SLOTS / 64];
+
+  /* Events beyond the last wheel */
+  int overflow_head;
+  int overflow_tail;
+
+  long applied;
+  long cancelled;
+  long evaluations;
+} logic_timing_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Create a timing simulator, the circuit settles on its data blocks
+ * at time 0.
+ *
+ * Options NULL selects inertial mode with unit delays.
+ *
+ * @param circuit
+ * @param options
+ * @return logic_timing_t*
+ */
+logic_timing_t *logic_timing_create(logic_circuit_t *circuit,
+                                    const logic_timing_options_t *options);
+
+/**
+ * @brief Override the delays of one gate.
+ *
+ * @param timing
+ * @param gate
+ * @param delay
+ * @return int
+ */
+int logic_timing_set_delay(logic_timing_t *timing, int gate,
+                           logic_delay_t delay);
+
+/**
+ * @brief Schedule a primary input change.
+ *
+ * @param timing
+ * @param input
+ * @param value
+ * @param time
+ * @return int
+ */
+int logic_timing_set_input(logic_timing_t *timing, int input, int value,
+                           uint64_t time);
+
+/**
+ * @brief Process every event up to and including a time.
+ *
+ * @param timing
+ * @param until
+ * @return int
+ */
+int logic_timing_run(logic_timing_t *timing, uint64_t until);
+
+/**
+ * @brief Current value of a net.
+ *
+ * @param timing
+ * @param net
+ * @return int
+ */
+int logic_timing_value(const logic_timing_t *timing, int net);
+
+/**
+ * @brief Copy the current values back into the output data blocks.
+ *
+ * @param timing
+ * @return int
+ */
+int logic_timing_write_back(logic_timing_t *timing);
+
+/**
+ * @brief Free the simulator, the circuit is not owned.
+ *
+ * @param timing
+ */
+void logic_timing_free(logic_timing_t *timing);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
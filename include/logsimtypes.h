@@ -13,6 +13,8 @@
 /*************** C Standard Headers ***************/
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 
 #include <graphviz/cgraph.h>
 #include <graphviz/gvc.h>
@@ -23,14 +25,50 @@
 #define DIR_LOG "logs"
 #define BUFFER 1024
 
-/*************** Variables ***************/
+/* Nets reserved in every compiled circuit for the constant words */
+#define LOGIC_NET_CONST0 0
+#define LOGIC_NET_CONST1 1
+#define LOGIC_NET_RESERVED 2
 
-extern GVC_t *g_graphviz_context;
-extern Agraph_t *g_graphviz_graph;
+/* Number of vectors simulated in parallel, one per bit of a word */
+#define LOGIC_LANES 64
+
+/* Data values, X and Z are only tracked by the four valued engine */
+#define LOGIC_VALUE_0 0
+#define LOGIC_VALUE_1 1
+#define LOGIC_VALUE_X 2
+#define LOGIC_VALUE_Z 3
 
 /*************** Enums ***************/
 
-typedef enum logic_block_type { AND, OR, NOT, XOR } logic_block_type_t;
+typedef enum logic_block_type {
+  AND,
+  OR,
+  NOT,
+  XOR,
+
+  /* Word level cells on buses, see logsimword.h */
+  ADD,
+  SUB,
+  MUX,
+  EQ,
+  LT,
+  SHL,
+  SHR,
+  CONCAT,
+  SLICE,
+
+  /* Ports of a RAM or ROM, see logsimmemory.h */
+  MEM_READ,
+  MEM_WRITE,
+
+  /* Lookup table of up to 6 inputs, see logsimlut.h */
+  LUT
+} logic_block_type_t;
+
+#define LOGIC_BLOCK_TYPES (LUT + 1)
+/* Cells, lookup tables included, are evaluated as a whole */
+#define LOGIC_IS_CELL(type) ((type) >= ADD)
 
 typedef enum logic_data_type { INPUT, OUTPUT } logic_data_type_t;
 
@@ -49,6 +87,8 @@ typedef enum logic_data_block_status {
 
 typedef struct logic_top_block logic_top_block_t;
 
+struct logic_memory;
+
 typedef struct logic_data {
   int data;
   int logic_data_type; /* INPUT | OUTPUT */
@@ -59,10 +99,21 @@ typedef struct logic_data {
 typedef struct logic_block {
   logic_block_type_t logic_block_type;
 
-  char *name;
-  char *prefix;
+  /* Interned by the context that created the block */
+  const char *name;
+  const char *prefix;
+  const char *path; /* Scopes and name, unique in the context */
+  int id;           /* Dense, in creation order */
+
   Agnode_t *graph_node;
 
+  /* Bits driven, 1 for gates, output stream i carries bit i of a cell */
+  int width;
+  int parameter; /* Cell dependent, see logsimword.h */
+
+  struct logic_memory *memory; /* Accessed by a memory port */
+  uint64_t truth_table;        /* Of a LUT, bit i is the output for inputs i */
+
   /* Use these to loop over input and output streams */
   int inputs;
   int outputs;
@@ -70,6 +121,8 @@ typedef struct logic_block {
   int current_input;
   int current_output;
 
+  uint32_t revision; /* Bumped by every change of the input streams */
+
   logic_top_block_t **input_streams;
   logic_top_block_t **output_streams;
 
@@ -81,8 +134,119 @@ typedef struct logic_top_block {
   logic_block_t *logic_block;
   logic_data_t *logic_data;
 
+  int bit; /* Of logic_block read, cells drive several */
+
 } logic_top_block_t;
 
+/* State of one simulation, contexts share nothing and may run on threads */
+typedef struct logic_sim {
+  /* NULL until logic_graph_init(), blocks are then drawn as evaluated */
+  GVC_t *graphviz_context;
+  Agraph_t *graphviz_graph;
+
+  /* Sinks, NULL drops the output */
+  FILE *console;
+  FILE *log_file;
+  FILE *debug_log_file;
+
+  /* Blocks created through the context, freed with it */
+  int allocations;
+  int allocation_capacity;
+  void **allocation_list;
+
+  /* Blocks by id */
+  int blocks;
+  int block_capacity;
+  logic_block_t **block_list;
+
+  /* Names, prefixes and paths, path ids map to the block they name */
+  struct util_interner *names;
+  int name_capacity;
+  int *name_blocks; /* -1 for paths of scopes */
+
+  /* Path ids of the entered scopes, innermost last */
+  int scopes;
+  int scope_capacity;
+  int *scope_list;
+} logic_sim_t;
+
+/*************** Compiled Circuit ***************/
+
+/* One bit per lane, lane 0 holds the value seen by the block API */
+typedef uint64_t logic_word_t;
+
+typedef struct logic_gate {
+  logic_block_type_t logic_block_type;
+
+  int output; /* Net driven by the gate */
+  int fanin;  /* Offset of the first input net in the circuit fanins */
+  int inputs;
+  int floating; /* Input streams left unconnected */
+
+  int level;
+  int block; /* Index in the circuit block list */
+
+  /* Word level cells drive width nets from output on */
+  int width;
+  int parameter;
+
+  struct logic_memory *memory;
+  uint64_t truth_table;
+} logic_gate_t;
+
+/* Gates of a feedback loop, contiguous in the gate list */
+typedef struct logic_loop {
+  int first;
+  int gates;
+} logic_loop_t;
+
+typedef struct logic_circuit {
+  /* Nets are numbered constants first, then primary inputs, then gates */
+  int nets;
+  int primary_inputs;
+  int gates;
+  int levels;
+  int outputs; /* Bits of the output blocks, one per bit of a cell */
+  int cells;   /* Gates that are word level cells or lookup tables */
+
+  logic_gate_t *gate_list; /* Levelized, gates after fanins outside loops */
+  int *fanins;
+  int *output_nets;
+
+  /* Blocks folded into the circuit and the net holding their result */
+  int blocks;
+  logic_block_t **block_list;
+  int *block_nets;
+
+  /* Index in the block list of each block id, -1 for other blocks */
+  int block_ids;
+  int *id_blocks;
+
+  logic_data_t **input_list; /* Data block behind each primary input */
+
+  /* Strongly connected components, settled by iteration */
+  int loops;
+  logic_loop_t *loop_list;
+
+  logic_word_t *values;
+
+  /* Gates, fanins and values come from logic_numa_alloc(), see logsimnuma.h */
+  int placement;
+
+  /* Cone schedules cached per output set, see logsimcone.h */
+  struct logic_cone *cone_list;
+  int *net_drivers;
+
+  /* Gates stamped with the current epoch hold values of the current inputs */
+  uint32_t epoch;
+  uint32_t *gate_epochs;
+
+  /* Block revisions last read, and gates edited since, see logsimeco.h */
+  uint32_t *block_revisions;
+  int stale_gates;
+  int *stale_list;
+} logic_circuit_t;
+
 #endif
 
 /************************************************/
@@ -0,0 +1,163 @@
+/**
+ * @file logsimvm.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Register based bytecode for compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_VM_H
+#define LOG_SIM_VM_H
+
+/*************** C Custom Headers ***************/
+
+#include "logsimlut.h"
+#include "logsimtypes.h"
+
+/*************** Macros ***************/
+
+/* Computed goto dispatch where the compiler supports label addresses */
+#if defined(__GNUC__)
+#define LOGIC_VM_THREADED 1
+#else
+#define LOGIC_VM_THREADED 0
+#endif
+
+/*************** Enums ***************/
+
+typedef enum logic_vm_opcode {
+  LOGIC_VM_HALT,
+  LOGIC_VM_LOOP, /* Settle loop_list[a] by iterating its body */
+  LOGIC_VM_CELL, /* Evaluate cell_list[a], writing its bus from dst on */
+  LOGIC_VM_LUT,  /* dst = lut_list[a] run on its fanins */
+
+  LOGIC_VM_CONST0, /* dst = 0 */
+  LOGIC_VM_CONST1, /* dst = ~0 */
+  LOGIC_VM_COPY,   /* dst = a */
+  LOGIC_VM_NOT,    /* dst = ~a */
+
+  LOGIC_VM_AND2, /* dst = a & b */
+  LOGIC_VM_OR2,  /* dst = a | b */
+  LOGIC_VM_XOR2, /* dst = a ^ b */
+
+  /* Second operand read through an inverter */
+  LOGIC_VM_ANDN,  /* dst = a & ~b */
+  LOGIC_VM_ORN,   /* dst = a | ~b */
+  LOGIC_VM_XNOR2, /* dst = a ^ ~b */
+
+  /* Superinstructions, two folds of a wide gate */
+  LOGIC_VM_AND3, /* dst = a & b & c */
+  LOGIC_VM_OR3,  /* dst = a | b | c */
+  LOGIC_VM_XOR3, /* dst = a ^ b ^ c */
+
+  /* Superinstructions, gate followed by the inverter it drives */
+  LOGIC_VM_AND2_NOT, /* dst = a & b, c = ~dst */
+  LOGIC_VM_OR2_NOT,  /* dst = a | b, c = ~dst */
+  LOGIC_VM_XOR2_NOT, /* dst = a ^ b, c = ~dst */
+
+  LOGIC_VM_OPCODES
+} logic_vm_opcode_t;
+
+/*************** Structures ***************/
+
+/* Operands are net indices into the circuit value array */
+typedef struct logic_vm_instruction {
+  uint32_t opcode;
+  uint32_t dst;
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+} logic_vm_instruction_t;
+
+/* Body of a feedback loop, placed after the main program and ended by HALT */
+typedef struct logic_vm_loop {
+  int body;
+  int iterations; /* Bound before the loop counts as oscillating */
+
+  int nets;
+  int *net_list;
+} logic_vm_loop_t;
+
+/* Lookup table, its micro-program is ops entries of lut_op_list from first */
+typedef struct logic_vm_lut {
+  int inputs;
+  int fanins[LOGIC_LUT_INPUTS];
+
+  int first;
+  int ops;
+  int result;
+} logic_vm_lut_t;
+
+typedef struct logic_vm_program {
+  int instructions;
+  int fused; /* Superinstructions emitted by the peephole pass */
+
+  logic_vm_instruction_t *instruction_list;
+
+  int loops;
+  logic_vm_loop_t *loop_list;
+
+  /* Word level cells, fanin offsets index cell_fanins */
+  int cells;
+  logic_gate_t *cell_list;
+  int *cell_fanins;
+
+  /* Lookup tables needing more than one instruction */
+  int luts;
+  logic_vm_lut_t *lut_list;
+  int lut_ops;
+  logic_lut_op_t *lut_op_list;
+
+  /* Per instruction, which of dst and c receive their final value */
+  uint8_t *last_writes;
+} logic_vm_program_t;
+
+struct logic_activity;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Lower a compiled circuit to bytecode.
+ *
+ * @param circuit
+ * @return logic_vm_program_t*
+ */
+logic_vm_program_t *logic_vm_compile(logic_circuit_t *circuit);
+
+/**
+ * @brief Run the program once over all the lanes of the value array.
+ *
+ * Feedback loops are iterated until no lane changes, within a bound, and
+ * the number of loops still oscillating is returned.
+ *
+ * @param program
+ * @param values
+ * @return int
+ */
+int logic_vm_run(const logic_vm_program_t *program, logic_word_t *values);
+
+/**
+ * @brief Run the program once and count the toggles of every net it writes.
+ *
+ * @param program
+ * @param values
+ * @param activity
+ * @return int
+ */
+int logic_vm_run_activity(const logic_vm_program_t *program,
+                          logic_word_t *values,
+                          struct logic_activity *activity);
+
+/**
+ * @brief Free a bytecode program.
+ *
+ * @param program
+ */
+void logic_vm_free(logic_vm_program_t *program);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
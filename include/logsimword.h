@@ -0,0 +1,98 @@
+/**
+ * @file logsimword.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Word level cells on multi-bit buses.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_WORD_H
+#define LOG_SIM_WORD_H
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Create a word level cell.
+ *
+ * Buses are connected least significant bit first, operands one after the
+ * other, and output stream i carries bit i. Inputs left unconnected read 0.
+ *
+ * - ADD, SUB: A then B, width bits each, the sum or difference mod 2^width.
+ * - MUX: select, then A and B of width bits, B when select is 1.
+ * - EQ, LT: A then B of width bits, one output bit, LT is unsigned.
+ * - SHL, SHR: a value of width bits, then operand bits of shift amount.
+ * - CONCAT: width bits passed through, buses connected in turn are joined.
+ * - SLICE: width bits starting at bit operand of the bus connected.
+ *
+ * @param sim
+ * @param logic_block_type
+ * @param width
+ * @param operand
+ * @param name
+ * @param prefix
+ * @return logic_block_t*
+ */
+logic_block_t *logic_create_word_cell(logic_sim_t *sim,
+                                      logic_block_type_t logic_block_type,
+                                      int width, int operand, const char *name,
+                                      const char *prefix);
+
+/**
+ * @brief Connect bits of a block to the next inputs of a block.
+ *
+ * @param logic_block
+ * @param logic_block_in
+ * @param first_bit
+ * @param bits
+ * @return int
+ */
+int logic_block_bus_connect(logic_block_t *logic_block,
+                            logic_block_t *logic_block_in, int first_bit,
+                            int bits);
+
+/**
+ * @brief Connect INPUT data blocks as a bus, least significant bit first.
+ *
+ * @param logic_block
+ * @param bits
+ * @param logic_data_list
+ * @return int
+ */
+int logic_block_data_bus_connect(logic_block_t *logic_block, int bits,
+                                 logic_data_t **logic_data_list);
+
+/**
+ * @brief Evaluate a cell on every lane at once.
+ *
+ * Lanes stay one bit per vector, so arithmetic runs bit-sliced across the
+ * bus: one pass over the bits computes 64 sums or comparisons.
+ *
+ * @param gate
+ * @param fanins
+ * @param values
+ */
+void logic_word_evaluate(const logic_gate_t *gate, const int *fanins,
+                         logic_word_t *values);
+
+/**
+ * @brief Get the value of a bus on one lane, up to 64 bits.
+ *
+ * @param values
+ * @param first_net
+ * @param bits
+ * @param lane
+ * @return uint64_t
+ */
+uint64_t logic_word_read(const logic_word_t *values, int first_net, int bits,
+                         int lane);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,105 @@
+/**
+ * @file logsimxsim.h
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Four valued (0/1/X/Z) simulation over two bit-planes per net.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef LOG_SIM_XSIM_H
+#define LOG_SIM_XSIM_H
+
+/*************** C Custom Headers ***************/
+
+#include "logsimtypes.h"
+
+/*************** Structures ***************/
+
+/*
+ * A lane reads 0 when only its zero bit is set, 1 when only its one bit is
+ * set, X when both are set and Z when neither is.
+ */
+typedef struct logic_xword {
+  logic_word_t zero;
+  logic_word_t one;
+} logic_xword_t;
+
+typedef struct logic_xsim {
+  logic_circuit_t *circuit;
+  logic_xword_t *values;
+} logic_xsim_t;
+
+/*************** Function Prototypes ***************/
+
+/**
+ * @brief Create a four valued simulator, every gate net starts at X.
+ *
+ * Feedback loops start from their last evaluated data blocks, if any, and
+ * lanes still oscillating after the iteration bound read X.
+ *
+ * The circuit should not be optimized, the passes assume two valued logic.
+ *
+ * @param circuit
+ * @return logic_xsim_t*
+ */
+logic_xsim_t *logic_xsim_create(logic_circuit_t *circuit);
+
+/**
+ * @brief Broadcast the data block values, X and Z included, to the inputs.
+ *
+ * @param xsim
+ * @return int
+ */
+int logic_xsim_load_inputs(logic_xsim_t *xsim);
+
+/**
+ * @brief Set the lanes of a primary input.
+ *
+ * @param xsim
+ * @param input
+ * @param xword
+ * @return int
+ */
+int logic_xsim_set_input(logic_xsim_t *xsim, int input, logic_xword_t xword);
+
+/**
+ * @brief Evaluate every gate once over 64 lanes, loops until they settle.
+ *
+ * @param xsim
+ * @return int
+ */
+int logic_xsim_run(logic_xsim_t *xsim);
+
+/**
+ * @brief Value of one lane of a net.
+ *
+ * @param xsim
+ * @param net
+ * @param lane
+ * @return int
+ */
+int logic_xsim_value(const logic_xsim_t *xsim, int net, int lane);
+
+/**
+ * @brief Copy one lane back into the output data blocks, data blocks driven
+ * with different values read X.
+ *
+ * @param xsim
+ * @param lane
+ * @return int
+ */
+int logic_xsim_write_back(logic_xsim_t *xsim, int lane);
+
+/**
+ * @brief Free the simulator, the circuit is not owned.
+ *
+ * @param xsim
+ */
+void logic_xsim_free(logic_xsim_t *xsim);
+
+#endif
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
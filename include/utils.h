@@ -10,6 +10,10 @@
 #ifndef LOG_SIM_UTILS_H
 #define LOG_SIM_UTILS_H
 
+/*************** C Standard Headers ***************/
+
+#include <stddef.h>
+
 /*************** C Custom Headers ***************/
 
 #include "logsimtypes.h"
@@ -20,17 +24,24 @@
 #define LOG_SIM_PRINT 1
 #define LOG_SIM_FILE 1
 
+/* Evaluate with 0/1/X/Z values instead of the two valued bytecode */
+#define LOG_SIM_XPROP 0
+
 /**************************************/
 
 #if LOG_SIM_DEBUG
 
-/* Either print to stderr or debug file */
+/* Either print to stderr or debug file, a NULL stream drops the line */
 #define LOG_SIM_DEBUG_PRINT(stream, fmt, ...)                                  \
-  fprintf(stream, "LOG: " fmt "\n", ##__VA_ARGS__)
+  do {                                                                         \
+    if ((stream) != NULL) {                                                    \
+      fprintf(stream, "LOG: " fmt "\n", ##__VA_ARGS__);                        \
+    }                                                                          \
+  } while (0)
 
 #else
 
-#define LOG_SIM_DEBUG_PRINT(fmt, ...)
+#define LOG_SIM_DEBUG_PRINT(stream, fmt, ...)
 
 #endif
 
@@ -38,11 +49,16 @@
 
 #if LOG_SIM_PRINT
 
-#define LOG_SIM_LOG_PRINT(fmt, ...) fprintf(stdout, fmt "\n", ##__VA_ARGS__)
+#define LOG_SIM_LOG_PRINT(stream, fmt, ...)                                    \
+  do {                                                                         \
+    if ((stream) != NULL) {                                                    \
+      fprintf(stream, fmt "\n", ##__VA_ARGS__);                                \
+    }                                                                          \
+  } while (0)
 
 #else
 
-#define LOG_SIM_LOG_PRINT(fmt, ...)
+#define LOG_SIM_LOG_PRINT(stream, fmt, ...)
 
 #endif
 
@@ -50,37 +66,184 @@
 
 #if LOG_SIM_FILE
 
-#define LOG_SIM_FILE_PRINT(log, fmt, ...) fprintf(log, fmt "\n", ##__VA_ARGS__)
+#define LOG_SIM_FILE_PRINT(log, fmt, ...)                                      \
+  do {                                                                         \
+    if ((log) != NULL) {                                                       \
+      fprintf(log, fmt "\n", ##__VA_ARGS__);                                   \
+    }                                                                          \
+  } while (0)
 
 #else
 
-#define LOG_SIM_FILE_PRINT(fmt, ...)
+#define LOG_SIM_FILE_PRINT(log, fmt, ...)
 
 #endif
 
+/*************** Structures ***************/
+
+/* Open addressing map from a pointer key to an integer value */
+typedef struct util_map {
+  size_t capacity;
+  size_t size;
+
+  const void **keys;
+  int *values;
+} util_map_t;
+
+/* Chunks of bytes handed out in order and freed together */
+typedef struct util_arena_chunk {
+  struct util_arena_chunk *next;
+  size_t used;
+  size_t size;
+  char data[];
+} util_arena_chunk_t;
+
+typedef struct util_arena {
+  util_arena_chunk_t *chunks;
+} util_arena_t;
+
+/* Open addressing table from a string to a dense id, strings live in arena */
+typedef struct util_interner {
+  util_arena_t arena;
+
+  size_t capacity;
+  int *slots; /* Id + 1, 0 for an empty slot */
+
+  int strings;
+  int string_capacity;
+  const char **string_list; /* Indexed by id */
+  uint64_t *hash_list;
+} util_interner_t;
+
 /*************** Function Prototypes ***************/
 
+/**
+ * @brief Get the name of a block type.
+ *
+ * @param type
+ * @return const char*
+ */
+const char *util_block_type_name(logic_block_type_t type);
+
 /**
  * @brief Create graph node.
  *
+ * @param graph
  * @param label
  * @param type
  * @return Agnode_t*
  */
-Agnode_t *util_create_edge(char *label, logic_block_type_t type);
+Agnode_t *util_create_edge(Agraph_t *graph, const char *label,
+                           logic_block_type_t type);
 
 /**
  * @brief Attach invisible node.
  *
+ * @param graph
  * @param label
  * @param block_index
  * @param node
  * @param reverse
  * @return int
  */
-int util_attach_invisible_edge(char *label, int block_index, Agnode_t *node,
+int util_attach_invisible_edge(Agraph_t *graph, const char *label,
+                               int block_index, Agnode_t *node,
                                bool reverse);
 
+/**
+ * @brief Initialize pointer map.
+ *
+ * @param map
+ * @param capacity
+ * @return int
+ */
+int util_map_init(util_map_t *map, size_t capacity);
+
+/**
+ * @brief Get the value stored for key, -1 if missing.
+ *
+ * @param map
+ * @param key
+ * @return int
+ */
+int util_map_get(util_map_t *map, const void *key);
+
+/**
+ * @brief Insert or update the value for key.
+ *
+ * @param map
+ * @param key
+ * @param value
+ * @return int
+ */
+int util_map_put(util_map_t *map, const void *key, int value);
+
+/**
+ * @brief Free pointer map.
+ *
+ * @param map
+ */
+void util_map_free(util_map_t *map);
+
+/**
+ * @brief Allocate bytes from the arena, valid until it is freed.
+ *
+ * @param arena
+ * @param size
+ * @return void*
+ */
+void *util_arena_alloc(util_arena_t *arena, size_t size);
+
+/**
+ * @brief Free every chunk of the arena.
+ *
+ * @param arena
+ */
+void util_arena_free(util_arena_t *arena);
+
+/**
+ * @brief Initialize string interner.
+ *
+ * @param interner
+ * @param capacity
+ * @return int
+ */
+int util_interner_init(util_interner_t *interner, size_t capacity);
+
+/**
+ * @brief Get the id of string, copying it in if missing, -1 on failure.
+ *
+ * @param interner
+ * @param string
+ * @return int
+ */
+int util_intern(util_interner_t *interner, const char *string);
+
+/**
+ * @brief Get the id of string, -1 if missing.
+ *
+ * @param interner
+ * @param string
+ * @return int
+ */
+int util_interner_find(const util_interner_t *interner, const char *string);
+
+/**
+ * @brief Get the interned copy of the string with id.
+ *
+ * @param interner
+ * @param id
+ * @return const char*
+ */
+const char *util_interner_string(const util_interner_t *interner, int id);
+
+/**
+ * @brief Free string interner.
+ *
+ * @param interner
+ */
+void util_interner_free(util_interner_t *interner);
+
 #endif
 
 /************************************************/
@@ -0,0 +1,348 @@
+/**
+ * @file logsimaig.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief And-Inverter Graph form of compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimaig.h"
+#include "../include/logsimcircuit.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_AIG_EMPTY UINT32_MAX
+
+/*************** Function Definitions ***************/
+
+static uint32_t logic_aig_hash(logic_aig_literal_t a, logic_aig_literal_t b) {
+  uint64_t key = ((uint64_t)a << 32) | b;
+
+  return (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+static int logic_aig_rehash(logic_aig_t *aig, int table_size) {
+  uint32_t *table = malloc(table_size * sizeof(uint32_t));
+
+  if (table == NULL) {
+    return -1;
+  }
+
+  for (int i = 0; i < table_size; i++) {
+    table[i] = LOGIC_AIG_EMPTY;
+  }
+
+  for (int n = aig->inputs + 1; n < aig->nodes; n++) {
+    logic_aig_node_t *node = &aig->node_list[n];
+    uint32_t slot =
+        logic_aig_hash(node->fanin0, node->fanin1) & (table_size - 1);
+
+    while (table[slot] != LOGIC_AIG_EMPTY) {
+      slot = (slot + 1) & (table_size - 1);
+    }
+
+    table[slot] = (uint32_t)n;
+  }
+
+  free(aig->table);
+
+  aig->table = table;
+  aig->table_size = table_size;
+
+  return 0;
+}
+
+logic_aig_t *logic_aig_create(int inputs) {
+  logic_aig_t *aig = calloc(1, sizeof(logic_aig_t));
+
+  if (aig == NULL) {
+    return NULL;
+  }
+
+  aig->inputs = inputs;
+  aig->nodes = inputs + 1;
+  aig->capacity = (inputs + 1) * 2 + 16;
+  aig->node_list = calloc(aig->capacity, sizeof(logic_aig_node_t));
+
+  if (aig->node_list == NULL || logic_aig_rehash(aig, 64) != 0) {
+    logic_aig_free(aig);
+    return NULL;
+  }
+
+  return aig;
+}
+
+logic_aig_literal_t logic_aig_input(const logic_aig_t *aig, int input) {
+  if (aig == NULL || input < 0 || input >= aig->inputs) {
+    return LOGIC_AIG_FALSE;
+  }
+
+  return LOGIC_AIG_LITERAL(input + 1, 0);
+}
+
+logic_aig_literal_t logic_aig_and(logic_aig_t *aig, logic_aig_literal_t a,
+                                  logic_aig_literal_t b) {
+  /* A full table is never probed, nothing built after a failure counts */
+  if (aig->failed) {
+    return LOGIC_AIG_FALSE;
+  }
+
+  /* Trivial cases never create a node */
+  if (a == LOGIC_AIG_FALSE || b == LOGIC_AIG_FALSE || a == LOGIC_AIG_NOT(b)) {
+    return LOGIC_AIG_FALSE;
+  }
+
+  if (a == LOGIC_AIG_TRUE || a == b) {
+    return b;
+  }
+
+  if (b == LOGIC_AIG_TRUE) {
+    return a;
+  }
+
+  if (a > b) {
+    logic_aig_literal_t swap = a;
+
+    a = b;
+    b = swap;
+  }
+
+  uint32_t slot = logic_aig_hash(a, b) & (aig->table_size - 1);
+
+  while (aig->table[slot] != LOGIC_AIG_EMPTY) {
+    logic_aig_node_t *node = &aig->node_list[aig->table[slot]];
+
+    if (node->fanin0 == a && node->fanin1 == b) {
+      return LOGIC_AIG_LITERAL(aig->table[slot], 0);
+    }
+
+    slot = (slot + 1) & (aig->table_size - 1);
+  }
+
+  if (aig->nodes == aig->capacity) {
+    logic_aig_node_t *node_list = realloc(
+        aig->node_list, aig->capacity * 2 * sizeof(logic_aig_node_t));
+
+    if (node_list == NULL) {
+      aig->failed = true;
+      return LOGIC_AIG_FALSE;
+    }
+
+    aig->node_list = node_list;
+    aig->capacity *= 2;
+  }
+
+  int n = aig->nodes++;
+
+  aig->node_list[n].fanin0 = a;
+  aig->node_list[n].fanin1 = b;
+  aig->table[slot] = (uint32_t)n;
+
+  if ((aig->nodes - aig->inputs) * 2 > aig->table_size &&
+      logic_aig_rehash(aig, aig->table_size * 2) != 0) {
+    aig->failed = true;
+  }
+
+  return LOGIC_AIG_LITERAL(n, 0);
+}
+
+logic_aig_literal_t logic_aig_or(logic_aig_t *aig, logic_aig_literal_t a,
+                                 logic_aig_literal_t b) {
+  return LOGIC_AIG_NOT(
+      logic_aig_and(aig, LOGIC_AIG_NOT(a), LOGIC_AIG_NOT(b)));
+}
+
+logic_aig_literal_t logic_aig_xor(logic_aig_t *aig, logic_aig_literal_t a,
+                                  logic_aig_literal_t b) {
+  logic_aig_literal_t only_a = logic_aig_and(aig, a, LOGIC_AIG_NOT(b));
+  logic_aig_literal_t only_b = logic_aig_and(aig, LOGIC_AIG_NOT(a), b);
+
+  return logic_aig_or(aig, only_a, only_b);
+}
+
+int logic_aig_add_output(logic_aig_t *aig, logic_aig_literal_t literal) {
+  if (aig->failed) {
+    return -1;
+  }
+
+  logic_aig_literal_t *output_list = realloc(
+      aig->output_list, (aig->outputs + 1) * sizeof(logic_aig_literal_t));
+
+  if (output_list == NULL) {
+    return -1;
+  }
+
+  aig->output_list = output_list;
+  aig->output_list[aig->outputs++] = literal;
+
+  return 0;
+}
+
+logic_aig_t *logic_aig_from_circuit(const logic_circuit_t *circuit) {
+  /* Literals are built in gate order, feedback has none to read yet */
+  if (circuit == NULL || circuit->loops > 0 || circuit->cells > 0) {
+    return NULL;
+  }
+
+  logic_aig_t *aig = logic_aig_create(circuit->primary_inputs);
+
+  if (aig == NULL) {
+    return NULL;
+  }
+
+  aig->nets = circuit->nets;
+  aig->net_literals = calloc(circuit->nets, sizeof(logic_aig_literal_t));
+
+  if (aig->net_literals == NULL) {
+    logic_aig_free(aig);
+    return NULL;
+  }
+
+  logic_aig_literal_t *literals = aig->net_literals;
+
+  literals[LOGIC_NET_CONST0] = LOGIC_AIG_FALSE;
+  literals[LOGIC_NET_CONST1] = LOGIC_AIG_TRUE;
+
+  for (int i = 0; i < circuit->primary_inputs; i++) {
+    literals[LOGIC_INPUT_NET(i)] = logic_aig_input(aig, i);
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    logic_gate_t *gate = &circuit->gate_list[g];
+    int *fanins = &circuit->fanins[gate->fanin];
+    logic_aig_literal_t result = LOGIC_AIG_FALSE;
+
+    switch (gate->logic_block_type) {
+    case AND: {
+      result = LOGIC_AIG_TRUE;
+
+      for (int j = 0; j < gate->inputs; j++) {
+        result = logic_aig_and(aig, result, literals[fanins[j]]);
+      }
+
+      break;
+    }
+    case OR: {
+      for (int j = 0; j < gate->inputs; j++) {
+        result = logic_aig_or(aig, result, literals[fanins[j]]);
+      }
+
+      break;
+    }
+    case XOR: {
+      for (int j = 0; j < gate->inputs; j++) {
+        result = logic_aig_xor(aig, result, literals[fanins[j]]);
+      }
+
+      break;
+    }
+    case NOT: {
+      /* Inverters vanish into complemented edges */
+      result = gate->inputs > 0
+                   ? LOGIC_AIG_NOT(literals[fanins[gate->inputs - 1]])
+                   : LOGIC_AIG_TRUE;
+      break;
+    }
+    default: {
+      break;
+    }
+    }
+
+    literals[gate->output] = result;
+  }
+
+  if (aig->failed) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to allocate the graph nodes.");
+    logic_aig_free(aig);
+    return NULL;
+  }
+
+  for (int i = 0; i < circuit->outputs; i++) {
+    if (logic_aig_add_output(aig, literals[circuit->output_nets[i]]) != 0) {
+      logic_aig_free(aig);
+      return NULL;
+    }
+  }
+
+  return aig;
+}
+
+int logic_aig_simulate(logic_aig_t *aig, const logic_word_t *inputs) {
+  if (aig == NULL || inputs == NULL || aig->failed) {
+    return -1;
+  }
+
+  logic_word_t *values = realloc(aig->values, aig->capacity * sizeof(*values));
+
+  if (values == NULL) {
+    return -1;
+  }
+
+  aig->values = values;
+
+  values[0] = 0;
+
+  for (int i = 0; i < aig->inputs; i++) {
+    values[i + 1] = inputs[i];
+  }
+
+  /* Nodes are created after their fanins, one pass is enough */
+  const logic_aig_node_t *node = &aig->node_list[aig->inputs + 1];
+
+  for (int n = aig->inputs + 1; n < aig->nodes; n++, node++) {
+    logic_aig_literal_t f0 = node->fanin0;
+    logic_aig_literal_t f1 = node->fanin1;
+
+    logic_word_t a = values[f0 >> 1] ^ (0 - (logic_word_t)(f0 & 1u));
+    logic_word_t b = values[f1 >> 1] ^ (0 - (logic_word_t)(f1 & 1u));
+
+    values[n] = a & b;
+  }
+
+  return 0;
+}
+
+logic_word_t logic_aig_value(const logic_aig_t *aig,
+                             logic_aig_literal_t literal) {
+  return aig->values[LOGIC_AIG_NODE(literal)] ^
+         (0 - (logic_word_t)LOGIC_AIG_IS_COMPLEMENT(literal));
+}
+
+int logic_aig_store(const logic_aig_t *aig, logic_circuit_t *circuit) {
+  if (aig == NULL || circuit == NULL || aig->values == NULL ||
+      aig->nets != circuit->nets) {
+    return -1;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    circuit->values[n] = logic_aig_value(aig, aig->net_literals[n]);
+  }
+
+  return 0;
+}
+
+void logic_aig_free(logic_aig_t *aig) {
+  if (aig == NULL) {
+    return;
+  }
+
+  free(aig->node_list);
+  free(aig->output_list);
+  free(aig->net_literals);
+  free(aig->table);
+  free(aig->values);
+  free(aig);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
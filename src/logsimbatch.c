@@ -0,0 +1,287 @@
+/**
+ * @file logsimbatch.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Batch regression over forked worker processes.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimbatch.h"
+#include "../include/logsimcircuit.h"
+#include "../include/logsimnuma.h"
+#include "../include/utils.h"
+
+/*************** Structures ***************/
+
+typedef struct logic_batch_run {
+  const logic_word_t *stimulus;
+  logic_batch_generator_t generator;
+  void *user;
+  long steps;
+
+  /* Shared with the workers */
+  logic_word_t *responses;
+  uint8_t *done;
+  size_t shared_size;
+} logic_batch_run_t;
+
+/*************** Function Definitions ***************/
+
+logic_batch_t *logic_batch_create(logic_circuit_t *circuit, int workers) {
+  if (circuit == NULL) {
+    return NULL;
+  }
+
+  logic_batch_t *batch = calloc(1, sizeof(logic_batch_t));
+
+  if (batch == NULL) {
+    return NULL;
+  }
+
+  if (workers <= 0) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    workers = cores > 0 ? (int)cores : 1;
+  }
+
+  batch->circuit = circuit;
+  batch->workers = workers;
+
+  /* Loops and memory writes carry state from one step to the next */
+  batch->sequential = circuit->loops > 0;
+
+  for (int g = 0; g < circuit->gates; g++) {
+    if (circuit->gate_list[g].logic_block_type == MEM_WRITE) {
+      batch->sequential = true;
+    }
+  }
+
+  batch->program = logic_vm_compile(circuit);
+
+  if (batch->program == NULL) {
+    free(batch);
+    return NULL;
+  }
+
+  return batch;
+}
+
+/* Body of one worker, it only touches its own values and steps */
+static int logic_batch_worker(const logic_batch_t *batch,
+                              const logic_batch_run_t *run, long first,
+                              long last) {
+  const logic_circuit_t *circuit = batch->circuit;
+  logic_word_t *values = logic_numa_alloc(
+      circuit->nets * sizeof(logic_word_t), circuit->placement);
+  logic_word_t *inputs =
+      malloc((circuit->primary_inputs + 1) * sizeof(logic_word_t));
+
+  if (values == NULL || inputs == NULL) {
+    logic_numa_free(values);
+    free(inputs);
+    return -1;
+  }
+
+  /* Loops start from the state held by the circuit, like logic_vm_run */
+  memcpy(values, circuit->values, circuit->nets * sizeof(logic_word_t));
+
+  for (long step = first; step < last; step++) {
+    const logic_word_t *step_inputs = inputs;
+
+    if (run->generator != NULL) {
+      run->generator(run->user, step, inputs);
+    } else {
+      step_inputs = &run->stimulus[step * circuit->primary_inputs];
+    }
+
+    memcpy(&values[LOGIC_INPUT_NET(0)], step_inputs,
+           circuit->primary_inputs * sizeof(logic_word_t));
+
+    if (logic_vm_run(batch->program, values) < 0) {
+      logic_numa_free(values);
+      free(inputs);
+      return -1;
+    }
+
+    for (int i = 0; i < circuit->outputs; i++) {
+      run->responses[step * circuit->outputs + i] =
+          values[circuit->output_nets[i]];
+    }
+
+    run->done[step] = 1;
+  }
+
+  logic_numa_free(values);
+  free(inputs);
+
+  return 0;
+}
+
+/* Fork the workers over contiguous slices, the failed ones are returned */
+static int logic_batch_fork(logic_batch_t *batch, logic_batch_run_t *run) {
+  const logic_circuit_t *circuit = batch->circuit;
+  int workers = batch->workers;
+
+  if (workers > run->steps) {
+    workers = run->steps > 0 ? (int)run->steps : 1;
+  }
+
+  pid_t *pids = calloc(workers, sizeof(pid_t));
+  logic_topology_t *topology = (circuit->placement & LOGIC_PLACE_PIN_WORKERS)
+                                   ? logic_topology_create()
+                                   : NULL;
+
+  if (pids == NULL) {
+    logic_topology_free(topology);
+    return -1;
+  }
+
+  /* Buffered output would be written again by every child */
+  fflush(NULL);
+
+  for (int w = 0; w < workers; w++) {
+    long first = run->steps * w / workers;
+    long last = run->steps * (w + 1) / workers;
+
+    pids[w] = fork();
+
+    if (pids[w] == 0) {
+      /* Pinned before allocating, so its values are touched on its node */
+      if (topology != NULL) {
+        logic_topology_pin(logic_topology_cpu(topology, w, true));
+      }
+
+      _exit(logic_batch_worker(batch, run, first, last) == 0 ? 0 : 1);
+    }
+
+    if (pids[w] < 0) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Failed to fork worker (%d).", w);
+    }
+  }
+
+  int failed = 0;
+
+  /* Workers never wait on each other, reaping in order is enough */
+  for (int w = 0; w < workers; w++) {
+    int status = 0;
+
+    if (pids[w] < 0 || waitpid(pids[w], &status, 0) < 0 ||
+        !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      failed += 1;
+    }
+  }
+
+  free(pids);
+  logic_topology_free(topology);
+
+  return failed;
+}
+
+static int logic_batch_start(logic_batch_t *batch, logic_batch_run_t *run,
+                             logic_word_t *responses) {
+  const logic_circuit_t *circuit = batch->circuit;
+  size_t responses_size =
+      (size_t)run->steps * circuit->outputs * sizeof(logic_word_t);
+
+  run->shared_size = responses_size + run->steps + 1;
+
+  void *shared = mmap(NULL, run->shared_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+  if (shared == MAP_FAILED) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to map the results area.");
+    return -1;
+  }
+
+  run->responses = shared;
+  run->done = (uint8_t *)shared + responses_size;
+
+  batch->failed_workers = 0;
+  batch->failed_steps = 0;
+
+  if (batch->sequential) {
+    /* In this process, so steps share loop state and memory writes persist */
+    if (logic_batch_worker(batch, run, 0, run->steps) != 0) {
+      batch->failed_workers = 1;
+    }
+  } else {
+    int failed = logic_batch_fork(batch, run);
+
+    if (failed < 0) {
+      munmap(shared, run->shared_size);
+      return -1;
+    }
+
+    batch->failed_workers = failed;
+  }
+
+  for (long step = 0; step < run->steps; step++) {
+    if (run->done[step]) {
+      memcpy(&responses[step * circuit->outputs],
+             &run->responses[step * circuit->outputs],
+             circuit->outputs * sizeof(logic_word_t));
+    } else {
+      memset(&responses[step * circuit->outputs], 0,
+             circuit->outputs * sizeof(logic_word_t));
+      batch->failed_steps += 1;
+    }
+  }
+
+  munmap(shared, run->shared_size);
+
+  return batch->failed_workers;
+}
+
+int logic_batch_run(logic_batch_t *batch, const logic_word_t *stimulus,
+                    long steps, logic_word_t *responses) {
+  if (batch == NULL || stimulus == NULL || responses == NULL || steps < 0) {
+    return -1;
+  }
+
+  logic_batch_run_t run = {0};
+
+  run.stimulus = stimulus;
+  run.steps = steps;
+
+  return logic_batch_start(batch, &run, responses);
+}
+
+int logic_batch_run_generated(logic_batch_t *batch,
+                              logic_batch_generator_t generator, void *user,
+                              long steps, logic_word_t *responses) {
+  if (batch == NULL || generator == NULL || responses == NULL || steps < 0) {
+    return -1;
+  }
+
+  logic_batch_run_t run = {0};
+
+  run.generator = generator;
+  run.user = user;
+  run.steps = steps;
+
+  return logic_batch_start(batch, &run, responses);
+}
+
+void logic_batch_free(logic_batch_t *batch) {
+  if (batch == NULL) {
+    return;
+  }
+
+  logic_vm_free(batch->program);
+  free(batch);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
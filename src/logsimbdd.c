@@ -0,0 +1,1292 @@
+/**
+ * @file logsimbdd.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Reduced ordered binary decision diagrams of circuit outputs.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimbdd.h"
+#include "../include/logsimcircuit.h"
+#include "../include/logsimlut.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+/* Variable of the nodes on the free list */
+#define LOGIC_BDD_FREE UINT32_MAX
+
+#define LOGIC_BDD_OP_AND 1u
+#define LOGIC_BDD_OP_XOR 2u
+
+#define LOGIC_BDD_NODES 1024
+#define LOGIC_BDD_BUCKETS 16
+
+/* Sifting turns back once the diagrams grow past this factor of the best */
+#define LOGIC_BDD_MAX_GROWTH 1.2
+
+/*************** Structures ***************/
+
+typedef struct logic_bdd_sift {
+  int var;
+  int nodes;
+} logic_bdd_sift_t;
+
+/*************** Function Definitions ***************/
+
+static uint32_t logic_bdd_hash(uint32_t a, uint32_t b) {
+  uint64_t hash = (((uint64_t)a << 32) | b) * 0x9E3779B97F4A7C15ull;
+
+  return (uint32_t)(hash >> 32);
+}
+
+static int logic_bdd_level(const logic_bdd_t *bdd, logic_bdd_edge_t edge) {
+  return bdd->var_levels[bdd->node_list[LOGIC_BDD_NODE(edge)].var];
+}
+
+logic_bdd_t *logic_bdd_create(int vars, const logic_bdd_options_t *options) {
+  logic_bdd_options_t defaults = {1 << 22, 18, true, 4096};
+
+  if (vars < 0) {
+    return NULL;
+  }
+
+  logic_bdd_t *bdd = calloc(1, sizeof(logic_bdd_t));
+
+  if (bdd == NULL) {
+    return NULL;
+  }
+
+  bdd->options = options != NULL ? *options : defaults;
+
+  if (bdd->options.max_nodes <= 0) {
+    bdd->options.max_nodes = defaults.max_nodes;
+  }
+
+  if (bdd->options.cache_bits < 4 || bdd->options.cache_bits > 28) {
+    bdd->options.cache_bits = defaults.cache_bits;
+  }
+
+  bdd->vars = vars;
+  bdd->capacity = LOGIC_BDD_NODES;
+  bdd->cache_mask = (1u << bdd->options.cache_bits) - 1;
+  bdd->next_reorder = bdd->options.reorder_nodes;
+
+  bdd->var_levels = malloc((vars + 1) * sizeof(int));
+  bdd->level_vars = malloc((vars + 1) * sizeof(int));
+  bdd->subtable_list = calloc(vars + 1, sizeof(logic_bdd_subtable_t));
+  bdd->node_list = malloc(bdd->capacity * sizeof(logic_bdd_node_t));
+  bdd->stamp_list = calloc(bdd->capacity, sizeof(uint32_t));
+  bdd->value_list = malloc(bdd->capacity * sizeof(double));
+  bdd->cache = calloc(bdd->cache_mask + 1, sizeof(logic_bdd_entry_t));
+
+  if (bdd->var_levels == NULL || bdd->level_vars == NULL ||
+      bdd->subtable_list == NULL || bdd->node_list == NULL ||
+      bdd->stamp_list == NULL || bdd->value_list == NULL ||
+      bdd->cache == NULL) {
+    logic_bdd_free(bdd);
+    return NULL;
+  }
+
+  /* The constant sits below every variable */
+  for (int v = 0; v <= vars; v++) {
+    bdd->var_levels[v] = v;
+    bdd->level_vars[v] = v;
+  }
+
+  for (int v = 0; v < vars; v++) {
+    logic_bdd_subtable_t *subtable = &bdd->subtable_list[v];
+
+    subtable->mask = LOGIC_BDD_BUCKETS - 1;
+    subtable->buckets = calloc(LOGIC_BDD_BUCKETS, sizeof(uint32_t));
+
+    if (subtable->buckets == NULL) {
+      logic_bdd_free(bdd);
+      return NULL;
+    }
+  }
+
+  bdd->node_list[0] = (logic_bdd_node_t){(uint32_t)vars, 1, 0, 0, 0};
+
+  /* Index 0 ends the free list and the bucket chains */
+  for (int n = bdd->capacity - 1; n > 0; n--) {
+    bdd->node_list[n].var = LOGIC_BDD_FREE;
+    bdd->node_list[n].next = bdd->free_list;
+    bdd->free_list = n;
+  }
+
+  return bdd;
+}
+
+/* Double the node list, up to the node limit */
+static int logic_bdd_reserve(logic_bdd_t *bdd) {
+  if (bdd->capacity > bdd->options.max_nodes) {
+    return -1;
+  }
+
+  int capacity = bdd->capacity * 2;
+
+  if (capacity > bdd->options.max_nodes + 1) {
+    capacity = bdd->options.max_nodes + 1;
+  }
+
+  logic_bdd_node_t *node_list =
+      realloc(bdd->node_list, capacity * sizeof(logic_bdd_node_t));
+
+  if (node_list == NULL) {
+    return -1;
+  }
+
+  bdd->node_list = node_list;
+
+  uint32_t *stamp_list = realloc(bdd->stamp_list, capacity * sizeof(uint32_t));
+
+  if (stamp_list == NULL) {
+    return -1;
+  }
+
+  bdd->stamp_list = stamp_list;
+
+  double *value_list = realloc(bdd->value_list, capacity * sizeof(double));
+
+  if (value_list == NULL) {
+    return -1;
+  }
+
+  bdd->value_list = value_list;
+
+  for (int n = capacity - 1; n >= bdd->capacity; n--) {
+    bdd->node_list[n].var = LOGIC_BDD_FREE;
+    bdd->node_list[n].next = bdd->free_list;
+    bdd->stamp_list[n] = 0;
+    bdd->free_list = n;
+  }
+
+  bdd->capacity = capacity;
+
+  return 0;
+}
+
+static uint32_t logic_bdd_alloc_node(logic_bdd_t *bdd) {
+  if (bdd->free_list == 0 && logic_bdd_reserve(bdd) != 0) {
+    return 0;
+  }
+
+  uint32_t n = bdd->free_list;
+
+  bdd->free_list = bdd->node_list[n].next;
+
+  return n;
+}
+
+static void logic_bdd_node_ref(logic_bdd_t *bdd, uint32_t n) {
+  if (n != 0 && bdd->node_list[n].refs++ == 0) {
+    bdd->dead -= 1;
+  }
+}
+
+static void logic_bdd_grow(logic_bdd_subtable_t *subtable,
+                           logic_bdd_node_t *node_list) {
+  uint32_t mask = subtable->mask * 2 + 1;
+  uint32_t *buckets = calloc(mask + 1, sizeof(uint32_t));
+
+  /* A full subtable only makes the chains longer */
+  if (buckets == NULL) {
+    return;
+  }
+
+  for (uint32_t b = 0; b <= subtable->mask; b++) {
+    uint32_t n = subtable->buckets[b];
+
+    while (n != 0) {
+      uint32_t next = node_list[n].next;
+      uint32_t slot =
+          logic_bdd_hash(node_list[n].high, node_list[n].low) & mask;
+
+      node_list[n].next = buckets[slot];
+      buckets[slot] = n;
+      n = next;
+    }
+  }
+
+  free(subtable->buckets);
+
+  subtable->buckets = buckets;
+  subtable->mask = mask;
+}
+
+/* Put a node back in the subtable of its variable */
+static void logic_bdd_insert(logic_bdd_t *bdd, uint32_t n) {
+  logic_bdd_node_t *node = &bdd->node_list[n];
+  logic_bdd_subtable_t *subtable = &bdd->subtable_list[node->var];
+  uint32_t slot = logic_bdd_hash(node->high, node->low) & subtable->mask;
+
+  node->next = subtable->buckets[slot];
+  subtable->buckets[slot] = n;
+  subtable->nodes += 1;
+  bdd->live += 1;
+
+  if (bdd->live > bdd->peak) {
+    bdd->peak = bdd->live;
+  }
+
+  if ((uint32_t)subtable->nodes > 2 * (subtable->mask + 1)) {
+    logic_bdd_grow(subtable, bdd->node_list);
+  }
+}
+
+static logic_bdd_edge_t logic_bdd_unique(logic_bdd_t *bdd, uint32_t var,
+                                         logic_bdd_edge_t high,
+                                         logic_bdd_edge_t low) {
+  if (high == low) {
+    return high;
+  }
+
+  /* High edges are kept regular, the complement moves to the parent */
+  if (LOGIC_BDD_IS_COMPLEMENT(high)) {
+    logic_bdd_edge_t edge = logic_bdd_unique(bdd, var, LOGIC_BDD_NOT(high),
+                                             LOGIC_BDD_NOT(low));
+
+    return edge == LOGIC_BDD_INVALID ? edge : LOGIC_BDD_NOT(edge);
+  }
+
+  logic_bdd_subtable_t *subtable = &bdd->subtable_list[var];
+  uint32_t slot = logic_bdd_hash(high, low) & subtable->mask;
+
+  for (uint32_t n = subtable->buckets[slot]; n != 0;
+       n = bdd->node_list[n].next) {
+    if (bdd->node_list[n].high == high && bdd->node_list[n].low == low) {
+      return n << 1;
+    }
+  }
+
+  uint32_t n = logic_bdd_alloc_node(bdd);
+
+  if (n == 0) {
+    return LOGIC_BDD_INVALID;
+  }
+
+  bdd->node_list[n] = (logic_bdd_node_t){var, 0, high, low, 0};
+  bdd->dead += 1;
+
+  logic_bdd_node_ref(bdd, LOGIC_BDD_NODE(high));
+  logic_bdd_node_ref(bdd, LOGIC_BDD_NODE(low));
+  logic_bdd_insert(bdd, n);
+
+  return n << 1;
+}
+
+/* Free a dead node, and the children dying with it */
+static void logic_bdd_release(logic_bdd_t *bdd, uint32_t n) {
+  logic_bdd_node_t *node = &bdd->node_list[n];
+  logic_bdd_subtable_t *subtable = &bdd->subtable_list[node->var];
+  uint32_t *link =
+      &subtable->buckets[logic_bdd_hash(node->high, node->low) &
+                         subtable->mask];
+
+  while (*link != n) {
+    link = &bdd->node_list[*link].next;
+  }
+
+  *link = node->next;
+  subtable->nodes -= 1;
+  bdd->live -= 1;
+  bdd->dead -= 1;
+
+  uint32_t children[2] = {LOGIC_BDD_NODE(node->high),
+                          LOGIC_BDD_NODE(node->low)};
+
+  node->var = LOGIC_BDD_FREE;
+  node->next = bdd->free_list;
+  bdd->free_list = n;
+
+  for (int c = 0; c < 2; c++) {
+    if (children[c] != 0 && --bdd->node_list[children[c]].refs == 0) {
+      bdd->dead += 1;
+      logic_bdd_release(bdd, children[c]);
+    }
+  }
+}
+
+logic_bdd_edge_t logic_bdd_var(logic_bdd_t *bdd, int var) {
+  if (bdd == NULL || var < 0 || var >= bdd->vars) {
+    return LOGIC_BDD_INVALID;
+  }
+
+  return logic_bdd_unique(bdd, var, LOGIC_BDD_TRUE, LOGIC_BDD_FALSE);
+}
+
+void logic_bdd_ref(logic_bdd_t *bdd, logic_bdd_edge_t edge) {
+  if (bdd != NULL && edge != LOGIC_BDD_INVALID) {
+    logic_bdd_node_ref(bdd, LOGIC_BDD_NODE(edge));
+  }
+}
+
+void logic_bdd_deref(logic_bdd_t *bdd, logic_bdd_edge_t edge) {
+  if (bdd == NULL || edge == LOGIC_BDD_INVALID ||
+      LOGIC_BDD_NODE(edge) == 0) {
+    return;
+  }
+
+  if (--bdd->node_list[LOGIC_BDD_NODE(edge)].refs == 0) {
+    bdd->dead += 1;
+  }
+}
+
+/**************************************/
+
+static logic_bdd_entry_t *logic_bdd_entry(logic_bdd_t *bdd, uint32_t op,
+                                          logic_bdd_edge_t f,
+                                          logic_bdd_edge_t g) {
+  return &bdd->cache[logic_bdd_hash(f * 4 + op, g) & bdd->cache_mask];
+}
+
+static void logic_bdd_cofactors(const logic_bdd_t *bdd, logic_bdd_edge_t f,
+                                int level, logic_bdd_edge_t *high,
+                                logic_bdd_edge_t *low) {
+  const logic_bdd_node_t *node = &bdd->node_list[LOGIC_BDD_NODE(f)];
+
+  if (bdd->var_levels[node->var] != level) {
+    *high = f;
+    *low = f;
+    return;
+  }
+
+  *high = node->high ^ LOGIC_BDD_IS_COMPLEMENT(f);
+  *low = node->low ^ LOGIC_BDD_IS_COMPLEMENT(f);
+}
+
+logic_bdd_edge_t logic_bdd_and(logic_bdd_t *bdd, logic_bdd_edge_t f,
+                               logic_bdd_edge_t g) {
+  if (f == LOGIC_BDD_INVALID || g == LOGIC_BDD_INVALID) {
+    return LOGIC_BDD_INVALID;
+  }
+
+  if (f == g || g == LOGIC_BDD_TRUE) {
+    return f;
+  }
+
+  if (f == LOGIC_BDD_TRUE) {
+    return g;
+  }
+
+  if (f == LOGIC_BDD_NOT(g) || f == LOGIC_BDD_FALSE || g == LOGIC_BDD_FALSE) {
+    return LOGIC_BDD_FALSE;
+  }
+
+  /* Commutative, one cache entry serves both orders */
+  if (f > g) {
+    logic_bdd_edge_t swap = f;
+
+    f = g;
+    g = swap;
+  }
+
+  logic_bdd_entry_t *entry = logic_bdd_entry(bdd, LOGIC_BDD_OP_AND, f, g);
+
+  if (entry->op == LOGIC_BDD_OP_AND && entry->f == f && entry->g == g) {
+    return entry->result;
+  }
+
+  int level_f = logic_bdd_level(bdd, f);
+  int level_g = logic_bdd_level(bdd, g);
+  int level = level_f < level_g ? level_f : level_g;
+  logic_bdd_edge_t f_high, f_low, g_high, g_low;
+
+  logic_bdd_cofactors(bdd, f, level, &f_high, &f_low);
+  logic_bdd_cofactors(bdd, g, level, &g_high, &g_low);
+
+  logic_bdd_edge_t high = logic_bdd_and(bdd, f_high, g_high);
+  logic_bdd_edge_t low = logic_bdd_and(bdd, f_low, g_low);
+
+  if (high == LOGIC_BDD_INVALID || low == LOGIC_BDD_INVALID) {
+    return LOGIC_BDD_INVALID;
+  }
+
+  logic_bdd_edge_t result =
+      logic_bdd_unique(bdd, bdd->level_vars[level], high, low);
+
+  if (result != LOGIC_BDD_INVALID) {
+    /* Growing the node list moved nothing in the cache */
+    entry = logic_bdd_entry(bdd, LOGIC_BDD_OP_AND, f, g);
+    *entry = (logic_bdd_entry_t){f, g, LOGIC_BDD_OP_AND, result};
+  }
+
+  return result;
+}
+
+logic_bdd_edge_t logic_bdd_or(logic_bdd_t *bdd, logic_bdd_edge_t f,
+                              logic_bdd_edge_t g) {
+  if (f == LOGIC_BDD_INVALID || g == LOGIC_BDD_INVALID) {
+    return LOGIC_BDD_INVALID;
+  }
+
+  logic_bdd_edge_t result =
+      logic_bdd_and(bdd, LOGIC_BDD_NOT(f), LOGIC_BDD_NOT(g));
+
+  return result == LOGIC_BDD_INVALID ? result : LOGIC_BDD_NOT(result);
+}
+
+logic_bdd_edge_t logic_bdd_xor(logic_bdd_t *bdd, logic_bdd_edge_t f,
+                               logic_bdd_edge_t g) {
+  if (f == LOGIC_BDD_INVALID || g == LOGIC_BDD_INVALID) {
+    return LOGIC_BDD_INVALID;
+  }
+
+  /* Complements of the operands only complement the result */
+  uint32_t complement = LOGIC_BDD_IS_COMPLEMENT(f) ^ LOGIC_BDD_IS_COMPLEMENT(g);
+
+  f &= ~1u;
+  g &= ~1u;
+
+  if (f == g) {
+    return LOGIC_BDD_FALSE ^ complement;
+  }
+
+  if (f == LOGIC_BDD_FALSE) {
+    return g ^ complement;
+  }
+
+  if (g == LOGIC_BDD_FALSE) {
+    return f ^ complement;
+  }
+
+  if (f > g) {
+    logic_bdd_edge_t swap = f;
+
+    f = g;
+    g = swap;
+  }
+
+  logic_bdd_entry_t *entry = logic_bdd_entry(bdd, LOGIC_BDD_OP_XOR, f, g);
+
+  if (entry->op == LOGIC_BDD_OP_XOR && entry->f == f && entry->g == g) {
+    return entry->result ^ complement;
+  }
+
+  int level_f = logic_bdd_level(bdd, f);
+  int level_g = logic_bdd_level(bdd, g);
+  int level = level_f < level_g ? level_f : level_g;
+  logic_bdd_edge_t f_high, f_low, g_high, g_low;
+
+  logic_bdd_cofactors(bdd, f, level, &f_high, &f_low);
+  logic_bdd_cofactors(bdd, g, level, &g_high, &g_low);
+
+  logic_bdd_edge_t high = logic_bdd_xor(bdd, f_high, g_high);
+  logic_bdd_edge_t low = logic_bdd_xor(bdd, f_low, g_low);
+
+  if (high == LOGIC_BDD_INVALID || low == LOGIC_BDD_INVALID) {
+    return LOGIC_BDD_INVALID;
+  }
+
+  logic_bdd_edge_t result =
+      logic_bdd_unique(bdd, bdd->level_vars[level], high, low);
+
+  if (result == LOGIC_BDD_INVALID) {
+    return result;
+  }
+
+  entry = logic_bdd_entry(bdd, LOGIC_BDD_OP_XOR, f, g);
+  *entry = (logic_bdd_entry_t){f, g, LOGIC_BDD_OP_XOR, result};
+
+  return result ^ complement;
+}
+
+logic_bdd_edge_t logic_bdd_ite(logic_bdd_t *bdd, logic_bdd_edge_t f,
+                               logic_bdd_edge_t g, logic_bdd_edge_t h) {
+  if (f == LOGIC_BDD_INVALID) {
+    return LOGIC_BDD_INVALID;
+  }
+
+  return logic_bdd_or(bdd, logic_bdd_and(bdd, f, g),
+                      logic_bdd_and(bdd, LOGIC_BDD_NOT(f), h));
+}
+
+/**************************************/
+
+int logic_bdd_collect(logic_bdd_t *bdd) {
+  if (bdd == NULL) {
+    return 0;
+  }
+
+  int live = bdd->live;
+
+  for (int n = 1; n < bdd->capacity && bdd->dead > 0; n++) {
+    if (bdd->node_list[n].var != LOGIC_BDD_FREE &&
+        bdd->node_list[n].refs == 0) {
+      logic_bdd_release(bdd, n);
+    }
+  }
+
+  /* Entries may name the freed nodes */
+  if (bdd->live < live) {
+    memset(bdd->cache, 0, (bdd->cache_mask + 1) * sizeof(logic_bdd_entry_t));
+  }
+
+  bdd->collections += 1;
+
+  return live - bdd->live;
+}
+
+/*
+ * Exchange the variables of a level and the one below. Nodes of the upper
+ * variable x reading the lower one y are rewritten in place into y nodes,
+ * so every edge pointing at them keeps its function.
+ */
+static int logic_bdd_swap(logic_bdd_t *bdd, int level) {
+  uint32_t x = bdd->level_vars[level];
+  uint32_t y = bdd->level_vars[level + 1];
+  logic_bdd_subtable_t *subtable = &bdd->subtable_list[x];
+  int count = subtable->nodes;
+
+  /* Up to two new x nodes per rewritten one, none may fail half way */
+  while (bdd->capacity - 1 - bdd->live < 2 * count) {
+    if (logic_bdd_reserve(bdd) != 0) {
+      return -1;
+    }
+  }
+
+  uint32_t *list = malloc((count + 1) * sizeof(uint32_t));
+
+  if (list == NULL) {
+    return -1;
+  }
+
+  int listed = 0;
+
+  for (uint32_t b = 0; b <= subtable->mask; b++) {
+    for (uint32_t n = subtable->buckets[b]; n != 0;
+         n = bdd->node_list[n].next) {
+      list[listed++] = n;
+    }
+
+    subtable->buckets[b] = 0;
+  }
+
+  subtable->nodes = 0;
+  bdd->live -= listed;
+
+  bdd->level_vars[level] = y;
+  bdd->level_vars[level + 1] = x;
+  bdd->var_levels[y] = level;
+  bdd->var_levels[x] = level + 1;
+
+  /* Nodes not reading y stay x nodes, one level lower */
+  for (int i = 0; i < listed; i++) {
+    const logic_bdd_node_t *node = &bdd->node_list[list[i]];
+
+    if (bdd->node_list[LOGIC_BDD_NODE(node->high)].var != y &&
+        bdd->node_list[LOGIC_BDD_NODE(node->low)].var != y) {
+      logic_bdd_insert(bdd, list[i]);
+      list[i] = 0;
+    }
+  }
+
+  for (int i = 0; i < listed; i++) {
+    uint32_t n = list[i];
+
+    if (n == 0) {
+      continue;
+    }
+
+    logic_bdd_edge_t f_high = bdd->node_list[n].high;
+    logic_bdd_edge_t f_low = bdd->node_list[n].low;
+    logic_bdd_edge_t high_high, high_low, low_high, low_low;
+
+    logic_bdd_cofactors(bdd, f_high, level, &high_high, &high_low);
+    logic_bdd_cofactors(bdd, f_low, level, &low_high, &low_low);
+
+    logic_bdd_edge_t high = logic_bdd_unique(bdd, x, high_high, low_high);
+    logic_bdd_edge_t low = logic_bdd_unique(bdd, x, high_low, low_low);
+
+    logic_bdd_node_ref(bdd, LOGIC_BDD_NODE(high));
+    logic_bdd_node_ref(bdd, LOGIC_BDD_NODE(low));
+
+    bdd->node_list[n].var = y;
+    bdd->node_list[n].high = high;
+    bdd->node_list[n].low = low;
+    logic_bdd_insert(bdd, n);
+
+    /* The old children may now be dead, the sizes must stay exact */
+    uint32_t children[2] = {LOGIC_BDD_NODE(f_high), LOGIC_BDD_NODE(f_low)};
+
+    for (int c = 0; c < 2; c++) {
+      if (children[c] != 0 && --bdd->node_list[children[c]].refs == 0) {
+        bdd->dead += 1;
+        logic_bdd_release(bdd, children[c]);
+      }
+    }
+  }
+
+  free(list);
+
+  return 0;
+}
+
+static int logic_bdd_compare_sift(const void *a, const void *b) {
+  const logic_bdd_sift_t *sift_a = a;
+  const logic_bdd_sift_t *sift_b = b;
+
+  if (sift_a->nodes != sift_b->nodes) {
+    return sift_b->nodes - sift_a->nodes;
+  }
+
+  return sift_a->var - sift_b->var;
+}
+
+/* Move a variable one level at a time, remembering the smallest size */
+static int logic_bdd_sift_walk(logic_bdd_t *bdd, int *level, int target,
+                               int *best_level, int *best_live) {
+  while (*level != target) {
+    int step = target > *level ? 1 : -1;
+
+    if (logic_bdd_swap(bdd, step > 0 ? *level : *level - 1) != 0) {
+      return -1;
+    }
+
+    *level += step;
+
+    if (bdd->live < *best_live) {
+      *best_live = bdd->live;
+      *best_level = *level;
+    } else if (bdd->live > LOGIC_BDD_MAX_GROWTH * *best_live) {
+      break;
+    }
+  }
+
+  return 0;
+}
+
+int logic_bdd_reorder(logic_bdd_t *bdd) {
+  if (bdd == NULL) {
+    return -1;
+  }
+
+  logic_bdd_collect(bdd);
+
+  logic_bdd_sift_t *sift_list =
+      malloc((bdd->vars + 1) * sizeof(logic_bdd_sift_t));
+
+  if (sift_list == NULL) {
+    return -1;
+  }
+
+  for (int v = 0; v < bdd->vars; v++) {
+    sift_list[v] = (logic_bdd_sift_t){v, bdd->subtable_list[v].nodes};
+  }
+
+  /* Variables with the most nodes have the most to gain */
+  qsort(sift_list, bdd->vars, sizeof(logic_bdd_sift_t),
+        logic_bdd_compare_sift);
+
+  int status = 0;
+
+  for (int i = 0; i < bdd->vars && status == 0; i++) {
+    int level = bdd->var_levels[sift_list[i].var];
+    int best_level = level;
+    int best_live = bdd->live;
+
+    /* Nearest end first, then the other one, then back to the best */
+    int first = level < bdd->vars / 2 ? 0 : bdd->vars - 1;
+    int second = first == 0 ? bdd->vars - 1 : 0;
+
+    status = logic_bdd_sift_walk(bdd, &level, first, &best_level, &best_live);
+
+    if (status == 0) {
+      status = logic_bdd_sift_walk(bdd, &level, second, &best_level,
+                                   &best_live);
+    }
+
+    int live = best_live;
+
+    if (status == 0) {
+      status = logic_bdd_sift_walk(bdd, &level, best_level, &best_level,
+                                   &live);
+    }
+  }
+
+  free(sift_list);
+
+  /* Entries may name nodes freed by the swaps */
+  memset(bdd->cache, 0, (bdd->cache_mask + 1) * sizeof(logic_bdd_entry_t));
+
+  bdd->reorders += 1;
+  bdd->next_reorder = 2 * bdd->live > bdd->options.reorder_nodes
+                          ? 2 * bdd->live
+                          : bdd->options.reorder_nodes;
+
+  return status;
+}
+
+/**************************************/
+
+static void logic_bdd_next_stamp(logic_bdd_t *bdd) {
+  if (++bdd->stamp == 0) {
+    memset(bdd->stamp_list, 0, bdd->capacity * sizeof(uint32_t));
+    bdd->stamp = 1;
+  }
+}
+
+static int logic_bdd_count_nodes(logic_bdd_t *bdd, uint32_t n, bool *vars) {
+  if (bdd->stamp_list[n] == bdd->stamp) {
+    return 0;
+  }
+
+  bdd->stamp_list[n] = bdd->stamp;
+
+  if (n == 0) {
+    return 1;
+  }
+
+  const logic_bdd_node_t *node = &bdd->node_list[n];
+
+  if (vars != NULL) {
+    vars[node->var] = true;
+  }
+
+  return 1 + logic_bdd_count_nodes(bdd, LOGIC_BDD_NODE(node->high), vars) +
+         logic_bdd_count_nodes(bdd, LOGIC_BDD_NODE(node->low), vars);
+}
+
+int logic_bdd_size(logic_bdd_t *bdd, logic_bdd_edge_t edge) {
+  if (bdd == NULL || edge == LOGIC_BDD_INVALID) {
+    return 0;
+  }
+
+  logic_bdd_next_stamp(bdd);
+
+  return logic_bdd_count_nodes(bdd, LOGIC_BDD_NODE(edge), NULL);
+}
+
+int logic_bdd_support(logic_bdd_t *bdd, logic_bdd_edge_t edge) {
+  if (bdd == NULL || edge == LOGIC_BDD_INVALID) {
+    return 0;
+  }
+
+  bool *vars = calloc(bdd->vars + 1, sizeof(bool));
+  int support = 0;
+
+  if (vars == NULL) {
+    return -1;
+  }
+
+  logic_bdd_next_stamp(bdd);
+  logic_bdd_count_nodes(bdd, LOGIC_BDD_NODE(edge), vars);
+
+  for (int v = 0; v < bdd->vars; v++) {
+    support += vars[v];
+  }
+
+  free(vars);
+
+  return support;
+}
+
+/* Fraction of the assignments satisfying the regular edge of a node */
+static double logic_bdd_density(logic_bdd_t *bdd, uint32_t n) {
+  if (n == 0) {
+    return 0.0;
+  }
+
+  if (bdd->stamp_list[n] == bdd->stamp) {
+    return bdd->value_list[n];
+  }
+
+  const logic_bdd_node_t *node = &bdd->node_list[n];
+  double high = logic_bdd_density(bdd, LOGIC_BDD_NODE(node->high));
+  double low = logic_bdd_density(bdd, LOGIC_BDD_NODE(node->low));
+
+  if (LOGIC_BDD_IS_COMPLEMENT(node->low)) {
+    low = 1.0 - low;
+  }
+
+  bdd->stamp_list[n] = bdd->stamp;
+  bdd->value_list[n] = (high + low) / 2;
+
+  return bdd->value_list[n];
+}
+
+double logic_bdd_sat_count(logic_bdd_t *bdd, logic_bdd_edge_t edge) {
+  if (bdd == NULL || edge == LOGIC_BDD_INVALID) {
+    return 0.0;
+  }
+
+  logic_bdd_next_stamp(bdd);
+
+  double density = logic_bdd_density(bdd, LOGIC_BDD_NODE(edge));
+
+  if (LOGIC_BDD_IS_COMPLEMENT(edge)) {
+    density = 1.0 - density;
+  }
+
+  /* Powers of two are exact, no rounding past the density itself */
+  for (int v = 0; v < bdd->vars; v++) {
+    density *= 2.0;
+  }
+
+  return density;
+}
+
+int logic_bdd_pick(const logic_bdd_t *bdd, logic_bdd_edge_t edge,
+                   int *assignment) {
+  if (bdd == NULL || assignment == NULL || edge == LOGIC_BDD_INVALID ||
+      edge == LOGIC_BDD_FALSE) {
+    return -1;
+  }
+
+  memset(assignment, 0, bdd->vars * sizeof(int));
+
+  /* Every edge other than the constant false reaches true */
+  while (LOGIC_BDD_NODE(edge) != 0) {
+    const logic_bdd_node_t *node = &bdd->node_list[LOGIC_BDD_NODE(edge)];
+    logic_bdd_edge_t high = node->high ^ LOGIC_BDD_IS_COMPLEMENT(edge);
+
+    assignment[node->var] = high != LOGIC_BDD_FALSE;
+    edge = high != LOGIC_BDD_FALSE
+               ? high
+               : node->low ^ LOGIC_BDD_IS_COMPLEMENT(edge);
+  }
+
+  return 0;
+}
+
+bool logic_bdd_evaluate(const logic_bdd_t *bdd, logic_bdd_edge_t edge,
+                        const int *assignment) {
+  if (bdd == NULL || assignment == NULL || edge == LOGIC_BDD_INVALID) {
+    return false;
+  }
+
+  uint32_t complement = LOGIC_BDD_IS_COMPLEMENT(edge);
+
+  while (LOGIC_BDD_NODE(edge) != 0) {
+    const logic_bdd_node_t *node = &bdd->node_list[LOGIC_BDD_NODE(edge)];
+
+    edge = assignment[node->var] ? node->high : node->low;
+    complement ^= LOGIC_BDD_IS_COMPLEMENT(edge);
+  }
+
+  return complement != 0;
+}
+
+/**************************************/
+
+/* Shannon expansion of a truth table over the diagrams of its inputs */
+static logic_bdd_edge_t logic_bdd_lut(logic_bdd_t *bdd, uint64_t truth_table,
+                                      int inputs,
+                                      const logic_bdd_edge_t *edges) {
+  if (inputs == 0) {
+    return truth_table & 1 ? LOGIC_BDD_TRUE : LOGIC_BDD_FALSE;
+  }
+
+  int half = 1 << (inputs - 1);
+  uint64_t mask = (1ull << half) - 1;
+  logic_bdd_edge_t high =
+      logic_bdd_lut(bdd, (truth_table >> half) & mask, inputs - 1, edges);
+  logic_bdd_edge_t low =
+      logic_bdd_lut(bdd, truth_table & mask, inputs - 1, edges);
+
+  if (high == LOGIC_BDD_INVALID || low == LOGIC_BDD_INVALID) {
+    return LOGIC_BDD_INVALID;
+  }
+
+  return logic_bdd_ite(bdd, edges[inputs - 1], high, low);
+}
+
+/* Sift or collect, only while every diagram still needed is referenced */
+static void logic_bdd_maintain(logic_bdd_t *bdd) {
+  if (bdd->options.reorder && bdd->live > bdd->next_reorder) {
+    logic_bdd_reorder(bdd);
+  } else if (bdd->dead > LOGIC_BDD_NODES && bdd->dead > bdd->live / 2) {
+    logic_bdd_collect(bdd);
+  }
+}
+
+/* Fold one more input into a wide gate, the partial result may grow past
+   the diagrams of the gates before it */
+static logic_bdd_edge_t logic_bdd_fold(logic_bdd_t *bdd,
+                                       logic_block_type_t type,
+                                       logic_bdd_edge_t result,
+                                       logic_bdd_edge_t edge) {
+  logic_bdd_ref(bdd, result);
+  logic_bdd_maintain(bdd);
+  logic_bdd_deref(bdd, result);
+
+  switch (type) {
+  case AND:
+    return logic_bdd_and(bdd, result, edge);
+  case OR:
+    return logic_bdd_or(bdd, result, edge);
+  default:
+    return logic_bdd_xor(bdd, result, edge);
+  }
+}
+
+static logic_bdd_edge_t logic_bdd_gate(logic_bdd_t *bdd,
+                                       const logic_circuit_t *circuit,
+                                       const logic_gate_t *gate,
+                                       const logic_bdd_edge_t *edges) {
+  const int *fanins = &circuit->fanins[gate->fanin];
+  logic_bdd_edge_t result = LOGIC_BDD_FALSE;
+
+  switch (gate->logic_block_type) {
+  case AND: {
+    result = LOGIC_BDD_TRUE;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      result = logic_bdd_fold(bdd, AND, result, edges[fanins[j]]);
+    }
+
+    break;
+  }
+  case OR: {
+    for (int j = 0; j < gate->inputs; j++) {
+      result = logic_bdd_fold(bdd, OR, result, edges[fanins[j]]);
+    }
+
+    break;
+  }
+  case XOR: {
+    for (int j = 0; j < gate->inputs; j++) {
+      result = logic_bdd_fold(bdd, XOR, result, edges[fanins[j]]);
+    }
+
+    break;
+  }
+  case NOT: {
+    result = gate->inputs > 0
+                 ? LOGIC_BDD_NOT(edges[fanins[gate->inputs - 1]])
+                 : LOGIC_BDD_TRUE;
+    break;
+  }
+  case LUT: {
+    logic_bdd_edge_t inputs[LOGIC_LUT_INPUTS];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      inputs[j] = edges[fanins[j]];
+    }
+
+    result = logic_bdd_lut(bdd, gate->truth_table, gate->inputs, inputs);
+    break;
+  }
+  default: {
+    result = LOGIC_BDD_INVALID;
+    break;
+  }
+  }
+
+  return result;
+}
+
+int logic_bdd_build(logic_bdd_t *bdd, const logic_circuit_t *circuit,
+                    const int *input_vars, logic_bdd_edge_t *outputs) {
+  if (bdd == NULL || circuit == NULL || outputs == NULL) {
+    return -1;
+  }
+
+  /* Outputs of a loop depend on its state, not only on the inputs */
+  if (circuit->loops > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with feedback loops are not "
+                                "combinational.");
+    return -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    logic_block_type_t type = circuit->gate_list[g].logic_block_type;
+
+    if (LOGIC_IS_CELL(type) && type != LUT) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Circuits with word level cells have no "
+                                  "diagram.");
+      return -1;
+    }
+  }
+
+  for (int i = 0; i < circuit->primary_inputs; i++) {
+    int var = input_vars != NULL ? input_vars[i] : i;
+
+    if (var < 0 || var >= bdd->vars) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Input (%d) has no variable.", i);
+      return -1;
+    }
+  }
+
+  logic_bdd_edge_t *edges = malloc(circuit->nets * sizeof(logic_bdd_edge_t));
+  int *readers = calloc(circuit->nets, sizeof(int));
+
+  if (edges == NULL || readers == NULL) {
+    free(edges);
+    free(readers);
+    return -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      readers[circuit->fanins[gate->fanin + j]] += 1;
+    }
+  }
+
+  for (int o = 0; o < circuit->outputs; o++) {
+    readers[circuit->output_nets[o]] += 1;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    edges[n] = LOGIC_BDD_INVALID;
+  }
+
+  edges[LOGIC_NET_CONST0] = LOGIC_BDD_FALSE;
+  edges[LOGIC_NET_CONST1] = LOGIC_BDD_TRUE;
+
+  int status = 0;
+
+  /* Every net holds one reference to its diagram until its last reader */
+  for (int i = 0; i < circuit->primary_inputs; i++) {
+    int net = LOGIC_INPUT_NET(i);
+
+    edges[net] = logic_bdd_var(bdd, input_vars != NULL ? input_vars[i] : i);
+
+    if (edges[net] == LOGIC_BDD_INVALID) {
+      status = -1;
+    } else if (readers[net] > 0) {
+      logic_bdd_ref(bdd, edges[net]);
+    }
+  }
+
+  for (int g = 0; g < circuit->gates && status == 0; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+    logic_bdd_edge_t result = logic_bdd_gate(bdd, circuit, gate, edges);
+
+    if (result == LOGIC_BDD_INVALID) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Diagrams outgrew (%d) nodes.",
+                          bdd->options.max_nodes);
+      status = -1;
+      break;
+    }
+
+    edges[gate->output] = result;
+
+    if (readers[gate->output] > 0) {
+      logic_bdd_ref(bdd, result);
+    }
+
+    /* Drop what no later gate reads */
+    for (int j = 0; j < gate->inputs; j++) {
+      int net = circuit->fanins[gate->fanin + j];
+
+      if (--readers[net] == 0) {
+        logic_bdd_deref(bdd, edges[net]);
+      }
+    }
+
+    logic_bdd_maintain(bdd);
+  }
+
+  for (int o = 0; o < circuit->outputs; o++) {
+    int net = circuit->output_nets[o];
+
+    outputs[o] = status == 0 ? edges[net] : LOGIC_BDD_INVALID;
+    logic_bdd_ref(bdd, outputs[o]);
+  }
+
+  /* Outputs are the last readers, a failed build drops what it built */
+  for (int n = LOGIC_NET_RESERVED; n < circuit->nets; n++) {
+    if (readers[n] > 0) {
+      logic_bdd_deref(bdd, edges[n]);
+    }
+  }
+
+  free(edges);
+  free(readers);
+
+  return status;
+}
+
+void logic_bdd_free(logic_bdd_t *bdd) {
+  if (bdd == NULL) {
+    return;
+  }
+
+  for (int v = 0; v < bdd->vars && bdd->subtable_list != NULL; v++) {
+    free(bdd->subtable_list[v].buckets);
+  }
+
+  free(bdd->var_levels);
+  free(bdd->level_vars);
+  free(bdd->subtable_list);
+  free(bdd->node_list);
+  free(bdd->stamp_list);
+  free(bdd->value_list);
+  free(bdd->cache);
+  free(bdd);
+}
+
+/**************************************/
+
+int logic_bdd_analyze(const logic_circuit_t *circuit,
+                      const logic_bdd_options_t *options,
+                      logic_bdd_report_t *report) {
+  if (circuit == NULL || report == NULL) {
+    return -1;
+  }
+
+  memset(report, 0, sizeof(logic_bdd_report_t));
+
+  int inputs = circuit->primary_inputs;
+  int *input_vars = malloc((inputs + 1) * sizeof(int));
+  logic_bdd_edge_t *outputs =
+      malloc((circuit->outputs + 1) * sizeof(logic_bdd_edge_t));
+  logic_bdd_t *bdd = logic_bdd_create(inputs, options);
+
+  report->output_list =
+      calloc(circuit->outputs + 1, sizeof(logic_bdd_output_t));
+
+  if (input_vars == NULL || outputs == NULL || bdd == NULL ||
+      report->output_list == NULL) {
+    free(input_vars);
+    free(outputs);
+    logic_bdd_free(bdd);
+    logic_bdd_report_free(report);
+    return -1;
+  }
+
+  /* Inputs read together start on neighbouring levels */
+  int next = 0;
+
+  for (int i = 0; i < inputs; i++) {
+    input_vars[i] = -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int input = circuit->fanins[gate->fanin + j] - LOGIC_INPUT_NET(0);
+
+      if (input >= 0 && input < inputs && input_vars[input] == -1) {
+        input_vars[input] = next++;
+      }
+    }
+  }
+
+  for (int i = 0; i < inputs; i++) {
+    input_vars[i] = input_vars[i] == -1 ? next++ : input_vars[i];
+  }
+
+  if (logic_bdd_build(bdd, circuit, input_vars, outputs) != 0) {
+    free(input_vars);
+    free(outputs);
+    logic_bdd_free(bdd);
+    logic_bdd_report_free(report);
+    return -1;
+  }
+
+  /* Only the output diagrams are left referenced */
+  logic_bdd_collect(bdd);
+
+  /* First output computing each function, indexed by node */
+  int *first_outputs = malloc(bdd->capacity * sizeof(int));
+
+  for (int n = 0; first_outputs != NULL && n < bdd->capacity; n++) {
+    first_outputs[n] = -1;
+  }
+
+  report->inputs = inputs;
+  report->outputs = circuit->outputs;
+
+  for (int o = 0; o < circuit->outputs; o++) {
+    logic_bdd_output_t *output = &report->output_list[o];
+    logic_bdd_edge_t edge = outputs[o];
+
+    output->nodes = logic_bdd_size(bdd, edge);
+    output->support = logic_bdd_support(bdd, edge);
+    output->satisfying = logic_bdd_sat_count(bdd, edge);
+    output->constant = edge == LOGIC_BDD_FALSE  ? 0
+                       : edge == LOGIC_BDD_TRUE ? 1
+                                                : -1;
+    output->equivalent = -1;
+
+    if (first_outputs == NULL) {
+      continue;
+    }
+
+    int first = first_outputs[LOGIC_BDD_NODE(edge)];
+
+    if (first == -1) {
+      first_outputs[LOGIC_BDD_NODE(edge)] = o;
+    } else {
+      output->equivalent = first;
+      output->complement = outputs[first] != edge;
+    }
+  }
+
+  report->nodes = bdd->live + 1;
+  report->peak_nodes = bdd->peak + 1;
+  report->collections = bdd->collections;
+  report->reorders = bdd->reorders;
+
+  free(first_outputs);
+  free(input_vars);
+  free(outputs);
+  logic_bdd_free(bdd);
+
+  return 0;
+}
+
+void logic_bdd_print_report(const logic_bdd_report_t *report, FILE *stream) {
+  if (report == NULL || stream == NULL) {
+    return;
+  }
+
+  const char *rule =
+      "+--------+------------+---------+------------------+----------+";
+
+  LOG_SIM_FILE_PRINT(stream, "%s", rule);
+  LOG_SIM_FILE_PRINT(stream, "%s",
+                     "| OUTPUT | NODES      | SUPPORT | SATISFYING       |"
+                     " FUNCTION |");
+  LOG_SIM_FILE_PRINT(stream, "%s", rule);
+
+  for (int o = 0; o < report->outputs; o++) {
+    const logic_bdd_output_t *output = &report->output_list[o];
+    char function[16] = "";
+
+    if (output->constant != -1) {
+      snprintf(function, sizeof(function), "%d", output->constant);
+    } else if (output->equivalent != -1) {
+      snprintf(function, sizeof(function), "%s%d",
+               output->complement ? "~" : "=", output->equivalent);
+    }
+
+    LOG_SIM_FILE_PRINT(stream, "| %-6d | %-10d | %-7d | %-16.15g | %-8s |", o,
+                       output->nodes, output->support, output->satisfying,
+                       function);
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "%s", rule);
+  LOG_SIM_FILE_PRINT(stream,
+                     "Inputs (%d), nodes (%d), peak (%d), reorders (%d).",
+                     report->inputs, report->nodes, report->peak_nodes,
+                     report->reorders);
+}
+
+void logic_bdd_report_free(logic_bdd_report_t *report) {
+  if (report == NULL) {
+    return;
+  }
+
+  free(report->output_list);
+
+  report->output_list = NULL;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
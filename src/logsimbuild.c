@@ -0,0 +1,269 @@
+/**
+ * @file logsimbuild.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Bulk netlist construction with capacity reserved up front.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimbuild.h"
+#include "../include/logsimcircuit.h"
+#include "../include/logsimlib.h"
+#include "../include/utils.h"
+
+/*************** Function Definitions ***************/
+
+logic_builder_t *logic_builder_create(logic_sim_t *sim, int gates, int inputs,
+                                      int edges) {
+  if (sim == NULL || gates < 0 || inputs < 0 || edges < 0) {
+    return NULL;
+  }
+
+  logic_builder_t *builder = calloc(1, sizeof(logic_builder_t));
+
+  if (builder == NULL) {
+    return NULL;
+  }
+
+  builder->sim = sim;
+  builder->gate_capacity = gates;
+  builder->input_capacity = inputs;
+  builder->edge_capacity = edges;
+
+  /* Input streams of every edge, then the output stream of every gate */
+  builder->gate_list = logic_sim_alloc(sim, gates * sizeof(logic_block_t));
+  builder->input_list = logic_sim_alloc(sim, inputs * sizeof(logic_data_t));
+  builder->output_list = logic_sim_alloc(sim, gates * sizeof(logic_data_t));
+  builder->stream_list =
+      logic_sim_alloc(sim, (edges + gates) * sizeof(logic_top_block_t));
+  builder->stream_pointers =
+      logic_sim_alloc(sim, (edges + gates) * sizeof(logic_top_block_t *));
+
+  if (builder->gate_list == NULL || builder->input_list == NULL ||
+      builder->output_list == NULL || builder->stream_list == NULL ||
+      builder->stream_pointers == NULL) {
+    free(builder);
+    return NULL;
+  }
+
+  return builder;
+}
+
+int logic_builder_add_inputs(logic_builder_t *builder, int count,
+                             const int *values) {
+  if (builder == NULL || count < 0 ||
+      count > builder->input_capacity - builder->inputs) {
+    return -1;
+  }
+
+  int first = builder->inputs;
+
+  for (int i = 0; i < count; i++) {
+    logic_data_t *logic_data = &builder->input_list[first + i];
+
+    logic_data->logic_data_type = INPUT;
+    logic_data->data = values != NULL ? values[i] : 0;
+    logic_data->status = NOT_EVALUATED;
+  }
+
+  builder->inputs += count;
+
+  return first;
+}
+
+/* Check a whole call before any block is touched */
+static int logic_builder_check(const logic_builder_t *builder, int count,
+                               const logic_block_type_t *types,
+                               const int *arities, const int *sources) {
+  if (count < 0 || count > builder->gate_capacity - builder->gates) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Builder has room for (%d) more gates.",
+                        builder->gate_capacity - builder->gates);
+    return -1;
+  }
+
+  long edges = 0;
+
+  for (int g = 0; g < count; g++) {
+    if (types[g] != AND && types[g] != OR && types[g] != XOR &&
+        types[g] != NOT) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Gate (%d) has no known type.",
+                          builder->gates + g);
+      return -1;
+    }
+
+    if (arities[g] < 1 || (types[g] == NOT && arities[g] != 1)) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Gate (%d) cannot take (%d) inputs.",
+                          builder->gates + g, arities[g]);
+      return -1;
+    }
+
+    edges += arities[g];
+  }
+
+  if (edges > builder->edge_capacity - builder->edges) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Builder has room for (%d) more edges.",
+                        builder->edge_capacity - builder->edges);
+    return -1;
+  }
+
+  for (long e = 0; e < edges; e++) {
+    int source = sources[e];
+
+    if (LOGIC_BUILD_IS_INPUT(source)
+            ? LOGIC_BUILD_INPUT(source) >= builder->inputs
+            : source < 0 || source >= builder->gates + count) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Edge (%ld) reads an unknown source (%d).",
+                          e, source);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/* Take back the names of gates first to last - 1, newest first */
+static void logic_builder_unname(logic_builder_t *builder, int first,
+                                 int last) {
+  logic_sim_t *sim = builder->sim;
+
+  for (int g = last - 1; g >= first; g--) {
+    int id = util_interner_find(sim->names, builder->gate_list[g].path);
+
+    sim->name_blocks[id] = -1;
+    sim->blocks--;
+  }
+}
+
+int logic_builder_add_gates(logic_builder_t *builder, int count,
+                            const logic_block_type_t *types,
+                            const int *arities, const int *sources,
+                            const char *const *names) {
+  if (builder == NULL || types == NULL || arities == NULL ||
+      (sources == NULL && count > 0) ||
+      logic_builder_check(builder, count, types, arities, sources) != 0) {
+    return -1;
+  }
+
+  int first = builder->gates;
+  int edges = builder->edges;
+  const int *source = sources;
+
+  for (int g = first; g < first + count; g++) {
+    logic_block_t *logic_block = &builder->gate_list[g];
+    logic_data_t *logic_data = &builder->output_list[g];
+    int arity = arities[g - first];
+
+    char name[32];
+
+    if (names == NULL) {
+      snprintf(name, sizeof(name), "g%d", g);
+    }
+
+    if (logic_sim_name_block(builder->sim, logic_block,
+                             names != NULL ? names[g - first] : name,
+                             NULL) != 0) {
+      logic_builder_unname(builder, first, g);
+      builder->edges = edges;
+      return -1;
+    }
+
+    logic_block->logic_block_type = types[g - first];
+    logic_block->width = 1;
+    logic_block->inputs = arity;
+    logic_block->outputs = 1;
+    logic_block->current_input = arity;
+    logic_block->current_output = 1;
+
+    /* Streams are handed out in order, edges first */
+    logic_block->input_streams = &builder->stream_pointers[builder->edges];
+    logic_block->output_streams =
+        &builder->stream_pointers[builder->edge_capacity + g];
+
+    for (int j = 0; j < arity; j++, source++) {
+      logic_top_block_t *logic_top_block =
+          &builder->stream_list[builder->edges];
+
+      if (LOGIC_BUILD_IS_INPUT(*source)) {
+        logic_top_block->logic_top_block_type = DATA_BLOCK;
+        logic_top_block->logic_data =
+            &builder->input_list[LOGIC_BUILD_INPUT(*source)];
+      } else {
+        logic_top_block->logic_top_block_type = LOGIC_BLOCK;
+        logic_top_block->logic_block = &builder->gate_list[*source];
+      }
+
+      builder->stream_pointers[builder->edges++] = logic_top_block;
+    }
+
+    logic_top_block_t *output =
+        &builder->stream_list[builder->edge_capacity + g];
+
+    logic_data->logic_data_type = OUTPUT;
+    logic_data->status = NOT_EVALUATED;
+
+    output->logic_top_block_type = DATA_BLOCK;
+    output->logic_data = logic_data;
+
+    logic_block->output_streams[0] = output;
+  }
+
+  builder->gates += count;
+
+  return first;
+}
+
+logic_block_t *logic_builder_gate(logic_builder_t *builder, int gate) {
+  if (builder == NULL || gate < 0 || gate >= builder->gates) {
+    return NULL;
+  }
+
+  return &builder->gate_list[gate];
+}
+
+logic_data_t *logic_builder_input(logic_builder_t *builder, int input) {
+  if (builder == NULL || input < 0 || input >= builder->inputs) {
+    return NULL;
+  }
+
+  return &builder->input_list[input];
+}
+
+logic_circuit_t *logic_builder_compile(logic_builder_t *builder, int outputs,
+                                       const int *output_gates) {
+  if (builder == NULL || output_gates == NULL || outputs <= 0) {
+    return NULL;
+  }
+
+  logic_block_t **logic_blocks = malloc(outputs * sizeof(logic_block_t *));
+
+  if (logic_blocks == NULL) {
+    return NULL;
+  }
+
+  for (int i = 0; i < outputs; i++) {
+    logic_blocks[i] = logic_builder_gate(builder, output_gates[i]);
+  }
+
+  /* A missing gate is reported by the compiler */
+  logic_circuit_t *circuit = logic_circuit_compile(outputs, logic_blocks);
+
+  free(logic_blocks);
+
+  return circuit;
+}
+
+void logic_builder_free(logic_builder_t *builder) {
+  free(builder);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,672 @@
+/**
+ * @file logsimcircuit.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Compiled, levelized form of a LogSim block graph.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimcone.h"
+#include "../include/logsimmemory.h"
+#include "../include/logsimnuma.h"
+#include "../include/utils.h"
+
+/*************** Structures ***************/
+
+typedef struct logic_circuit_frame {
+  logic_block_t *logic_block;
+  int id; /* Discovery index */
+  int next_input;
+} logic_circuit_frame_t;
+
+/* Tarjan state, indexed by discovery index */
+typedef struct logic_circuit_walk {
+  util_map_t visit_map;
+
+  int discovered;
+  int capacity;
+  logic_block_t **block_list;
+  int *lowlinks;
+  bool *on_stack;
+
+  int *scc_stack;
+  int scc_depth;
+} logic_circuit_walk_t;
+
+/*************** Function Definitions ***************/
+
+static int logic_circuit_reserve(void **array, int *capacity, int needed,
+                                 size_t size) {
+  if (needed <= *capacity) {
+    return 0;
+  }
+
+  int grown = *capacity > 0 ? *capacity : 16;
+
+  while (grown < needed) {
+    grown *= 2;
+  }
+
+  void *resized = realloc(*array, (size_t)grown * size);
+
+  if (resized == NULL) {
+    return -1;
+  }
+
+  *array = resized;
+  *capacity = grown;
+
+  return 0;
+}
+
+static int logic_circuit_discover(logic_circuit_walk_t *walk,
+                                  logic_block_t *logic_block) {
+  int id = walk->discovered;
+
+  if (id == walk->capacity) {
+    int capacity = walk->capacity > 0 ? walk->capacity * 2 : 64;
+    logic_block_t **block_list =
+        realloc(walk->block_list, capacity * sizeof(logic_block_t *));
+    int *lowlinks = realloc(walk->lowlinks, capacity * sizeof(int));
+    bool *on_stack = realloc(walk->on_stack, capacity * sizeof(bool));
+    int *scc_stack = realloc(walk->scc_stack, capacity * sizeof(int));
+
+    /* Whatever was resized is kept, the walk frees it either way */
+    walk->block_list = block_list != NULL ? block_list : walk->block_list;
+    walk->lowlinks = lowlinks != NULL ? lowlinks : walk->lowlinks;
+    walk->on_stack = on_stack != NULL ? on_stack : walk->on_stack;
+    walk->scc_stack = scc_stack != NULL ? scc_stack : walk->scc_stack;
+
+    if (block_list == NULL || lowlinks == NULL || on_stack == NULL ||
+        scc_stack == NULL) {
+      return -1;
+    }
+
+    walk->capacity = capacity;
+  }
+
+  if (util_map_put(&walk->visit_map, logic_block, id) != 0) {
+    return -1;
+  }
+
+  walk->block_list[id] = logic_block;
+  walk->lowlinks[id] = id;
+  walk->on_stack[id] = true;
+  walk->scc_stack[walk->scc_depth++] = id;
+  walk->discovered += 1;
+
+  return id;
+}
+
+static void logic_circuit_walk_free(logic_circuit_walk_t *walk) {
+  util_map_free(&walk->visit_map);
+
+  free(walk->block_list);
+  free(walk->lowlinks);
+  free(walk->on_stack);
+  free(walk->scc_stack);
+}
+
+static bool logic_circuit_reads_itself(const logic_block_t *logic_block) {
+  for (int j = 0; j < logic_block->inputs; j++) {
+    const logic_top_block_t *logic_top_block = logic_block->input_streams[j];
+
+    if (logic_top_block->logic_top_block_type == LOGIC_BLOCK &&
+        logic_top_block->logic_block == logic_block) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/* All gates of a loop share the deepest level found inside it */
+static void logic_circuit_level_loop(logic_circuit_t *circuit,
+                                     const logic_loop_t *loop) {
+  int level = 0;
+
+  for (int g = loop->first; g < loop->first + loop->gates; g++) {
+    level = circuit->gate_list[g].level > level ? circuit->gate_list[g].level
+                                                : level;
+  }
+
+  for (int g = loop->first; g < loop->first + loop->gates; g++) {
+    circuit->gate_list[g].level = level;
+  }
+}
+
+/* Write ports outside the compiled cones drop their writes, say so */
+static void logic_circuit_check_memories(const logic_circuit_t *circuit) {
+  for (int g = 0; g < circuit->gates; g++) {
+    const logic_memory_t *memory = circuit->gate_list[g].memory;
+    int first = 0;
+    int writes = 0;
+
+    if (memory == NULL) {
+      continue;
+    }
+
+    while (circuit->gate_list[first].memory != memory) {
+      first++;
+    }
+
+    if (first < g) {
+      continue;
+    }
+
+    for (int w = g; w < circuit->gates; w++) {
+      writes += circuit->gate_list[w].memory == memory &&
+                circuit->gate_list[w].logic_block_type == MEM_WRITE;
+    }
+
+    if (writes < memory->ports) {
+      LOG_SIM_DEBUG_PRINT(stderr,
+                          "Memory compiled without (%d) of its (%d) write "
+                          "ports, pass them as roots.",
+                          memory->ports - writes, memory->ports);
+    }
+  }
+}
+
+/* New input values make every cone evaluation stale */
+static void logic_circuit_next_epoch(logic_circuit_t *circuit) {
+  if (circuit->gate_epochs == NULL) {
+    return;
+  }
+
+  circuit->epoch += 1;
+
+  if (circuit->epoch == 0) {
+    memset(circuit->gate_epochs, 0, circuit->gates * sizeof(uint32_t));
+    circuit->epoch = 1;
+  }
+}
+
+logic_circuit_t *logic_circuit_compile(int total_logic_blocks,
+                                       logic_block_t **logic_blocks) {
+  logic_circuit_t *circuit = NULL;
+
+  util_map_t block_map;
+  util_map_t data_map;
+
+  logic_circuit_walk_t walk = {0};
+
+  logic_block_t **order = NULL;
+  int order_count = 0;
+  int order_capacity = 0;
+
+  logic_data_t **inputs = NULL;
+  int input_count = 0;
+  int input_capacity = 0;
+
+  logic_loop_t *loops = NULL;
+  int loop_count = 0;
+  int loop_capacity = 0;
+
+  logic_circuit_frame_t *stack = NULL;
+  int depth = 0;
+  int stack_capacity = 0;
+
+  int fanin_count = 0;
+
+  if (util_map_init(&block_map, 64) != 0) {
+    return NULL;
+  }
+
+  if (util_map_init(&data_map, 64) != 0) {
+    util_map_free(&block_map);
+    return NULL;
+  }
+
+  if (util_map_init(&walk.visit_map, 64) != 0) {
+    util_map_free(&block_map);
+    util_map_free(&data_map);
+    return NULL;
+  }
+
+  /*
+   * Iterative Tarjan walk, so deep netlists cannot exhaust the stack. Every
+   * strongly connected component is placed after the ones it reads, which
+   * keeps acyclic parts in post-order and feedback loops contiguous.
+   */
+  for (int i = 0; i < total_logic_blocks; i++) {
+    logic_block_t *root = logic_blocks[i];
+
+    if (root == NULL) {
+      LOG_SIM_DEBUG_PRINT(stderr, "No data found.");
+      goto error;
+    }
+
+    if (util_map_get(&walk.visit_map, root) != -1) {
+      continue;
+    }
+
+    int root_id = logic_circuit_discover(&walk, root);
+
+    if (root_id == -1 ||
+        logic_circuit_reserve((void **)&stack, &stack_capacity, depth + 1,
+                              sizeof(logic_circuit_frame_t)) != 0) {
+      goto error;
+    }
+
+    stack[depth++] = (logic_circuit_frame_t){root, root_id, 0};
+
+    while (depth > 0) {
+      logic_circuit_frame_t *frame = &stack[depth - 1];
+      logic_block_t *logic_block = frame->logic_block;
+      int id = frame->id;
+
+      if (frame->next_input < logic_block->inputs) {
+        logic_top_block_t *logic_top_block =
+            logic_block->input_streams[frame->next_input];
+
+        frame->next_input += 1;
+
+        switch (logic_top_block->logic_top_block_type) {
+        case LOGIC_BLOCK: {
+          logic_block_t *logic_block_in = logic_top_block->logic_block;
+          int id_in = util_map_get(&walk.visit_map, logic_block_in);
+
+          fanin_count += 1;
+
+          if (id_in == -1) {
+            id_in = logic_circuit_discover(&walk, logic_block_in);
+
+            if (id_in == -1 ||
+                logic_circuit_reserve((void **)&stack, &stack_capacity,
+                                      depth + 1,
+                                      sizeof(logic_circuit_frame_t)) != 0) {
+              goto error;
+            }
+
+            stack[depth++] = (logic_circuit_frame_t){logic_block_in, id_in, 0};
+          } else if (walk.on_stack[id_in] && id_in < walk.lowlinks[id]) {
+            /* Feedback to a block whose component is still open */
+            walk.lowlinks[id] = id_in;
+          }
+
+          break;
+        }
+        case DATA_BLOCK: {
+          logic_data_t *logic_data = logic_top_block->logic_data;
+
+          if (util_map_get(&data_map, logic_data) == -1) {
+            if (logic_circuit_reserve((void **)&inputs, &input_capacity,
+                                      input_count + 1,
+                                      sizeof(logic_data_t *)) != 0) {
+              goto error;
+            }
+
+            if (util_map_put(&data_map, logic_data, input_count) != 0) {
+              goto error;
+            }
+
+            inputs[input_count++] = logic_data;
+          }
+
+          fanin_count += 1;
+          break;
+        }
+        case NONE: {
+          /* Unconnected inputs of a cell read the constant 0 */
+          fanin_count += LOGIC_IS_CELL(logic_block->logic_block_type);
+          break;
+        }
+        }
+
+        continue;
+      }
+
+      depth -= 1;
+
+      if (depth > 0 && walk.lowlinks[id] < walk.lowlinks[stack[depth - 1].id]) {
+        walk.lowlinks[stack[depth - 1].id] = walk.lowlinks[id];
+      }
+
+      if (walk.lowlinks[id] != id) {
+        continue;
+      }
+
+      /* Root of a component, its blocks take the next gate slots */
+      int first = order_count;
+
+      if (logic_circuit_reserve((void **)&order, &order_capacity,
+                                order_count + walk.scc_depth,
+                                sizeof(logic_block_t *)) != 0) {
+        goto error;
+      }
+
+      int member;
+
+      do {
+        member = walk.scc_stack[--walk.scc_depth];
+        walk.on_stack[member] = false;
+
+        if (util_map_put(&block_map, walk.block_list[member], order_count) !=
+            0) {
+          goto error;
+        }
+
+        order[order_count++] = walk.block_list[member];
+      } while (member != id);
+
+      if (order_count - first > 1 || logic_circuit_reads_itself(logic_block)) {
+        if (logic_circuit_reserve((void **)&loops, &loop_capacity,
+                                  loop_count + 1, sizeof(logic_loop_t)) != 0) {
+          goto error;
+        }
+
+        loops[loop_count++] = (logic_loop_t){first, order_count - first};
+      }
+    }
+  }
+
+  circuit = calloc(1, sizeof(logic_circuit_t));
+
+  if (circuit == NULL) {
+    goto error;
+  }
+
+  int gate_base = LOGIC_NET_RESERVED + input_count;
+  int gate_nets = 0;
+  int output_bits = 0;
+
+  /* Cells drive one net per bit, they are placed side by side */
+  for (int g = 0; g < order_count; g++) {
+    gate_nets += order[g]->width > 1 ? order[g]->width : 1;
+  }
+
+  for (int i = 0; i < total_logic_blocks; i++) {
+    output_bits += logic_blocks[i]->width > 1 ? logic_blocks[i]->width : 1;
+  }
+
+  circuit->primary_inputs = input_count;
+  circuit->gates = order_count;
+  circuit->nets = gate_base + gate_nets;
+  circuit->outputs = output_bits;
+  circuit->blocks = order_count;
+  circuit->loops = loop_count;
+
+  circuit->gate_list =
+      logic_numa_alloc((order_count + 1) * sizeof(logic_gate_t), 0);
+  circuit->fanins = logic_numa_alloc((fanin_count + 1) * sizeof(int), 0);
+  circuit->output_nets = calloc(output_bits + 1, sizeof(int));
+  circuit->block_nets = calloc(order_count + 1, sizeof(int));
+  circuit->values = logic_numa_alloc(circuit->nets * sizeof(logic_word_t), 0);
+
+  if (circuit->gate_list == NULL || circuit->fanins == NULL ||
+      circuit->output_nets == NULL || circuit->block_nets == NULL ||
+      circuit->values == NULL) {
+    goto error;
+  }
+
+  /* Ownership of the walk arrays moves to the circuit */
+  circuit->block_list = order;
+  circuit->input_list = inputs;
+  circuit->loop_list = loops;
+  order = NULL;
+  inputs = NULL;
+  loops = NULL;
+
+  for (int b = 0; b < circuit->blocks; b++) {
+    if (circuit->block_list[b]->id >= circuit->block_ids) {
+      circuit->block_ids = circuit->block_list[b]->id + 1;
+    }
+  }
+
+  circuit->id_blocks = malloc((circuit->block_ids + 1) * sizeof(int));
+  circuit->block_revisions =
+      malloc((circuit->blocks + 1) * sizeof(uint32_t));
+
+  if (circuit->id_blocks == NULL || circuit->block_revisions == NULL) {
+    goto error;
+  }
+
+  memset(circuit->id_blocks, -1, circuit->block_ids * sizeof(int));
+
+  for (int b = 0; b < circuit->blocks; b++) {
+    circuit->id_blocks[circuit->block_list[b]->id] = b;
+    circuit->block_revisions[b] = circuit->block_list[b]->revision;
+  }
+
+  int fanin = 0;
+  int net = gate_base;
+  int next_loop = 0;
+
+  /* Feedback reads gates placed later, every output is numbered first */
+  for (int g = 0; g < circuit->gates; g++) {
+    logic_gate_t *gate = &circuit->gate_list[g];
+    int width = circuit->block_list[g]->width;
+
+    gate->width = width > 1 ? width : 1;
+    gate->parameter = circuit->block_list[g]->parameter;
+    gate->memory = circuit->block_list[g]->memory;
+    gate->truth_table = circuit->block_list[g]->truth_table;
+    gate->output = net;
+    net += gate->width;
+
+    if (LOGIC_IS_CELL(circuit->block_list[g]->logic_block_type)) {
+      circuit->cells += 1;
+    }
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    logic_block_t *logic_block = circuit->block_list[g];
+    logic_gate_t *gate = &circuit->gate_list[g];
+
+    gate->logic_block_type = logic_block->logic_block_type;
+    gate->fanin = fanin;
+    gate->block = g;
+    gate->level = 1;
+
+    for (int j = 0; j < logic_block->inputs; j++) {
+      logic_top_block_t *logic_top_block = logic_block->input_streams[j];
+
+      if (logic_top_block->logic_top_block_type == LOGIC_BLOCK) {
+        int g_in = util_map_get(&block_map, logic_top_block->logic_block);
+
+        circuit->fanins[fanin++] =
+            circuit->gate_list[g_in].output + logic_top_block->bit;
+
+        /* Feedback reads a gate placed later, its loop is levelled below */
+        if (circuit->gate_list[g_in].level + 1 > gate->level) {
+          gate->level = circuit->gate_list[g_in].level + 1;
+        }
+      } else if (logic_top_block->logic_top_block_type == DATA_BLOCK) {
+        int input = util_map_get(&data_map, logic_top_block->logic_data);
+
+        circuit->fanins[fanin++] = LOGIC_INPUT_NET(input);
+      } else {
+        gate->floating += 1;
+
+        if (LOGIC_IS_CELL(gate->logic_block_type)) {
+          circuit->fanins[fanin++] = LOGIC_NET_CONST0;
+        }
+      }
+    }
+
+    gate->inputs = fanin - gate->fanin;
+    circuit->block_nets[g] = gate->output;
+
+    if (gate->level > circuit->levels) {
+      circuit->levels = gate->level;
+    }
+
+    /* A loop settles as a whole, levelled before any reader is placed */
+    if (next_loop < circuit->loops &&
+        g == circuit->loop_list[next_loop].first +
+                 circuit->loop_list[next_loop].gates - 1) {
+      logic_circuit_level_loop(circuit, &circuit->loop_list[next_loop++]);
+    }
+  }
+
+  for (int l = 0; l < circuit->loops; l++) {
+    logic_loop_t *loop = &circuit->loop_list[l];
+
+    for (int g = loop->first; g < loop->first + loop->gates; g++) {
+      logic_block_t *logic_block = circuit->block_list[g];
+      logic_gate_t *gate = &circuit->gate_list[g];
+
+      /* Loops hold state, they start from the last evaluated value */
+      for (int b = 0; b < gate->width && b < logic_block->outputs; b++) {
+        logic_data_t *logic_data = logic_block->output_streams[b]->logic_data;
+
+        if (logic_data != NULL && logic_data->status == EVALUATED &&
+            logic_data->data != 0) {
+          circuit->values[gate->output + b] = ~(logic_word_t)0;
+        }
+      }
+    }
+  }
+
+  for (int i = 0, o = 0; i < total_logic_blocks; i++) {
+    logic_gate_t *gate =
+        &circuit->gate_list[util_map_get(&block_map, logic_blocks[i])];
+
+    for (int b = 0; b < gate->width; b++) {
+      circuit->output_nets[o++] = gate->output + b;
+    }
+  }
+
+  logic_circuit_load_inputs(circuit);
+  logic_circuit_check_memories(circuit);
+
+  free(stack);
+  util_map_free(&block_map);
+  util_map_free(&data_map);
+  logic_circuit_walk_free(&walk);
+
+  return circuit;
+
+error:
+  free(order);
+  free(inputs);
+  free(loops);
+  free(stack);
+  util_map_free(&block_map);
+  util_map_free(&data_map);
+  logic_circuit_walk_free(&walk);
+  logic_circuit_free(circuit);
+
+  return NULL;
+}
+
+void logic_circuit_free(logic_circuit_t *circuit) {
+  if (circuit == NULL) {
+    return;
+  }
+
+  logic_cone_clear(circuit);
+
+  logic_numa_free(circuit->gate_list);
+  logic_numa_free(circuit->fanins);
+  free(circuit->output_nets);
+  free(circuit->block_list);
+  free(circuit->block_nets);
+  free(circuit->id_blocks);
+  free(circuit->input_list);
+  free(circuit->loop_list);
+  free(circuit->block_revisions);
+  free(circuit->stale_list);
+  logic_numa_free(circuit->values);
+  free(circuit);
+}
+
+int logic_circuit_block_net(const logic_circuit_t *circuit,
+                            const logic_block_t *logic_block) {
+  if (circuit == NULL || logic_block == NULL || logic_block->id < 0 ||
+      logic_block->id >= circuit->block_ids) {
+    return -1;
+  }
+
+  int b = circuit->id_blocks[logic_block->id];
+
+  /* Ids are per context, the block may share one with a compiled block */
+  if (b == -1 || circuit->block_list[b] != logic_block) {
+    return -1;
+  }
+
+  return circuit->block_nets[b];
+}
+
+int logic_circuit_load_inputs(logic_circuit_t *circuit) {
+  if (circuit == NULL) {
+    return -1;
+  }
+
+  circuit->values[LOGIC_NET_CONST0] = 0;
+  circuit->values[LOGIC_NET_CONST1] = ~(logic_word_t)0;
+
+  for (int i = 0; i < circuit->primary_inputs; i++) {
+    circuit->values[LOGIC_INPUT_NET(i)] =
+        circuit->input_list[i]->data ? ~(logic_word_t)0 : 0;
+  }
+
+  logic_circuit_next_epoch(circuit);
+
+  return 0;
+}
+
+int logic_circuit_set_input(logic_circuit_t *circuit, int input,
+                            logic_word_t word) {
+  if (circuit == NULL || input < 0 || input >= circuit->primary_inputs) {
+    return -1;
+  }
+
+  circuit->values[LOGIC_INPUT_NET(input)] = word;
+  logic_circuit_next_epoch(circuit);
+
+  return 0;
+}
+
+int logic_circuit_write_back(logic_circuit_t *circuit, int lane) {
+  if (circuit == NULL || lane < 0 || lane >= LOGIC_LANES) {
+    return -1;
+  }
+
+  for (int b = 0; b < circuit->blocks; b++) {
+    logic_block_t *logic_block = circuit->block_list[b];
+
+    /* Swept by the optimizer */
+    if (circuit->block_nets[b] < 0) {
+      continue;
+    }
+
+    int net = circuit->block_nets[b];
+
+    for (int i = 0; i < logic_block->outputs; i++) {
+      logic_top_block_t *logic_top_block = logic_block->output_streams[i];
+
+      if (logic_top_block->logic_top_block_type != DATA_BLOCK ||
+          logic_top_block->logic_data == NULL) {
+        continue;
+      }
+
+      /* Stream i of a cell carries bit i, every stream of a gate its bit */
+      int bit = LOGIC_IS_CELL(logic_block->logic_block_type) &&
+                        i < logic_block->width
+                    ? i
+                    : 0;
+      int data = (int)((circuit->values[net + bit] >> lane) & 1);
+
+      logic_top_block->logic_data->data = data;
+      logic_top_block->logic_data->status = EVALUATED;
+    }
+  }
+
+  return 0;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,302 @@
+/**
+ * @file logsimcone.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Output selective evaluation over cached cone schedules.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcone.h"
+#include "../include/logsimword.h"
+
+/*************** Function Definitions ***************/
+
+static int logic_cone_compare(const void *a, const void *b) {
+  int value_a = *(const int *)a;
+  int value_b = *(const int *)b;
+
+  return (value_a > value_b) - (value_a < value_b);
+}
+
+static uint64_t logic_cone_key(const int *outputs, int total_outputs) {
+  uint64_t key = 0xCBF29CE484222325ull;
+
+  for (int i = 0; i < total_outputs; i++) {
+    key = (key ^ (uint64_t)(uint32_t)outputs[i]) * 0x100000001B3ull;
+  }
+
+  return key;
+}
+
+static int logic_cone_prepare(logic_circuit_t *circuit) {
+  if (circuit->net_drivers != NULL) {
+    return 0;
+  }
+
+  circuit->net_drivers = malloc(circuit->nets * sizeof(int));
+  circuit->gate_epochs = calloc(circuit->gates + 1, sizeof(uint32_t));
+
+  if (circuit->net_drivers == NULL || circuit->gate_epochs == NULL) {
+    logic_cone_clear(circuit);
+    return -1;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    circuit->net_drivers[n] = -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    for (int b = 0; b < circuit->gate_list[g].width; b++) {
+      circuit->net_drivers[circuit->gate_list[g].output + b] = g;
+    }
+  }
+
+  /* Nothing has been evaluated through a cone yet */
+  circuit->epoch = 1;
+
+  return 0;
+}
+
+static logic_cone_t *logic_cone_build(logic_circuit_t *circuit,
+                                      const int *outputs, int total_outputs,
+                                      uint64_t key) {
+  logic_cone_t *cone = calloc(1, sizeof(logic_cone_t));
+  bool *marked = calloc(circuit->gates + 1, sizeof(bool));
+  int *stack = malloc((circuit->gates + 1) * sizeof(int));
+
+  if (cone != NULL) {
+    cone->output_list = malloc((total_outputs + 1) * sizeof(int));
+    cone->gate_list = malloc((circuit->gates + 1) * sizeof(int));
+  }
+
+  if (cone == NULL || marked == NULL || stack == NULL ||
+      cone->output_list == NULL || cone->gate_list == NULL) {
+    if (cone != NULL) {
+      free(cone->output_list);
+      free(cone->gate_list);
+    }
+
+    free(cone);
+    free(marked);
+    free(stack);
+    return NULL;
+  }
+
+  cone->key = key;
+  cone->outputs = total_outputs;
+  memcpy(cone->output_list, outputs, total_outputs * sizeof(int));
+
+  int depth = 0;
+
+  for (int i = 0; i < total_outputs; i++) {
+    int g = circuit->net_drivers[circuit->output_nets[outputs[i]]];
+
+    if (g >= 0 && !marked[g]) {
+      marked[g] = true;
+      stack[depth++] = g;
+    }
+  }
+
+  while (depth > 0) {
+    int g = stack[--depth];
+    logic_gate_t *gate = &circuit->gate_list[g];
+
+    cone->gate_list[cone->gates++] = g;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int g_in = circuit->net_drivers[circuit->fanins[gate->fanin + j]];
+
+      if (g_in >= 0 && !marked[g_in]) {
+        marked[g_in] = true;
+        stack[depth++] = g_in;
+      }
+    }
+  }
+
+  /* Circuit order is levelized, so sorted indices form a schedule */
+  qsort(cone->gate_list, cone->gates, sizeof(int), logic_cone_compare);
+
+  free(marked);
+  free(stack);
+
+  return cone;
+}
+
+logic_cone_t *logic_cone_get(logic_circuit_t *circuit, int total_outputs,
+                             const int *outputs) {
+  /* A cone schedule is a single pass, it cannot settle feedback */
+  if (circuit == NULL || outputs == NULL || total_outputs <= 0 ||
+      circuit->loops > 0) {
+    return NULL;
+  }
+
+  int *sorted = malloc(total_outputs * sizeof(int));
+
+  if (sorted == NULL || logic_cone_prepare(circuit) != 0) {
+    free(sorted);
+    return NULL;
+  }
+
+  memcpy(sorted, outputs, total_outputs * sizeof(int));
+  qsort(sorted, total_outputs, sizeof(int), logic_cone_compare);
+
+  /* Duplicate IDs do not change the cone */
+  int count = 0;
+
+  for (int i = 0; i < total_outputs; i++) {
+    if (sorted[i] < 0 || sorted[i] >= circuit->outputs) {
+      free(sorted);
+      return NULL;
+    }
+
+    if (count == 0 || sorted[count - 1] != sorted[i]) {
+      sorted[count++] = sorted[i];
+    }
+  }
+
+  uint64_t key = logic_cone_key(sorted, count);
+  logic_cone_t **link = &circuit->cone_list;
+
+  while (*link != NULL) {
+    logic_cone_t *cone = *link;
+
+    if (cone->key == key && cone->outputs == count &&
+        memcmp(cone->output_list, sorted, count * sizeof(int)) == 0) {
+      /* Move to front, checkers tend to repeat the same queries */
+      *link = cone->next;
+      cone->next = circuit->cone_list;
+      circuit->cone_list = cone;
+
+      free(sorted);
+      return cone;
+    }
+
+    link = &cone->next;
+  }
+
+  logic_cone_t *cone = logic_cone_build(circuit, sorted, count, key);
+
+  free(sorted);
+
+  if (cone == NULL) {
+    return NULL;
+  }
+
+  cone->next = circuit->cone_list;
+  circuit->cone_list = cone;
+
+  return cone;
+}
+
+int logic_cone_evaluate(logic_circuit_t *circuit, const logic_cone_t *cone) {
+  if (circuit == NULL || cone == NULL || circuit->gate_epochs == NULL) {
+    return -1;
+  }
+
+  logic_word_t *values = circuit->values;
+  uint32_t epoch = circuit->epoch;
+
+  for (int i = 0; i < cone->gates; i++) {
+    int g = cone->gate_list[i];
+
+    /* Shared with a cone already evaluated for these inputs */
+    if (circuit->gate_epochs[g] == epoch) {
+      continue;
+    }
+
+    const logic_gate_t *gate = &circuit->gate_list[g];
+    const int *fanins = &circuit->fanins[gate->fanin];
+    logic_word_t word = 0;
+
+    switch (gate->logic_block_type) {
+    case AND: {
+      word = ~(logic_word_t)0;
+
+      for (int j = 0; j < gate->inputs; j++) {
+        word &= values[fanins[j]];
+      }
+
+      break;
+    }
+    case OR: {
+      for (int j = 0; j < gate->inputs; j++) {
+        word |= values[fanins[j]];
+      }
+
+      break;
+    }
+    case XOR: {
+      for (int j = 0; j < gate->inputs; j++) {
+        word ^= values[fanins[j]];
+      }
+
+      break;
+    }
+    case NOT: {
+      word = gate->inputs > 0 ? ~values[fanins[gate->inputs - 1]]
+                              : ~(logic_word_t)0;
+      break;
+    }
+    default: {
+      /* Cells write their whole bus */
+      logic_word_evaluate(gate, fanins, values);
+      circuit->gate_epochs[g] = epoch;
+      continue;
+    }
+    }
+
+    values[gate->output] = word;
+    circuit->gate_epochs[g] = epoch;
+  }
+
+  return 0;
+}
+
+int logic_circuit_evaluate_outputs(logic_circuit_t *circuit,
+                                   int total_outputs, const int *outputs) {
+  logic_cone_t *cone = logic_cone_get(circuit, total_outputs, outputs);
+
+  if (cone == NULL) {
+    return -1;
+  }
+
+  return logic_cone_evaluate(circuit, cone);
+}
+
+void logic_cone_clear(logic_circuit_t *circuit) {
+  if (circuit == NULL) {
+    return;
+  }
+
+  logic_cone_t *cone = circuit->cone_list;
+
+  while (cone != NULL) {
+    logic_cone_t *next = cone->next;
+
+    free(cone->output_list);
+    free(cone->gate_list);
+    free(cone);
+
+    cone = next;
+  }
+
+  free(circuit->net_drivers);
+  free(circuit->gate_epochs);
+
+  circuit->cone_list = NULL;
+  circuit->net_drivers = NULL;
+  circuit->gate_epochs = NULL;
+  circuit->epoch = 0;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,411 @@
+/**
+ * @file logsimdot.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Streaming DOT export of compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <spawn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimdot.h"
+#include "../include/utils.h"
+
+/*************** Structures ***************/
+
+typedef struct logic_dot_gate {
+  int gate;
+  int level;
+  const char *prefix;
+} logic_dot_gate_t;
+
+/*************** Variables ***************/
+
+extern char **environ;
+
+/*************** Function Definitions ***************/
+
+static void logic_dot_print_escaped(FILE *stream, const char *text) {
+  for (; text != NULL && *text != '\0'; text++) {
+    if (*text == '"' || *text == '\\') {
+      fputc('\\', stream);
+    }
+
+    fputc(*text, stream);
+  }
+}
+
+static int logic_dot_compare_levels(const void *a, const void *b) {
+  const logic_dot_gate_t *gate_a = a;
+  const logic_dot_gate_t *gate_b = b;
+
+  if (gate_a->level != gate_b->level) {
+    return gate_a->level - gate_b->level;
+  }
+
+  return gate_a->gate - gate_b->gate;
+}
+
+static int logic_dot_compare_prefixes(const void *a, const void *b) {
+  const logic_dot_gate_t *gate_a = a;
+  const logic_dot_gate_t *gate_b = b;
+
+  /* Blocks without a prefix stay outside every cluster, at the end */
+  if ((gate_a->prefix == NULL) != (gate_b->prefix == NULL)) {
+    return gate_a->prefix == NULL ? 1 : -1;
+  }
+
+  if (gate_a->prefix != NULL) {
+    int order = strcmp(gate_a->prefix, gate_b->prefix);
+
+    if (order != 0) {
+      return order;
+    }
+  }
+
+  return gate_a->gate - gate_b->gate;
+}
+
+/* Walk back from the roots, nearest gates first, within the limits */
+static int logic_dot_select(const logic_circuit_t *circuit,
+                            const logic_dot_options_t *options,
+                            const int *net_drivers, bool *selected) {
+  int *queue = malloc((circuit->gates + 1) * sizeof(int));
+  int *depths = malloc((circuit->gates + 1) * sizeof(int));
+  int head = 0;
+  int tail = 0;
+  int count = 0;
+
+  if (queue == NULL || depths == NULL) {
+    free(queue);
+    free(depths);
+    return -1;
+  }
+
+  int roots = options->cone_net >= 0 ? 1 : circuit->outputs;
+
+  for (int i = 0; i < roots; i++) {
+    int net = options->cone_net >= 0 ? options->cone_net
+                                     : circuit->output_nets[i];
+    int g = net_drivers[net];
+
+    if (g >= 0 && !selected[g]) {
+      selected[g] = true;
+      depths[tail] = 1;
+      queue[tail++] = g;
+    }
+  }
+
+  while (head < tail) {
+    int g = queue[head];
+    int depth = depths[head++];
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    count += 1;
+
+    if (options->max_gates > 0 && count >= options->max_gates) {
+      /* The queued gates past the sample are dropped again */
+      for (int i = head; i < tail; i++) {
+        selected[queue[i]] = false;
+      }
+
+      break;
+    }
+
+    if (options->max_depth > 0 && depth >= options->max_depth) {
+      continue;
+    }
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int g_in = net_drivers[circuit->fanins[gate->fanin + j]];
+
+      if (g_in >= 0 && !selected[g_in]) {
+        selected[g_in] = true;
+        depths[tail] = depth + 1;
+        queue[tail++] = g_in;
+      }
+    }
+  }
+
+  free(queue);
+  free(depths);
+
+  return count;
+}
+
+static void logic_dot_write_gate(const logic_circuit_t *circuit,
+                                 const int *net_drivers, const bool *selected,
+                                 const bool *outputs, int g, bool nested,
+                                 FILE *stream) {
+  const logic_gate_t *gate = &circuit->gate_list[g];
+  const logic_block_t *logic_block = circuit->block_list[gate->block];
+  bool cut = false;
+
+  for (int j = 0; j < gate->inputs; j++) {
+    int g_in = net_drivers[circuit->fanins[gate->fanin + j]];
+
+    cut = cut || (g_in >= 0 && !selected[g_in]);
+  }
+
+  fprintf(stream, "%sn%d [label=\"", nested ? "    " : "  ", gate->output);
+  logic_dot_print_escaped(stream, logic_block->name);
+  fprintf(stream, "\\n%s\"%s%s];\n",
+          util_block_type_name(gate->logic_block_type),
+          cut ? ", style=dashed" : "",
+          outputs[gate->output] ? ", peripheries=2" : "");
+}
+
+int logic_dot_write(const logic_circuit_t *circuit,
+                    const logic_dot_options_t *options, const char *name,
+                    FILE *stream) {
+  if (circuit == NULL || stream == NULL) {
+    return -1;
+  }
+
+  logic_dot_options_t defaults = {LOGIC_DOT_CLUSTER_NONE, -1, 0, 0};
+
+  if (options == NULL) {
+    options = &defaults;
+  }
+
+  if (options->cone_net >= circuit->nets) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Net (%d) is not in the circuit.",
+                        options->cone_net);
+    return -1;
+  }
+
+  int *net_drivers = malloc(circuit->nets * sizeof(int));
+  bool *selected = calloc(circuit->gates + 1, sizeof(bool));
+  bool *outputs = calloc(circuit->nets, sizeof(bool));
+  bool *inputs = calloc(circuit->nets, sizeof(bool));
+  logic_dot_gate_t *order =
+      malloc((circuit->gates + 1) * sizeof(logic_dot_gate_t));
+
+  if (net_drivers == NULL || selected == NULL || outputs == NULL ||
+      inputs == NULL || order == NULL) {
+    free(net_drivers);
+    free(selected);
+    free(outputs);
+    free(inputs);
+    free(order);
+    return -1;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    net_drivers[n] = -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    for (int b = 0; b < circuit->gate_list[g].width; b++) {
+      net_drivers[circuit->gate_list[g].output + b] = g;
+    }
+  }
+
+  for (int i = 0; i < circuit->outputs; i++) {
+    outputs[circuit->output_nets[i]] = true;
+  }
+
+  int status = logic_dot_select(circuit, options, net_drivers, selected);
+  int count = 0;
+
+  for (int g = 0; g < circuit->gates && status >= 0; g++) {
+    if (!selected[g]) {
+      continue;
+    }
+
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    order[count++] = (logic_dot_gate_t){
+        g, gate->level, circuit->block_list[gate->block]->prefix};
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int net = circuit->fanins[gate->fanin + j];
+
+      inputs[net] = net_drivers[net] < 0;
+    }
+  }
+
+  if (options->cluster == LOGIC_DOT_CLUSTER_LEVELS) {
+    qsort(order, count, sizeof(logic_dot_gate_t), logic_dot_compare_levels);
+  } else if (options->cluster == LOGIC_DOT_CLUSTER_PREFIX) {
+    qsort(order, count, sizeof(logic_dot_gate_t), logic_dot_compare_prefixes);
+  }
+
+  fputs("digraph \"", stream);
+  logic_dot_print_escaped(stream, name != NULL ? name : "logsim");
+  fputs("\" {\n", stream);
+  fputs("  rankdir=LR;\n  splines=ortho;\n  node [shape=rectangle];\n", stream);
+
+  /* One node per net, data blocks shared by many gates are drawn once */
+  for (int n = 0; n < circuit->nets && status >= 0; n++) {
+    if (!inputs[n]) {
+      continue;
+    }
+
+    if (n < LOGIC_NET_RESERVED) {
+      fprintf(stream, "  n%d [label=\"%d\", shape=plaintext];\n", n,
+              n == LOGIC_NET_CONST1);
+    } else {
+      fprintf(stream, "  n%d [label=\"I%d\", shape=circle];\n", n,
+              n - LOGIC_NET_RESERVED);
+    }
+  }
+
+  int cluster = 0;
+  bool open = false;
+
+  for (int i = 0; i < count; i++) {
+    bool clustered = false;
+    bool opens = false;
+
+    if (options->cluster == LOGIC_DOT_CLUSTER_LEVELS) {
+      clustered = true;
+      opens = i == 0 || order[i].level != order[i - 1].level;
+    } else if (options->cluster == LOGIC_DOT_CLUSTER_PREFIX) {
+      clustered = order[i].prefix != NULL;
+      opens = clustered &&
+              (i == 0 || strcmp(order[i].prefix, order[i - 1].prefix) != 0);
+    }
+
+    if (open && (opens || !clustered)) {
+      fputs("  }\n", stream);
+      open = false;
+    }
+
+    if (opens) {
+      fprintf(stream, "  subgraph cluster_%d {\n    label=\"", cluster++);
+
+      if (options->cluster == LOGIC_DOT_CLUSTER_LEVELS) {
+        fprintf(stream, "level %d", order[i].level);
+      } else {
+        logic_dot_print_escaped(stream, order[i].prefix);
+      }
+
+      fputs("\";\n", stream);
+      open = true;
+    }
+
+    logic_dot_write_gate(circuit, net_drivers, selected, outputs,
+                         order[i].gate, open, stream);
+  }
+
+  if (open) {
+    fputs("  }\n", stream);
+  }
+
+  for (int i = 0; i < count; i++) {
+    const logic_gate_t *gate = &circuit->gate_list[order[i].gate];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int net = circuit->fanins[gate->fanin + j];
+
+      int g_in = net_drivers[net];
+
+      /* A cell is one node named after the first net of its bus */
+      if (g_in < 0) {
+        fprintf(stream, "  n%d -> n%d;\n", net, gate->output);
+      } else if (selected[g_in]) {
+        fprintf(stream, "  n%d -> n%d;\n", circuit->gate_list[g_in].output,
+                gate->output);
+      }
+    }
+  }
+
+  fputs("}\n", stream);
+
+  free(net_drivers);
+  free(selected);
+  free(outputs);
+  free(inputs);
+  free(order);
+
+  return status < 0 ? -1 : 0;
+}
+
+int logic_dot_write_file(const logic_circuit_t *circuit,
+                         const logic_dot_options_t *options, const char *name,
+                         const char *path) {
+  if (path == NULL) {
+    return -1;
+  }
+
+  FILE *stream = fopen(path, "w");
+
+  if (stream == NULL) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to open (%s).", path);
+    return -1;
+  }
+
+  int status = logic_dot_write(circuit, options, name, stream);
+
+  if (fclose(stream) != 0) {
+    status = -1;
+  }
+
+  return status;
+}
+
+logic_dot_render_t *logic_dot_render_start(const char *dot_path,
+                                           const char *output_path,
+                                           const char *format) {
+  if (dot_path == NULL || output_path == NULL) {
+    return NULL;
+  }
+
+  logic_dot_render_t *render = calloc(1, sizeof(logic_dot_render_t));
+  size_t size = strlen(format != NULL ? format : "svg") + 3;
+  char *type = malloc(size);
+
+  if (render == NULL || type == NULL) {
+    free(render);
+    free(type);
+    return NULL;
+  }
+
+  snprintf(type, size, "-T%s", format != NULL ? format : "svg");
+
+  /* graphviz is not thread safe, so the layout runs in its own process */
+  char *argv[] = {"dot", type, (char *)dot_path, "-o", (char *)output_path,
+                  NULL};
+  int status = posix_spawnp(&render->pid, "dot", NULL, NULL, argv, environ);
+
+  free(type);
+
+  if (status != 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to start dot (%s).", strerror(status));
+    free(render);
+    return NULL;
+  }
+
+  return render;
+}
+
+int logic_dot_render_wait(logic_dot_render_t *render) {
+  if (render == NULL) {
+    return -1;
+  }
+
+  int status = 0;
+  pid_t pid = waitpid(render->pid, &status, 0);
+
+  free(render);
+
+  if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
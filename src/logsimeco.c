@@ -0,0 +1,1071 @@
+/**
+ * @file logsimeco.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Engineering change orders on compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimcone.h"
+#include "../include/logsimeco.h"
+#include "../include/logsimmemory.h"
+#include "../include/logsimnuma.h"
+#include "../include/logsimword.h"
+#include "../include/utils.h"
+
+/*************** Structures ***************/
+
+typedef struct logic_eco_frame {
+  logic_block_t *logic_block;
+  int next_input;
+} logic_eco_frame_t;
+
+typedef struct logic_eco_visit {
+  int gate;
+  int next_input;
+} logic_eco_visit_t;
+
+/* Gates an update reads again, the edited ones first, then the added ones */
+typedef struct logic_eco {
+  int shift; /* Added primary inputs, gate nets move up by as many */
+
+  int edits;
+  int *edit_blocks;
+  int *block_gates;
+
+  int added;
+  int added_capacity;
+  logic_block_t **added_list;
+  int *added_nets;
+  util_map_t added_map; /* Block to its index in the added list, -2 open */
+
+  int input_capacity;
+  logic_data_t **input_list;
+  util_map_t data_map; /* Data block to its primary input */
+
+  /* Fanin nets of the gates read again, in the numbering after the update */
+  int *fanin_offsets;
+  int fanin_count;
+  int fanin_capacity;
+  int *fanin_list;
+  int *floating;
+
+  /* Index among the gates read again, -1 for the others */
+  int *gate_edits;
+  int *drivers;
+} logic_eco_t;
+
+/*************** Function Definitions ***************/
+
+int logic_block_disconnect(logic_block_t *logic_block, int input) {
+  if (logic_block == NULL || input < 0 || input >= logic_block->inputs) {
+    return -1;
+  }
+
+  logic_top_block_t *logic_top_block = logic_block->input_streams[input];
+
+  logic_top_block->logic_top_block_type = NONE;
+  logic_top_block->logic_block = NULL;
+  logic_top_block->logic_data = NULL;
+  logic_top_block->bit = 0;
+
+  if (input < logic_block->current_input) {
+    logic_block->current_input = input;
+  }
+
+  logic_block->revision += 1;
+
+  return 0;
+}
+
+int logic_block_replace(logic_sim_t *sim, logic_block_t *logic_block,
+                        logic_block_t *replacement) {
+  if (sim == NULL || logic_block == NULL || replacement == NULL) {
+    return -1;
+  }
+
+  int rewired = 0;
+
+  /* Readers are not tracked, every block of the context is looked at */
+  for (int b = 0; b < sim->blocks; b++) {
+    logic_block_t *reader = sim->block_list[b];
+
+    if (reader == replacement) {
+      continue;
+    }
+
+    for (int j = 0; j < reader->inputs; j++) {
+      logic_top_block_t *logic_top_block = reader->input_streams[j];
+
+      if (logic_top_block->logic_top_block_type != LOGIC_BLOCK ||
+          logic_top_block->logic_block != logic_block) {
+        continue;
+      }
+
+      if (logic_top_block->bit >= replacement->width) {
+        LOG_SIM_DEBUG_PRINT(stderr, "Block (%s) drives (%d) bits.",
+                            replacement->path, replacement->width);
+        return -1;
+      }
+
+      logic_top_block->logic_block = replacement;
+      reader->revision += 1;
+      rewired += 1;
+    }
+  }
+
+  return rewired;
+}
+
+/**************************************/
+
+static void logic_eco_free(logic_eco_t *eco) {
+  free(eco->edit_blocks);
+  free(eco->block_gates);
+  free(eco->added_list);
+  free(eco->added_nets);
+  free(eco->input_list);
+  free(eco->fanin_offsets);
+  free(eco->fanin_list);
+  free(eco->floating);
+  free(eco->gate_edits);
+  free(eco->drivers);
+
+  util_map_free(&eco->added_map);
+  util_map_free(&eco->data_map);
+}
+
+static int logic_eco_grow(void **array, int *capacity, int needed,
+                          size_t size) {
+  if (needed <= *capacity) {
+    return 0;
+  }
+
+  int grown = *capacity > 0 ? *capacity * 2 : 16;
+
+  while (grown < needed) {
+    grown *= 2;
+  }
+
+  void *resized = realloc(*array, (size_t)grown * size);
+
+  if (resized == NULL) {
+    return -1;
+  }
+
+  *array = resized;
+  *capacity = grown;
+
+  return 0;
+}
+
+static int logic_eco_add_input(const logic_circuit_t *circuit,
+                               logic_eco_t *eco, logic_data_t *logic_data) {
+  if (util_map_get(&eco->data_map, logic_data) != -1) {
+    return 0;
+  }
+
+  if (logic_eco_grow((void **)&eco->input_list, &eco->input_capacity,
+                     eco->shift + 1, sizeof(logic_data_t *)) != 0 ||
+      util_map_put(&eco->data_map, logic_data,
+                   circuit->primary_inputs + eco->shift) != 0) {
+    return -1;
+  }
+
+  eco->input_list[eco->shift++] = logic_data;
+
+  return 0;
+}
+
+/* Blocks an edited block newly reads, each after the blocks it reads */
+static int logic_eco_discover(const logic_circuit_t *circuit, logic_eco_t *eco,
+                              logic_block_t *root) {
+  logic_eco_frame_t *stack = NULL;
+  int depth = 0;
+  int capacity = 0;
+  int status = 0;
+
+  if (logic_eco_grow((void **)&stack, &capacity, 1,
+                     sizeof(logic_eco_frame_t)) != 0) {
+    return -1;
+  }
+
+  stack[depth++] = (logic_eco_frame_t){root, 0};
+
+  while (depth > 0 && status == 0) {
+    logic_eco_frame_t *frame = &stack[depth - 1];
+    logic_block_t *logic_block = frame->logic_block;
+
+    if (frame->next_input == logic_block->inputs) {
+      depth -= 1;
+
+      /* The root is compiled already */
+      if (depth == 0) {
+        break;
+      }
+
+      if (logic_eco_grow((void **)&eco->added_list, &eco->added_capacity,
+                         eco->added + 1, sizeof(logic_block_t *)) != 0 ||
+          util_map_put(&eco->added_map, logic_block, eco->added) != 0) {
+        status = -1;
+        break;
+      }
+
+      eco->added_list[eco->added++] = logic_block;
+      continue;
+    }
+
+    logic_top_block_t *logic_top_block =
+        logic_block->input_streams[frame->next_input];
+
+    frame->next_input += 1;
+
+    if (logic_top_block->logic_top_block_type == DATA_BLOCK) {
+      status = logic_eco_add_input(circuit, eco, logic_top_block->logic_data);
+      continue;
+    }
+
+    if (logic_top_block->logic_top_block_type != LOGIC_BLOCK) {
+      continue;
+    }
+
+    logic_block_t *logic_block_in = logic_top_block->logic_block;
+
+    if (logic_circuit_block_net(circuit, logic_block_in) >= 0) {
+      continue;
+    }
+
+    int state = util_map_get(&eco->added_map, logic_block_in);
+
+    if (state == -2) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Block (%s) closes a feedback loop.",
+                          logic_block_in->path);
+      status = -1;
+    } else if (state == -1) {
+      if (util_map_put(&eco->added_map, logic_block_in, -2) != 0 ||
+          logic_eco_grow((void **)&stack, &capacity, depth + 1,
+                         sizeof(logic_eco_frame_t)) != 0) {
+        status = -1;
+        break;
+      }
+
+      stack[depth++] = (logic_eco_frame_t){logic_block_in, 0};
+    }
+  }
+
+  free(stack);
+
+  return status;
+}
+
+/* Net a stream reads after the update, -1 when it is unconnected */
+static int logic_eco_stream_net(const logic_circuit_t *circuit,
+                                logic_eco_t *eco,
+                                const logic_top_block_t *logic_top_block) {
+  switch (logic_top_block->logic_top_block_type) {
+  case LOGIC_BLOCK: {
+    int net = logic_circuit_block_net(circuit, logic_top_block->logic_block);
+
+    if (net >= 0) {
+      return net + eco->shift + logic_top_block->bit;
+    }
+
+    int added = util_map_get(&eco->added_map, logic_top_block->logic_block);
+
+    return eco->added_nets[added] + logic_top_block->bit;
+  }
+  case DATA_BLOCK: {
+    return LOGIC_INPUT_NET(
+        util_map_get(&eco->data_map, logic_top_block->logic_data));
+  }
+  default: {
+    return -1;
+  }
+  }
+}
+
+static int logic_eco_read(const logic_circuit_t *circuit, logic_eco_t *eco,
+                          const logic_block_t *logic_block, int slot) {
+  if (logic_eco_grow((void **)&eco->fanin_list, &eco->fanin_capacity,
+                     eco->fanin_count + logic_block->inputs + 1,
+                     sizeof(int)) != 0) {
+    return -1;
+  }
+
+  eco->fanin_offsets[slot] = eco->fanin_count;
+  eco->floating[slot] = 0;
+
+  for (int j = 0; j < logic_block->inputs; j++) {
+    int net = logic_eco_stream_net(circuit, eco, logic_block->input_streams[j]);
+
+    if (net >= 0) {
+      eco->fanin_list[eco->fanin_count++] = net;
+      continue;
+    }
+
+    eco->floating[slot] += 1;
+
+    /* Unconnected inputs of a cell read the constant 0 */
+    if (LOGIC_IS_CELL(logic_block->logic_block_type)) {
+      eco->fanin_list[eco->fanin_count++] = LOGIC_NET_CONST0;
+    }
+  }
+
+  eco->fanin_offsets[slot + 1] = eco->fanin_count;
+
+  return 0;
+}
+
+static int logic_eco_inputs(const logic_circuit_t *circuit,
+                            const logic_eco_t *eco, int g) {
+  int slot = eco->gate_edits[g];
+
+  if (slot >= 0) {
+    return eco->fanin_offsets[slot + 1] - eco->fanin_offsets[slot];
+  }
+
+  return circuit->gate_list[g].inputs;
+}
+
+static int logic_eco_fanin(const logic_circuit_t *circuit,
+                           const logic_eco_t *eco, int g, int j) {
+  int slot = eco->gate_edits[g];
+
+  if (slot >= 0) {
+    return eco->fanin_list[eco->fanin_offsets[slot] + j];
+  }
+
+  int net = circuit->fanins[circuit->gate_list[g].fanin + j];
+
+  return net >= LOGIC_INPUT_NET(circuit->primary_inputs) ? net + eco->shift
+                                                         : net;
+}
+
+
+/*
+ * Depth first over the fanins of the gates from first on, each gate placed
+ * after the ones it reads. Gates reading only earlier gates keep their
+ * order, so only those behind a newly read later gate move.
+ */
+static int logic_eco_order(const logic_circuit_t *circuit,
+                           const logic_eco_t *eco, int first, int gates,
+                           int *order) {
+  int region = gates - first;
+  uint8_t *state = calloc(region + 1, sizeof(uint8_t));
+  logic_eco_visit_t *stack = malloc((region + 1) * sizeof(logic_eco_visit_t));
+  int count = 0;
+
+  if (state == NULL || stack == NULL) {
+    free(state);
+    free(stack);
+    return -1;
+  }
+
+  for (int root = first; root < gates && count >= 0; root++) {
+    if (state[root - first] != 0) {
+      continue;
+    }
+
+    int depth = 0;
+
+    stack[depth++] = (logic_eco_visit_t){root, 0};
+    state[root - first] = 1;
+
+    while (depth > 0) {
+      logic_eco_visit_t *visit = &stack[depth - 1];
+
+      if (visit->next_input == logic_eco_inputs(circuit, eco, visit->gate)) {
+        state[visit->gate - first] = 2;
+        order[count++] = visit->gate;
+        depth -= 1;
+        continue;
+      }
+
+      int net = logic_eco_fanin(circuit, eco, visit->gate, visit->next_input);
+      int g_in = eco->drivers[net];
+
+      visit->next_input += 1;
+
+      /* Gates before first are placed already */
+      if (g_in < first) {
+        continue;
+      }
+
+      if (state[g_in - first] == 1) {
+        LOG_SIM_DEBUG_PRINT(stderr, "Edits close a feedback loop at gate "
+                                    "(%d).",
+                            g_in);
+        count = -1;
+        break;
+      }
+
+      if (state[g_in - first] == 0) {
+        state[g_in - first] = 1;
+        stack[depth++] = (logic_eco_visit_t){g_in, 0};
+      }
+    }
+  }
+
+  free(state);
+  free(stack);
+
+  return count;
+}
+
+static int logic_eco_compare(const void *a, const void *b) {
+  int value_a = *(const int *)a;
+  int value_b = *(const int *)b;
+
+  return (value_a > value_b) - (value_a < value_b);
+}
+
+static bool logic_eco_contains(const int *list, int count, int value) {
+  int low = 0;
+  int high = count;
+
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+
+    if (list[middle] < value) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low < count && list[low] == value;
+}
+
+static int logic_eco_resize(void **array, size_t size) {
+  void *resized = realloc(*array, size);
+
+  if (resized == NULL) {
+    return -1;
+  }
+
+  *array = resized;
+
+  return 0;
+}
+
+/* Drop the cones holding an edited gate, renumber the gates of the others */
+static void logic_eco_cones(logic_circuit_t *circuit, const int *edited,
+                            int edits, int first, const int *positions) {
+  logic_cone_t **link = &circuit->cone_list;
+
+  while (*link != NULL) {
+    logic_cone_t *cone = *link;
+    bool stale = false;
+
+    for (int e = 0; e < edits && !stale; e++) {
+      stale = logic_eco_contains(cone->gate_list, cone->gates, edited[e]);
+    }
+
+    if (stale) {
+      *link = cone->next;
+
+      free(cone->output_list);
+      free(cone->gate_list);
+      free(cone);
+      continue;
+    }
+
+    bool moved = false;
+
+    for (int i = 0; i < cone->gates; i++) {
+      int g = cone->gate_list[i];
+
+      if (g >= first && positions[g - first] != g) {
+        cone->gate_list[i] = positions[g - first];
+        moved = true;
+      }
+    }
+
+    /* Sorted indices have to stay a schedule */
+    if (moved) {
+      qsort(cone->gate_list, cone->gates, sizeof(int), logic_eco_compare);
+    }
+
+    link = &cone->next;
+  }
+}
+
+int logic_circuit_update(logic_circuit_t *circuit, logic_eco_report_t *report) {
+  logic_eco_report_t local = {0};
+  logic_eco_t eco = {0};
+
+  int *edited = NULL;
+  int *order = NULL;
+  int *positions = NULL;
+  int *net_levels = NULL;
+
+  logic_gate_t *gate_list = NULL;
+  int *fanins = NULL;
+  logic_word_t *values = NULL;
+  uint32_t *gate_epochs = NULL;
+
+  int status = -1;
+
+  if (circuit == NULL || circuit->block_revisions == NULL) {
+    return -1;
+  }
+
+  if (report == NULL) {
+    report = &local;
+  }
+
+  memset(report, 0, sizeof(logic_eco_report_t));
+
+  /* A loop settles as a whole, placing gates by their fanins would split it */
+  if (circuit->loops > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with feedback loops are compiled "
+                                "again.");
+    return -1;
+  }
+
+  /* Blocks must map one to one onto gates */
+  if (circuit->gates != circuit->blocks) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Optimized or mapped circuits are compiled "
+                                "again.");
+    return -1;
+  }
+
+  int gates = circuit->gates;
+  int blocks = circuit->blocks;
+  int base = LOGIC_INPUT_NET(circuit->primary_inputs);
+
+  eco.edit_blocks = malloc((blocks + 1) * sizeof(int));
+  eco.block_gates = malloc((blocks + 1) * sizeof(int));
+
+  if (eco.edit_blocks == NULL || eco.block_gates == NULL ||
+      util_map_init(&eco.added_map, 64) != 0 ||
+      util_map_init(&eco.data_map, 64) != 0) {
+    goto done;
+  }
+
+  for (int g = 0; g < gates; g++) {
+    eco.block_gates[circuit->gate_list[g].block] = g;
+  }
+
+  for (int b = 0; b < blocks; b++) {
+    if (circuit->block_list[b]->revision != circuit->block_revisions[b]) {
+      eco.edit_blocks[eco.edits++] = b;
+    }
+  }
+
+  if (eco.edits == 0) {
+    report->first_gate = gates;
+    status = 0;
+    goto done;
+  }
+
+  for (int i = 0; i < circuit->primary_inputs; i++) {
+    if (util_map_put(&eco.data_map, circuit->input_list[i], i) != 0) {
+      goto done;
+    }
+  }
+
+  for (int e = 0; e < eco.edits; e++) {
+    if (logic_eco_discover(circuit, &eco,
+                           circuit->block_list[eco.edit_blocks[e]]) != 0) {
+      goto done;
+    }
+  }
+
+  int total = gates + eco.added;
+  int reads = eco.edits + eco.added;
+  int nets = circuit->nets + eco.shift;
+
+  eco.added_nets = malloc((eco.added + 1) * sizeof(int));
+  eco.fanin_offsets = malloc((reads + 1) * sizeof(int));
+  eco.floating = malloc((reads + 1) * sizeof(int));
+  eco.gate_edits = malloc((total + 1) * sizeof(int));
+
+  if (eco.added_nets == NULL || eco.fanin_offsets == NULL ||
+      eco.floating == NULL || eco.gate_edits == NULL) {
+    goto done;
+  }
+
+  /* Added gates drive nets after every existing one */
+  for (int a = 0; a < eco.added; a++) {
+    int width = eco.added_list[a]->width;
+
+    eco.added_nets[a] = nets;
+    nets += width > 1 ? width : 1;
+  }
+
+  eco.drivers = malloc((nets + 1) * sizeof(int));
+
+  if (eco.drivers == NULL) {
+    goto done;
+  }
+
+  for (int n = 0; n < nets; n++) {
+    eco.drivers[n] = -1;
+  }
+
+  for (int g = 0; g < total; g++) {
+    int output = g < gates ? circuit->gate_list[g].output + eco.shift
+                           : eco.added_nets[g - gates];
+    int width = g < gates ? circuit->gate_list[g].width
+                          : eco.added_list[g - gates]->width;
+
+    for (int b = 0; b < (width > 1 ? width : 1); b++) {
+      eco.drivers[output + b] = g;
+    }
+
+    eco.gate_edits[g] = -1;
+  }
+
+  int first = gates;
+
+  for (int e = 0; e < eco.edits; e++) {
+    int g = eco.block_gates[eco.edit_blocks[e]];
+
+    eco.gate_edits[g] = e;
+    first = g < first ? g : first;
+
+    if (logic_eco_read(circuit, &eco, circuit->block_list[eco.edit_blocks[e]],
+                       e) != 0) {
+      goto done;
+    }
+  }
+
+  for (int a = 0; a < eco.added; a++) {
+    eco.gate_edits[gates + a] = eco.edits + a;
+
+    if (logic_eco_read(circuit, &eco, eco.added_list[a], eco.edits + a) != 0) {
+      goto done;
+    }
+  }
+
+  /* Nothing before the first edited gate reads what changed */
+  int region = total - first;
+
+  edited = malloc((eco.edits + 1) * sizeof(int));
+  order = malloc((region + 1) * sizeof(int));
+  positions = malloc((region + 1) * sizeof(int));
+  net_levels = calloc(nets + 1, sizeof(int));
+
+  if (edited == NULL || order == NULL || positions == NULL ||
+      net_levels == NULL ||
+      logic_eco_order(circuit, &eco, first, total, order) != region) {
+    goto done;
+  }
+
+  int head = circuit->gate_list[first].fanin;
+  int fanin_total = head;
+
+  for (int g = first; g < total; g++) {
+    fanin_total += logic_eco_inputs(circuit, &eco, g);
+  }
+
+  gate_list =
+      logic_numa_alloc((total + 1) * sizeof(logic_gate_t), circuit->placement);
+  fanins = logic_numa_alloc((fanin_total + 1) * sizeof(int),
+                            circuit->placement);
+  values = nets != circuit->nets
+               ? logic_numa_alloc(nets * sizeof(logic_word_t),
+                                  circuit->placement)
+               : circuit->values;
+
+  if (gate_list == NULL || fanins == NULL || values == NULL) {
+    goto done;
+  }
+
+  if (circuit->gate_epochs != NULL) {
+    gate_epochs = calloc(total + 1, sizeof(uint32_t));
+
+    if (gate_epochs == NULL) {
+      goto done;
+    }
+  }
+
+  int block_ids = circuit->block_ids;
+
+  for (int a = 0; a < eco.added; a++) {
+    if (eco.added_list[a]->id >= block_ids) {
+      block_ids = eco.added_list[a]->id + 1;
+    }
+  }
+
+  /* Grown before anything changes, a failure leaves the circuit as it was */
+  size_t grown = blocks + eco.added + 1;
+
+  if (logic_eco_resize((void **)&circuit->block_list,
+                       grown * sizeof(logic_block_t *)) != 0 ||
+      logic_eco_resize((void **)&circuit->block_nets, grown * sizeof(int)) !=
+          0 ||
+      logic_eco_resize((void **)&circuit->block_revisions,
+                       grown * sizeof(uint32_t)) != 0 ||
+      logic_eco_resize((void **)&circuit->id_blocks,
+                       (block_ids + 1) * sizeof(int)) != 0 ||
+      logic_eco_resize((void **)&circuit->input_list,
+                       (circuit->primary_inputs + eco.shift + 1) *
+                           sizeof(logic_data_t *)) != 0 ||
+      logic_eco_resize((void **)&circuit->stale_list,
+                       (circuit->stale_gates + reads + 1) * sizeof(int)) != 0) {
+    goto done;
+  }
+
+  int levels = 0;
+
+  /* Gates before first keep their place, only their nets move up */
+  for (int g = 0; g < first; g++) {
+    gate_list[g] = circuit->gate_list[g];
+    gate_list[g].output += eco.shift;
+
+    for (int b = 0; b < gate_list[g].width; b++) {
+      net_levels[gate_list[g].output + b] = gate_list[g].level;
+    }
+
+    levels = gate_list[g].level > levels ? gate_list[g].level : levels;
+  }
+
+  for (int i = 0; i < head; i++) {
+    int net = circuit->fanins[i];
+
+    fanins[i] = net >= base ? net + eco.shift : net;
+  }
+
+  int fanin = head;
+
+  for (int i = first; i < total; i++) {
+    int g = order[i - first];
+    logic_gate_t gate = {0};
+
+    if (g < gates) {
+      gate = circuit->gate_list[g];
+      gate.output += eco.shift;
+    } else {
+      logic_block_t *logic_block = eco.added_list[g - gates];
+
+      gate.logic_block_type = logic_block->logic_block_type;
+      gate.output = eco.added_nets[g - gates];
+      gate.block = blocks + g - gates;
+      gate.width = logic_block->width > 1 ? logic_block->width : 1;
+      gate.parameter = logic_block->parameter;
+      gate.memory = logic_block->memory;
+      gate.truth_table = logic_block->truth_table;
+
+      if (LOGIC_IS_CELL(gate.logic_block_type)) {
+        circuit->cells += 1;
+      }
+    }
+
+    if (eco.gate_edits[g] >= 0) {
+      gate.floating = eco.floating[eco.gate_edits[g]];
+    }
+
+    gate.fanin = fanin;
+    gate.inputs = logic_eco_inputs(circuit, &eco, g);
+    gate.level = 1;
+
+    for (int j = 0; j < gate.inputs; j++) {
+      int net = logic_eco_fanin(circuit, &eco, g, j);
+
+      fanins[fanin++] = net;
+
+      if (net_levels[net] + 1 > gate.level) {
+        gate.level = net_levels[net] + 1;
+      }
+    }
+
+    for (int b = 0; b < gate.width; b++) {
+      net_levels[gate.output + b] = gate.level;
+    }
+
+    levels = gate.level > levels ? gate.level : levels;
+    report->moved_gates += g != i;
+
+    gate_list[i] = gate;
+    positions[g - first] = i;
+  }
+
+  if (values != circuit->values) {
+    memcpy(values, circuit->values, base * sizeof(logic_word_t));
+    memcpy(&values[base + eco.shift], &circuit->values[base],
+           (circuit->nets - base) * sizeof(logic_word_t));
+
+    for (int k = 0; k < eco.shift; k++) {
+      values[base + k] = eco.input_list[k]->data ? ~(logic_word_t)0 : 0;
+    }
+  }
+
+  for (int o = 0; o < circuit->outputs; o++) {
+    if (circuit->output_nets[o] >= base) {
+      circuit->output_nets[o] += eco.shift;
+    }
+  }
+
+  for (int b = 0; b < blocks; b++) {
+    if (circuit->block_nets[b] >= base) {
+      circuit->block_nets[b] += eco.shift;
+    }
+  }
+
+  for (int id = circuit->block_ids; id < block_ids; id++) {
+    circuit->id_blocks[id] = -1;
+  }
+
+  for (int a = 0; a < eco.added; a++) {
+    logic_block_t *logic_block = eco.added_list[a];
+
+    circuit->block_list[blocks + a] = logic_block;
+    circuit->block_nets[blocks + a] = eco.added_nets[a];
+    circuit->block_revisions[blocks + a] = logic_block->revision;
+    circuit->id_blocks[logic_block->id] = blocks + a;
+  }
+
+  for (int e = 0; e < eco.edits; e++) {
+    int b = eco.edit_blocks[e];
+
+    circuit->block_revisions[b] = circuit->block_list[b]->revision;
+    edited[e] = eco.block_gates[b];
+  }
+
+  for (int k = 0; k < eco.shift; k++) {
+    circuit->input_list[circuit->primary_inputs + k] = eco.input_list[k];
+  }
+
+  /* Gates pending evaluation follow the new order */
+  for (int s = 0; s < circuit->stale_gates; s++) {
+    int g = circuit->stale_list[s];
+
+    circuit->stale_list[s] = g >= first ? positions[g - first] : g;
+  }
+
+  for (int g = first; g < total; g++) {
+    if (eco.gate_edits[g] >= 0) {
+      circuit->stale_list[circuit->stale_gates++] = positions[g - first];
+    }
+  }
+
+  qsort(edited, eco.edits, sizeof(int), logic_eco_compare);
+  logic_eco_cones(circuit, edited, eco.edits, first, positions);
+
+  /* Gates before first still hold the values of the current inputs */
+  if (gate_epochs != NULL) {
+    memcpy(gate_epochs, circuit->gate_epochs, first * sizeof(uint32_t));
+
+    for (int n = 0; n < nets; n++) {
+      int g = eco.drivers[n];
+
+      eco.drivers[n] = g >= first ? positions[g - first] : g;
+    }
+
+    free(circuit->net_drivers);
+    free(circuit->gate_epochs);
+
+    circuit->net_drivers = eco.drivers;
+    circuit->gate_epochs = gate_epochs;
+    eco.drivers = NULL;
+    gate_epochs = NULL;
+  }
+
+  logic_numa_free(circuit->gate_list);
+  logic_numa_free(circuit->fanins);
+
+  if (values != circuit->values) {
+    logic_numa_free(circuit->values);
+  }
+
+  circuit->gate_list = gate_list;
+  circuit->fanins = fanins;
+  circuit->values = values;
+  gate_list = NULL;
+  fanins = NULL;
+  values = NULL;
+
+  circuit->primary_inputs += eco.shift;
+  circuit->nets = nets;
+  circuit->gates = total;
+  circuit->blocks = blocks + eco.added;
+  circuit->block_ids = block_ids;
+  circuit->levels = levels;
+
+  report->edited_gates = eco.edits;
+  report->added_gates = eco.added;
+  report->added_inputs = eco.shift;
+  report->first_gate = first;
+
+  status = 0;
+
+done:
+  if (values != NULL && values != circuit->values) {
+    logic_numa_free(values);
+  }
+
+  logic_numa_free(gate_list);
+  logic_numa_free(fanins);
+  free(gate_epochs);
+  free(edited);
+  free(order);
+  free(positions);
+  free(net_levels);
+  logic_eco_free(&eco);
+
+  return status;
+}
+
+/**************************************/
+
+static void logic_eco_evaluate(const logic_gate_t *gate, const int *fanins,
+                               logic_word_t *values) {
+  logic_word_t word = 0;
+
+  switch (gate->logic_block_type) {
+  case AND: {
+    word = ~(logic_word_t)0;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      word &= values[fanins[j]];
+    }
+
+    break;
+  }
+  case OR: {
+    for (int j = 0; j < gate->inputs; j++) {
+      word |= values[fanins[j]];
+    }
+
+    break;
+  }
+  case XOR: {
+    for (int j = 0; j < gate->inputs; j++) {
+      word ^= values[fanins[j]];
+    }
+
+    break;
+  }
+  case NOT: {
+    word = gate->inputs > 0 ? ~values[fanins[gate->inputs - 1]]
+                            : ~(logic_word_t)0;
+    break;
+  }
+  default: {
+    /* Cells write their whole bus */
+    logic_word_evaluate(gate, fanins, values);
+    return;
+  }
+  }
+
+  values[gate->output] = word;
+}
+
+int logic_circuit_evaluate_edits(logic_circuit_t *circuit) {
+  if (circuit == NULL) {
+    return -1;
+  }
+
+  if (circuit->stale_gates == 0) {
+    return 0;
+  }
+
+  qsort(circuit->stale_list, circuit->stale_gates, sizeof(int),
+        logic_eco_compare);
+
+  int first = circuit->stale_list[0];
+  int width = 1;
+
+  for (int g = first; g < circuit->gates; g++) {
+    width = circuit->gate_list[g].width > width ? circuit->gate_list[g].width
+                                                : width;
+  }
+
+  bool *changed = calloc(circuit->nets, sizeof(bool));
+  logic_word_t *previous = malloc(width * sizeof(logic_word_t));
+
+  if (changed == NULL || previous == NULL) {
+    free(changed);
+    free(previous);
+    return -1;
+  }
+
+  logic_word_t *values = circuit->values;
+  int evaluated = 0;
+  int s = 0;
+
+  for (int g = first; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+    const int *fanins = &circuit->fanins[gate->fanin];
+    bool stale = false;
+
+    while (s < circuit->stale_gates && circuit->stale_list[s] <= g) {
+      stale = stale || circuit->stale_list[s] == g;
+      s += 1;
+    }
+
+    /* Memory contents may have been written by an earlier port */
+    for (int j = 0; j < gate->inputs && !stale; j++) {
+      stale = changed[fanins[j]] || gate->logic_block_type == MEM_READ;
+    }
+
+    if (!stale) {
+      continue;
+    }
+
+    memcpy(previous, &values[gate->output],
+           gate->width * sizeof(logic_word_t));
+
+    logic_eco_evaluate(gate, fanins, values);
+    evaluated += 1;
+
+    for (int b = 0; b < gate->width; b++) {
+      changed[gate->output + b] = values[gate->output + b] != previous[b];
+    }
+  }
+
+  circuit->stale_gates = 0;
+
+  free(changed);
+  free(previous);
+
+  /* Memories take the writes once every gate is evaluated, as in a run */
+  int status = evaluated;
+
+  for (int g = first; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    if (gate->logic_block_type == MEM_WRITE &&
+        logic_memory_commit(gate->memory) != 0) {
+      status = -1;
+    }
+  }
+
+  return status;
+}
+
+void logic_eco_print_report(const logic_eco_report_t *report, FILE *stream) {
+  if (report == NULL || stream == NULL) {
+    return;
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+  LOG_SIM_FILE_PRINT(stream, "|   UPDATE        | GATES      |");
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d |", "Edited",
+                     report->edited_gates);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d |", "Added",
+                     report->added_gates);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d |", "Inputs added",
+                     report->added_inputs);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d |", "Moved",
+                     report->moved_gates);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d |", "Untouched",
+                     report->first_gate);
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,415 @@
+/**
+ * @file logsimequiv.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Simulation based equivalence checking of two circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimequiv.h"
+#include "../include/logsimvm.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+/* Exhaustive runs never enumerate more than 2^40 vectors */
+#define LOGIC_EQUIV_MAX_EXHAUSTIVE 40
+
+/*************** Structures ***************/
+
+typedef struct logic_equiv_entry {
+  uint64_t signature;
+  int side; /* 0 for circuit a, 1 for circuit b */
+  int net;
+  bool phase;
+} logic_equiv_entry_t;
+
+/*************** Function Definitions ***************/
+
+static uint64_t logic_equiv_random(uint64_t *state) {
+  /* xorshift64* */
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+
+  return *state * 0x2545F4914F6CDD1Dull;
+}
+
+static uint64_t logic_equiv_mix(uint64_t signature, logic_word_t word) {
+  signature ^= word + 0x9E3779B97F4A7C15ull + (signature << 6) +
+               (signature >> 2);
+
+  return signature;
+}
+
+static int logic_equiv_compare(const void *a, const void *b) {
+  const logic_equiv_entry_t *entry_a = a;
+  const logic_equiv_entry_t *entry_b = b;
+
+  if (entry_a->signature != entry_b->signature) {
+    return entry_a->signature < entry_b->signature ? -1 : 1;
+  }
+
+  if (entry_a->side != entry_b->side) {
+    return entry_a->side - entry_b->side;
+  }
+
+  return entry_a->net - entry_b->net;
+}
+
+/* Map every input of circuit b to the input of circuit a it is driven by */
+static int *logic_equiv_match_inputs(const logic_circuit_t *circuit_a,
+                                     const logic_circuit_t *circuit_b) {
+  util_map_t data_map;
+  int *inputs = malloc((circuit_b->primary_inputs + 1) * sizeof(int));
+  int shared = 0;
+
+  if (inputs == NULL || util_map_init(&data_map, circuit_a->primary_inputs)) {
+    free(inputs);
+    return NULL;
+  }
+
+  for (int i = 0; i < circuit_a->primary_inputs; i++) {
+    if (util_map_put(&data_map, circuit_a->input_list[i], i) != 0) {
+      util_map_free(&data_map);
+      free(inputs);
+      return NULL;
+    }
+  }
+
+  for (int i = 0; i < circuit_b->primary_inputs; i++) {
+    inputs[i] = util_map_get(&data_map, circuit_b->input_list[i]);
+    shared += inputs[i] != -1;
+  }
+
+  util_map_free(&data_map);
+
+  if (shared == circuit_b->primary_inputs) {
+    return inputs;
+  }
+
+  /* Positions only pair circuits built from separate data blocks */
+  if (shared > 0 || circuit_a->primary_inputs != circuit_b->primary_inputs) {
+    LOG_SIM_DEBUG_PRINT(stderr,
+                        "Circuits share (%d) of (%d) inputs, cannot match "
+                        "the others.",
+                        shared, circuit_b->primary_inputs);
+    free(inputs);
+    return NULL;
+  }
+
+  for (int i = 0; i < circuit_b->primary_inputs; i++) {
+    inputs[i] = i;
+  }
+
+  return inputs;
+}
+
+static void logic_equiv_match_internal(const logic_circuit_t *circuit_a,
+                                       const logic_circuit_t *circuit_b,
+                                       const uint64_t *signatures_a,
+                                       const uint64_t *signatures_b,
+                                       const bool *phases_a,
+                                       const bool *phases_b,
+                                       logic_equiv_result_t *result) {
+  int total = circuit_a->gates + circuit_b->gates;
+  logic_equiv_entry_t *entries =
+      malloc((total + 1) * sizeof(logic_equiv_entry_t));
+  result->candidate_list =
+      malloc((circuit_b->gates + 1) * sizeof(logic_equiv_pair_t));
+
+  if (entries == NULL || result->candidate_list == NULL) {
+    free(entries);
+    return;
+  }
+
+  int count = 0;
+
+  for (int g = 0; g < circuit_a->gates; g++) {
+    int net = circuit_a->gate_list[g].output;
+
+    entries[count++] =
+        (logic_equiv_entry_t){signatures_a[net], 0, net, phases_a[net]};
+  }
+
+  for (int g = 0; g < circuit_b->gates; g++) {
+    int net = circuit_b->gate_list[g].output;
+
+    entries[count++] =
+        (logic_equiv_entry_t){signatures_b[net], 1, net, phases_b[net]};
+  }
+
+  qsort(entries, count, sizeof(logic_equiv_entry_t), logic_equiv_compare);
+
+  /* Pair every net of b with the first net of a in its class */
+  for (int i = 0; i < count;) {
+    int j = i;
+
+    while (j < count && entries[j].signature == entries[i].signature) {
+      j += 1;
+    }
+
+    if (entries[i].side == 0) {
+      for (int k = i + 1; k < j; k++) {
+        if (entries[k].side == 1) {
+          result->candidate_list[result->candidates++] =
+              (logic_equiv_pair_t){entries[i].net, entries[k].net,
+                                   entries[i].phase != entries[k].phase};
+        }
+      }
+    }
+
+    i = j;
+  }
+
+  free(entries);
+}
+
+int logic_equiv_check(logic_circuit_t *circuit_a, logic_circuit_t *circuit_b,
+                      const logic_equiv_options_t *options,
+                      logic_equiv_result_t *result) {
+  logic_equiv_options_t defaults = {16, 1024, 0x5EED, false};
+
+  if (result == NULL) {
+    return -1;
+  }
+
+  /* Cleared first, so a rejected check can still be printed and freed */
+  memset(result, 0, sizeof(logic_equiv_result_t));
+  result->output = -1;
+
+  if (circuit_a == NULL || circuit_b == NULL ||
+      circuit_a->outputs != circuit_b->outputs) {
+    return -1;
+  }
+
+  /* Outputs of a loop depend on its state, not only on the inputs */
+  if (circuit_a->loops > 0 || circuit_b->loops > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with feedback loops are not "
+                                "combinational.");
+    return -1;
+  }
+
+  if (options == NULL) {
+    options = &defaults;
+  }
+
+  result->equivalent = true;
+  result->inputs = circuit_a->primary_inputs;
+  result->outputs = circuit_a->outputs;
+
+  int *input_map = logic_equiv_match_inputs(circuit_a, circuit_b);
+  logic_vm_program_t *program_a = logic_vm_compile(circuit_a);
+  logic_vm_program_t *program_b = logic_vm_compile(circuit_b);
+  logic_word_t *words = calloc(circuit_a->primary_inputs + 1,
+                               sizeof(logic_word_t));
+
+  result->counterexample = calloc(circuit_a->primary_inputs + 1, sizeof(int));
+  result->signatures = calloc(circuit_a->outputs + 1, sizeof(uint64_t));
+
+  uint64_t *signatures_a = NULL;
+  uint64_t *signatures_b = NULL;
+  bool *phases_a = NULL;
+  bool *phases_b = NULL;
+
+  if (options->match_internal) {
+    signatures_a = calloc(circuit_a->nets, sizeof(uint64_t));
+    signatures_b = calloc(circuit_b->nets, sizeof(uint64_t));
+    phases_a = calloc(circuit_a->nets, sizeof(bool));
+    phases_b = calloc(circuit_b->nets, sizeof(bool));
+  }
+
+  if (input_map == NULL || program_a == NULL || program_b == NULL ||
+      words == NULL || result->counterexample == NULL ||
+      result->signatures == NULL ||
+      (options->match_internal &&
+       (signatures_a == NULL || signatures_b == NULL || phases_a == NULL ||
+        phases_b == NULL))) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits cannot be compared.");
+
+    free(input_map);
+    free(words);
+    free(signatures_a);
+    free(signatures_b);
+    free(phases_a);
+    free(phases_b);
+    logic_vm_free(program_a);
+    logic_vm_free(program_b);
+    logic_equiv_result_free(result);
+    return -1;
+  }
+
+  int inputs = circuit_a->primary_inputs;
+  long blocks = options->random_words;
+  logic_word_t last_mask = ~(logic_word_t)0;
+  uint64_t state = options->seed != 0 ? options->seed : 0x5EED;
+
+  result->exhaustive = inputs <= options->exhaustive_inputs &&
+                       inputs <= LOGIC_EQUIV_MAX_EXHAUSTIVE;
+
+  if (result->exhaustive) {
+    long vectors = 1L << inputs;
+
+    blocks = (vectors + LOGIC_LANES - 1) / LOGIC_LANES;
+
+    if (vectors < LOGIC_LANES) {
+      last_mask = ((logic_word_t)1 << vectors) - 1;
+    }
+  }
+
+  /* Lane patterns enumerating the six lowest inputs within a word */
+  static const logic_word_t lane_patterns[6] = {
+      0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+      0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull};
+
+  for (long block = 0; block < blocks; block++) {
+    logic_word_t mask = block == blocks - 1 ? last_mask : ~(logic_word_t)0;
+
+    for (int i = 0; i < inputs; i++) {
+      if (!result->exhaustive) {
+        words[i] = logic_equiv_random(&state);
+      } else if (i < 6) {
+        words[i] = lane_patterns[i];
+      } else {
+        words[i] = (block >> (i - 6)) & 1 ? ~(logic_word_t)0 : 0;
+      }
+
+      logic_circuit_set_input(circuit_a, i, words[i]);
+    }
+
+    for (int i = 0; i < circuit_b->primary_inputs; i++) {
+      logic_circuit_set_input(circuit_b, i, words[input_map[i]]);
+    }
+
+    logic_vm_run(program_a, circuit_a->values);
+    logic_vm_run(program_b, circuit_b->values);
+
+    result->vectors += __builtin_popcountll(mask);
+
+    if (options->match_internal) {
+      for (int n = 0; n < circuit_a->nets; n++) {
+        if (block == 0) {
+          phases_a[n] = circuit_a->values[n] & 1;
+        }
+
+        logic_word_t word = phases_a[n] ? ~circuit_a->values[n]
+                                        : circuit_a->values[n];
+
+        signatures_a[n] = logic_equiv_mix(signatures_a[n], word & mask);
+      }
+
+      for (int n = 0; n < circuit_b->nets; n++) {
+        if (block == 0) {
+          phases_b[n] = circuit_b->values[n] & 1;
+        }
+
+        logic_word_t word = phases_b[n] ? ~circuit_b->values[n]
+                                        : circuit_b->values[n];
+
+        signatures_b[n] = logic_equiv_mix(signatures_b[n], word & mask);
+      }
+    }
+
+    int mismatch = -1;
+    logic_word_t difference = 0;
+
+    for (int o = 0; o < circuit_a->outputs; o++) {
+      logic_word_t word_a = circuit_a->values[circuit_a->output_nets[o]];
+      logic_word_t word_b = circuit_b->values[circuit_b->output_nets[o]];
+
+      result->signatures[o] = logic_equiv_mix(result->signatures[o],
+                                              word_a & mask);
+
+      if (mismatch == -1 && ((word_a ^ word_b) & mask) != 0) {
+        mismatch = o;
+        difference = (word_a ^ word_b) & mask;
+      }
+    }
+
+    /* Stop at the first mismatching block */
+    if (mismatch != -1) {
+      int lane = __builtin_ctzll(difference);
+
+      result->equivalent = false;
+      result->output = mismatch;
+
+      for (int i = 0; i < inputs; i++) {
+        result->counterexample[i] = (int)((words[i] >> lane) & 1);
+      }
+
+      break;
+    }
+  }
+
+  if (options->match_internal) {
+    logic_equiv_match_internal(circuit_a, circuit_b, signatures_a,
+                               signatures_b, phases_a, phases_b, result);
+  }
+
+  free(input_map);
+  free(words);
+  free(signatures_a);
+  free(signatures_b);
+  free(phases_a);
+  free(phases_b);
+  logic_vm_free(program_a);
+  logic_vm_free(program_b);
+
+  return 0;
+}
+
+void logic_equiv_print_result(const logic_equiv_result_t *result,
+                              FILE *stream) {
+  if (result == NULL || stream == NULL) {
+    return;
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "Vectors simulated (%ld, %s).", result->vectors,
+                     result->exhaustive ? "exhaustive" : "random");
+
+  if (result->equivalent) {
+    LOG_SIM_FILE_PRINT(stream, "Circuits are %s.",
+                       result->exhaustive ? "equivalent"
+                                          : "equivalent on every vector");
+  } else {
+    LOG_SIM_FILE_PRINT(stream, "Output (%d) differs, counterexample:",
+                       result->output);
+
+    for (int i = 0; i < result->inputs; i++) {
+      LOG_SIM_FILE_PRINT(stream, "INPUT (%d) = %d", i,
+                         result->counterexample[i]);
+    }
+  }
+
+  if (result->candidate_list != NULL) {
+    LOG_SIM_FILE_PRINT(stream, "Candidate equivalent internal nets (%d).",
+                       result->candidates);
+  }
+}
+
+void logic_equiv_result_free(logic_equiv_result_t *result) {
+  if (result == NULL) {
+    return;
+  }
+
+  free(result->counterexample);
+  free(result->signatures);
+  free(result->candidate_list);
+
+  result->counterexample = NULL;
+  result->signatures = NULL;
+  result->candidate_list = NULL;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
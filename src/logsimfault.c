@@ -0,0 +1,593 @@
+/**
+ * @file logsimfault.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Parallel pattern stuck-at fault simulation.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimfault.h"
+#include "../include/logsimnuma.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+/* Faults handed to a worker at a time */
+#define LOGIC_FAULT_CHUNK 64
+
+/* Evaluate a gate with none of its pins forced */
+#define LOGIC_FAULT_NO_PIN -2
+
+/*************** Structures ***************/
+
+typedef struct logic_fault_run {
+  const logic_word_t *patterns;
+  long total_patterns;
+  long blocks;
+
+  logic_word_t mask; /* Lanes holding a pattern in the current block */
+  long block;
+  int next_fault;
+
+  /* Workers start once the barrier is sized for the threads created */
+  pthread_mutex_t mutex;
+  pthread_cond_t ready_cond;
+  bool ready;
+
+  pthread_barrier_t barrier;
+
+  logic_topology_t *topology; /* Workers are pinned when set */
+  bool failed;                /* A worker could not allocate its arrays */
+} logic_fault_run_t;
+
+typedef struct logic_fault_worker {
+  logic_fault_sim_t *fault_sim;
+  logic_fault_run_t *run;
+
+  pthread_t thread;
+  int id;
+
+  /* Faulty values, only valid for nets stamped with the current fault */
+  logic_word_t *faulty;
+  uint32_t *net_stamps;
+  uint32_t *gate_stamps;
+  uint32_t stamp;
+
+  int *queue;
+  int *level_fill;
+
+  int detected;
+} logic_fault_worker_t;
+
+/*************** Function Definitions ***************/
+
+logic_fault_sim_t *logic_fault_sim_create(logic_circuit_t *circuit,
+                                          int threads) {
+  if (circuit == NULL) {
+    return NULL;
+  }
+
+  /* Faults propagate level by level, feedback would need sequential ATPG */
+  if (circuit->loops > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with feedback loops are not fault "
+                                "simulated.");
+    return NULL;
+  }
+
+  /* Faults sit on gate pins, a cell has no single bit pins to fault */
+  if (circuit->cells > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with word level cells are not "
+                                "fault simulated.");
+    return NULL;
+  }
+
+  logic_fault_sim_t *fault_sim = calloc(1, sizeof(logic_fault_sim_t));
+
+  if (fault_sim == NULL) {
+    return NULL;
+  }
+
+  int faults = 0;
+  int fanin_total = 0;
+
+  for (int g = 0; g < circuit->gates; g++) {
+    faults += 2 * (circuit->gate_list[g].inputs + 1);
+    fanin_total += circuit->gate_list[g].inputs;
+  }
+
+  fault_sim->circuit = circuit;
+  fault_sim->threads = threads > 0 ? threads : 1;
+  fault_sim->faults = faults;
+
+  fault_sim->program = logic_vm_compile(circuit);
+  fault_sim->fault_list = calloc(faults + 1, sizeof(logic_fault_t));
+  fault_sim->fanout_offsets = calloc(circuit->nets + 1, sizeof(int));
+  fault_sim->fanout_list = calloc(fanin_total + 1, sizeof(int));
+  fault_sim->net_drivers = malloc(circuit->nets * sizeof(int));
+  fault_sim->output_nets = calloc(circuit->nets, sizeof(bool));
+  fault_sim->level_offsets = calloc(circuit->levels + 2, sizeof(int));
+
+  if (fault_sim->program == NULL || fault_sim->fault_list == NULL ||
+      fault_sim->fanout_offsets == NULL || fault_sim->fanout_list == NULL ||
+      fault_sim->net_drivers == NULL || fault_sim->output_nets == NULL ||
+      fault_sim->level_offsets == NULL) {
+    logic_fault_sim_free(fault_sim);
+    return NULL;
+  }
+
+  /* Stuck-at 0 and 1 on every gate output and input pin */
+  int f = 0;
+
+  for (int g = 0; g < circuit->gates; g++) {
+    for (int pin = LOGIC_FAULT_OUTPUT; pin < circuit->gate_list[g].inputs;
+         pin++) {
+      for (int stuck_at = 0; stuck_at <= 1; stuck_at++) {
+        fault_sim->fault_list[f++] =
+            (logic_fault_t){g, pin, stuck_at, false, -1};
+      }
+    }
+  }
+
+  /* Fanout lists in compressed rows */
+  for (int g = 0; g < circuit->gates; g++) {
+    logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      fault_sim->fanout_offsets[circuit->fanins[gate->fanin + j] + 1] += 1;
+    }
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    fault_sim->fanout_offsets[n + 1] += fault_sim->fanout_offsets[n];
+    fault_sim->net_drivers[n] = -1;
+  }
+
+  int *fill = calloc(circuit->nets + 1, sizeof(int));
+
+  if (fill == NULL) {
+    logic_fault_sim_free(fault_sim);
+    return NULL;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int net = circuit->fanins[gate->fanin + j];
+
+      /* A gate reading a net twice is queued once anyway */
+      fault_sim->fanout_list[fault_sim->fanout_offsets[net] + fill[net]++] = g;
+    }
+
+    fault_sim->net_drivers[gate->output] = g;
+    fault_sim->level_offsets[gate->level + 1] += 1;
+  }
+
+  free(fill);
+
+  for (int l = 0; l <= circuit->levels; l++) {
+    fault_sim->level_offsets[l + 1] += fault_sim->level_offsets[l];
+  }
+
+  for (int i = 0; i < circuit->outputs; i++) {
+    fault_sim->output_nets[circuit->output_nets[i]] = true;
+  }
+
+  return fault_sim;
+}
+
+static inline logic_word_t logic_fault_read(const logic_fault_worker_t *worker,
+                                            const logic_word_t *good,
+                                            int net) {
+  return worker->net_stamps[net] == worker->stamp ? worker->faulty[net]
+                                                  : good[net];
+}
+
+static logic_word_t logic_fault_eval_gate(const logic_fault_worker_t *worker,
+                                          const logic_circuit_t *circuit,
+                                          const logic_gate_t *gate,
+                                          int forced_pin,
+                                          logic_word_t forced) {
+  const logic_word_t *good = circuit->values;
+  const int *fanins = &circuit->fanins[gate->fanin];
+  logic_word_t word = 0;
+
+  if (gate->logic_block_type == NOT) {
+    if (gate->inputs == 0) {
+      return ~(logic_word_t)0;
+    }
+
+    int last = gate->inputs - 1;
+
+    return ~(last == forced_pin ? forced
+                                : logic_fault_read(worker, good, fanins[last]));
+  }
+
+  if (gate->logic_block_type == AND) {
+    word = ~(logic_word_t)0;
+  }
+
+  for (int j = 0; j < gate->inputs; j++) {
+    logic_word_t in =
+        j == forced_pin ? forced : logic_fault_read(worker, good, fanins[j]);
+
+    switch (gate->logic_block_type) {
+    case AND:
+      word &= in;
+      break;
+    case OR:
+      word |= in;
+      break;
+    case XOR:
+      word ^= in;
+      break;
+    case NOT:
+      break;
+    default:
+      break;
+    }
+  }
+
+  return word;
+}
+
+static void logic_fault_enqueue_fanouts(logic_fault_worker_t *worker,
+                                        int net) {
+  logic_fault_sim_t *fault_sim = worker->fault_sim;
+  const logic_circuit_t *circuit = fault_sim->circuit;
+
+  for (int k = fault_sim->fanout_offsets[net];
+       k < fault_sim->fanout_offsets[net + 1]; k++) {
+    int g = fault_sim->fanout_list[k];
+    int level = circuit->gate_list[g].level;
+
+    if (worker->gate_stamps[g] == worker->stamp) {
+      continue;
+    }
+
+    worker->gate_stamps[g] = worker->stamp;
+    worker->queue[fault_sim->level_offsets[level] + worker->level_fill[level]++] =
+        g;
+  }
+}
+
+/* Returns the lanes of the block in which the fault reaches an output */
+static logic_word_t logic_fault_propagate(logic_fault_worker_t *worker,
+                                          const logic_fault_t *fault,
+                                          logic_word_t mask) {
+  logic_fault_sim_t *fault_sim = worker->fault_sim;
+  const logic_circuit_t *circuit = fault_sim->circuit;
+  const logic_word_t *good = circuit->values;
+  const logic_gate_t *site = &circuit->gate_list[fault->gate];
+  logic_word_t stuck = fault->stuck_at ? ~(logic_word_t)0 : 0;
+
+  worker->stamp += 1;
+
+  if (worker->stamp == 0) {
+    memset(worker->net_stamps, 0, circuit->nets * sizeof(uint32_t));
+    memset(worker->gate_stamps, 0, (circuit->gates + 1) * sizeof(uint32_t));
+    worker->stamp = 1;
+  }
+
+  logic_word_t value =
+      fault->pin == LOGIC_FAULT_OUTPUT
+          ? stuck
+          : logic_fault_eval_gate(worker, circuit, site, fault->pin, stuck);
+
+  /* Not excited, or masked at the faulty gate */
+  if (((value ^ good[site->output]) & mask) == 0) {
+    return 0;
+  }
+
+  worker->faulty[site->output] = value;
+  worker->net_stamps[site->output] = worker->stamp;
+
+  if (fault_sim->output_nets[site->output]) {
+    return (value ^ good[site->output]) & mask;
+  }
+
+  logic_fault_enqueue_fanouts(worker, site->output);
+
+  /* No lane before the first excited one can detect the fault */
+  logic_word_t excited = (value ^ good[site->output]) & mask;
+  logic_word_t first_lane = excited & (0 - excited);
+
+  logic_word_t detected = 0;
+  int level = site->level + 1;
+
+  /* Walk the fanout cone level by level, events only */
+  for (; level <= circuit->levels && (detected & first_lane) == 0; level++) {
+    int *segment = &worker->queue[fault_sim->level_offsets[level]];
+
+    for (int k = 0; k < worker->level_fill[level]; k++) {
+      const logic_gate_t *gate = &circuit->gate_list[segment[k]];
+      logic_word_t word = logic_fault_eval_gate(
+          worker, circuit, gate, LOGIC_FAULT_NO_PIN, 0);
+      logic_word_t difference = (word ^ good[gate->output]) & mask;
+
+      if (difference == 0) {
+        continue;
+      }
+
+      worker->faulty[gate->output] = word;
+      worker->net_stamps[gate->output] = worker->stamp;
+
+      if (fault_sim->output_nets[gate->output]) {
+        detected |= difference;
+      }
+
+      logic_fault_enqueue_fanouts(worker, gate->output);
+    }
+
+    worker->level_fill[level] = 0;
+  }
+
+  /* Early exit leaves queued gates behind */
+  for (; level <= circuit->levels; level++) {
+    worker->level_fill[level] = 0;
+  }
+
+  return detected;
+}
+
+static void *logic_fault_worker_main(void *argument) {
+  logic_fault_worker_t *worker = argument;
+  logic_fault_sim_t *fault_sim = worker->fault_sim;
+  logic_fault_run_t *run = worker->run;
+  logic_circuit_t *circuit = fault_sim->circuit;
+
+  pthread_mutex_lock(&run->mutex);
+
+  while (!run->ready) {
+    pthread_cond_wait(&run->ready_cond, &run->mutex);
+  }
+
+  pthread_mutex_unlock(&run->mutex);
+
+  /* Pinned before allocating, so its arrays are touched on its node */
+  if (run->topology != NULL) {
+    logic_topology_pin(logic_topology_cpu(run->topology, worker->id, false));
+  }
+
+  int placement = circuit->placement;
+
+  worker->faulty =
+      logic_numa_alloc(circuit->nets * sizeof(logic_word_t), placement);
+  worker->net_stamps =
+      logic_numa_alloc(circuit->nets * sizeof(uint32_t), placement);
+  worker->gate_stamps =
+      logic_numa_alloc((circuit->gates + 1) * sizeof(uint32_t), placement);
+  worker->queue =
+      logic_numa_alloc((circuit->gates + 1) * sizeof(int), placement);
+  worker->level_fill =
+      logic_numa_alloc((circuit->levels + 2) * sizeof(int), placement);
+
+  if (worker->faulty == NULL || worker->net_stamps == NULL ||
+      worker->gate_stamps == NULL || worker->queue == NULL ||
+      worker->level_fill == NULL) {
+    __atomic_store_n(&run->failed, true, __ATOMIC_RELAXED);
+  }
+
+  /* Every worker gives up together, none is left waiting on a barrier */
+  pthread_barrier_wait(&run->barrier);
+
+  for (long block = 0; block < run->blocks && !run->failed; block++) {
+    /* Worker 0 simulates the good machine for the block */
+    if (worker->id == 0) {
+      const logic_word_t *words =
+          &run->patterns[block * circuit->primary_inputs];
+      long lanes = run->total_patterns - block * LOGIC_LANES;
+
+      for (int i = 0; i < circuit->primary_inputs; i++) {
+        logic_circuit_set_input(circuit, i, words[i]);
+      }
+
+      logic_vm_run(fault_sim->program, circuit->values);
+
+      run->mask = lanes >= LOGIC_LANES ? ~(logic_word_t)0
+                                       : (((logic_word_t)1 << lanes) - 1);
+      run->block = block;
+      run->next_fault = 0;
+    }
+
+    pthread_barrier_wait(&run->barrier);
+
+    for (;;) {
+      int first =
+          __atomic_fetch_add(&run->next_fault, LOGIC_FAULT_CHUNK,
+                             __ATOMIC_RELAXED);
+
+      if (first >= fault_sim->faults) {
+        break;
+      }
+
+      int last = first + LOGIC_FAULT_CHUNK < fault_sim->faults
+                     ? first + LOGIC_FAULT_CHUNK
+                     : fault_sim->faults;
+
+      for (int f = first; f < last; f++) {
+        logic_fault_t *fault = &fault_sim->fault_list[f];
+
+        /* Fault dropping */
+        if (fault->detected) {
+          continue;
+        }
+
+        logic_word_t lanes = logic_fault_propagate(worker, fault, run->mask);
+
+        if (lanes != 0) {
+          fault->detected = true;
+          fault->pattern = fault_sim->patterns + block * LOGIC_LANES +
+                           __builtin_ctzll(lanes);
+          worker->detected += 1;
+        }
+      }
+    }
+
+    pthread_barrier_wait(&run->barrier);
+  }
+
+  logic_numa_free(worker->faulty);
+  logic_numa_free(worker->net_stamps);
+  logic_numa_free(worker->gate_stamps);
+  logic_numa_free(worker->queue);
+  logic_numa_free(worker->level_fill);
+
+  return NULL;
+}
+
+int logic_fault_sim_run(logic_fault_sim_t *fault_sim,
+                        const logic_word_t *patterns, long total_patterns,
+                        logic_fault_report_t *report) {
+  if (fault_sim == NULL || patterns == NULL || total_patterns < 0) {
+    return -1;
+  }
+
+  logic_circuit_t *circuit = fault_sim->circuit;
+  logic_fault_run_t run = {0};
+  int threads = fault_sim->threads;
+  int status = 0;
+
+  run.patterns = patterns;
+  run.total_patterns = total_patterns;
+  run.blocks = (total_patterns + LOGIC_LANES - 1) / LOGIC_LANES;
+
+  logic_fault_worker_t *workers =
+      calloc(threads, sizeof(logic_fault_worker_t));
+
+  if (workers == NULL) {
+    return -1;
+  }
+
+  for (int t = 0; t < threads; t++) {
+    workers[t].fault_sim = fault_sim;
+    workers[t].run = &run;
+    workers[t].id = t;
+  }
+
+  /* Pinned workers all get a thread, the caller keeps its own affinity */
+  run.topology = (circuit->placement & LOGIC_PLACE_PIN_WORKERS)
+                     ? logic_topology_create()
+                     : NULL;
+
+  int first = run.topology != NULL ? 0 : 1;
+  int started = first;
+
+  pthread_mutex_init(&run.mutex, NULL);
+  pthread_cond_init(&run.ready_cond, NULL);
+
+  for (; started < threads; started++) {
+    if (pthread_create(&workers[started].thread, NULL,
+                       logic_fault_worker_main, &workers[started]) != 0) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Failed to start fault worker (%d).",
+                          started);
+      break;
+    }
+  }
+
+  /* Faults are claimed in chunks, so fewer workers still cover them all */
+  if (started > 0) {
+    pthread_barrier_init(&run.barrier, NULL, started);
+
+    pthread_mutex_lock(&run.mutex);
+    run.ready = true;
+    pthread_cond_broadcast(&run.ready_cond);
+    pthread_mutex_unlock(&run.mutex);
+
+    if (first == 1) {
+      logic_fault_worker_main(&workers[0]);
+    }
+
+    for (int t = first; t < started; t++) {
+      pthread_join(workers[t].thread, NULL);
+    }
+
+    pthread_barrier_destroy(&run.barrier);
+  }
+
+  pthread_cond_destroy(&run.ready_cond);
+  pthread_mutex_destroy(&run.mutex);
+  logic_topology_free(run.topology);
+
+  if (started == 0 || run.failed) {
+    status = -1;
+  }
+
+  int new_detected = 0;
+
+  for (int t = 0; t < threads; t++) {
+    new_detected += workers[t].detected;
+  }
+
+  free(workers);
+
+  if (status != 0) {
+    return -1;
+  }
+
+  fault_sim->detected += new_detected;
+  fault_sim->patterns += total_patterns;
+
+  if (report != NULL) {
+    report->patterns = total_patterns;
+    report->faults = fault_sim->faults;
+    report->detected = fault_sim->detected;
+    report->new_detected = new_detected;
+    report->coverage = fault_sim->faults > 0 ? 100.0 * fault_sim->detected /
+                                                   fault_sim->faults
+                                             : 100.0;
+  }
+
+  return 0;
+}
+
+void logic_fault_print_report(const logic_fault_report_t *report,
+                              FILE *stream) {
+  if (report == NULL || stream == NULL) {
+    return;
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+  LOG_SIM_FILE_PRINT(stream, "|   FAULT SIM     | VALUE      |");
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10ld |", "Patterns",
+                     report->patterns);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d |", "Faults", report->faults);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d |", "New detected",
+                     report->new_detected);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d |", "Detected",
+                     report->detected);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-9.2f%% |", "Coverage",
+                     report->coverage);
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+}
+
+void logic_fault_sim_free(logic_fault_sim_t *fault_sim) {
+  if (fault_sim == NULL) {
+    return;
+  }
+
+  logic_vm_free(fault_sim->program);
+
+  free(fault_sim->fault_list);
+  free(fault_sim->fanout_offsets);
+  free(fault_sim->fanout_list);
+  free(fault_sim->net_drivers);
+  free(fault_sim->output_nets);
+  free(fault_sim->level_offsets);
+  free(fault_sim);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
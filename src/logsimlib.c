@@ -12,82 +12,344 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
 /*************** C Custom Headers ***************/
 
+#include "../include/logsimcircuit.h"
 #include "../include/logsimlib.h"
+#include "../include/logsimopt.h"
+#include "../include/logsimvm.h"
+#include "../include/logsimxsim.h"
 #include "../include/utils.h"
 
-/*************** Variables ***************/
+/*************** Function Definitions ***************/
+
+logic_sim_t *logic_sim_create() {
+  logic_sim_t *sim = calloc(1, sizeof(logic_sim_t));
 
-GVC_t *g_graphviz_context = NULL;
-Agraph_t *g_graphviz_graph = NULL;
+  if (sim == NULL) {
+    return NULL;
+  }
 
-FILE *g_log_file = NULL;
-FILE *g_debug_log_file = NULL;
+  sim->console = stdout;
+  sim->names = malloc(sizeof(util_interner_t));
 
-/*************** Function Definitions ***************/
+  if (sim->names == NULL || util_interner_init(sim->names, 64) != 0) {
+    free(sim->names);
+    free(sim);
+    return NULL;
+  }
+
+  return sim;
+}
+
+void logic_sim_free(logic_sim_t *sim) {
+  if (sim == NULL) {
+    return;
+  }
+
+  if (sim->graphviz_graph != NULL) {
+    agclose(sim->graphviz_graph);
+    gvFreeContext(sim->graphviz_context);
+  }
+
+  logic_utility_terminate(sim);
+
+  for (int i = 0; i < sim->allocations; i++) {
+    free(sim->allocation_list[i]);
+  }
+
+  free(sim->allocation_list);
+  free(sim->block_list);
+
+  util_interner_free(sim->names);
+
+  free(sim->names);
+  free(sim->name_blocks);
+  free(sim->scope_list);
+  free(sim);
+}
+
+void *logic_sim_alloc(logic_sim_t *sim, size_t size) {
+  if (sim->allocations == sim->allocation_capacity) {
+    int capacity =
+        sim->allocation_capacity > 0 ? sim->allocation_capacity * 2 : 64;
+    void **allocation_list =
+        realloc(sim->allocation_list, capacity * sizeof(void *));
+
+    if (allocation_list == NULL) {
+      return NULL;
+    }
+
+    sim->allocation_list = allocation_list;
+    sim->allocation_capacity = capacity;
+  }
+
+  void *memory = calloc(1, size > 0 ? size : 1);
+
+  if (memory != NULL) {
+    sim->allocation_list[sim->allocations++] = memory;
+  }
+
+  return memory;
+}
+
+/* Intern a string, strings not naming a block map to -1 in name_blocks */
+static int logic_sim_intern(logic_sim_t *sim, const char *string) {
+  int id = util_intern(sim->names, string);
+
+  if (id < 0) {
+    return -1;
+  }
+
+  if (id >= sim->name_capacity) {
+    int capacity = sim->name_capacity > 0 ? sim->name_capacity : 32;
+
+    while (capacity <= id) {
+      capacity *= 2;
+    }
+
+    int *name_blocks = realloc(sim->name_blocks, capacity * sizeof(int));
+
+    if (name_blocks == NULL) {
+      return -1;
+    }
+
+    memset(&name_blocks[sim->name_capacity], -1,
+           (capacity - sim->name_capacity) * sizeof(int));
+
+    sim->name_blocks = name_blocks;
+    sim->name_capacity = capacity;
+  }
+
+  return id;
+}
+
+/* Path of name in the innermost scope, the caller frees it */
+static char *logic_sim_path(logic_sim_t *sim, const char *name) {
+  const char *scope =
+      sim->scopes > 0
+          ? util_interner_string(sim->names, sim->scope_list[sim->scopes - 1])
+          : NULL;
+  size_t size = strlen(name) + (scope != NULL ? strlen(scope) + 1 : 0) + 16;
+  char *path = malloc(size);
+
+  if (path == NULL) {
+    return NULL;
+  }
+
+  if (scope != NULL) {
+    snprintf(path, size, "%s/%s", scope, name);
+  } else {
+    snprintf(path, size, "%s", name);
+  }
+
+  return path;
+}
+
+int logic_sim_name_block(logic_sim_t *sim, logic_block_t *logic_block,
+                         const char *name, const char *prefix) {
+  if (sim->blocks == sim->block_capacity) {
+    int capacity = sim->block_capacity > 0 ? sim->block_capacity * 2 : 64;
+    logic_block_t **block_list =
+        realloc(sim->block_list, capacity * sizeof(logic_block_t *));
+
+    if (block_list == NULL) {
+      return -1;
+    }
+
+    sim->block_list = block_list;
+    sim->block_capacity = capacity;
+  }
+
+  name = name != NULL ? name : "";
+
+  char *path = logic_sim_path(sim, name);
+
+  if (path == NULL) {
+    return -1;
+  }
+
+  size_t length = strlen(path);
+  int id = util_interner_find(sim->names, path);
+
+  /* Names taken in the scope get a suffix, so blocks never merge */
+  for (int n = 2; id != -1 && id < sim->name_capacity &&
+                  sim->name_blocks[id] != -1;
+       n++) {
+    snprintf(&path[length], 16, "#%d", n);
+    id = util_interner_find(sim->names, path);
+  }
 
-void logic_graph_init(char *name) {
-  g_graphviz_context = gvContext();
-  g_graphviz_graph = agopen(name, Agundirected, NULL);
+  if (path[length] != '\0') {
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Block (%s) renamed to (%s).",
+                        name, path);
+  }
+
+  int path_id = logic_sim_intern(sim, path);
+  int name_id = logic_sim_intern(sim, name);
+  int prefix_id = prefix != NULL ? logic_sim_intern(sim, prefix) : -2;
+
+  free(path);
+
+  if (path_id < 0 || name_id < 0 || prefix_id == -1) {
+    return -1;
+  }
+
+  logic_block->id = sim->blocks;
+  logic_block->path = util_interner_string(sim->names, path_id);
+  logic_block->name = util_interner_string(sim->names, name_id);
+  logic_block->prefix =
+      prefix != NULL ? util_interner_string(sim->names, prefix_id) : NULL;
+
+  sim->name_blocks[path_id] = logic_block->id;
+  sim->block_list[sim->blocks++] = logic_block;
+
+  return 0;
+}
+
+int logic_sim_enter(logic_sim_t *sim, const char *name) {
+  if (sim == NULL || name == NULL) {
+    return -1;
+  }
+
+  if (sim->scopes == sim->scope_capacity) {
+    int capacity = sim->scope_capacity > 0 ? sim->scope_capacity * 2 : 8;
+    int *scope_list = realloc(sim->scope_list, capacity * sizeof(int));
+
+    if (scope_list == NULL) {
+      return -1;
+    }
+
+    sim->scope_list = scope_list;
+    sim->scope_capacity = capacity;
+  }
+
+  char *path = logic_sim_path(sim, name);
+  int id = path != NULL ? logic_sim_intern(sim, path) : -1;
+
+  free(path);
+
+  if (id < 0) {
+    return -1;
+  }
+
+  sim->scope_list[sim->scopes++] = id;
+
+  return 0;
+}
+
+int logic_sim_leave(logic_sim_t *sim) {
+  if (sim == NULL || sim->scopes == 0) {
+    return -1;
+  }
 
-  agattr(g_graphviz_graph, AGNODE, "shape", "ellipse");
+  sim->scopes -= 1;
 
-  agattr(g_graphviz_graph, AGRAPH, "rankdir", "LR");
-  agattr(g_graphviz_graph, AGRAPH, "splines", "ortho");
+  return 0;
+}
+
+logic_block_t *logic_find_block(const logic_sim_t *sim, const char *path) {
+  if (sim == NULL || path == NULL) {
+    return NULL;
+  }
+
+  int id = util_interner_find(sim->names, path);
+
+  if (id == -1 || id >= sim->name_capacity || sim->name_blocks[id] == -1) {
+    return NULL;
+  }
+
+  return sim->block_list[sim->name_blocks[id]];
 }
 
-void logic_graph_export(char *name) {
-  gvLayout(g_graphviz_context, g_graphviz_graph, "dot");
+void logic_graph_init(logic_sim_t *sim, char *name) {
+  sim->graphviz_context = gvContext();
+  sim->graphviz_graph = agopen(name, Agundirected, NULL);
+
+  agattr(sim->graphviz_graph, AGNODE, "shape", "ellipse");
+
+  agattr(sim->graphviz_graph, AGRAPH, "rankdir", "LR");
+  agattr(sim->graphviz_graph, AGRAPH, "splines", "ortho");
+}
+
+void logic_graph_export(logic_sim_t *sim, char *name) {
+  if (sim->graphviz_graph == NULL) {
+    return;
+  }
+
+  gvLayout(sim->graphviz_context, sim->graphviz_graph, "dot");
 
   char svg_path[1024];
   snprintf(svg_path, sizeof(svg_path), "%s/%s", DIR_SVG, name);
 
   mkdir(DIR_SVG, 0755);
 
-  gvRenderFilename(g_graphviz_context, g_graphviz_graph, "svg", svg_path);
+  gvRenderFilename(sim->graphviz_context, sim->graphviz_graph, "svg",
+                   svg_path);
 
-  gvFreeLayout(g_graphviz_context, g_graphviz_graph);
-  agclose(g_graphviz_graph);
-  gvFreeContext(g_graphviz_context);
+  gvFreeLayout(sim->graphviz_context, sim->graphviz_graph);
+  agclose(sim->graphviz_graph);
+  gvFreeContext(sim->graphviz_context);
+
+  sim->graphviz_graph = NULL;
+  sim->graphviz_context = NULL;
 }
 
-void logic_utility_init(char *name) {
+void logic_utility_init(logic_sim_t *sim, char *name) {
 
   char log_path[1024];
   snprintf(log_path, sizeof(log_path), "%s/%s", DIR_LOG, name);
 
   mkdir(DIR_LOG, 0755);
 
-  g_log_file = fopen(log_path, "w");
+  sim->log_file = fopen(log_path, "w");
 
-  LOG_SIM_FILE_PRINT(g_log_file, "+-----------------+--------+-------+");
-  LOG_SIM_FILE_PRINT(g_log_file, "|   BLOCK         | TYPE   | DATA  |");
-  LOG_SIM_FILE_PRINT(g_log_file, "+-----------------+--------+-------+");
+  LOG_SIM_FILE_PRINT(sim->log_file, "+-----------------+--------+-------+");
+  LOG_SIM_FILE_PRINT(sim->log_file, "|   BLOCK         | TYPE   | DATA  |");
+  LOG_SIM_FILE_PRINT(sim->log_file, "+-----------------+--------+-------+");
 
   /**************************************/
 
+  /* Each context gets its own debug log, named after its block log */
+  const char *extension = strrchr(name, '.');
+  int length = extension != NULL ? (int)(extension - name) : (int)strlen(name);
+
   memset(log_path, 0, sizeof(log_path));
-  snprintf(log_path, sizeof(log_path), "%s/%s", DIR_LOG, "debug.log");
+  snprintf(log_path, sizeof(log_path), "%s/%.*s.debug.log", DIR_LOG, length,
+           name);
 
-  g_debug_log_file = fopen(log_path, "w");
+  sim->debug_log_file = fopen(log_path, "w");
 }
 
-void logic_utility_terminate() {
-  fclose(g_log_file);
-  fclose(g_debug_log_file);
+void logic_utility_terminate(logic_sim_t *sim) {
+  if (sim->log_file != NULL) {
+    fclose(sim->log_file);
+  }
+
+  if (sim->debug_log_file != NULL) {
+    fclose(sim->debug_log_file);
+  }
+
+  sim->log_file = NULL;
+  sim->debug_log_file = NULL;
 }
 
 /**************************************/
 
 logic_top_block_t *
-logic_create_top_block(logic_top_block_type_t logic_top_block_type) {
+logic_create_top_block(logic_sim_t *sim,
+                       logic_top_block_type_t logic_top_block_type) {
   logic_top_block_t *logic_top_block = NULL;
 
-  logic_top_block = calloc(1, sizeof(logic_top_block_t));
+  logic_top_block = logic_sim_alloc(sim, sizeof(logic_top_block_t));
+
+  if (logic_top_block == NULL) {
+    return NULL;
+  }
 
   logic_top_block->logic_top_block_type = logic_top_block_type;
 
@@ -97,30 +359,50 @@ logic_create_top_block(logic_top_block_type_t logic_top_block_type) {
   return logic_top_block;
 }
 
-logic_block_t *logic_create_logic_block(logic_block_type_t logic_block_type,
-                                        int inputs, int outputs, char *name,
-                                        char *prefix) {
+logic_block_t *logic_create_logic_block(logic_sim_t *sim,
+                                        logic_block_type_t logic_block_type,
+                                        int inputs, int outputs,
+                                        const char *name, const char *prefix) {
   logic_block_t *logic_block = NULL;
 
-  logic_block = calloc(1, sizeof(logic_block_t));
+  logic_block = logic_sim_alloc(sim, sizeof(logic_block_t));
+
+  if (logic_block == NULL ||
+      logic_sim_name_block(sim, logic_block, name, prefix) != 0) {
+    return NULL;
+  }
 
-  logic_block->name = name;
-  logic_block->prefix = prefix;
   logic_block->logic_block_type = logic_block_type;
+  logic_block->width = 1;
   logic_block->inputs = inputs;
   logic_block->outputs = outputs;
 
-  logic_block->input_streams = calloc(inputs, sizeof(logic_top_block_t *));
+  logic_block->input_streams =
+      logic_sim_alloc(sim, inputs * sizeof(logic_top_block_t *));
 
-  logic_block->output_streams = calloc(outputs, sizeof(logic_top_block_t *));
+  logic_block->output_streams =
+      logic_sim_alloc(sim, outputs * sizeof(logic_top_block_t *));
+
+  if (logic_block->input_streams == NULL ||
+      logic_block->output_streams == NULL) {
+    return NULL;
+  }
 
   /* Create all the top level blocks */
   for (int i = 0; i < inputs; i++) {
-    logic_block->input_streams[i] = logic_create_top_block(NONE);
+    logic_block->input_streams[i] = logic_create_top_block(sim, NONE);
+
+    if (logic_block->input_streams[i] == NULL) {
+      return NULL;
+    }
   }
 
   for (int i = 0; i < outputs; i++) {
-    logic_block->output_streams[i] = logic_create_top_block(NONE);
+    logic_block->output_streams[i] = logic_create_top_block(sim, NONE);
+
+    if (logic_block->output_streams[i] == NULL) {
+      return NULL;
+    }
   }
 
   logic_block->current_input = 0;
@@ -129,11 +411,16 @@ logic_block_t *logic_create_logic_block(logic_block_type_t logic_block_type,
   return logic_block;
 }
 
-logic_data_t *logic_create_data_block(logic_data_type_t logic_data_type,
+logic_data_t *logic_create_data_block(logic_sim_t *sim,
+                                      logic_data_type_t logic_data_type,
                                       int data) {
   logic_data_t *logic_data = NULL;
 
-  logic_data = calloc(1, sizeof(logic_data_t));
+  logic_data = logic_sim_alloc(sim, sizeof(logic_data_t));
+
+  if (logic_data == NULL) {
+    return NULL;
+  }
 
   logic_data->logic_data_type = logic_data_type;
   logic_data->data = data;
@@ -143,6 +430,17 @@ logic_data_t *logic_create_data_block(logic_data_type_t logic_data_type,
   return logic_data;
 }
 
+void logic_block_input_connected(logic_block_t *logic_block) {
+  logic_block->revision += 1;
+
+  /* A disconnect may have rewound to a stream in front of connected ones */
+  do {
+    logic_block->current_input += 1;
+  } while (logic_block->current_input < logic_block->inputs &&
+           logic_block->input_streams[logic_block->current_input]
+                   ->logic_top_block_type != NONE);
+}
+
 int logic_block_data_connect(logic_block_t *logic_block,
                              logic_data_t *logic_data) {
   if (logic_block == NULL || logic_data == NULL) {
@@ -155,18 +453,30 @@ int logic_block_data_connect(logic_block_t *logic_block,
   case INPUT: {
     int current_input_block = logic_block->current_input;
 
+    if (current_input_block >= logic_block->inputs) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Block (%s) has (%d) inputs connected.",
+                          logic_block->path, logic_block->inputs);
+      return -1;
+    }
+
     /* Assign data block */
     logic_block->input_streams[current_input_block]->logic_top_block_type =
         DATA_BLOCK;
     logic_block->input_streams[current_input_block]->logic_data = logic_data;
 
-    logic_block->current_input += 1;
+    logic_block_input_connected(logic_block);
 
     break;
   }
   case OUTPUT: {
     int current_output_block = logic_block->current_output;
 
+    if (current_output_block >= logic_block->outputs) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Block (%s) has (%d) outputs connected.",
+                          logic_block->path, logic_block->outputs);
+      return -1;
+    }
+
     /* Assign data block */
     logic_block->output_streams[current_output_block]->logic_top_block_type =
         DATA_BLOCK;
@@ -189,12 +499,19 @@ int logic_block_block_connect(logic_block_t *logic_block,
 
   int current_input_block = logic_block->current_input;
 
+  if (current_input_block >= logic_block->inputs) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Block (%s) has (%d) inputs connected.",
+                        logic_block->path, logic_block->inputs);
+    return -1;
+  }
+
   /* Assign data block */
   logic_block->input_streams[current_input_block]->logic_top_block_type =
       LOGIC_BLOCK;
   logic_block->input_streams[current_input_block]->logic_block = logic_block_in;
+  logic_block->input_streams[current_input_block]->bit = 0;
 
-  logic_block->current_input += 1;
+  logic_block_input_connected(logic_block);
 
   return 0;
 }
@@ -217,6 +534,11 @@ int logic_process_data(logic_block_type_t logic_block_type, int input_a,
   case NOT: {
     return !input_b;
   }
+
+  default: {
+    /* Word level cells are only evaluated compiled */
+    break;
+  }
   }
 
   return 0;
@@ -232,172 +554,336 @@ int logic_get_initalization_value(logic_block_type_t type) {
     return 0;
   case NOT:
     return 1;
+  default:
+    return 0;
   }
 
   return 0;
 }
 
-int logic_evaluate_single_block(logic_block_t *logic_block,
-                                Agnode_t *previous_node) {
-  if (logic_block == NULL) {
-    LOG_SIM_DEBUG_PRINT(g_debug_log_file, "No data found.");
-    return -1;
+/* Add the graph node and console entry of a block evaluated by the VM */
+static int logic_report_block(logic_sim_t *sim, logic_block_t *logic_block) {
+  /* Without a graph only the console and the logs get the block */
+  if (sim->graphviz_graph == NULL) {
+    return logic_console(sim, logic_block);
   }
 
-  LOG_SIM_DEBUG_PRINT(g_debug_log_file, "Evaluating logic block (%s).",
-                      logic_block->name);
+  Agnode_t *node = util_create_edge(sim->graphviz_graph, logic_block->path,
+                                    logic_block->logic_block_type);
 
-  /* Create graph node */
-  Agnode_t *node =
-      util_create_edge(logic_block->name, logic_block->logic_block_type);
+  logic_block->graph_node = node;
 
-  /* Add an edge from node to previous_node */
-  if (previous_node != NULL) {
-    LOG_SIM_DEBUG_PRINT(
-        g_debug_log_file, "(Previous Node: %s) Connecting (%s) -> (%s).",
-        agnameof(previous_node), agnameof(node), agnameof(previous_node));
+  for (int j = 0; j < logic_block->inputs; j++) {
+    logic_top_block_t *logic_top_block = logic_block->input_streams[j];
 
-    agedge(g_graphviz_graph, node, previous_node, NULL, true);
+    switch (logic_top_block->logic_top_block_type) {
+    case LOGIC_BLOCK: {
+      /* Feedback from a block not reported yet, connected afterwards */
+      if (logic_top_block->logic_block->graph_node == NULL) {
+        break;
+      }
+
+      LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Connecting (%s) -> (%s).",
+                          logic_top_block->logic_block->name,
+                          logic_block->name);
+
+      agedge(sim->graphviz_graph, logic_top_block->logic_block->graph_node,
+             node, NULL, true);
+      break;
+    }
+    case DATA_BLOCK: {
+      /* Create unique name for data node */
+      util_attach_invisible_edge(sim->graphviz_graph, logic_block->path, j,
+                                 node, false);
+      break;
+    }
+    case NONE: {
+      break;
+    }
+    }
   }
 
-  logic_block->graph_node = node;
+  return logic_console(sim, logic_block);
+}
 
-  /* Loop over the input streams and check the connected block */
-  int logic_inputs = logic_block->inputs;
-  int logic_output = logic_block->outputs;
-
-  for (int i = 0; i < logic_output; i++) {
-    /* Evaluation result */
-    int logic_eval_result =
-        logic_get_initalization_value(logic_block->logic_block_type);
-
-    for (int j = 0; j < logic_inputs; j++) {
-      logic_top_block_t *logic_top_block = logic_block->input_streams[j];
-
-      /* If it is logic block then recursively evaluate it */
-      switch (logic_top_block->logic_top_block_type) {
-      case LOGIC_BLOCK: {
-        if (logic_top_block->logic_block->output_streams[0]
-                ->logic_data->status == NOT_EVALUATED) {
-          logic_evaluate_single_block(logic_top_block->logic_block, node);
-        } else {
-
-          agedge(g_graphviz_graph, logic_top_block->logic_block->graph_node,
-                 node, NULL, true);
-        }
+/* Add the edges of feedback loops skipped while their blocks were reported */
+static void logic_report_feedback(logic_sim_t *sim,
+                                  const logic_circuit_t *circuit,
+                                  const bool *reported) {
+  for (int l = 0; l < circuit->loops && sim->graphviz_graph != NULL; l++) {
+    const logic_loop_t *loop = &circuit->loop_list[l];
+    int last = loop->first + loop->gates;
+
+    for (int g = loop->first; g < last; g++) {
+      int b = circuit->gate_list[g].block;
+      logic_block_t *logic_block = circuit->block_list[b];
 
-        /* Use the data from the result */
-        logic_block_type_t logic_block_type = logic_block->logic_block_type;
+      if (reported[b]) {
+        continue;
+      }
 
-        int input_a = logic_eval_result;
-        int input_b =
-            logic_top_block->logic_block->output_streams[0]->logic_data->data;
+      for (int j = 0; j < logic_block->inputs; j++) {
+        logic_top_block_t *logic_top_block = logic_block->input_streams[j];
 
-        logic_eval_result =
-            logic_process_data(logic_block_type, input_a, input_b);
+        if (logic_top_block->logic_top_block_type != LOGIC_BLOCK) {
+          continue;
+        }
 
-        break;
+        /* Only blocks placed later in the loop were skipped */
+        for (int h = g; h < last; h++) {
+          if (circuit->block_list[circuit->gate_list[h].block] !=
+              logic_top_block->logic_block) {
+            continue;
+          }
+
+          LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Connecting (%s) -> (%s).",
+                              logic_top_block->logic_block->name,
+                              logic_block->name);
+
+          agedge(sim->graphviz_graph,
+                 logic_top_block->logic_block->graph_node,
+                 logic_block->graph_node, NULL, true);
+          break;
+        }
       }
-      case DATA_BLOCK: {
-        /* Create unique name for data node */
-        util_attach_invisible_edge(logic_block->name, j,
-                                   logic_block->graph_node, false);
+    }
+  }
+}
 
-        /* Get the top logic block */
-        logic_block_type_t logic_block_type = logic_block->logic_block_type;
+#if LOG_SIM_XPROP
 
-        int input_a = logic_eval_result;
-        int input_b = logic_top_block->logic_data->data;
+/* Track X and Z, the optimizer assumes 0/1 values so the circuit runs as is */
+static int logic_simulate(logic_sim_t *sim, logic_circuit_t *circuit) {
+  logic_xsim_t *xsim = logic_xsim_create(circuit);
 
-        logic_eval_result =
-            logic_process_data(logic_block_type, input_a, input_b);
+  if (xsim == NULL) {
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Failed to compile circuit.");
+    return -1;
+  }
 
-        break;
-      }
-      case NONE: {
-        break;
-      }
-      }
+  LOG_SIM_DEBUG_PRINT(sim->debug_log_file,
+                      "Simulating %d gates with X propagation.",
+                      circuit->gates);
+
+  logic_xsim_run(xsim);
+  logic_xsim_write_back(xsim, 0);
+  logic_xsim_free(xsim);
+
+  return 0;
+}
+
+#else
+
+static int logic_simulate(logic_sim_t *sim, logic_circuit_t *circuit) {
+  logic_opt_options_t options = {true, true, true, true};
+  logic_opt_report_t report = {0};
+
+  /* The data blocks are fixed for this call, so they fold as constants */
+  if (circuit->loops == 0 && circuit->cells == 0) {
+    logic_circuit_optimize(circuit, &options, &report);
+  }
+
+  logic_vm_program_t *program = logic_vm_compile(circuit);
+
+  if (program == NULL) {
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Failed to compile circuit.");
+    return -1;
+  }
+
+  LOG_SIM_DEBUG_PRINT(sim->debug_log_file,
+                      "Optimized %d gates to %d (%d folded, %d merged, %d "
+                      "dead).",
+                      report.gates_before, report.gates_after, report.folded,
+                      report.merged, report.dead);
+
+  LOG_SIM_DEBUG_PRINT(sim->debug_log_file,
+                      "Compiled %d gates into %d instructions (%d fused).",
+                      circuit->gates, program->instructions, program->fused);
+
+  if (logic_vm_run(program, circuit->values) > 0) {
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Feedback loop did not settle.");
+  }
+
+  logic_circuit_write_back(circuit, 0);
+  logic_vm_free(program);
+
+  return 0;
+}
+
+#endif
+
+/* Compile the cones of the output blocks, run them and report every block */
+static int logic_evaluate_compiled(logic_sim_t *sim, int total_logic_blocks,
+                                   logic_block_t **logic_blocks) {
+  logic_circuit_t *circuit =
+      logic_circuit_compile(total_logic_blocks, logic_blocks);
+
+  if (circuit == NULL) {
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Failed to compile circuit.");
+    return -1;
+  }
+
+  /* Blocks evaluated by an earlier call are not reported twice */
+  bool *reported = calloc(circuit->blocks + 1, sizeof(bool));
+
+  if (reported == NULL) {
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Failed to allocate reports.");
+    logic_circuit_free(circuit);
+    return -1;
+  }
+
+  for (int b = 0; b < circuit->blocks; b++) {
+    /* Memory write ports have no output to tell */
+    if (circuit->block_list[b]->outputs == 0) {
+      continue;
     }
 
-    /* Write to output data block */
-    logic_block->output_streams[i]->logic_data->data = logic_eval_result;
-    logic_block->output_streams[i]->logic_data->status = EVALUATED;
+    logic_top_block_t *logic_top_block =
+        circuit->block_list[b]->output_streams[0];
+
+    reported[b] = logic_top_block->logic_data != NULL &&
+                  logic_top_block->logic_data->status == EVALUATED;
+  }
+
+  if (logic_simulate(sim, circuit) != 0) {
+    free(reported);
+    logic_circuit_free(circuit);
+    return -1;
+  }
+
+  for (int b = 0; b < circuit->blocks; b++) {
+    logic_block_t *logic_block = circuit->block_list[b];
+
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Evaluating logic block (%s).",
+                        logic_block->name);
+
+    if (reported[b]) {
+      continue;
+    }
+
+    logic_report_block(sim, logic_block);
+  }
+
+  logic_report_feedback(sim, circuit, reported);
+
+  free(reported);
+  logic_circuit_free(circuit);
+
+  return 0;
+}
+
+int logic_evaluate_single_block(logic_sim_t *sim, logic_block_t *logic_block,
+                                Agnode_t *previous_node) {
+  if (logic_block == NULL) {
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "No data found.");
+    return -1;
+  }
+
+  if (logic_evaluate_compiled(sim, 1, &logic_block) != 0) {
+    return -1;
   }
 
-  logic_console(logic_block);
+  /* Add an edge from node to previous_node */
+  if (previous_node != NULL && sim->graphviz_graph != NULL) {
+    agedge(sim->graphviz_graph, logic_block->graph_node, previous_node, NULL,
+           true);
+  }
 
   return 0;
 }
 
-int logic_evaluate(int total_logic_blocks, ...) {
+int logic_evaluate(logic_sim_t *sim, int total_logic_blocks, ...) {
 
   va_list logic_blocks;
+  logic_block_t **logic_block_list =
+      calloc(total_logic_blocks + 1, sizeof(logic_block_t *));
+
+  if (logic_block_list == NULL) {
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "Failed to allocate blocks.");
+    return -1;
+  }
 
   va_start(logic_blocks, total_logic_blocks);
 
   for (int i = 0; i < total_logic_blocks; i++) {
-    logic_block_t *logic_block = va_arg(logic_blocks, logic_block_t *);
+    logic_block_list[i] = va_arg(logic_blocks, logic_block_t *);
+  }
 
-    logic_evaluate_single_block(logic_block, NULL);
+  va_end(logic_blocks);
 
-    util_attach_invisible_edge(logic_block->name, i, logic_block->graph_node,
-                               true);
+  int status =
+      logic_evaluate_compiled(sim, total_logic_blocks, logic_block_list);
+
+  for (int i = 0; i < total_logic_blocks && status == 0 &&
+                  sim->graphviz_graph != NULL;
+       i++) {
+    util_attach_invisible_edge(sim->graphviz_graph, logic_block_list[i]->path,
+                               i, logic_block_list[i]->graph_node, true);
   }
 
-  va_end(logic_blocks);
+  free(logic_block_list);
 
-  return 0;
+  return status;
 }
 
-int logic_console(logic_block_t *logic_block) {
+/* Value carried by a stream, a block input reads the bit it is connected to */
+static int logic_console_data(const logic_top_block_t *logic_top_block) {
+  if (logic_top_block->logic_top_block_type == LOGIC_BLOCK) {
+    const logic_block_t *logic_block_in = logic_top_block->logic_block;
+
+    if (logic_top_block->bit >= logic_block_in->outputs) {
+      return 0;
+    }
+
+    logic_top_block = logic_block_in->output_streams[logic_top_block->bit];
+  }
+
+  return logic_top_block->logic_data != NULL ? logic_top_block->logic_data->data
+                                             : 0;
+}
+
+int logic_console(logic_sim_t *sim, logic_block_t *logic_block) {
   if (logic_block == NULL) {
-    LOG_SIM_DEBUG_PRINT(g_debug_log_file, "No data found.");
+    LOG_SIM_DEBUG_PRINT(sim->debug_log_file, "No data found.");
 
     return -1;
   }
 
   int logic_inputs = logic_block->inputs;
 
-  LOG_SIM_LOG_PRINT("----------\n"
+  LOG_SIM_LOG_PRINT(sim->console, "----------\n"
                     "| LOGSIM |\n"
                     "----------\n");
 
-  LOG_SIM_LOG_PRINT("Result for logic block (%s)\n"
+  LOG_SIM_LOG_PRINT(sim->console, "Result for logic block (%s)\n"
                     "---------------------------",
                     logic_block->name);
 
   for (int i = 0; i < logic_inputs; i++) {
-    if (logic_block->input_streams[i]->logic_top_block_type == LOGIC_BLOCK) {
-      int input = logic_block->input_streams[i]
-                      ->logic_block->output_streams[0]
-                      ->logic_data->data;
-
-      LOG_SIM_LOG_PRINT("INPUT Found (%d).", input);
-
-      LOG_SIM_FILE_PRINT(g_log_file, "| %-5s (%-5s)   | INPUT  | %d     |",
-                         logic_block->name,
-                         logic_block->prefix ? logic_block->prefix : "", input);
+    int input = logic_console_data(logic_block->input_streams[i]);
 
-    } else {
-      int input = logic_block->input_streams[i]->logic_data->data;
-      LOG_SIM_LOG_PRINT("INPUT Found (%d).", input);
+    LOG_SIM_LOG_PRINT(sim->console, "INPUT Found (%d).", input);
 
-      LOG_SIM_FILE_PRINT(g_log_file, "| %-5s (%-5s)   | INPUT  | %d     |",
-                         logic_block->name,
-                         logic_block->prefix ? logic_block->prefix : "", input);
-    }
+    LOG_SIM_FILE_PRINT(sim->log_file, "| %-5s (%-5s)   | INPUT  | %d     |",
+                       logic_block->name,
+                       logic_block->prefix ? logic_block->prefix : "", input);
   }
 
-  int output = logic_block->output_streams[0]->logic_data->data;
+  /* Gates report their one output, cells every bit */
+  int logic_outputs =
+      LOGIC_IS_CELL(logic_block->logic_block_type) ? logic_block->outputs : 1;
+
+  for (int i = 0; i < logic_outputs; i++) {
+    int output = logic_console_data(logic_block->output_streams[i]);
 
-  LOG_SIM_LOG_PRINT("OUTPUT data found (%d).", output);
+    LOG_SIM_LOG_PRINT(sim->console, "OUTPUT data found (%d).", output);
 
-  LOG_SIM_FILE_PRINT(g_log_file, "| %-5s (%-5s)   | OUTPUT | %d     |",
-                     logic_block->name,
-                     logic_block->prefix ? logic_block->prefix : "", output);
+    LOG_SIM_FILE_PRINT(sim->log_file, "| %-5s (%-5s)   | OUTPUT | %d     |",
+                       logic_block->name,
+                       logic_block->prefix ? logic_block->prefix : "", output);
+  }
 
-  LOG_SIM_FILE_PRINT(g_log_file, "+-----------------+--------+-------+");
+  LOG_SIM_FILE_PRINT(sim->log_file, "+-----------------+--------+-------+");
 
   return 0;
 }
@@ -0,0 +1,993 @@
+/**
+ * @file logsimlut.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Lookup table blocks and the pass mapping gates onto them.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimcone.h"
+#include "../include/logsimlib.h"
+#include "../include/logsimlut.h"
+#include "../include/logsimnuma.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_LUT_DEFAULT_INPUTS 4
+#define LOGIC_LUT_DEFAULT_CUTS 8
+
+/* Leaf sets tried per gate while combining the cuts of its fanins */
+#define LOGIC_LUT_MERGES 64
+
+#define LOGIC_LUT_REGISTERS (1 + LOGIC_LUT_INPUTS + LOGIC_LUT_OPS)
+
+/* A micro-program in native instructions, a 3 op one runs as about 8 */
+#define LOGIC_LUT_RUN_COST 2.0f
+#define LOGIC_LUT_OP_COST 2.0f
+
+/*************** Structures ***************/
+
+typedef struct logic_lut_compiler {
+  int inputs;
+
+  logic_lut_op_t *op_list;
+  int ops;
+
+  /* Function held by each register, as a table over all the inputs */
+  int registers;
+  uint64_t table_list[LOGIC_LUT_REGISTERS];
+} logic_lut_compiler_t;
+
+/* Leaves sorted by net, the table is over them and repeated up to 64 bits */
+typedef struct logic_lut_cut {
+  int leaves;
+  int leaf_list[LOGIC_LUT_INPUTS];
+  uint64_t truth_table;
+
+  int depth;
+  float flow;
+} logic_lut_cut_t;
+
+/* Union of one cut per distinct fanin of a gate */
+typedef struct logic_lut_merge {
+  int leaves;
+  int leaf_list[LOGIC_LUT_INPUTS];
+  uint8_t choice[LOGIC_LUT_INPUTS];
+} logic_lut_merge_t;
+
+typedef struct logic_lut_map {
+  const logic_circuit_t *circuit;
+  int inputs;
+  int cuts;
+
+  /* Per net, cuts are freed once every reader has been enumerated */
+  logic_lut_cut_t **cut_sets;
+  int *cut_counts;
+  int *readers;
+  int *fanouts;
+
+  /* Per net, the chosen cut of the gate driving it */
+  logic_lut_cut_t *best;
+  int *depth;
+  float *flow;
+} logic_lut_map_t;
+
+/*************** Variables ***************/
+
+/* Table of input i, over six inputs */
+static const uint64_t logic_lut_masks[LOGIC_LUT_INPUTS] = {
+    0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull};
+
+/*************** Function Definitions ***************/
+
+static uint64_t logic_lut_mask(int inputs) {
+  return inputs >= LOGIC_LUT_INPUTS ? ~0ull : (1ull << (1 << inputs)) - 1;
+}
+
+/* Repeat a table up to 64 bits, as if it had six inputs */
+static uint64_t logic_lut_repeat(uint64_t truth_table, int inputs) {
+  truth_table &= logic_lut_mask(inputs);
+
+  for (int n = inputs; n < LOGIC_LUT_INPUTS; n++) {
+    truth_table |= truth_table << (1 << n);
+  }
+
+  return truth_table;
+}
+
+logic_block_t *logic_create_lut(logic_sim_t *sim, int inputs,
+                                uint64_t truth_table, const char *name,
+                                const char *prefix) {
+  if (sim == NULL) {
+    return NULL;
+  }
+
+  if (inputs < 0 || inputs > LOGIC_LUT_INPUTS) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Lookup tables take up to %d inputs, not %d.",
+                        LOGIC_LUT_INPUTS, inputs);
+    return NULL;
+  }
+
+  logic_block_t *logic_block =
+      logic_create_logic_block(sim, LUT, inputs, 1, name, prefix);
+
+  if (logic_block == NULL) {
+    return NULL;
+  }
+
+  logic_block->truth_table = truth_table & logic_lut_mask(inputs);
+
+  return logic_block;
+}
+
+logic_word_t logic_lut_evaluate(uint64_t truth_table, int inputs,
+                                const int *fanins, const logic_word_t *values) {
+  logic_word_t level[1 << (LOGIC_LUT_INPUTS - 1)];
+
+  if (inputs <= 0 || inputs > LOGIC_LUT_INPUTS) {
+    return truth_table & 1 ? ~(logic_word_t)0 : 0;
+  }
+
+  logic_word_t x = values[fanins[0]];
+
+  /* Pairs of table bits pick 0, the first input, its inverse or 1 */
+  for (int i = 0; i < 1 << (inputs - 1); i++) {
+    logic_word_t low = -(logic_word_t)((truth_table >> (2 * i)) & 1);
+    logic_word_t high = -(logic_word_t)((truth_table >> (2 * i + 1)) & 1);
+
+    level[i] = (low & ~x) | (high & x);
+  }
+
+  /* Every further input halves the candidates */
+  for (int j = 1; j < inputs; j++) {
+    x = values[fanins[j]];
+
+    for (int i = 0; i < 1 << (inputs - 1 - j); i++) {
+      level[i] = level[2 * i] ^ ((level[2 * i] ^ level[2 * i + 1]) & x);
+    }
+  }
+
+  return level[0];
+}
+
+/**************************************/
+
+static int logic_lut_emit(logic_lut_compiler_t *compiler, int select,
+                          int high, int low, int invert, uint64_t table) {
+  logic_lut_op_t *op = &compiler->op_list[compiler->ops++];
+  int dst = compiler->registers++;
+
+  op->dst = (uint8_t)dst;
+  op->select = (uint8_t)select;
+  op->high = (uint8_t)high;
+  op->low = (uint8_t)low;
+  op->invert = (uint8_t)invert;
+
+  compiler->table_list[dst] = table;
+
+  return dst;
+}
+
+static int logic_lut_find(const logic_lut_compiler_t *compiler,
+                          uint64_t table) {
+  for (int r = 0; r < compiler->registers; r++) {
+    if (compiler->table_list[r] == table) {
+      return r;
+    }
+  }
+
+  return -1;
+}
+
+/* Each operation holds a distinct cofactor, at most LOGIC_LUT_OPS of them */
+static int logic_lut_build(logic_lut_compiler_t *compiler, uint64_t table) {
+  int known = logic_lut_find(compiler, table);
+
+  if (known != -1) {
+    return known;
+  }
+
+  /* 0 is register 0, 1 is its inverse */
+  if (table == ~0ull) {
+    return logic_lut_emit(compiler, 0, 0, 0, LOGIC_LUT_INVERT_LOW, table);
+  }
+
+  known = logic_lut_find(compiler, ~table);
+
+  if (known != -1) {
+    return logic_lut_emit(compiler, known, 0, 0, LOGIC_LUT_INVERT_LOW, table);
+  }
+
+  int pick = -1;
+  uint64_t pick_low = 0;
+  uint64_t pick_high = 0;
+
+  for (int i = 0; i < compiler->inputs; i++) {
+    uint64_t mask = logic_lut_masks[i];
+    int shift = 1 << i;
+    uint64_t low = (table & ~mask) | ((table & ~mask) << shift);
+    uint64_t high = (table & mask) | ((table & mask) >> shift);
+
+    if (low == high) {
+      continue;
+    }
+
+    /* A constant or inverted cofactor leaves an AND, OR or XOR */
+    int x = 1 + i;
+
+    if (low == 0 || low == ~0ull) {
+      int invert = low == 0 ? 0 : LOGIC_LUT_INVERT_LOW;
+
+      return logic_lut_emit(compiler, x, logic_lut_build(compiler, high), 0,
+                            invert, table);
+    }
+
+    if (high == 0 || high == ~0ull) {
+      int invert = high == 0 ? 0 : LOGIC_LUT_INVERT_HIGH;
+
+      return logic_lut_emit(compiler, x, 0, logic_lut_build(compiler, low),
+                            invert, table);
+    }
+
+    if (high == ~low) {
+      int rest = logic_lut_build(compiler, low);
+
+      return logic_lut_emit(compiler, x, rest, rest, LOGIC_LUT_INVERT_HIGH,
+                            table);
+    }
+
+    if (pick == -1) {
+      pick = i;
+      pick_low = low;
+      pick_high = high;
+    }
+  }
+
+  int low = logic_lut_build(compiler, pick_low);
+  int high = logic_lut_build(compiler, pick_high);
+
+  return logic_lut_emit(compiler, 1 + pick, high, low, 0, table);
+}
+
+int logic_lut_compile(uint64_t truth_table, int inputs, logic_lut_op_t *op_list,
+                      int *result) {
+  logic_lut_compiler_t compiler;
+
+  if (inputs < 0 || inputs > LOGIC_LUT_INPUTS || op_list == NULL ||
+      result == NULL) {
+    return -1;
+  }
+
+  compiler.inputs = inputs;
+  compiler.op_list = op_list;
+  compiler.ops = 0;
+  compiler.registers = 1 + inputs;
+  compiler.table_list[0] = 0;
+
+  for (int i = 0; i < inputs; i++) {
+    compiler.table_list[1 + i] = logic_lut_masks[i];
+  }
+
+  *result = logic_lut_build(&compiler, logic_lut_repeat(truth_table, inputs));
+
+  return compiler.ops;
+}
+
+logic_word_t logic_lut_run(const logic_lut_op_t *op_list, int ops, int result,
+                           int inputs, const int *fanins,
+                           const logic_word_t *values) {
+  logic_word_t r[LOGIC_LUT_REGISTERS];
+
+  r[0] = 0;
+
+  for (int j = 0; j < inputs; j++) {
+    r[1 + j] = values[fanins[j]];
+  }
+
+  for (int i = 0; i < ops; i++) {
+    const logic_lut_op_t *op = &op_list[i];
+    logic_word_t high =
+        r[op->high] ^ -(logic_word_t)(op->invert & LOGIC_LUT_INVERT_HIGH);
+    logic_word_t low = r[op->low] ^ -(logic_word_t)(op->invert >> 1);
+
+    r[op->dst] = low ^ ((low ^ high) & r[op->select]);
+  }
+
+  return r[result];
+}
+
+/**************************************/
+
+static bool logic_lut_mappable(const logic_gate_t *gate) {
+  switch (gate->logic_block_type) {
+  case AND:
+  case OR:
+  case XOR:
+  case NOT:
+    return gate->inputs > 0;
+  default:
+    return false;
+  }
+}
+
+/* Distinct fanins of a gate, -1 when there are more than limit */
+static int logic_lut_distinct(const logic_gate_t *gate, const int *fanins,
+                              int *distinct, int limit) {
+  /* NOT only reads its last one */
+  if (gate->logic_block_type == NOT) {
+    distinct[0] = fanins[gate->inputs - 1];
+    return 1;
+  }
+
+  int count = 0;
+
+  for (int j = 0; j < gate->inputs; j++) {
+    int seen = 0;
+
+    while (seen < count && distinct[seen] != fanins[j]) {
+      seen += 1;
+    }
+
+    if (seen == count) {
+      if (count == limit) {
+        return -1;
+      }
+
+      distinct[count++] = fanins[j];
+    }
+  }
+
+  return count;
+}
+
+/* Sorted union of two leaf lists, -1 when it has more than limit leaves */
+static int logic_lut_union(const int *a, int a_count, const int *b,
+                           int b_count, int *out, int limit) {
+  int i = 0;
+  int j = 0;
+  int count = 0;
+
+  while (i < a_count || j < b_count) {
+    int net;
+
+    if (j == b_count || (i < a_count && a[i] < b[j])) {
+      net = a[i++];
+    } else if (i == a_count || b[j] < a[i]) {
+      net = b[j++];
+    } else {
+      net = a[i++];
+      j++;
+    }
+
+    if (count == limit) {
+      return -1;
+    }
+
+    out[count++] = net;
+  }
+
+  return count;
+}
+
+/* Table of a cut over a superset of its leaves */
+static uint64_t logic_lut_expand(const logic_lut_cut_t *cut,
+                                 const int *leaf_list, int leaves) {
+  if (cut->leaves == leaves) {
+    return cut->truth_table;
+  }
+
+  int position[LOGIC_LUT_INPUTS];
+
+  for (int i = 0, k = 0; i < cut->leaves; i++) {
+    while (leaf_list[k] != cut->leaf_list[i]) {
+      k++;
+    }
+
+    position[i] = k;
+  }
+
+  uint64_t table = 0;
+
+  for (int m = 0; m < 64; m++) {
+    int index = 0;
+
+    for (int i = 0; i < cut->leaves; i++) {
+      index |= ((m >> position[i]) & 1) << i;
+    }
+
+    table |= ((cut->truth_table >> index) & 1) << m;
+  }
+
+  return table;
+}
+
+/* Instructions of a gate once folded by logic_vm_compile() */
+static int logic_lut_gate_ops(const logic_gate_t *gate) {
+  return gate->logic_block_type == NOT || gate->inputs < 3 ? 1
+                                                          : gate->inputs - 1;
+}
+
+/* Cost of a table in native instructions, one op runs as one of them */
+static float logic_lut_table_cost(uint64_t truth_table, int inputs) {
+  logic_lut_op_t op_list[LOGIC_LUT_OPS];
+  int result = 0;
+  int ops = logic_lut_compile(truth_table & logic_lut_mask(inputs), inputs,
+                              op_list, &result);
+
+  return ops > 1 ? LOGIC_LUT_RUN_COST + LOGIC_LUT_OP_COST * ops : 1.0f;
+}
+
+/* Gate driving a fanin inside a cut, -1 for leaves and repeated fanins */
+static int logic_lut_inner(const int *driver, const int *fanins, int j,
+                           const logic_lut_cut_t *cut) {
+  for (int first = 0; first < j; first++) {
+    if (fanins[first] == fanins[j]) {
+      return -1;
+    }
+  }
+
+  for (int i = 0; i < cut->leaves; i++) {
+    if (cut->leaf_list[i] == fanins[j]) {
+      return -1;
+    }
+  }
+
+  return driver[fanins[j]];
+}
+
+/* Instructions of the gates only the cut reads, references are dropped */
+static float logic_lut_dereference(const logic_lut_map_t *map,
+                                   int *references, const int *driver, int g,
+                                   const logic_lut_cut_t *cut) {
+  const logic_gate_t *gate = &map->circuit->gate_list[g];
+  const int *fanins = &map->circuit->fanins[gate->fanin];
+  float ops = (float)logic_lut_gate_ops(gate);
+
+  for (int j = 0; j < gate->inputs; j++) {
+    int inner = logic_lut_inner(driver, fanins, j, cut);
+
+    if (inner != -1 && --references[fanins[j]] == 0) {
+      ops += logic_lut_dereference(map, references, driver, inner, cut);
+    }
+  }
+
+  return ops;
+}
+
+static void logic_lut_reference(const logic_lut_map_t *map, int *references,
+                                const int *driver, int g,
+                                const logic_lut_cut_t *cut) {
+  const logic_gate_t *gate = &map->circuit->gate_list[g];
+  const int *fanins = &map->circuit->fanins[gate->fanin];
+
+  for (int j = 0; j < gate->inputs; j++) {
+    int inner = logic_lut_inner(driver, fanins, j, cut);
+
+    if (inner != -1 && references[fanins[j]]++ == 0) {
+      logic_lut_reference(map, references, driver, inner, cut);
+    }
+  }
+}
+
+static int logic_lut_compare(const void *a, const void *b) {
+  const logic_lut_cut_t *cut_a = a;
+  const logic_lut_cut_t *cut_b = b;
+
+  if (cut_a->flow != cut_b->flow) {
+    return cut_a->flow < cut_b->flow ? -1 : 1;
+  }
+
+  if (cut_a->leaves != cut_b->leaves) {
+    return cut_a->leaves - cut_b->leaves;
+  }
+
+  return cut_a->depth - cut_b->depth;
+}
+
+static void logic_lut_trivial(const logic_lut_map_t *map, int net,
+                              logic_lut_cut_t *cut) {
+  cut->leaves = 1;
+  cut->leaf_list[0] = net;
+  cut->truth_table = logic_lut_masks[0];
+  cut->depth = map->depth[net];
+  cut->flow = map->flow[net];
+}
+
+/* Combine the cuts of the fanins of a gate, the best ones first */
+static int logic_lut_enumerate(logic_lut_map_t *map, const logic_gate_t *gate,
+                               logic_lut_cut_t *candidates) {
+  const int *fanins = &map->circuit->fanins[gate->fanin];
+  int distinct[LOGIC_LUT_INPUTS];
+  logic_lut_cut_t trivial[LOGIC_LUT_INPUTS];
+  logic_lut_merge_t buffers[2][LOGIC_LUT_MERGES];
+  logic_lut_merge_t *merges = buffers[0];
+  int count = 1;
+
+  int fanin_count = logic_lut_distinct(gate, fanins, distinct, map->inputs);
+
+  /* Gates reading more nets than a table has inputs are kept */
+  if (fanin_count < 0) {
+    return 0;
+  }
+
+  merges[0].leaves = 0;
+
+  for (int u = 0; u < fanin_count; u++) {
+    logic_lut_merge_t *next = buffers[(u + 1) % 2];
+    int net = distinct[u];
+    int options = map->cut_counts[net] + 1;
+    int next_count = 0;
+
+    logic_lut_trivial(map, net, &trivial[u]);
+
+    for (int m = 0; m < count && next_count < LOGIC_LUT_MERGES; m++) {
+      for (int o = 0; o < options && next_count < LOGIC_LUT_MERGES; o++) {
+        const logic_lut_cut_t *cut =
+            o < map->cut_counts[net] ? &map->cut_sets[net][o] : &trivial[u];
+        logic_lut_merge_t *merge = &next[next_count];
+        int leaves =
+            logic_lut_union(merges[m].leaf_list, merges[m].leaves,
+                            cut->leaf_list, cut->leaves, merge->leaf_list,
+                            map->inputs);
+
+        if (leaves < 0) {
+          continue;
+        }
+
+        merge->leaves = leaves;
+        memcpy(merge->choice, merges[m].choice, sizeof(merge->choice));
+        merge->choice[u] = (uint8_t)o;
+        next_count += 1;
+      }
+    }
+
+    merges = next;
+    count = next_count;
+  }
+
+  int candidate_count = 0;
+
+  for (int m = 0; m < count; m++) {
+    const logic_lut_merge_t *merge = &merges[m];
+    logic_lut_cut_t *cut = &candidates[candidate_count];
+    uint64_t tables[LOGIC_LUT_INPUTS];
+    int duplicate = 0;
+
+    for (int c = 0; c < candidate_count && !duplicate; c++) {
+      duplicate = candidates[c].leaves == merge->leaves &&
+                  memcmp(candidates[c].leaf_list, merge->leaf_list,
+                         merge->leaves * sizeof(int)) == 0;
+    }
+
+    if (duplicate) {
+      continue;
+    }
+
+    cut->leaves = merge->leaves;
+    memcpy(cut->leaf_list, merge->leaf_list, merge->leaves * sizeof(int));
+
+    for (int u = 0; u < fanin_count; u++) {
+      int net = distinct[u];
+      int choice = merge->choice[u];
+      const logic_lut_cut_t *chosen = choice < map->cut_counts[net]
+                                          ? &map->cut_sets[net][choice]
+                                          : &trivial[u];
+
+      tables[u] = logic_lut_expand(chosen, cut->leaf_list, cut->leaves);
+    }
+
+    /* Apply the gate to its fanin tables, in fanin order */
+    uint64_t table = gate->logic_block_type == AND ? ~0ull : 0;
+
+    if (gate->logic_block_type == NOT) {
+      table = ~tables[0];
+    }
+
+    for (int j = 0; j < gate->inputs && gate->logic_block_type != NOT; j++) {
+      int u = 0;
+
+      while (distinct[u] != fanins[j]) {
+        u++;
+      }
+
+      if (gate->logic_block_type == AND) {
+        table &= tables[u];
+      } else if (gate->logic_block_type == OR) {
+        table |= tables[u];
+      } else {
+        table ^= tables[u];
+      }
+    }
+
+    /* Area is counted in the instructions a run executes */
+    cut->truth_table = table;
+    cut->depth = 0;
+    cut->flow = logic_lut_table_cost(table, cut->leaves);
+
+    for (int i = 0; i < cut->leaves; i++) {
+      int leaf = cut->leaf_list[i];
+
+      if (map->depth[leaf] > cut->depth) {
+        cut->depth = map->depth[leaf];
+      }
+
+      cut->flow += map->flow[leaf] / (float)map->fanouts[leaf];
+    }
+
+    cut->depth += 1;
+    candidate_count += 1;
+  }
+
+  qsort(candidates, candidate_count, sizeof(logic_lut_cut_t),
+        logic_lut_compare);
+
+  return candidate_count;
+}
+
+static void logic_lut_release(logic_lut_map_t *map, const logic_gate_t *gate) {
+  const int *fanins = &map->circuit->fanins[gate->fanin];
+
+  for (int j = 0; j < gate->inputs; j++) {
+    int net = fanins[j];
+    int first = 0;
+
+    while (first < j && fanins[first] != net) {
+      first++;
+    }
+
+    if (first < j || --map->readers[net] > 0) {
+      continue;
+    }
+
+    free(map->cut_sets[net]);
+    map->cut_sets[net] = NULL;
+    map->cut_counts[net] = 0;
+  }
+}
+
+int logic_circuit_map_luts(logic_circuit_t *circuit,
+                           const logic_lut_options_t *options,
+                           logic_lut_report_t *report) {
+  logic_lut_options_t defaults = {LOGIC_LUT_DEFAULT_INPUTS,
+                                  LOGIC_LUT_DEFAULT_CUTS};
+  logic_lut_report_t local = {0};
+
+  if (circuit == NULL) {
+    return -1;
+  }
+
+  if (circuit->loops > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with feedback loops are not "
+                                "mapped.");
+    return -1;
+  }
+
+  if (circuit->cells > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with word level cells are not "
+                                "mapped.");
+    return -1;
+  }
+
+  if (options == NULL) {
+    options = &defaults;
+  }
+
+  if (options->inputs < 2 || options->inputs > LOGIC_LUT_INPUTS ||
+      options->cuts < 1) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Lookup tables take 2 to %d inputs.",
+                        LOGIC_LUT_INPUTS);
+    return -1;
+  }
+
+  if (report == NULL) {
+    report = &local;
+  }
+
+  int nets = circuit->nets;
+  int gates = circuit->gates;
+  int fanin_total = gates > 0 ? circuit->gate_list[gates - 1].fanin +
+                                    circuit->gate_list[gates - 1].inputs
+                              : 0;
+
+  logic_lut_map_t map = {0};
+
+  map.circuit = circuit;
+  map.inputs = options->inputs;
+  map.cuts = options->cuts;
+
+  map.cut_sets = calloc(nets, sizeof(logic_lut_cut_t *));
+  map.cut_counts = calloc(nets, sizeof(int));
+  map.readers = calloc(nets, sizeof(int));
+  map.fanouts = calloc(nets, sizeof(int));
+  map.best = calloc(nets, sizeof(logic_lut_cut_t));
+  map.depth = calloc(nets, sizeof(int));
+  map.flow = calloc(nets, sizeof(float));
+
+  logic_lut_cut_t *candidates =
+      malloc(LOGIC_LUT_MERGES * sizeof(logic_lut_cut_t));
+  bool *mapped = calloc(gates + 1, sizeof(bool));
+  bool *required = calloc(nets, sizeof(bool));
+  int *driver = malloc(nets * sizeof(int));
+  int status = -1;
+
+  if (map.cut_sets == NULL || map.cut_counts == NULL || map.readers == NULL ||
+      map.fanouts == NULL || map.best == NULL || map.depth == NULL ||
+      map.flow == NULL || candidates == NULL || mapped == NULL ||
+      required == NULL || driver == NULL) {
+    goto done;
+  }
+
+  for (int n = 0; n < nets; n++) {
+    driver[n] = -1;
+  }
+
+  /* Readers free the cut sets, fanouts share the area of a net out */
+  for (int g = 0; g < gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+    const int *fanins = &circuit->fanins[gate->fanin];
+
+    driver[gate->output] = g;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int first = 0;
+
+      while (first < j && fanins[first] != fanins[j]) {
+        first++;
+      }
+
+      if (first == j) {
+        map.readers[fanins[j]] += 1;
+        map.fanouts[fanins[j]] += 1;
+      }
+    }
+  }
+
+  for (int i = 0; i < circuit->outputs; i++) {
+    map.fanouts[circuit->output_nets[i]] += 1;
+  }
+
+  for (int n = 0; n < nets; n++) {
+    if (map.fanouts[n] == 0) {
+      map.fanouts[n] = 1;
+    }
+  }
+
+  /* Enumerate in level order, the cuts of every fanin are complete */
+  for (int g = 0; g < gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+    int out = gate->output;
+    int count = logic_lut_mappable(gate)
+                    ? logic_lut_enumerate(&map, gate, candidates)
+                    : 0;
+    const int *fanins = &circuit->fanins[gate->fanin];
+
+    /* The gate as it is, kept unless a table runs in fewer instructions */
+    map.flow[out] = (float)logic_lut_gate_ops(gate);
+
+    for (int j = 0; j < gate->inputs; j++) {
+      if (map.depth[fanins[j]] > map.depth[out]) {
+        map.depth[out] = map.depth[fanins[j]];
+      }
+
+      map.flow[out] += map.flow[fanins[j]] / (float)map.fanouts[fanins[j]];
+    }
+
+    map.depth[out] += 1;
+
+    /* Readers may still absorb a kept gate into their own tables */
+    if (count > 0) {
+      int kept = count < map.cuts ? count : map.cuts;
+
+      map.cut_sets[out] = malloc(kept * sizeof(logic_lut_cut_t));
+
+      if (map.cut_sets[out] == NULL) {
+        goto done;
+      }
+
+      memcpy(map.cut_sets[out], candidates, kept * sizeof(logic_lut_cut_t));
+      map.cut_counts[out] = kept;
+
+      if (candidates[0].flow < map.flow[out]) {
+        map.best[out] = candidates[0];
+        map.depth[out] = candidates[0].depth;
+        map.flow[out] = candidates[0].flow;
+        mapped[g] = true;
+      }
+    }
+
+    logic_lut_release(&map, gate);
+  }
+
+  /* Cover from the outputs, the leaves of a chosen cut are needed in turn */
+  for (int i = 0; i < circuit->outputs; i++) {
+    required[circuit->output_nets[i]] = true;
+  }
+
+  int count = 0;
+  int fanin = 0;
+
+  for (int g = gates - 1; g >= 0; g--) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    if (!required[gate->output]) {
+      continue;
+    }
+
+    /* Flow shares reconvergent gates out, the cover counts them exactly */
+    if (mapped[g]) {
+      const logic_lut_cut_t *cut = &map.best[gate->output];
+      float replaced =
+          logic_lut_dereference(&map, map.fanouts, driver, g, cut);
+
+      logic_lut_reference(&map, map.fanouts, driver, g, cut);
+      mapped[g] = logic_lut_table_cost(cut->truth_table, cut->leaves) <
+                  replaced;
+    }
+
+    if (mapped[g]) {
+      const logic_lut_cut_t *cut = &map.best[gate->output];
+
+      for (int i = 0; i < cut->leaves; i++) {
+        required[cut->leaf_list[i]] = true;
+      }
+
+      fanin += cut->leaves;
+    } else {
+      for (int j = 0; j < gate->inputs; j++) {
+        required[circuit->fanins[gate->fanin + j]] = true;
+      }
+
+      fanin += gate->inputs;
+    }
+
+    count += 1;
+  }
+
+  logic_gate_t *gate_list = logic_numa_alloc(
+      (count + 1) * sizeof(logic_gate_t), circuit->placement);
+  int *fanins =
+      logic_numa_alloc((fanin + 1) * sizeof(int), circuit->placement);
+  int *level = map.depth;
+
+  if (gate_list == NULL || fanins == NULL) {
+    logic_numa_free(gate_list);
+    logic_numa_free(fanins);
+    goto done;
+  }
+
+  /* Cached schedules refer to the gates about to be rewritten */
+  logic_cone_clear(circuit);
+
+  report->gates_before = gates;
+  report->levels_before = circuit->levels;
+  report->fanins_before = fanin_total;
+  report->luts = 0;
+
+  for (int n = 0; n < nets; n++) {
+    level[n] = 0;
+  }
+
+  circuit->levels = 0;
+  count = 0;
+  fanin = 0;
+
+  for (int g = 0; g < gates; g++) {
+    logic_gate_t gate = circuit->gate_list[g];
+
+    if (!required[gate.output]) {
+      continue;
+    }
+
+    if (mapped[g]) {
+      const logic_lut_cut_t *cut = &map.best[gate.output];
+
+      memcpy(&fanins[fanin], cut->leaf_list, cut->leaves * sizeof(int));
+
+      gate.logic_block_type = LUT;
+      gate.inputs = cut->leaves;
+      gate.floating = 0;
+      gate.truth_table = cut->truth_table & logic_lut_mask(cut->leaves);
+      report->luts += 1;
+    } else {
+      memcpy(&fanins[fanin], &circuit->fanins[gate.fanin],
+             gate.inputs * sizeof(int));
+    }
+
+    gate.fanin = fanin;
+    gate.level = 1;
+    fanin += gate.inputs;
+
+    for (int j = 0; j < gate.inputs; j++) {
+      if (level[fanins[gate.fanin + j]] + 1 > gate.level) {
+        gate.level = level[fanins[gate.fanin + j]] + 1;
+      }
+    }
+
+    level[gate.output] = gate.level;
+
+    if (gate.level > circuit->levels) {
+      circuit->levels = gate.level;
+    }
+
+    gate_list[count++] = gate;
+  }
+
+  /* Nets inside a table are no longer computed */
+  for (int b = 0; b < circuit->blocks; b++) {
+    int net = circuit->block_nets[b];
+
+    if (net >= LOGIC_NET_RESERVED + circuit->primary_inputs &&
+        !required[net]) {
+      circuit->block_nets[b] = -1;
+    }
+  }
+
+  logic_numa_free(circuit->gate_list);
+  logic_numa_free(circuit->fanins);
+
+  circuit->gate_list = gate_list;
+  circuit->fanins = fanins;
+  circuit->gates = count;
+  circuit->cells = report->luts;
+
+  report->gates_after = count;
+  report->levels_after = circuit->levels;
+  report->fanins_after = fanin;
+
+  status = 0;
+
+done:
+  if (map.cut_sets != NULL) {
+    for (int n = 0; n < nets; n++) {
+      free(map.cut_sets[n]);
+    }
+  }
+
+  free(map.cut_sets);
+  free(map.cut_counts);
+  free(map.readers);
+  free(map.fanouts);
+  free(map.best);
+  free(map.depth);
+  free(map.flow);
+  free(candidates);
+  free(mapped);
+  free(required);
+  free(driver);
+
+  return status;
+}
+
+void logic_lut_print_report(const logic_lut_report_t *report, FILE *stream) {
+  if (report == NULL || stream == NULL) {
+    return;
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+--------+--------+");
+  LOG_SIM_FILE_PRINT(stream, "|                 | BEFORE | AFTER  |");
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+--------+--------+");
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-6d | %-6d |", "Gates",
+                     report->gates_before, report->gates_after);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-6d | %-6d |", "Lookup tables", 0,
+                     report->luts);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-6d | %-6d |", "Levels",
+                     report->levels_before, report->levels_after);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-6d | %-6d |", "Net reads",
+                     report->fanins_before, report->fanins_after);
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+--------+--------+");
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,688 @@
+/**
+ * @file logsimmemory.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief RAM and ROM primitives with packed and paged storage.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimlib.h"
+#include "../include/logsimmemory.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_MEMORY_PAGE_CHUNKS (LOGIC_MEMORY_PAGE_BYTES / 8)
+#define LOGIC_MEMORY_EMPTY UINT64_MAX
+
+/*************** Function Definitions ***************/
+
+logic_memory_t *logic_memory_create(logic_memory_kind_t kind, int width,
+                                    uint64_t depth) {
+  if (width < 1 || depth < 1 || depth > UINT64_MAX / (uint64_t)width) {
+    return NULL;
+  }
+
+  logic_memory_t *memory = calloc(1, sizeof(logic_memory_t));
+
+  if (memory == NULL) {
+    return NULL;
+  }
+
+  memory->kind = kind;
+  memory->width = width;
+  memory->depth = depth;
+  memory->address_bits = 1;
+
+  while (memory->address_bits < 64 &&
+         (uint64_t)1 << memory->address_bits < depth) {
+    memory->address_bits += 1;
+  }
+
+  uint64_t chunks = (depth * width + 63) / 64;
+
+  /* Small memories are one packed array, large ones are paged */
+  if (chunks * 8 <= LOGIC_MEMORY_DENSE_BYTES) {
+    memory->bits = calloc(chunks, sizeof(uint64_t));
+
+    if (memory->bits == NULL) {
+      free(memory);
+      return NULL;
+    }
+  }
+
+  return memory;
+}
+
+static logic_memory_page_t *logic_memory_slot(logic_memory_page_t *page_list,
+                                              int capacity, uint64_t index) {
+  uint64_t slot = (index * 0x9E3779B97F4A7C15ull) & (uint64_t)(capacity - 1);
+
+  while (page_list[slot].index != LOGIC_MEMORY_EMPTY &&
+         page_list[slot].index != index) {
+    slot = (slot + 1) & (uint64_t)(capacity - 1);
+  }
+
+  return &page_list[slot];
+}
+
+static int logic_memory_grow(logic_memory_t *memory) {
+  int capacity = memory->page_capacity > 0 ? memory->page_capacity * 2 : 64;
+  logic_memory_page_t *page_list =
+      malloc(capacity * sizeof(logic_memory_page_t));
+
+  if (page_list == NULL) {
+    return -1;
+  }
+
+  for (int i = 0; i < capacity; i++) {
+    page_list[i].index = LOGIC_MEMORY_EMPTY;
+    page_list[i].bits = NULL;
+  }
+
+  for (int i = 0; i < memory->page_capacity; i++) {
+    if (memory->page_list[i].index != LOGIC_MEMORY_EMPTY) {
+      *logic_memory_slot(page_list, capacity, memory->page_list[i].index) =
+          memory->page_list[i];
+    }
+  }
+
+  free(memory->page_list);
+  memory->page_list = page_list;
+  memory->page_capacity = capacity;
+  memory->last_page = NULL;
+
+  return 0;
+}
+
+/* Chunk of 64 bits holding a bit offset, NULL for a page not written yet */
+static uint64_t *logic_memory_chunk(logic_memory_t *memory, uint64_t chunk,
+                                    bool create) {
+  if (memory->bits != NULL) {
+    return &memory->bits[chunk];
+  }
+
+  uint64_t index = chunk / LOGIC_MEMORY_PAGE_CHUNKS;
+  logic_memory_page_t *page = memory->last_page;
+
+  if (page == NULL || page->index != index) {
+    page = memory->page_capacity > 0
+               ? logic_memory_slot(memory->page_list, memory->page_capacity,
+                                   index)
+               : NULL;
+
+    if (page == NULL || page->index == LOGIC_MEMORY_EMPTY) {
+      if (!create) {
+        return NULL;
+      }
+
+      /* Keep the table at most half full */
+      if (2 * (memory->pages + 1) > memory->page_capacity) {
+        if (logic_memory_grow(memory) != 0) {
+          return NULL;
+        }
+      }
+
+      page = logic_memory_slot(memory->page_list, memory->page_capacity, index);
+      page->bits = calloc(LOGIC_MEMORY_PAGE_CHUNKS, sizeof(uint64_t));
+
+      if (page->bits == NULL) {
+        return NULL;
+      }
+
+      page->index = index;
+      memory->pages += 1;
+    }
+
+    memory->last_page = page;
+  }
+
+  return &page->bits[chunk % LOGIC_MEMORY_PAGE_CHUNKS];
+}
+
+/* Up to 64 bits from a bit offset, a word may straddle two chunks */
+static uint64_t logic_memory_get(logic_memory_t *memory, uint64_t offset,
+                                 int bits) {
+  uint64_t chunk = offset / 64;
+  int shift = (int)(offset % 64);
+  const uint64_t *low = logic_memory_chunk(memory, chunk, false);
+  uint64_t value = low != NULL ? *low >> shift : 0;
+
+  if (shift + bits > 64) {
+    const uint64_t *high = logic_memory_chunk(memory, chunk + 1, false);
+
+    value |= high != NULL ? *high << (64 - shift) : 0;
+  }
+
+  return bits == 64 ? value : value & (((uint64_t)1 << bits) - 1);
+}
+
+static int logic_memory_put(logic_memory_t *memory, uint64_t offset,
+                            int bits, uint64_t value) {
+  uint64_t chunk = offset / 64;
+  int shift = (int)(offset % 64);
+  uint64_t mask = bits == 64 ? ~(uint64_t)0 : ((uint64_t)1 << bits) - 1;
+
+  value &= mask;
+
+  /* Zeros written to a page that does not exist leave it so */
+  uint64_t *low = logic_memory_chunk(memory, chunk, (value << shift) != 0);
+
+  if (low != NULL) {
+    *low = (*low & ~(mask << shift)) | (value << shift);
+  } else if ((value << shift) != 0) {
+    return -1;
+  }
+
+  if (shift + bits > 64) {
+    uint64_t high_mask = mask >> (64 - shift);
+    uint64_t high_value = value >> (64 - shift);
+    uint64_t *high = logic_memory_chunk(memory, chunk + 1, high_value != 0);
+
+    if (high != NULL) {
+      *high = (*high & ~high_mask) | high_value;
+    } else if (high_value != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+int logic_memory_read(logic_memory_t *memory, uint64_t address,
+                      uint64_t *word) {
+  if (memory == NULL || word == NULL || address >= memory->depth) {
+    return -1;
+  }
+
+  uint64_t offset = address * memory->width;
+
+  for (int b = 0; b < memory->width; b += 64) {
+    int bits = memory->width - b < 64 ? memory->width - b : 64;
+
+    word[b / 64] = logic_memory_get(memory, offset + b, bits);
+  }
+
+  return 0;
+}
+
+int logic_memory_write(logic_memory_t *memory, uint64_t address,
+                       const uint64_t *word) {
+  if (memory == NULL || word == NULL || address >= memory->depth) {
+    return -1;
+  }
+
+  uint64_t offset = address * memory->width;
+
+  for (int b = 0; b < memory->width; b += 64) {
+    int bits = memory->width - b < 64 ? memory->width - b : 64;
+
+    if (logic_memory_put(memory, offset + b, bits, word[b / 64]) != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int logic_memory_load_binary(logic_memory_t *memory,
+                                    const unsigned char *data, size_t size) {
+  size_t bytes = (memory->width + 7) / 8;
+  uint64_t words = size / bytes;
+
+  if (words > memory->depth) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Image holds (%llu) words, memory (%llu).",
+                        (unsigned long long)words,
+                        (unsigned long long)memory->depth);
+    words = memory->depth;
+  }
+
+  for (uint64_t address = 0; address < words; address++) {
+    const unsigned char *word = &data[address * bytes];
+    uint64_t offset = address * memory->width;
+
+    for (int b = 0; b < memory->width; b += 64) {
+      int bits = memory->width - b < 64 ? memory->width - b : 64;
+      uint64_t value = 0;
+
+      for (int k = 0; k < (bits + 7) / 8; k++) {
+        value |= (uint64_t)word[b / 8 + k] << (8 * k);
+      }
+
+      if (logic_memory_put(memory, offset + b, bits, value) != 0) {
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static int logic_memory_hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+
+  return -1;
+}
+
+/* Store the hex digits [first, last) as a word, from the last digit up */
+static int logic_memory_put_hex(logic_memory_t *memory, uint64_t address,
+                                const char *first, const char *last) {
+  uint64_t offset = address * memory->width;
+  uint64_t value = 0;
+  int chunk = 0;
+  int position = 0;
+
+  for (const char *c = last - 1; c >= first; c--) {
+    if (*c == '_') {
+      continue;
+    }
+
+    if (position == 64) {
+      if (64 * chunk < memory->width &&
+          logic_memory_put(memory, offset + 64 * chunk,
+                           memory->width - 64 * chunk < 64
+                               ? memory->width - 64 * chunk
+                               : 64,
+                           value) != 0) {
+        return -1;
+      }
+
+      chunk += 1;
+      position = 0;
+      value = 0;
+    }
+
+    value |= (uint64_t)logic_memory_hex_digit(*c) << position;
+    position += 4;
+  }
+
+  /* Bits above the last digit read 0 */
+  for (; 64 * chunk < memory->width; chunk++, value = 0) {
+    int bits =
+        memory->width - 64 * chunk < 64 ? memory->width - 64 * chunk : 64;
+
+    if (logic_memory_put(memory, offset + 64 * chunk, bits, value) != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int logic_memory_load_hex(logic_memory_t *memory, const char *data,
+                                 size_t size) {
+  const char *end = data + size;
+  const char *c = data;
+  uint64_t address = 0;
+  int line = 1;
+
+  while (c < end) {
+    if (*c == '\n') {
+      line += 1;
+      c++;
+      continue;
+    }
+
+    if (*c == ' ' || *c == '\t' || *c == '\r') {
+      c++;
+      continue;
+    }
+
+    if (*c == '#' || (*c == '/' && c + 1 < end && c[1] == '/')) {
+      while (c < end && *c != '\n') {
+        c++;
+      }
+
+      continue;
+    }
+
+    bool at = *c == '@';
+    const char *first = at ? c + 1 : c;
+    const char *last = first;
+
+    while (last < end &&
+           (logic_memory_hex_digit(*last) != -1 || *last == '_')) {
+      last++;
+    }
+
+    if (last == first ||
+        (last < end && *last != ' ' && *last != '\t' && *last != '\r' &&
+         *last != '\n')) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Line (%d) of the image is not hex.", line);
+      return -1;
+    }
+
+    if (at) {
+      address = 0;
+
+      for (const char *d = first; d < last; d++) {
+        if (*d != '_') {
+          address = address * 16 + logic_memory_hex_digit(*d);
+        }
+      }
+    } else {
+      if (address >= memory->depth) {
+        LOG_SIM_DEBUG_PRINT(stderr, "Line (%d) of the image is past the end.",
+                            line);
+        return -1;
+      }
+
+      if (logic_memory_put_hex(memory, address, first, last) != 0) {
+        return -1;
+      }
+
+      address += 1;
+    }
+
+    c = last;
+  }
+
+  return 0;
+}
+
+int logic_memory_load(logic_memory_t *memory, const char *path,
+                      logic_memory_format_t format) {
+  if (memory == NULL || path == NULL) {
+    return -1;
+  }
+
+  int fd = open(path, O_RDONLY);
+
+  if (fd == -1) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to open (%s).", path);
+    return -1;
+  }
+
+  struct stat file_stat;
+
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    return -1;
+  }
+
+  size_t size = (size_t)file_stat.st_size;
+
+  if (size == 0) {
+    close(fd);
+    return 0;
+  }
+
+  void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  if (data == MAP_FAILED) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to map (%s).", path);
+    close(fd);
+    return -1;
+  }
+
+  /* Images are read once front to back */
+  madvise(data, size, MADV_SEQUENTIAL);
+
+  int status = format == LOGIC_MEMORY_BINARY
+                   ? logic_memory_load_binary(memory, data, size)
+                   : logic_memory_load_hex(memory, data, size);
+
+  munmap(data, size);
+  close(fd);
+
+  return status;
+}
+
+static logic_block_t *logic_memory_port(logic_sim_t *sim,
+                                        logic_memory_t *memory,
+                                        logic_block_type_t type, int inputs,
+                                        int outputs, const char *name,
+                                        const char *prefix) {
+  logic_block_t *logic_block =
+      logic_create_logic_block(sim, type, inputs, outputs, name, prefix);
+
+  if (logic_block == NULL) {
+    return NULL;
+  }
+
+  logic_block->width = outputs;
+  logic_block->memory = memory;
+
+  return logic_block;
+}
+
+logic_block_t *logic_create_memory_read(logic_sim_t *sim,
+                                        logic_memory_t *memory,
+                                        const char *name, const char *prefix) {
+  if (sim == NULL || memory == NULL) {
+    return NULL;
+  }
+
+  return logic_memory_port(sim, memory, MEM_READ, memory->address_bits,
+                           memory->width, name, prefix);
+}
+
+logic_block_t *logic_create_memory_write(logic_sim_t *sim,
+                                         logic_memory_t *memory,
+                                         const char *name, const char *prefix) {
+  if (sim == NULL || memory == NULL) {
+    return NULL;
+  }
+
+  if (memory->kind == LOGIC_MEMORY_ROM) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Write port (%s) on a ROM.", name);
+    return NULL;
+  }
+
+  if (memory->ports == memory->port_capacity) {
+    int capacity = memory->port_capacity > 0 ? memory->port_capacity * 2 : 4;
+    logic_memory_port_t *port_list =
+        realloc(memory->port_list, capacity * sizeof(logic_memory_port_t));
+
+    if (port_list == NULL) {
+      return NULL;
+    }
+
+    memory->port_list = port_list;
+    memory->port_capacity = capacity;
+  }
+
+  int inputs = 1 + memory->address_bits + memory->width;
+  logic_memory_port_t *port = &memory->port_list[memory->ports];
+
+  port->pending = false;
+  port->words = calloc(inputs, sizeof(logic_word_t));
+
+  if (port->words == NULL) {
+    return NULL;
+  }
+
+  logic_block_t *logic_block =
+      logic_memory_port(sim, memory, MEM_WRITE, inputs, 0, name, prefix);
+
+  if (logic_block == NULL) {
+    free(port->words);
+    return NULL;
+  }
+
+  logic_block->parameter = memory->ports++;
+
+  return logic_block;
+}
+
+/* True when every word is all 0 or all 1, the lanes then agree */
+static bool logic_memory_uniform(const logic_word_t *values, const int *fanins,
+                                 int count) {
+  for (int j = 0; j < count; j++) {
+    logic_word_t word = values[fanins[j]];
+
+    if (word != 0 && word != ~(logic_word_t)0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void logic_memory_evaluate(const logic_gate_t *gate, const int *fanins,
+                           logic_word_t *values) {
+  logic_memory_t *memory = gate->memory;
+
+  if (gate->logic_block_type == MEM_WRITE) {
+    logic_memory_port_t *port = &memory->port_list[gate->parameter];
+
+    /* Loops may evaluate a port again, only the settled inputs count */
+    for (int j = 0; j < gate->inputs; j++) {
+      port->words[j] = values[fanins[j]];
+    }
+
+    port->pending = true;
+    values[gate->output] = 0;
+    return;
+  }
+
+  logic_word_t *out = &values[gate->output];
+  int address_bits = memory->address_bits;
+  int width = memory->width;
+  bool uniform = logic_memory_uniform(values, fanins, address_bits);
+
+  for (int b = 0; b < width; b++) {
+    out[b] = 0;
+  }
+
+  /* Lanes sharing one address are read once */
+  for (int lane = 0; lane < (uniform ? 1 : LOGIC_LANES); lane++) {
+    uint64_t address = 0;
+
+    for (int a = 0; a < address_bits; a++) {
+      address |= ((values[fanins[a]] >> lane) & 1) << a;
+    }
+
+    if (address >= memory->depth) {
+      continue;
+    }
+
+    logic_word_t lanes = uniform ? ~(logic_word_t)0 : (logic_word_t)1 << lane;
+    uint64_t offset = address * width;
+
+    for (int b = 0; b < width; b += 64) {
+      uint64_t word =
+          logic_memory_get(memory, offset + b, width - b < 64 ? width - b : 64);
+
+      while (word != 0) {
+        out[b + __builtin_ctzll(word)] |= lanes;
+        word &= word - 1;
+      }
+    }
+  }
+}
+
+int logic_memory_commit(logic_memory_t *memory) {
+  if (memory == NULL) {
+    return -1;
+  }
+
+  int address_bits = memory->address_bits;
+  int width = memory->width;
+  int status = 0;
+  bool pending = false;
+
+  for (int p = 0; p < memory->ports; p++) {
+    pending = pending || memory->port_list[p].pending;
+  }
+
+  /* Lane order is vector order, a later lane overwrites an earlier one */
+  for (int lane = 0; lane < LOGIC_LANES && pending; lane++) {
+    for (int p = 0; p < memory->ports; p++) {
+      const logic_memory_port_t *port = &memory->port_list[p];
+
+      if (!port->pending || ((port->words[0] >> lane) & 1) == 0) {
+        continue;
+      }
+
+      const logic_word_t *address_words = &port->words[1];
+      const logic_word_t *data_words = &port->words[1 + address_bits];
+      uint64_t address = 0;
+
+      for (int a = 0; a < address_bits; a++) {
+        address |= ((address_words[a] >> lane) & 1) << a;
+      }
+
+      if (address >= memory->depth) {
+        continue;
+      }
+
+      for (int b = 0; b < width; b += 64) {
+        int bits = width - b < 64 ? width - b : 64;
+        uint64_t value = 0;
+
+        for (int i = 0; i < bits; i++) {
+          value |= ((data_words[b + i] >> lane) & 1) << i;
+        }
+
+        if (logic_memory_put(memory, address * width + b, bits, value) != 0) {
+          status = -1;
+        }
+      }
+    }
+  }
+
+  for (int p = 0; p < memory->ports; p++) {
+    memory->port_list[p].pending = false;
+  }
+
+  return status;
+}
+
+size_t logic_memory_footprint(const logic_memory_t *memory) {
+  if (memory == NULL) {
+    return 0;
+  }
+
+  if (memory->bits != NULL) {
+    return (memory->depth * memory->width + 63) / 64 * sizeof(uint64_t);
+  }
+
+  return (size_t)memory->pages * LOGIC_MEMORY_PAGE_BYTES +
+         (size_t)memory->page_capacity * sizeof(logic_memory_page_t);
+}
+
+void logic_memory_free(logic_memory_t *memory) {
+  if (memory == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < memory->page_capacity; i++) {
+    free(memory->page_list[i].bits);
+  }
+
+  for (int p = 0; p < memory->ports; p++) {
+    free(memory->port_list[p].words);
+  }
+
+  free(memory->bits);
+  free(memory->page_list);
+  free(memory->port_list);
+  free(memory);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
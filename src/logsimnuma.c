@@ -0,0 +1,394 @@
+/**
+ * @file logsimnuma.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Huge page backed circuit arrays, NUMA topology and worker pinning.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/* CPU_SET and sched_setaffinity */
+#define _GNU_SOURCE
+
+/*************** C Standard Headers ***************/
+
+#include <dirent.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimnuma.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_NUMA_ALIGN 64
+
+#define LOGIC_NUMA_NODES "/sys/devices/system/node"
+
+/*************** Structures ***************/
+
+/* Kept in the cache line before the memory handed out */
+typedef struct logic_numa_header {
+  void *base;
+  size_t length; /* Of the mapping, 0 when allocated on the heap */
+} logic_numa_header_t;
+
+/*************** Function Definitions ***************/
+
+static void *logic_numa_map(size_t length, int placement) {
+  void *base = MAP_FAILED;
+
+  if (placement & LOGIC_PLACE_EXPLICIT_HUGE_PAGES) {
+    base = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (base != MAP_FAILED) {
+      return base;
+    }
+  }
+
+  /* Over map by a page, so the start can be moved to a huge page boundary */
+  char *mapping = mmap(NULL, length + LOGIC_HUGE_PAGE_SIZE,
+                       PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1, 0);
+
+  if (mapping == MAP_FAILED) {
+    return MAP_FAILED;
+  }
+
+  size_t head = (LOGIC_HUGE_PAGE_SIZE -
+                 (uintptr_t)mapping % LOGIC_HUGE_PAGE_SIZE) %
+                LOGIC_HUGE_PAGE_SIZE;
+
+  if (head > 0) {
+    munmap(mapping, head);
+  }
+
+  munmap(mapping + head + length, LOGIC_HUGE_PAGE_SIZE - head);
+
+  base = mapping + head;
+
+#ifdef MADV_HUGEPAGE
+  madvise(base, length, MADV_HUGEPAGE);
+#endif
+
+  return base;
+}
+
+void *logic_numa_alloc(size_t size, int placement) {
+  size_t total = LOGIC_NUMA_ALIGN + size;
+  char *base = NULL;
+  size_t length = 0;
+
+  /* Smaller blocks would waste most of a huge page */
+  if ((placement &
+       (LOGIC_PLACE_HUGE_PAGES | LOGIC_PLACE_EXPLICIT_HUGE_PAGES)) != 0 &&
+      size >= LOGIC_HUGE_PAGE_SIZE / 2) {
+    length = (total + LOGIC_HUGE_PAGE_SIZE - 1) & ~(LOGIC_HUGE_PAGE_SIZE - 1);
+    base = logic_numa_map(length, placement);
+
+    if (base == MAP_FAILED) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Failed to map (%zu) bytes on huge pages.",
+                          size);
+      base = NULL;
+      length = 0;
+    }
+  }
+
+  if (base == NULL) {
+    if (posix_memalign((void **)&base, LOGIC_NUMA_ALIGN, total) != 0) {
+      return NULL;
+    }
+
+    memset(base, 0, total);
+  }
+
+  logic_numa_header_t *header = (logic_numa_header_t *)base;
+
+  header->base = base;
+  header->length = length;
+
+  return base + LOGIC_NUMA_ALIGN;
+}
+
+void logic_numa_free(void *memory) {
+  if (memory == NULL) {
+    return;
+  }
+
+  logic_numa_header_t *header =
+      (logic_numa_header_t *)((char *)memory - LOGIC_NUMA_ALIGN);
+
+  if (header->length > 0) {
+    munmap(header->base, header->length);
+  } else {
+    free(header->base);
+  }
+}
+
+int logic_circuit_place(logic_circuit_t *circuit, int placement) {
+  if (circuit == NULL) {
+    return -1;
+  }
+
+  int gates = circuit->gates;
+  int fanin_total = gates > 0 ? circuit->gate_list[gates - 1].fanin +
+                                    circuit->gate_list[gates - 1].inputs
+                              : 0;
+  size_t gates_size = (gates + 1) * sizeof(logic_gate_t);
+  size_t fanins_size = (fanin_total + 1) * sizeof(int);
+  size_t values_size = circuit->nets * sizeof(logic_word_t);
+
+  logic_gate_t *gate_list = logic_numa_alloc(gates_size, placement);
+  int *fanins = logic_numa_alloc(fanins_size, placement);
+  logic_word_t *values = logic_numa_alloc(values_size, placement);
+
+  if (gate_list == NULL || fanins == NULL || values == NULL) {
+    logic_numa_free(gate_list);
+    logic_numa_free(fanins);
+    logic_numa_free(values);
+    return -1;
+  }
+
+  memcpy(gate_list, circuit->gate_list, gates_size);
+  memcpy(fanins, circuit->fanins, fanins_size);
+  memcpy(values, circuit->values, values_size);
+
+  logic_numa_free(circuit->gate_list);
+  logic_numa_free(circuit->fanins);
+  logic_numa_free(circuit->values);
+
+  circuit->gate_list = gate_list;
+  circuit->fanins = fanins;
+  circuit->values = values;
+  circuit->placement = placement;
+
+  return 0;
+}
+
+/**************************************/
+
+/* Parse a sysfs list such as 0-3,8-11, keeping the allowed processors */
+static int logic_topology_parse(const char *text, const cpu_set_t *allowed,
+                                int *cpu_list, int cpus, int capacity) {
+  while (*text != '\0' && *text != '\n') {
+    char *end;
+    long first = strtol(text, &end, 10);
+    long last = first;
+
+    if (end == text) {
+      break;
+    }
+
+    if (*end == '-') {
+      text = end + 1;
+      last = strtol(text, &end, 10);
+    }
+
+    for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+      if (cpu >= 0 && cpus < capacity && CPU_ISSET(cpu, allowed)) {
+        cpu_list[cpus++] = (int)cpu;
+      }
+    }
+
+    text = *end == ',' ? end + 1 : end;
+  }
+
+  return cpus;
+}
+
+static int logic_topology_compare(const void *a, const void *b) {
+  return *(const int *)a - *(const int *)b;
+}
+
+logic_topology_t *logic_topology_create(void) {
+  cpu_set_t allowed;
+
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return NULL;
+  }
+
+  int allowed_cpus = CPU_COUNT(&allowed);
+  logic_topology_t *topology = calloc(1, sizeof(logic_topology_t));
+  int node_capacity = 8;
+
+  if (topology == NULL) {
+    return NULL;
+  }
+
+  topology->cpu_list = malloc((allowed_cpus + 1) * sizeof(int));
+  topology->node_ids = malloc(node_capacity * sizeof(int));
+
+  if (topology->cpu_list == NULL || topology->node_ids == NULL) {
+    logic_topology_free(topology);
+    return NULL;
+  }
+
+  DIR *directory = opendir(LOGIC_NUMA_NODES);
+  struct dirent *entry;
+
+  while (directory != NULL && (entry = readdir(directory)) != NULL) {
+    int node;
+
+    if (sscanf(entry->d_name, "node%d", &node) != 1) {
+      continue;
+    }
+
+    if (topology->nodes + 1 == node_capacity) {
+      int *node_ids = realloc(topology->node_ids,
+                              node_capacity * 2 * sizeof(int));
+
+      if (node_ids == NULL) {
+        break;
+      }
+
+      topology->node_ids = node_ids;
+      node_capacity *= 2;
+    }
+
+    topology->node_ids[topology->nodes++] = node;
+  }
+
+  if (directory != NULL) {
+    closedir(directory);
+  }
+
+  /* Directory order is arbitrary, nodes are listed by number */
+  qsort(topology->node_ids, topology->nodes, sizeof(int),
+        logic_topology_compare);
+
+  topology->node_offsets = malloc((topology->nodes + 2) * sizeof(int));
+
+  if (topology->node_offsets == NULL) {
+    logic_topology_free(topology);
+    return NULL;
+  }
+
+  int nodes = 0;
+
+  for (int n = 0; n < topology->nodes; n++) {
+    char path[512];
+    char text[4096] = "";
+
+    snprintf(path, sizeof(path), LOGIC_NUMA_NODES "/node%d/cpulist",
+             topology->node_ids[n]);
+
+    FILE *file = fopen(path, "r");
+
+    if (file != NULL) {
+      if (fgets(text, sizeof(text), file) == NULL) {
+        text[0] = '\0';
+      }
+
+      fclose(file);
+    }
+
+    int first = topology->cpus;
+
+    topology->cpus = logic_topology_parse(text, &allowed, topology->cpu_list,
+                                          topology->cpus, allowed_cpus);
+
+    /* Nodes of memory alone, or outside the affinity mask, are left out */
+    if (topology->cpus > first) {
+      topology->node_ids[nodes] = topology->node_ids[n];
+      topology->node_offsets[nodes++] = first;
+    }
+  }
+
+  if (topology->cpus < allowed_cpus || nodes == 0) {
+    /* No sysfs tree, or one listing less than the mask */
+    topology->cpus = 0;
+    nodes = 1;
+    topology->node_ids[0] = 0;
+    topology->node_offsets[0] = 0;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &allowed)) {
+        topology->cpu_list[topology->cpus++] = cpu;
+      }
+    }
+  }
+
+  topology->nodes = nodes;
+  topology->node_offsets[nodes] = topology->cpus;
+
+  return topology;
+}
+
+int logic_topology_cpu(const logic_topology_t *topology, int worker,
+                       bool spread) {
+  if (topology == NULL || topology->cpus == 0 || worker < 0) {
+    return -1;
+  }
+
+  if (!spread) {
+    return topology->cpu_list[worker % topology->cpus];
+  }
+
+  int node = worker % topology->nodes;
+  int first = topology->node_offsets[node];
+  int size = topology->node_offsets[node + 1] - first;
+
+  return topology->cpu_list[first + (worker / topology->nodes) % size];
+}
+
+int logic_topology_pin(int cpu) {
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return -1;
+  }
+
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+
+  /* Pid 0 is the calling thread */
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to pin to processor (%d).", cpu);
+    return -1;
+  }
+
+  return 0;
+}
+
+void logic_topology_print(const logic_topology_t *topology, FILE *stream) {
+  if (topology == NULL || stream == NULL) {
+    return;
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+  LOG_SIM_FILE_PRINT(stream, "|   NODE          | PROCESSORS |");
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+
+  for (int n = 0; n < topology->nodes; n++) {
+    char label[32];
+
+    snprintf(label, sizeof(label), "Node %d", topology->node_ids[n]);
+
+    LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d |", label,
+                       topology->node_offsets[n + 1] -
+                           topology->node_offsets[n]);
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+}
+
+void logic_topology_free(logic_topology_t *topology) {
+  if (topology == NULL) {
+    return;
+  }
+
+  free(topology->node_ids);
+  free(topology->node_offsets);
+  free(topology->cpu_list);
+  free(topology);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,464 @@
+/**
+ * @file logsimopt.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Netlist optimization passes run on compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimcone.h"
+#include "../include/logsimnuma.h"
+#include "../include/logsimopt.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+/* Simplification left a gate that still has to be evaluated */
+#define LOGIC_OPT_KEEP -1
+
+/*************** Function Definitions ***************/
+
+static int logic_opt_compare(const void *a, const void *b) {
+  int net_a = *(const int *)a;
+  int net_b = *(const int *)b;
+
+  return (net_a > net_b) - (net_a < net_b);
+}
+
+static int logic_opt_remove(int *fanins, int inputs, int net) {
+  int count = 0;
+
+  for (int j = 0; j < inputs; j++) {
+    if (fanins[j] != net) {
+      fanins[count++] = fanins[j];
+    }
+  }
+
+  return count;
+}
+
+static int logic_opt_unique(int *fanins, int inputs) {
+  int count = 0;
+
+  for (int j = 0; j < inputs; j++) {
+    if (count == 0 || fanins[count - 1] != fanins[j]) {
+      fanins[count++] = fanins[j];
+    }
+  }
+
+  return count;
+}
+
+/* Reduce a gate over already substituted fanins, returns the equivalent net */
+static int logic_opt_simplify(const logic_gate_t *gate_list,
+                              const int *kept_fanins, const int *driver,
+                              logic_block_type_t *type, int *fanins,
+                              int *inputs) {
+  int count = *inputs;
+
+  switch (*type) {
+  case AND:
+  case OR: {
+    int absorbing = *type == AND ? LOGIC_NET_CONST0 : LOGIC_NET_CONST1;
+    int neutral = *type == AND ? LOGIC_NET_CONST1 : LOGIC_NET_CONST0;
+
+    for (int j = 0; j < count; j++) {
+      if (fanins[j] == absorbing) {
+        return absorbing;
+      }
+    }
+
+    count = logic_opt_remove(fanins, count, neutral);
+    qsort(fanins, count, sizeof(int), logic_opt_compare);
+    count = logic_opt_unique(fanins, count);
+
+    *inputs = count;
+
+    if (count == 0) {
+      return neutral;
+    }
+
+    return count == 1 ? fanins[0] : LOGIC_OPT_KEEP;
+  }
+  case XOR: {
+    int parity = 0;
+
+    for (int j = 0; j < count; j++) {
+      parity ^= fanins[j] == LOGIC_NET_CONST1;
+    }
+
+    count = logic_opt_remove(fanins, count, LOGIC_NET_CONST0);
+    count = logic_opt_remove(fanins, count, LOGIC_NET_CONST1);
+    qsort(fanins, count, sizeof(int), logic_opt_compare);
+
+    /* Equal pairs cancel out */
+    int kept = 0;
+
+    for (int j = 0; j < count; j++) {
+      if (j + 1 < count && fanins[j] == fanins[j + 1]) {
+        j += 1;
+        continue;
+      }
+
+      fanins[kept++] = fanins[j];
+    }
+
+    count = kept;
+
+    if (count == 0) {
+      *inputs = 0;
+      return parity ? LOGIC_NET_CONST1 : LOGIC_NET_CONST0;
+    }
+
+    if (count == 1 && parity == 0) {
+      *inputs = 1;
+      return fanins[0];
+    }
+
+    if (count == 1) {
+      *type = NOT;
+    } else if (parity) {
+      fanins[count++] = LOGIC_NET_CONST1;
+    }
+
+    *inputs = count;
+
+    if (*type != NOT) {
+      return LOGIC_OPT_KEEP;
+    }
+  }
+  /* fall through */
+  case NOT: {
+    if (count == 0) {
+      return LOGIC_NET_CONST1;
+    }
+
+    int net = fanins[count - 1];
+
+    fanins[0] = net;
+    *inputs = 1;
+
+    if (net == LOGIC_NET_CONST0 || net == LOGIC_NET_CONST1) {
+      return net == LOGIC_NET_CONST0 ? LOGIC_NET_CONST1 : LOGIC_NET_CONST0;
+    }
+
+    /* Double inversion */
+    if (driver[net] >= 0 && gate_list[driver[net]].logic_block_type == NOT) {
+      return kept_fanins[gate_list[driver[net]].fanin];
+    }
+
+    return LOGIC_OPT_KEEP;
+  }
+  default: {
+    break;
+  }
+  }
+
+  return LOGIC_OPT_KEEP;
+}
+
+static uint64_t logic_opt_hash(logic_block_type_t type, const int *fanins,
+                               int inputs) {
+  uint64_t hash = 0xCBF29CE484222325ull ^ (uint64_t)type;
+
+  for (int j = 0; j < inputs; j++) {
+    hash = (hash ^ (uint64_t)(uint32_t)fanins[j]) * 0x100000001B3ull;
+  }
+
+  return hash;
+}
+
+int logic_circuit_optimize(logic_circuit_t *circuit,
+                           const logic_opt_options_t *options,
+                           logic_opt_report_t *report) {
+  logic_opt_options_t all = {true, true, true, false};
+  logic_opt_report_t local = {0};
+
+  if (circuit == NULL) {
+    return -1;
+  }
+
+  /* Single pass rewrites assume every fanin is final when it is read */
+  if (circuit->loops > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with feedback loops are not "
+                                "optimized.");
+    return -1;
+  }
+
+  if (circuit->cells > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with word level cells are not "
+                                "optimized.");
+    return -1;
+  }
+
+  if (options == NULL) {
+    options = &all;
+  }
+
+  if (report == NULL) {
+    report = &local;
+  }
+
+  int nets = circuit->nets;
+  int gates = circuit->gates;
+  int fanin_total = gates > 0 ? circuit->gate_list[gates - 1].fanin +
+                                    circuit->gate_list[gates - 1].inputs
+                              : 0;
+
+  int max_inputs = 1;
+
+  for (int g = 0; g < gates; g++) {
+    if (circuit->gate_list[g].inputs + 1 > max_inputs) {
+      max_inputs = circuit->gate_list[g].inputs + 1;
+    }
+  }
+
+  /* Kept gates are a subset of the originals, so every array fits */
+  int table_size = 16;
+
+  while (table_size < gates * 2) {
+    table_size <<= 1;
+  }
+
+  int *repl = malloc(nets * sizeof(int));
+  int *driver = malloc(nets * sizeof(int));
+  bool *live = calloc(nets, sizeof(bool));
+  bool *kept = calloc(gates + 1, sizeof(bool));
+  int *buffer = malloc(max_inputs * sizeof(int));
+  int *table = malloc(table_size * sizeof(int));
+  int *fanins =
+      logic_numa_alloc((fanin_total + 1) * sizeof(int), circuit->placement);
+  logic_gate_t *gate_list = logic_numa_alloc(
+      (gates + 1) * sizeof(logic_gate_t), circuit->placement);
+
+  if (repl == NULL || driver == NULL || live == NULL || kept == NULL ||
+      buffer == NULL || table == NULL || fanins == NULL || gate_list == NULL) {
+    free(repl);
+    free(driver);
+    free(live);
+    free(kept);
+    free(buffer);
+    free(table);
+    logic_numa_free(fanins);
+    logic_numa_free(gate_list);
+    return -1;
+  }
+
+  /* Cached schedules refer to the gates about to be rewritten */
+  logic_cone_clear(circuit);
+
+  for (int n = 0; n < nets; n++) {
+    repl[n] = n;
+    driver[n] = -1;
+  }
+
+  for (int i = 0; i < table_size; i++) {
+    table[i] = -1;
+  }
+
+  if (options->constant_inputs) {
+    for (int i = 0; i < circuit->primary_inputs; i++) {
+      repl[LOGIC_INPUT_NET(i)] = circuit->input_list[i]->data
+                                     ? LOGIC_NET_CONST1
+                                     : LOGIC_NET_CONST0;
+    }
+  }
+
+  report->gates_before = gates;
+  report->folded = 0;
+  report->merged = 0;
+  report->dead = 0;
+
+  /* Rewrite gate by gate, every fanin is final before its readers */
+  int fanin = 0;
+
+  for (int g = 0; g < gates; g++) {
+    logic_gate_t *gate = &circuit->gate_list[g];
+    logic_block_type_t type = gate->logic_block_type;
+    int inputs = gate->inputs;
+
+    for (int j = 0; j < inputs; j++) {
+      buffer[j] = repl[circuit->fanins[gate->fanin + j]];
+    }
+
+    if (options->propagate_constants) {
+      int net = logic_opt_simplify(circuit->gate_list, fanins, driver, &type,
+                                   buffer, &inputs);
+
+      if (net != LOGIC_OPT_KEEP) {
+        repl[gate->output] = net;
+        report->folded += 1;
+        continue;
+      }
+    } else if (type == NOT && inputs > 1) {
+      buffer[0] = buffer[inputs - 1];
+      inputs = 1;
+    } else if (type != NOT) {
+      qsort(buffer, inputs, sizeof(int), logic_opt_compare);
+    }
+
+    if (options->structural_hashing) {
+      uint64_t hash = logic_opt_hash(type, buffer, inputs);
+      int slot = (int)(hash & (uint64_t)(table_size - 1));
+      int hit = -1;
+
+      while (table[slot] != -1) {
+        logic_gate_t *other = &circuit->gate_list[table[slot]];
+
+        if (other->logic_block_type == type && other->inputs == inputs &&
+            memcmp(&fanins[other->fanin], buffer, inputs * sizeof(int)) == 0) {
+          hit = table[slot];
+          break;
+        }
+
+        slot = (slot + 1) & (table_size - 1);
+      }
+
+      if (hit != -1) {
+        repl[gate->output] = circuit->gate_list[hit].output;
+        report->merged += 1;
+        continue;
+      }
+
+      table[slot] = g;
+    }
+
+    /* The rewritten fanins never outrun the original ones */
+    memcpy(&fanins[fanin], buffer, inputs * sizeof(int));
+
+    gate->logic_block_type = type;
+    gate->fanin = fanin;
+    gate->inputs = inputs;
+    fanin += inputs;
+
+    driver[gate->output] = g;
+    kept[g] = true;
+  }
+
+  for (int i = 0; i < circuit->outputs; i++) {
+    circuit->output_nets[i] = repl[circuit->output_nets[i]];
+    live[circuit->output_nets[i]] = true;
+  }
+
+  if (options->sweep_dead_gates) {
+    for (int g = gates - 1; g >= 0; g--) {
+      logic_gate_t *gate = &circuit->gate_list[g];
+
+      if (!kept[g]) {
+        continue;
+      }
+
+      if (!live[gate->output]) {
+        kept[g] = false;
+        report->dead += 1;
+        continue;
+      }
+
+      for (int j = 0; j < gate->inputs; j++) {
+        live[fanins[gate->fanin + j]] = true;
+      }
+    }
+  }
+
+  /* Compact the kept gates and recompute their levels */
+  int *level = driver;
+  int count = 0;
+
+  for (int n = 0; n < nets; n++) {
+    level[n] = 0;
+  }
+
+  circuit->levels = 0;
+
+  for (int g = 0; g < gates; g++) {
+    logic_gate_t gate = circuit->gate_list[g];
+
+    if (!kept[g]) {
+      continue;
+    }
+
+    gate.level = 1;
+
+    for (int j = 0; j < gate.inputs; j++) {
+      if (level[fanins[gate.fanin + j]] + 1 > gate.level) {
+        gate.level = level[fanins[gate.fanin + j]] + 1;
+      }
+    }
+
+    level[gate.output] = gate.level;
+
+    if (gate.level > circuit->levels) {
+      circuit->levels = gate.level;
+    }
+
+    gate_list[count++] = gate;
+  }
+
+  /* Blocks follow their replacement net, swept nets are not written back */
+  for (int b = 0; b < circuit->blocks; b++) {
+    int net = circuit->block_nets[b];
+
+    if (net < 0) {
+      continue;
+    }
+
+    net = repl[net];
+
+    if (net >= LOGIC_NET_RESERVED + circuit->primary_inputs &&
+        level[net] == 0) {
+      net = -1;
+    }
+
+    circuit->block_nets[b] = net;
+  }
+
+  logic_numa_free(circuit->gate_list);
+  logic_numa_free(circuit->fanins);
+
+  circuit->gate_list = gate_list;
+  circuit->fanins = fanins;
+  circuit->gates = count;
+
+  report->gates_after = count;
+
+  free(repl);
+  free(driver);
+  free(live);
+  free(kept);
+  free(buffer);
+  free(table);
+
+  return 0;
+}
+
+void logic_opt_print_report(const logic_opt_report_t *report, FILE *stream) {
+  if (report == NULL || stream == NULL) {
+    return;
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+--------+");
+  LOG_SIM_FILE_PRINT(stream, "|   PASS          | GATES  |");
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+--------+");
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-6d |", "Before",
+                     report->gates_before);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-6d |", "Constant folded",
+                     report->folded);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-6d |", "Merged", report->merged);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-6d |", "Dead", report->dead);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-6d |", "After",
+                     report->gates_after);
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+--------+");
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
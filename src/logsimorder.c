@@ -0,0 +1,509 @@
+/**
+ * @file logsimorder.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Gate and net reordering of compiled circuits for memory locality.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimcone.h"
+#include "../include/logsimnuma.h"
+#include "../include/logsimorder.h"
+#include "../include/utils.h"
+
+/*************** Structures ***************/
+
+/* Gates reading each gate, each reader listed once */
+typedef struct logic_order_graph {
+  int *driver; /* Per net, the gate driving it or -1 */
+
+  int *reader_offsets;
+  int *reader_list;
+
+  int *pending; /* Per gate, driving gates not yet placed */
+} logic_order_graph_t;
+
+/* Reader made ready by a placement, sorted by its number of readers */
+typedef struct logic_order_ready {
+  int readers;
+  int gate;
+} logic_order_ready_t;
+
+/*************** Function Definitions ***************/
+
+double logic_circuit_locality(const logic_circuit_t *circuit, int *bandwidth) {
+  if (bandwidth != NULL) {
+    *bandwidth = 0;
+  }
+
+  if (circuit == NULL) {
+    return 0.0;
+  }
+
+  int base = LOGIC_NET_RESERVED + circuit->primary_inputs;
+  double total = 0.0;
+  long reads = 0;
+
+  for (int g = 0; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int net = circuit->fanins[gate->fanin + j];
+
+      if (net < base) {
+        continue;
+      }
+
+      int distance = abs(gate->output - net);
+
+      if (bandwidth != NULL && distance > *bandwidth) {
+        *bandwidth = distance;
+      }
+
+      total += distance;
+      reads += 1;
+    }
+  }
+
+  return reads > 0 ? total / (double)reads : 0.0;
+}
+
+static void logic_order_graph_free(logic_order_graph_t *graph) {
+  free(graph->driver);
+  free(graph->reader_offsets);
+  free(graph->reader_list);
+  free(graph->pending);
+}
+
+static int logic_order_graph_build(const logic_circuit_t *circuit,
+                                   logic_order_graph_t *graph) {
+  int gates = circuit->gates;
+  int fanin_total = gates > 0 ? circuit->gate_list[gates - 1].fanin +
+                                    circuit->gate_list[gates - 1].inputs
+                              : 0;
+  int *seen = malloc((gates + 1) * sizeof(int));
+
+  graph->driver = malloc(circuit->nets * sizeof(int));
+  graph->reader_offsets = calloc(gates + 2, sizeof(int));
+  graph->reader_list = malloc((fanin_total + 1) * sizeof(int));
+  graph->pending = calloc(gates + 1, sizeof(int));
+
+  if (seen == NULL || graph->driver == NULL ||
+      graph->reader_offsets == NULL || graph->reader_list == NULL ||
+      graph->pending == NULL) {
+    free(seen);
+    logic_order_graph_free(graph);
+    return -1;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    graph->driver[n] = -1;
+  }
+
+  for (int g = 0; g < gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int b = 0; b < gate->width; b++) {
+      graph->driver[gate->output + b] = g;
+    }
+  }
+
+  /* Count, then place, every distinct driving gate of each gate */
+  for (int pass = 0; pass < 2; pass++) {
+    for (int g = 0; g < gates; g++) {
+      seen[g] = -1;
+    }
+
+    for (int g = 0; g < gates; g++) {
+      const logic_gate_t *gate = &circuit->gate_list[g];
+
+      for (int j = 0; j < gate->inputs; j++) {
+        int d = graph->driver[circuit->fanins[gate->fanin + j]];
+
+        if (d < 0 || d == g || seen[d] == g) {
+          continue;
+        }
+
+        seen[d] = g;
+
+        if (pass == 0) {
+          graph->reader_offsets[d + 1] += 1;
+          graph->pending[g] += 1;
+        } else {
+          graph->reader_list[graph->reader_offsets[d + 1]++] = g;
+        }
+      }
+    }
+
+    /* Prefix sums, shifted by one so the second pass ends on the offsets */
+    if (pass == 0) {
+      for (int g = 0; g < gates; g++) {
+        graph->reader_offsets[g + 1] += graph->reader_offsets[g];
+      }
+
+      memmove(&graph->reader_offsets[1], &graph->reader_offsets[0],
+              gates * sizeof(int));
+      graph->reader_offsets[0] = 0;
+    }
+  }
+
+  free(seen);
+
+  return 0;
+}
+
+/* Post-order from the outputs, then from the gates outside their cones */
+static int logic_order_dfs(const logic_circuit_t *circuit,
+                           const logic_order_graph_t *graph, int *order) {
+  int gates = circuit->gates;
+  uint8_t *state = calloc(gates + 1, sizeof(uint8_t));
+  int *stack = malloc((gates + 1) * sizeof(int));
+  int *next = malloc((gates + 1) * sizeof(int));
+  int count = 0;
+
+  if (state == NULL || stack == NULL || next == NULL) {
+    free(state);
+    free(stack);
+    free(next);
+    return -1;
+  }
+
+  for (int i = 0; i < circuit->outputs + gates; i++) {
+    int root = i < circuit->outputs ? graph->driver[circuit->output_nets[i]]
+                                    : i - circuit->outputs;
+
+    if (root < 0 || state[root] != 0) {
+      continue;
+    }
+
+    int depth = 0;
+
+    state[root] = 1;
+    next[root] = 0;
+    stack[depth++] = root;
+
+    while (depth > 0) {
+      int g = stack[depth - 1];
+      const logic_gate_t *gate = &circuit->gate_list[g];
+
+      if (next[g] < gate->inputs) {
+        int d = graph->driver[circuit->fanins[gate->fanin + next[g]++]];
+
+        if (d >= 0 && state[d] == 0) {
+          state[d] = 1;
+          next[d] = 0;
+          stack[depth++] = d;
+        }
+
+        continue;
+      }
+
+      depth -= 1;
+      order[count++] = g;
+    }
+  }
+
+  free(state);
+  free(stack);
+  free(next);
+
+  return 0;
+}
+
+/* Depth first order, stably bucketed by level */
+static int logic_order_level(const logic_circuit_t *circuit,
+                             const logic_order_graph_t *graph, int *order) {
+  int gates = circuit->gates;
+  int *dfs = malloc((gates + 1) * sizeof(int));
+  int *offsets = calloc(circuit->levels + 2, sizeof(int));
+
+  if (dfs == NULL || offsets == NULL ||
+      logic_order_dfs(circuit, graph, dfs) != 0) {
+    free(dfs);
+    free(offsets);
+    return -1;
+  }
+
+  for (int g = 0; g < gates; g++) {
+    offsets[circuit->gate_list[g].level + 1] += 1;
+  }
+
+  for (int l = 0; l <= circuit->levels; l++) {
+    offsets[l + 1] += offsets[l];
+  }
+
+  for (int i = 0; i < gates; i++) {
+    order[offsets[circuit->gate_list[dfs[i]].level]++] = dfs[i];
+  }
+
+  free(dfs);
+  free(offsets);
+
+  return 0;
+}
+
+static int logic_order_compare(const void *a, const void *b) {
+  const logic_order_ready_t *ready_a = a;
+  const logic_order_ready_t *ready_b = b;
+
+  if (ready_a->readers != ready_b->readers) {
+    return ready_a->readers - ready_b->readers;
+  }
+
+  return ready_a->gate - ready_b->gate;
+}
+
+/*
+ * Topological placement from the gates reading only inputs. Cuthill-McKee
+ * queues the readers a placement makes ready, fewest readers first, while
+ * fanout clustering stacks them so they follow their driver at once.
+ */
+static int logic_order_ready(const logic_circuit_t *circuit,
+                             logic_order_graph_t *graph, bool cluster,
+                             int *order) {
+  int gates = circuit->gates;
+  int *list = malloc((gates + 1) * sizeof(int));
+  logic_order_ready_t *ready =
+      malloc((gates + 1) * sizeof(logic_order_ready_t));
+  int head = 0;
+  int tail = 0;
+  int count = 0;
+
+  if (list == NULL || ready == NULL) {
+    free(list);
+    free(ready);
+    return -1;
+  }
+
+  int sources = 0;
+
+  for (int g = 0; g < gates; g++) {
+    if (graph->pending[g] == 0) {
+      ready[sources++] = (logic_order_ready_t){
+          graph->reader_offsets[g + 1] - graph->reader_offsets[g], g};
+    }
+  }
+
+  qsort(ready, sources, sizeof(logic_order_ready_t), logic_order_compare);
+
+  /* The stack pops from the end, so the sources go on it reversed */
+  for (int i = 0; i < sources; i++) {
+    list[tail++] = ready[cluster ? sources - 1 - i : i].gate;
+  }
+
+  while (cluster ? tail > 0 : head < tail) {
+    int g = cluster ? list[--tail] : list[head++];
+    int made = 0;
+
+    order[count++] = g;
+
+    for (int r = graph->reader_offsets[g]; r < graph->reader_offsets[g + 1];
+         r++) {
+      int reader = graph->reader_list[r];
+
+      if (--graph->pending[reader] == 0) {
+        ready[made++] = (logic_order_ready_t){
+            graph->reader_offsets[reader + 1] - graph->reader_offsets[reader],
+            reader};
+      }
+    }
+
+    qsort(ready, made, sizeof(logic_order_ready_t), logic_order_compare);
+
+    for (int i = 0; i < made; i++) {
+      list[tail++] = ready[cluster ? made - 1 - i : i].gate;
+    }
+  }
+
+  free(list);
+  free(ready);
+
+  return count == gates ? 0 : -1;
+}
+
+/* Lay the gate nets out in the new gate order and renumber every reference */
+static int logic_order_apply(logic_circuit_t *circuit, const int *order) {
+  int gates = circuit->gates;
+  int base = LOGIC_NET_RESERVED + circuit->primary_inputs;
+  int fanin_total = gates > 0 ? circuit->gate_list[gates - 1].fanin +
+                                    circuit->gate_list[gates - 1].inputs
+                              : 0;
+
+  int *net_map = malloc(circuit->nets * sizeof(int));
+  logic_gate_t *gate_list = logic_numa_alloc(
+      (gates + 1) * sizeof(logic_gate_t), circuit->placement);
+  int *fanins =
+      logic_numa_alloc((fanin_total + 1) * sizeof(int), circuit->placement);
+  logic_word_t *previous =
+      malloc((circuit->nets - base + 1) * sizeof(logic_word_t));
+
+  if (net_map == NULL || gate_list == NULL || fanins == NULL ||
+      previous == NULL) {
+    free(net_map);
+    logic_numa_free(gate_list);
+    logic_numa_free(fanins);
+    free(previous);
+    return -1;
+  }
+
+  /* Nets of swept gates have no driver, they are dropped */
+  for (int n = 0; n < circuit->nets; n++) {
+    net_map[n] = n < base ? n : -1;
+  }
+
+  int net = base;
+
+  for (int i = 0; i < gates; i++) {
+    gate_list[i] = circuit->gate_list[order[i]];
+
+    for (int b = 0; b < gate_list[i].width; b++) {
+      net_map[gate_list[i].output + b] = net + b;
+    }
+
+    gate_list[i].output = net;
+    net += gate_list[i].width;
+  }
+
+  int fanin = 0;
+
+  for (int i = 0; i < gates; i++) {
+    logic_gate_t *gate = &gate_list[i];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      fanins[fanin + j] = net_map[circuit->fanins[gate->fanin + j]];
+    }
+
+    gate->fanin = fanin;
+    fanin += gate->inputs;
+  }
+
+  memcpy(previous, &circuit->values[base],
+         (circuit->nets - base) * sizeof(logic_word_t));
+
+  for (int n = base; n < circuit->nets; n++) {
+    if (net_map[n] >= 0) {
+      circuit->values[net_map[n]] = previous[n - base];
+    }
+  }
+
+  for (int i = 0; i < circuit->outputs; i++) {
+    circuit->output_nets[i] = net_map[circuit->output_nets[i]];
+  }
+
+  for (int b = 0; b < circuit->blocks; b++) {
+    if (circuit->block_nets[b] >= 0) {
+      circuit->block_nets[b] = net_map[circuit->block_nets[b]];
+    }
+  }
+
+  logic_numa_free(circuit->gate_list);
+  logic_numa_free(circuit->fanins);
+
+  circuit->gate_list = gate_list;
+  circuit->fanins = fanins;
+  circuit->nets = net;
+
+  free(net_map);
+  free(previous);
+
+  return 0;
+}
+
+int logic_circuit_reorder(logic_circuit_t *circuit,
+                          logic_order_method_t method,
+                          logic_order_report_t *report) {
+  logic_order_report_t local = {0};
+  logic_order_graph_t graph = {0};
+
+  if (circuit == NULL) {
+    return -1;
+  }
+
+  /* Loop bodies are contiguous, placing readers first would split them */
+  if (circuit->loops > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with feedback loops are not "
+                                "reordered.");
+    return -1;
+  }
+
+  if (report == NULL) {
+    report = &local;
+  }
+
+  int *order = malloc((circuit->gates + 1) * sizeof(int));
+
+  if (order == NULL || logic_order_graph_build(circuit, &graph) != 0) {
+    free(order);
+    return -1;
+  }
+
+  int status = -1;
+
+  switch (method) {
+  case LOGIC_ORDER_DFS: {
+    status = logic_order_dfs(circuit, &graph, order);
+    break;
+  }
+  case LOGIC_ORDER_LEVEL: {
+    status = logic_order_level(circuit, &graph, order);
+    break;
+  }
+  case LOGIC_ORDER_CUTHILL_MCKEE:
+  case LOGIC_ORDER_FANOUT: {
+    status = logic_order_ready(circuit, &graph, method == LOGIC_ORDER_FANOUT,
+                               order);
+    break;
+  }
+  default: {
+    LOG_SIM_DEBUG_PRINT(stderr, "Unknown order (%d).", method);
+    break;
+  }
+  }
+
+  report->distance_before =
+      logic_circuit_locality(circuit, &report->bandwidth_before);
+
+  if (status == 0) {
+    /* Cached schedules refer to the gates about to be renumbered */
+    logic_cone_clear(circuit);
+
+    status = logic_order_apply(circuit, order);
+  }
+
+  report->distance_after =
+      logic_circuit_locality(circuit, &report->bandwidth_after);
+
+  logic_order_graph_free(&graph);
+  free(order);
+
+  return status;
+}
+
+void logic_order_print_report(const logic_order_report_t *report,
+                              FILE *stream) {
+  if (report == NULL || stream == NULL) {
+    return;
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+------------+");
+  LOG_SIM_FILE_PRINT(stream, "|   NETS READ     | BEFORE     | AFTER      |");
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+------------+");
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10.1f | %-10.1f |", "Mean distance",
+                     report->distance_before, report->distance_after);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10d | %-10d |", "Bandwidth",
+                     report->bandwidth_before, report->bandwidth_after);
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+------------+");
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
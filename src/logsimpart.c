@@ -0,0 +1,1572 @@
+/**
+ * @file logsimpart.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Min-cut partitioning and multi-process simulation of circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <sched.h>
+#include <signal.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimnuma.h"
+#include "../include/logsimpart.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+/* Graphs this small are bisected directly */
+#define LOGIC_PART_COARSEST 128
+
+/* Nets with more pins than this do not guide the matching */
+#define LOGIC_PART_MATCH_PINS 32
+
+#define LOGIC_PART_INITIAL_TRIES 4
+#define LOGIC_PART_FM_PASSES 8
+#define LOGIC_PART_PICK_TRIES 8
+
+/* Spins on an empty or full ring before yielding the processor */
+#define LOGIC_PART_SPINS 256
+
+/*************** Structures ***************/
+
+/* Gates as vertices, every net read by another gate as a hyperedge */
+typedef struct logic_part_graph {
+  int vertices;
+  int *vertex_weights;
+  int *vertex_ids; /* Gate behind each vertex */
+
+  int edges;
+  int *edge_offsets;
+  int *pin_list;
+
+  int *incident_offsets;
+  int *incident_list;
+} logic_part_graph_t;
+
+typedef struct logic_part_fm {
+  const logic_part_graph_t *graph;
+  int *sides;
+
+  int (*counts)[2]; /* Pins of each edge on each side */
+  int *gains;
+  bool *locked;
+
+  /* Bucket lists of free vertices by side and gain */
+  int max_gain;
+  int *heads[2];
+  int top[2];
+  int *next;
+  int *previous;
+
+  int weights[2];
+  int low; /* Bounds on the weight of side 0 */
+  int high;
+  int target;
+} logic_part_fm_t;
+
+/* Single producer, single consumer, indices only ever grow */
+typedef struct logic_part_ring {
+  alignas(64) atomic_ulong head;
+  alignas(64) atomic_ulong tail;
+
+  unsigned long mask;
+  long offset; /* First word of the ring in the shared word area */
+} logic_part_ring_t;
+
+typedef struct logic_part_run {
+  const logic_circuit_t *circuit;
+  const logic_partition_t *partition;
+
+  int *net_parts; /* Part driving each net, -1 for inputs and constants */
+
+  /* Nets sent from part p to part q, in gate order */
+  int *send_offsets;
+  int *send_list;
+
+  /* Parts reading the output of each gate, other than its own */
+  int *target_offsets;
+  int *target_list;
+
+  logic_part_ring_t *rings; /* parts x parts, shared */
+  logic_word_t *words;      /* Ring storage, shared */
+  logic_word_t *responses;  /* Shared */
+  size_t shared_size;
+} logic_part_run_t;
+
+/*************** Function Definitions ***************/
+
+static uint64_t logic_part_random(uint64_t *state) {
+  /* xorshift64* */
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+
+  return *state * 0x2545F4914F6CDD1Dull;
+}
+
+static void logic_part_graph_free(logic_part_graph_t *graph) {
+  if (graph == NULL) {
+    return;
+  }
+
+  free(graph->vertex_weights);
+  free(graph->vertex_ids);
+  free(graph->edge_offsets);
+  free(graph->pin_list);
+  free(graph->incident_offsets);
+  free(graph->incident_list);
+  free(graph);
+}
+
+/* Edges filled in, derive the vertex to edge incidence */
+static int logic_part_graph_incidence(logic_part_graph_t *graph) {
+  int pins = graph->edge_offsets[graph->edges];
+
+  graph->incident_offsets = calloc(graph->vertices + 1, sizeof(int));
+  graph->incident_list = malloc((pins + 1) * sizeof(int));
+
+  if (graph->incident_offsets == NULL || graph->incident_list == NULL) {
+    return -1;
+  }
+
+  for (int p = 0; p < pins; p++) {
+    graph->incident_offsets[graph->pin_list[p] + 1] += 1;
+  }
+
+  for (int v = 0; v < graph->vertices; v++) {
+    graph->incident_offsets[v + 1] += graph->incident_offsets[v];
+  }
+
+  int *fill = malloc((graph->vertices + 1) * sizeof(int));
+
+  if (fill == NULL) {
+    return -1;
+  }
+
+  memcpy(fill, graph->incident_offsets, graph->vertices * sizeof(int));
+
+  for (int e = 0; e < graph->edges; e++) {
+    for (int p = graph->edge_offsets[e]; p < graph->edge_offsets[e + 1];
+         p++) {
+      graph->incident_list[fill[graph->pin_list[p]]++] = e;
+    }
+  }
+
+  free(fill);
+
+  return 0;
+}
+
+static logic_part_graph_t *logic_part_graph_alloc(int vertices, int edges,
+                                                  int pins) {
+  logic_part_graph_t *graph = calloc(1, sizeof(logic_part_graph_t));
+
+  if (graph == NULL) {
+    return NULL;
+  }
+
+  graph->vertices = vertices;
+  graph->vertex_weights = malloc((vertices + 1) * sizeof(int));
+  graph->vertex_ids = malloc((vertices + 1) * sizeof(int));
+  graph->edge_offsets = calloc(edges + 1, sizeof(int));
+  graph->pin_list = malloc((pins + 1) * sizeof(int));
+
+  if (graph->vertex_weights == NULL || graph->vertex_ids == NULL ||
+      graph->edge_offsets == NULL || graph->pin_list == NULL) {
+    logic_part_graph_free(graph);
+    return NULL;
+  }
+
+  return graph;
+}
+
+static logic_part_graph_t *
+logic_part_graph_from_circuit(const logic_circuit_t *circuit) {
+  int *net_drivers = malloc(circuit->nets * sizeof(int));
+  int *net_stamps = malloc(circuit->nets * sizeof(int));
+  int pins = 0;
+
+  if (net_drivers == NULL || net_stamps == NULL) {
+    free(net_drivers);
+    free(net_stamps);
+    return NULL;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    net_drivers[n] = -1;
+    net_stamps[n] = -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    net_drivers[circuit->gate_list[g].output] = g;
+    pins += circuit->gate_list[g].inputs + 1;
+  }
+
+  logic_part_graph_t *graph =
+      logic_part_graph_alloc(circuit->gates, circuit->nets, pins);
+
+  if (graph == NULL) {
+    free(net_drivers);
+    free(net_stamps);
+    return NULL;
+  }
+
+  /* Count the distinct readers of every gate net first */
+  int *readers = calloc(circuit->nets + 1, sizeof(int));
+
+  if (readers == NULL) {
+    free(net_drivers);
+    free(net_stamps);
+    logic_part_graph_free(graph);
+    return NULL;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    graph->vertex_weights[g] = gate->inputs > 0 ? gate->inputs : 1;
+    graph->vertex_ids[g] = g;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int net = circuit->fanins[gate->fanin + j];
+
+      if (net_drivers[net] >= 0 && net_drivers[net] != g &&
+          net_stamps[net] != g) {
+        net_stamps[net] = g;
+        readers[net] += 1;
+      }
+    }
+  }
+
+  int *edge_nets = malloc((circuit->nets + 1) * sizeof(int));
+
+  if (edge_nets == NULL) {
+    free(net_drivers);
+    free(net_stamps);
+    free(readers);
+    logic_part_graph_free(graph);
+    return NULL;
+  }
+
+  graph->edges = 0;
+
+  for (int n = 0; n < circuit->nets; n++) {
+    if (readers[n] == 0) {
+      continue;
+    }
+
+    edge_nets[n] = graph->edges;
+    graph->pin_list[graph->edge_offsets[graph->edges]] = net_drivers[n];
+    graph->edge_offsets[graph->edges + 1] =
+        graph->edge_offsets[graph->edges] + 1 + readers[n];
+    graph->edges += 1;
+  }
+
+  /* Readers are appended after the driver of every edge */
+  int *fill = malloc((graph->edges + 1) * sizeof(int));
+
+  if (fill == NULL) {
+    free(net_drivers);
+    free(net_stamps);
+    free(readers);
+    free(edge_nets);
+    logic_part_graph_free(graph);
+    return NULL;
+  }
+
+  for (int e = 0; e < graph->edges; e++) {
+    fill[e] = graph->edge_offsets[e] + 1;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    net_stamps[n] = -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int net = circuit->fanins[gate->fanin + j];
+
+      if (readers[net] > 0 && net_drivers[net] != g && net_stamps[net] != g) {
+        net_stamps[net] = g;
+        graph->pin_list[fill[edge_nets[net]]++] = g;
+      }
+    }
+  }
+
+  free(net_drivers);
+  free(net_stamps);
+  free(readers);
+  free(edge_nets);
+  free(fill);
+
+  if (logic_part_graph_incidence(graph) != 0) {
+    logic_part_graph_free(graph);
+    return NULL;
+  }
+
+  return graph;
+}
+
+/* Vertices of one side, edges left with a single pin are dropped */
+static logic_part_graph_t *
+logic_part_graph_induce(const logic_part_graph_t *graph, const int *sides,
+                        int side, int *map) {
+  int vertices = 0;
+
+  for (int v = 0; v < graph->vertices; v++) {
+    map[v] = sides[v] == side ? vertices++ : -1;
+  }
+
+  logic_part_graph_t *sub = logic_part_graph_alloc(
+      vertices, graph->edges, graph->edge_offsets[graph->edges]);
+
+  if (sub == NULL) {
+    return NULL;
+  }
+
+  for (int v = 0; v < graph->vertices; v++) {
+    if (map[v] >= 0) {
+      sub->vertex_weights[map[v]] = graph->vertex_weights[v];
+      sub->vertex_ids[map[v]] = graph->vertex_ids[v];
+    }
+  }
+
+  sub->edges = 0;
+
+  for (int e = 0; e < graph->edges; e++) {
+    int start = sub->edge_offsets[sub->edges];
+    int end = start;
+
+    for (int p = graph->edge_offsets[e]; p < graph->edge_offsets[e + 1];
+         p++) {
+      if (map[graph->pin_list[p]] >= 0) {
+        sub->pin_list[end++] = map[graph->pin_list[p]];
+      }
+    }
+
+    if (end - start >= 2) {
+      sub->edge_offsets[++sub->edges] = end;
+    }
+  }
+
+  if (logic_part_graph_incidence(sub) != 0) {
+    logic_part_graph_free(sub);
+    return NULL;
+  }
+
+  return sub;
+}
+
+/* Merge vertex pairs sharing small nets, map gets the coarse vertex */
+static logic_part_graph_t *
+logic_part_graph_coarsen(const logic_part_graph_t *graph, int max_weight,
+                         uint64_t *seed, int *map) {
+  int *order = malloc((graph->vertices + 1) * sizeof(int));
+  double *scores = calloc(graph->vertices + 1, sizeof(double));
+  int *touched = malloc((graph->vertices + 1) * sizeof(int));
+
+  if (order == NULL || scores == NULL || touched == NULL) {
+    free(order);
+    free(scores);
+    free(touched);
+    return NULL;
+  }
+
+  for (int v = 0; v < graph->vertices; v++) {
+    order[v] = v;
+    map[v] = -1;
+  }
+
+  for (int v = graph->vertices - 1; v > 0; v--) {
+    int u = (int)(logic_part_random(seed) % (uint64_t)(v + 1));
+    int swap = order[v];
+
+    order[v] = order[u];
+    order[u] = swap;
+  }
+
+  int vertices = 0;
+
+  for (int i = 0; i < graph->vertices; i++) {
+    int v = order[i];
+    int count = 0;
+    int best = -1;
+
+    if (map[v] >= 0) {
+      continue;
+    }
+
+    for (int k = graph->incident_offsets[v]; k < graph->incident_offsets[v + 1];
+         k++) {
+      int e = graph->incident_list[k];
+      int size = graph->edge_offsets[e + 1] - graph->edge_offsets[e];
+
+      if (size > LOGIC_PART_MATCH_PINS) {
+        continue;
+      }
+
+      for (int p = graph->edge_offsets[e]; p < graph->edge_offsets[e + 1];
+           p++) {
+        int u = graph->pin_list[p];
+
+        if (u == v || map[u] >= 0 ||
+            graph->vertex_weights[u] + graph->vertex_weights[v] > max_weight) {
+          continue;
+        }
+
+        if (scores[u] == 0) {
+          touched[count++] = u;
+        }
+
+        scores[u] += 1.0 / (size - 1);
+      }
+    }
+
+    for (int t = 0; t < count; t++) {
+      if (best < 0 || scores[touched[t]] > scores[best]) {
+        best = touched[t];
+      }
+    }
+
+    for (int t = 0; t < count; t++) {
+      scores[touched[t]] = 0;
+    }
+
+    map[v] = vertices;
+
+    if (best >= 0) {
+      map[best] = vertices;
+    }
+
+    vertices += 1;
+  }
+
+  free(order);
+  free(scores);
+
+  logic_part_graph_t *coarse = logic_part_graph_alloc(
+      vertices, graph->edges, graph->edge_offsets[graph->edges]);
+
+  if (coarse == NULL) {
+    free(touched);
+    return NULL;
+  }
+
+  memset(coarse->vertex_weights, 0, vertices * sizeof(int));
+
+  for (int v = 0; v < graph->vertices; v++) {
+    coarse->vertex_weights[map[v]] += graph->vertex_weights[v];
+    coarse->vertex_ids[map[v]] = graph->vertex_ids[v];
+  }
+
+  /* touched now stamps the coarse pins already on the current edge */
+  for (int v = 0; v < vertices; v++) {
+    touched[v] = -1;
+  }
+
+  coarse->edges = 0;
+
+  for (int e = 0; e < graph->edges; e++) {
+    int start = coarse->edge_offsets[coarse->edges];
+    int end = start;
+
+    for (int p = graph->edge_offsets[e]; p < graph->edge_offsets[e + 1];
+         p++) {
+      int u = map[graph->pin_list[p]];
+
+      if (touched[u] != e) {
+        touched[u] = e;
+        coarse->pin_list[end++] = u;
+      }
+    }
+
+    if (end - start >= 2) {
+      coarse->edge_offsets[++coarse->edges] = end;
+    }
+  }
+
+  free(touched);
+
+  if (logic_part_graph_incidence(coarse) != 0) {
+    logic_part_graph_free(coarse);
+    return NULL;
+  }
+
+  return coarse;
+}
+
+static int logic_part_cut(const logic_part_graph_t *graph, const int *sides) {
+  int cut = 0;
+
+  for (int e = 0; e < graph->edges; e++) {
+    int first = sides[graph->pin_list[graph->edge_offsets[e]]];
+
+    for (int p = graph->edge_offsets[e] + 1; p < graph->edge_offsets[e + 1];
+         p++) {
+      if (sides[graph->pin_list[p]] != first) {
+        cut += 1;
+        break;
+      }
+    }
+  }
+
+  return cut;
+}
+
+static void logic_part_bucket_insert(logic_part_fm_t *fm, int v) {
+  int side = fm->sides[v];
+  int index = fm->gains[v] + fm->max_gain;
+
+  fm->previous[v] = -1;
+  fm->next[v] = fm->heads[side][index];
+
+  if (fm->heads[side][index] >= 0) {
+    fm->previous[fm->heads[side][index]] = v;
+  }
+
+  fm->heads[side][index] = v;
+
+  if (index > fm->top[side]) {
+    fm->top[side] = index;
+  }
+}
+
+static void logic_part_bucket_remove(logic_part_fm_t *fm, int v) {
+  int side = fm->sides[v];
+  int index = fm->gains[v] + fm->max_gain;
+
+  if (fm->previous[v] >= 0) {
+    fm->next[fm->previous[v]] = fm->next[v];
+  } else {
+    fm->heads[side][index] = fm->next[v];
+  }
+
+  if (fm->next[v] >= 0) {
+    fm->previous[fm->next[v]] = fm->previous[v];
+  }
+}
+
+static void logic_part_adjust_gain(logic_part_fm_t *fm, int v, int delta) {
+  if (fm->locked[v]) {
+    return;
+  }
+
+  logic_part_bucket_remove(fm, v);
+  fm->gains[v] += delta;
+  logic_part_bucket_insert(fm, v);
+}
+
+/* Balanced after the move, or at least closer to the target */
+static bool logic_part_feasible(const logic_part_fm_t *fm, int v) {
+  int weight = fm->graph->vertex_weights[v];
+  int after = fm->sides[v] == 0 ? fm->weights[0] - weight
+                                : fm->weights[0] + weight;
+
+  if (after >= fm->low && after <= fm->high) {
+    return true;
+  }
+
+  return abs(after - fm->target) < abs(fm->weights[0] - fm->target);
+}
+
+static int logic_part_fm_pick(logic_part_fm_t *fm) {
+  int best = -1;
+
+  for (int side = 0; side < 2; side++) {
+    int found = -1;
+    int tried = 0;
+
+    while (fm->top[side] >= 0 && fm->heads[side][fm->top[side]] < 0) {
+      fm->top[side] -= 1;
+    }
+
+    /* Only the best few vertices of a side are tried for balance */
+    for (int index = fm->top[side];
+         index >= 0 && found < 0 && tried < LOGIC_PART_PICK_TRIES; index--) {
+      for (int v = fm->heads[side][index];
+           v >= 0 && tried < LOGIC_PART_PICK_TRIES; v = fm->next[v]) {
+        tried += 1;
+
+        if (logic_part_feasible(fm, v)) {
+          found = v;
+          break;
+        }
+      }
+    }
+
+    if (found >= 0 && (best < 0 || fm->gains[found] > fm->gains[best])) {
+      best = found;
+    }
+  }
+
+  return best;
+}
+
+static void logic_part_fm_move(logic_part_fm_t *fm, int v) {
+  const logic_part_graph_t *graph = fm->graph;
+  int from = fm->sides[v];
+  int to = 1 - from;
+
+  for (int k = graph->incident_offsets[v]; k < graph->incident_offsets[v + 1];
+       k++) {
+    int e = graph->incident_list[k];
+    int start = graph->edge_offsets[e];
+    int end = graph->edge_offsets[e + 1];
+
+    /* Classic FM updates, before and after the pin changes side */
+    if (fm->counts[e][to] == 0) {
+      for (int p = start; p < end; p++) {
+        logic_part_adjust_gain(fm, graph->pin_list[p], 1);
+      }
+    } else if (fm->counts[e][to] == 1) {
+      for (int p = start; p < end; p++) {
+        if (fm->sides[graph->pin_list[p]] == to) {
+          logic_part_adjust_gain(fm, graph->pin_list[p], -1);
+        }
+      }
+    }
+
+    fm->counts[e][from] -= 1;
+    fm->counts[e][to] += 1;
+
+    if (fm->counts[e][from] == 0) {
+      for (int p = start; p < end; p++) {
+        logic_part_adjust_gain(fm, graph->pin_list[p], -1);
+      }
+    } else if (fm->counts[e][from] == 1) {
+      for (int p = start; p < end; p++) {
+        if (fm->sides[graph->pin_list[p]] == from &&
+            graph->pin_list[p] != v) {
+          logic_part_adjust_gain(fm, graph->pin_list[p], 1);
+        }
+      }
+    }
+  }
+
+  fm->sides[v] = to;
+  fm->weights[from] -= graph->vertex_weights[v];
+  fm->weights[to] += graph->vertex_weights[v];
+}
+
+static int logic_part_fm_pass(logic_part_fm_t *fm, int *moves) {
+  const logic_part_graph_t *graph = fm->graph;
+  int cut = logic_part_cut(graph, fm->sides);
+  int best_cut = cut;
+  int best_moves = 0;
+  int best_balance = abs(fm->weights[0] - fm->target);
+  bool best_balanced = fm->weights[0] >= fm->low && fm->weights[0] <= fm->high;
+  int count = 0;
+
+  for (int e = 0; e < graph->edges; e++) {
+    fm->counts[e][0] = 0;
+    fm->counts[e][1] = 0;
+
+    for (int p = graph->edge_offsets[e]; p < graph->edge_offsets[e + 1];
+         p++) {
+      fm->counts[e][fm->sides[graph->pin_list[p]]] += 1;
+    }
+  }
+
+  for (int side = 0; side < 2; side++) {
+    for (int i = 0; i <= 2 * fm->max_gain; i++) {
+      fm->heads[side][i] = -1;
+    }
+
+    fm->top[side] = -1;
+  }
+
+  for (int v = 0; v < graph->vertices; v++) {
+    int side = fm->sides[v];
+
+    fm->gains[v] = 0;
+    fm->locked[v] = false;
+
+    for (int k = graph->incident_offsets[v]; k < graph->incident_offsets[v + 1];
+         k++) {
+      int e = graph->incident_list[k];
+
+      fm->gains[v] += fm->counts[e][side] == 1;
+      fm->gains[v] -= fm->counts[e][1 - side] == 0;
+    }
+
+    logic_part_bucket_insert(fm, v);
+  }
+
+  for (;;) {
+    int v = logic_part_fm_pick(fm);
+
+    if (v < 0) {
+      break;
+    }
+
+    cut -= fm->gains[v];
+    logic_part_bucket_remove(fm, v);
+    fm->locked[v] = true;
+    logic_part_fm_move(fm, v);
+    moves[count++] = v;
+
+    int balance = abs(fm->weights[0] - fm->target);
+    bool balanced = fm->weights[0] >= fm->low && fm->weights[0] <= fm->high;
+
+    /* Balance first, then the cut, then closeness to the target */
+    if (balanced ? !best_balanced || cut < best_cut ||
+                       (cut == best_cut && balance < best_balance)
+                 : !best_balanced && balance < best_balance) {
+      best_cut = cut;
+      best_moves = count;
+      best_balance = balance;
+      best_balanced = balanced;
+    }
+
+    /* A long run of moves without a better cut rarely recovers */
+    if (count - best_moves > 64 + graph->vertices / 16) {
+      break;
+    }
+  }
+
+  /* Undo the moves past the best prefix */
+  while (count > best_moves) {
+    int v = moves[--count];
+    int from = fm->sides[v];
+
+    fm->sides[v] = 1 - from;
+    fm->weights[from] -= graph->vertex_weights[v];
+    fm->weights[1 - from] += graph->vertex_weights[v];
+  }
+
+  return best_moves;
+}
+
+static int logic_part_fm_refine(const logic_part_graph_t *graph, int *sides,
+                                int target, int slack) {
+  logic_part_fm_t fm = {0};
+  int max_degree = 0;
+
+  for (int v = 0; v < graph->vertices; v++) {
+    int degree = graph->incident_offsets[v + 1] - graph->incident_offsets[v];
+
+    max_degree = degree > max_degree ? degree : max_degree;
+  }
+
+  fm.graph = graph;
+  fm.sides = sides;
+  fm.max_gain = max_degree;
+  fm.target = target;
+  fm.low = target - slack;
+  fm.high = target + slack;
+
+  fm.counts = malloc((graph->edges + 1) * sizeof(*fm.counts));
+  fm.gains = malloc((graph->vertices + 1) * sizeof(int));
+  fm.locked = malloc((graph->vertices + 1) * sizeof(bool));
+  fm.next = malloc((graph->vertices + 1) * sizeof(int));
+  fm.previous = malloc((graph->vertices + 1) * sizeof(int));
+  fm.heads[0] = malloc((2 * max_degree + 1) * sizeof(int));
+  fm.heads[1] = malloc((2 * max_degree + 1) * sizeof(int));
+
+  int *moves = malloc((graph->vertices + 1) * sizeof(int));
+  int status = 0;
+
+  if (fm.counts == NULL || fm.gains == NULL || fm.locked == NULL ||
+      fm.next == NULL || fm.previous == NULL || fm.heads[0] == NULL ||
+      fm.heads[1] == NULL || moves == NULL) {
+    status = -1;
+  }
+
+  for (int v = 0; v < graph->vertices && status == 0; v++) {
+    fm.weights[sides[v]] += graph->vertex_weights[v];
+  }
+
+  for (int pass = 0; pass < LOGIC_PART_FM_PASSES && status == 0; pass++) {
+    if (logic_part_fm_pass(&fm, moves) == 0) {
+      break;
+    }
+  }
+
+  free(fm.counts);
+  free(fm.gains);
+  free(fm.locked);
+  free(fm.next);
+  free(fm.previous);
+  free(fm.heads[0]);
+  free(fm.heads[1]);
+  free(moves);
+
+  return status;
+}
+
+/* Grow side 0 from a random vertex until it holds its share */
+static void logic_part_grow(const logic_part_graph_t *graph, int target,
+                            uint64_t *seed, int *sides, int *queue) {
+  int weight = 0;
+  int head = 0;
+  int tail = 0;
+  int next = 0;
+
+  for (int v = 0; v < graph->vertices; v++) {
+    sides[v] = 1;
+  }
+
+  int start = (int)(logic_part_random(seed) % (uint64_t)graph->vertices);
+
+  sides[start] = 0;
+  queue[tail++] = start;
+
+  while (weight < target) {
+    if (head == tail) {
+      /* Disconnected, continue from the next vertex not taken */
+      while (next < graph->vertices && sides[next] == 0) {
+        next += 1;
+      }
+
+      if (next == graph->vertices) {
+        break;
+      }
+
+      sides[next] = 0;
+      queue[tail++] = next;
+    }
+
+    int v = queue[head++];
+
+    weight += graph->vertex_weights[v];
+
+    for (int k = graph->incident_offsets[v];
+         k < graph->incident_offsets[v + 1]; k++) {
+      int e = graph->incident_list[k];
+
+      for (int p = graph->edge_offsets[e]; p < graph->edge_offsets[e + 1];
+           p++) {
+        int u = graph->pin_list[p];
+
+        if (sides[u] == 1) {
+          sides[u] = 0;
+          queue[tail++] = u;
+        }
+      }
+    }
+  }
+
+  /* Queued but not taken */
+  for (int i = head; i < tail; i++) {
+    sides[queue[i]] = 1;
+  }
+}
+
+static int logic_part_bisect(const logic_part_graph_t *graph, double ratio,
+                             double imbalance, uint64_t *seed, int *sides) {
+  int total = 0;
+  int heaviest = 0;
+
+  for (int v = 0; v < graph->vertices; v++) {
+    total += graph->vertex_weights[v];
+    heaviest = graph->vertex_weights[v] > heaviest ? graph->vertex_weights[v]
+                                                   : heaviest;
+  }
+
+  int target = (int)(total * ratio + 0.5);
+  int slack = (int)(imbalance * total * (ratio < 0.5 ? ratio : 1 - ratio));
+
+  slack = slack > heaviest ? slack : heaviest;
+
+  if (graph->vertices > LOGIC_PART_COARSEST) {
+    int *map = malloc(graph->vertices * sizeof(int));
+    int max_weight = total / (LOGIC_PART_COARSEST / 4) + 1;
+    logic_part_graph_t *coarse =
+        map != NULL ? logic_part_graph_coarsen(graph, max_weight, seed, map)
+                    : NULL;
+
+    /* Matching stalls on heavy or isolated vertices, refine here then */
+    if (coarse != NULL && coarse->vertices < graph->vertices * 9 / 10) {
+      int *coarse_sides = malloc((coarse->vertices + 1) * sizeof(int));
+      int status = coarse_sides != NULL
+                       ? logic_part_bisect(coarse, ratio, imbalance, seed,
+                                           coarse_sides)
+                       : -1;
+
+      for (int v = 0; v < graph->vertices && status == 0; v++) {
+        sides[v] = coarse_sides[map[v]];
+      }
+
+      free(coarse_sides);
+      free(map);
+      logic_part_graph_free(coarse);
+
+      return status == 0 ? logic_part_fm_refine(graph, sides, target, slack)
+                         : -1;
+    }
+
+    free(map);
+    logic_part_graph_free(coarse);
+  }
+
+  int *candidate = malloc((graph->vertices + 1) * sizeof(int));
+  int *queue = malloc((graph->vertices + 1) * sizeof(int));
+  int best_cut = -1;
+
+  if (candidate == NULL || queue == NULL) {
+    free(candidate);
+    free(queue);
+    return -1;
+  }
+
+  for (int t = 0; t < LOGIC_PART_INITIAL_TRIES && graph->vertices > 0; t++) {
+    logic_part_grow(graph, target, seed, candidate, queue);
+
+    if (logic_part_fm_refine(graph, candidate, target, slack) != 0) {
+      free(candidate);
+      free(queue);
+      return -1;
+    }
+
+    int cut = logic_part_cut(graph, candidate);
+
+    if (best_cut < 0 || cut < best_cut) {
+      best_cut = cut;
+      memcpy(sides, candidate, graph->vertices * sizeof(int));
+    }
+  }
+
+  free(candidate);
+  free(queue);
+
+  return 0;
+}
+
+static int logic_part_split(const logic_part_graph_t *graph, int parts,
+                            int first, double imbalance, uint64_t *seed,
+                            int *gate_parts) {
+  if (parts == 1 || graph->vertices <= 1) {
+    for (int v = 0; v < graph->vertices; v++) {
+      gate_parts[graph->vertex_ids[v]] = first;
+    }
+
+    return 0;
+  }
+
+  int left = parts / 2;
+  int *sides = malloc(graph->vertices * sizeof(int));
+  int *map = malloc(graph->vertices * sizeof(int));
+  int status = -1;
+
+  if (sides != NULL && map != NULL &&
+      logic_part_bisect(graph, (double)left / parts, imbalance, seed, sides) ==
+          0) {
+    status = 0;
+
+    for (int side = 0; side < 2 && status == 0; side++) {
+      logic_part_graph_t *sub = logic_part_graph_induce(graph, sides, side, map);
+
+      status = sub != NULL ? logic_part_split(
+                                 sub, side == 0 ? left : parts - left,
+                                 side == 0 ? first : first + left, imbalance,
+                                 seed, gate_parts)
+                           : -1;
+
+      logic_part_graph_free(sub);
+    }
+  }
+
+  free(sides);
+  free(map);
+
+  return status;
+}
+
+static int *logic_part_net_parts(const logic_circuit_t *circuit,
+                                 const logic_partition_t *partition) {
+  int *net_parts = malloc(circuit->nets * sizeof(int));
+
+  if (net_parts == NULL) {
+    return NULL;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    net_parts[n] = -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    net_parts[circuit->gate_list[g].output] = partition->gate_parts[g];
+  }
+
+  return net_parts;
+}
+
+/* Parts other than its own reading each gate output, each once */
+static int logic_part_targets(const logic_circuit_t *circuit,
+                              const logic_partition_t *partition,
+                              const int *net_parts, int **offsets,
+                              int **list) {
+  int parts = partition->parts;
+  int *net_gates = malloc(circuit->nets * sizeof(int));
+  bool *reads = calloc((size_t)circuit->gates * parts + 1, sizeof(bool));
+  int count = 0;
+
+  *offsets = calloc(circuit->gates + 1, sizeof(int));
+
+  if (net_gates == NULL || reads == NULL || *offsets == NULL) {
+    free(net_gates);
+    free(reads);
+    return -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    net_gates[circuit->gate_list[g].output] = g;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+    int part = partition->gate_parts[g];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int net = circuit->fanins[gate->fanin + j];
+
+      if (net_parts[net] >= 0 && net_parts[net] != part &&
+          !reads[(size_t)net_gates[net] * parts + part]) {
+        reads[(size_t)net_gates[net] * parts + part] = true;
+        count += 1;
+      }
+    }
+  }
+
+  *list = malloc((count + 1) * sizeof(int));
+
+  if (*list == NULL) {
+    free(net_gates);
+    free(reads);
+    return -1;
+  }
+
+  count = 0;
+
+  for (int g = 0; g < circuit->gates; g++) {
+    (*offsets)[g] = count;
+
+    for (int p = 0; p < parts; p++) {
+      if (reads[(size_t)g * parts + p]) {
+        (*list)[count++] = p;
+      }
+    }
+  }
+
+  (*offsets)[circuit->gates] = count;
+
+  free(net_gates);
+  free(reads);
+
+  return 0;
+}
+
+logic_partition_t *logic_partition_create(const logic_circuit_t *circuit,
+                                          int parts, double imbalance) {
+  if (circuit == NULL || parts < 1) {
+    return NULL;
+  }
+
+  if (circuit->loops > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with feedback loops can't be "
+                                "partitioned.");
+    return NULL;
+  }
+
+  if (circuit->cells > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with word level cells can't be "
+                                "partitioned.");
+    return NULL;
+  }
+
+  logic_partition_t *partition = calloc(1, sizeof(logic_partition_t));
+  logic_part_graph_t *graph = logic_part_graph_from_circuit(circuit);
+  uint64_t seed = 0x9E3779B97F4A7C15ull;
+
+  if (partition == NULL || graph == NULL) {
+    free(partition);
+    logic_part_graph_free(graph);
+    return NULL;
+  }
+
+  partition->parts = parts;
+  partition->gate_parts = calloc(circuit->gates + 1, sizeof(int));
+  partition->part_weights = calloc(parts, sizeof(int));
+
+  /* Every level of bisection adds its own imbalance */
+  int levels = 0;
+
+  while ((1 << levels) < parts) {
+    levels += 1;
+  }
+
+  imbalance = (imbalance > 0 ? imbalance : 0.05) / (levels > 0 ? levels : 1);
+
+  if (partition->gate_parts == NULL || partition->part_weights == NULL ||
+      logic_part_split(graph, parts, 0, imbalance, &seed,
+                       partition->gate_parts) != 0) {
+    logic_part_graph_free(graph);
+    logic_partition_free(partition);
+    return NULL;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    partition->part_weights[partition->gate_parts[g]] +=
+        graph->vertex_weights[g];
+  }
+
+  partition->boundary_nets = logic_part_cut(graph, partition->gate_parts);
+  logic_part_graph_free(graph);
+
+  int *net_parts = logic_part_net_parts(circuit, partition);
+  int *offsets = NULL;
+  int *list = NULL;
+
+  if (net_parts == NULL || logic_part_targets(circuit, partition, net_parts,
+                                              &offsets, &list) != 0) {
+    free(net_parts);
+    free(offsets);
+    logic_partition_free(partition);
+    return NULL;
+  }
+
+  partition->messages = offsets[circuit->gates];
+
+  free(net_parts);
+  free(offsets);
+  free(list);
+
+  return partition;
+}
+
+static void logic_part_run_free(logic_part_run_t *run) {
+  free(run->net_parts);
+  free(run->send_offsets);
+  free(run->send_list);
+  free(run->target_offsets);
+  free(run->target_list);
+
+  if (run->rings != NULL) {
+    munmap(run->rings, run->shared_size);
+  }
+}
+
+static int logic_part_run_prepare(logic_part_run_t *run, long steps) {
+  const logic_circuit_t *circuit = run->circuit;
+  int parts = run->partition->parts;
+  int pairs = parts * parts;
+
+  run->net_parts = logic_part_net_parts(circuit, run->partition);
+
+  if (run->net_parts == NULL ||
+      logic_part_targets(circuit, run->partition, run->net_parts,
+                         &run->target_offsets, &run->target_list) != 0) {
+    return -1;
+  }
+
+  run->send_offsets = calloc(pairs + 1, sizeof(int));
+  run->send_list = malloc((run->target_offsets[circuit->gates] + 1) *
+                          sizeof(int));
+
+  if (run->send_offsets == NULL || run->send_list == NULL) {
+    return -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    for (int t = run->target_offsets[g]; t < run->target_offsets[g + 1];
+         t++) {
+      int pair = run->partition->gate_parts[g] * parts + run->target_list[t];
+
+      run->send_offsets[pair + 1] += 1;
+    }
+  }
+
+  for (int pair = 0; pair < pairs; pair++) {
+    run->send_offsets[pair + 1] += run->send_offsets[pair];
+  }
+
+  int *fill = malloc((pairs + 1) * sizeof(int));
+
+  if (fill == NULL) {
+    return -1;
+  }
+
+  memcpy(fill, run->send_offsets, pairs * sizeof(int));
+
+  /* Gate order is the order the producer pushes in */
+  for (int g = 0; g < circuit->gates; g++) {
+    for (int t = run->target_offsets[g]; t < run->target_offsets[g + 1];
+         t++) {
+      int pair = run->partition->gate_parts[g] * parts + run->target_list[t];
+
+      run->send_list[fill[pair]++] = circuit->gate_list[g].output;
+    }
+  }
+
+  free(fill);
+
+  /* A ring holds two steps, the producer never waits inside a step */
+  long words = 0;
+  unsigned long *masks = malloc((pairs + 1) * sizeof(unsigned long));
+
+  if (masks == NULL) {
+    return -1;
+  }
+
+  for (int pair = 0; pair < pairs; pair++) {
+    int count = run->send_offsets[pair + 1] - run->send_offsets[pair];
+    unsigned long capacity = 0;
+
+    if (count > 0) {
+      capacity = 64;
+
+      while (capacity < 2 * (unsigned long)count) {
+        capacity <<= 1;
+      }
+    }
+
+    masks[pair] = capacity;
+    words += (long)capacity;
+  }
+
+  size_t rings_size = pairs * sizeof(logic_part_ring_t);
+  size_t words_size = words * sizeof(logic_word_t);
+  size_t responses_size =
+      (size_t)steps * circuit->outputs * sizeof(logic_word_t);
+
+  run->shared_size = rings_size + words_size + responses_size + 1;
+
+  void *shared = mmap(NULL, run->shared_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+  if (shared == MAP_FAILED) {
+    free(masks);
+    return -1;
+  }
+
+  run->rings = shared;
+  run->words = (logic_word_t *)((char *)shared + rings_size);
+  run->responses = (logic_word_t *)((char *)shared + rings_size + words_size);
+
+  words = 0;
+
+  for (int pair = 0; pair < pairs; pair++) {
+    atomic_init(&run->rings[pair].head, 0);
+    atomic_init(&run->rings[pair].tail, 0);
+    run->rings[pair].mask = masks[pair] > 0 ? masks[pair] - 1 : 0;
+    run->rings[pair].offset = words;
+    words += (long)masks[pair];
+  }
+
+  free(masks);
+
+  return 0;
+}
+
+static void logic_part_push(logic_part_run_t *run, logic_part_ring_t *ring,
+                            logic_word_t word) {
+  unsigned long tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  int spins = 0;
+
+  while (tail - atomic_load_explicit(&ring->head, memory_order_acquire) >
+         ring->mask) {
+    if (++spins % LOGIC_PART_SPINS == 0) {
+      sched_yield();
+    }
+  }
+
+  run->words[ring->offset + (long)(tail & ring->mask)] = word;
+  atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+static logic_word_t logic_part_pop(logic_part_run_t *run,
+                                   logic_part_ring_t *ring) {
+  unsigned long head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  int spins = 0;
+
+  while (atomic_load_explicit(&ring->tail, memory_order_acquire) == head) {
+    if (++spins % LOGIC_PART_SPINS == 0) {
+      sched_yield();
+    }
+  }
+
+  logic_word_t word = run->words[ring->offset + (long)(head & ring->mask)];
+
+  atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+  return word;
+}
+
+/* Body of the process simulating one part */
+static int logic_part_worker(logic_part_run_t *run, int part,
+                             const logic_word_t *stimulus, long steps) {
+  const logic_circuit_t *circuit = run->circuit;
+  int parts = run->partition->parts;
+  logic_word_t *values = logic_numa_alloc(
+      circuit->nets * sizeof(logic_word_t), circuit->placement);
+  long *net_steps =
+      logic_numa_alloc(circuit->nets * sizeof(long), circuit->placement);
+  int *cursors = malloc(parts * sizeof(int));
+
+  if (values == NULL || net_steps == NULL || cursors == NULL) {
+    logic_numa_free(values);
+    logic_numa_free(net_steps);
+    free(cursors);
+    return -1;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    net_steps[n] = -1;
+  }
+
+  values[LOGIC_NET_CONST0] = 0;
+  values[LOGIC_NET_CONST1] = ~(logic_word_t)0;
+
+  for (long step = 0; step < steps; step++) {
+    for (int i = 0; i < circuit->primary_inputs; i++) {
+      values[LOGIC_INPUT_NET(i)] =
+          stimulus[step * circuit->primary_inputs + i];
+    }
+
+    for (int p = 0; p < parts; p++) {
+      cursors[p] = run->send_offsets[p * parts + part];
+    }
+
+    for (int g = 0; g < circuit->gates; g++) {
+      const logic_gate_t *gate = &circuit->gate_list[g];
+      const int *fanins = &circuit->fanins[gate->fanin];
+
+      if (run->partition->gate_parts[g] != part) {
+        continue;
+      }
+
+      /* Remote nets arrive in the order their producer pushed them */
+      for (int j = 0; j < gate->inputs; j++) {
+        int source = run->net_parts[fanins[j]];
+
+        while (source >= 0 && source != part &&
+               net_steps[fanins[j]] != step) {
+          int net = run->send_list[cursors[source]++];
+
+          values[net] =
+              logic_part_pop(run, &run->rings[source * parts + part]);
+          net_steps[net] = step;
+        }
+      }
+
+      logic_word_t word = 0;
+
+      switch (gate->logic_block_type) {
+      case AND: {
+        word = ~(logic_word_t)0;
+
+        for (int j = 0; j < gate->inputs; j++) {
+          word &= values[fanins[j]];
+        }
+
+        break;
+      }
+      case OR: {
+        for (int j = 0; j < gate->inputs; j++) {
+          word |= values[fanins[j]];
+        }
+
+        break;
+      }
+      case XOR: {
+        for (int j = 0; j < gate->inputs; j++) {
+          word ^= values[fanins[j]];
+        }
+
+        break;
+      }
+      case NOT: {
+        word = gate->inputs > 0 ? ~values[fanins[gate->inputs - 1]]
+                                : ~(logic_word_t)0;
+        break;
+      }
+      default: {
+        break;
+      }
+      }
+
+      values[gate->output] = word;
+
+      for (int t = run->target_offsets[g]; t < run->target_offsets[g + 1];
+           t++) {
+        logic_part_push(run, &run->rings[part * parts + run->target_list[t]],
+                        word);
+      }
+    }
+
+    /* Outputs go out through the part driving them, the first for the rest */
+    for (int i = 0; i < circuit->outputs; i++) {
+      int net = circuit->output_nets[i];
+      int owner = run->net_parts[net] >= 0 ? run->net_parts[net] : 0;
+
+      if (owner == part) {
+        run->responses[step * circuit->outputs + i] = values[net];
+      }
+    }
+  }
+
+  logic_numa_free(values);
+  logic_numa_free(net_steps);
+  free(cursors);
+
+  return 0;
+}
+
+int logic_partition_simulate(const logic_circuit_t *circuit,
+                             const logic_partition_t *partition,
+                             const logic_word_t *stimulus, long steps,
+                             logic_word_t *responses) {
+  if (circuit == NULL || partition == NULL || stimulus == NULL ||
+      responses == NULL || steps < 0) {
+    return -1;
+  }
+
+  if (circuit->loops > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with feedback loops can't be "
+                                "partitioned.");
+    return -1;
+  }
+
+  if (circuit->cells > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with word level cells can't be "
+                                "partitioned.");
+    return -1;
+  }
+
+  logic_part_run_t run = {0};
+
+  run.circuit = circuit;
+  run.partition = partition;
+
+  if (logic_part_run_prepare(&run, steps) != 0) {
+    logic_part_run_free(&run);
+    return -1;
+  }
+
+  pid_t *pids = calloc(partition->parts, sizeof(pid_t));
+  int status = pids != NULL ? 0 : -1;
+  logic_topology_t *topology = (circuit->placement & LOGIC_PLACE_PIN_WORKERS)
+                                   ? logic_topology_create()
+                                   : NULL;
+  int started = 0;
+
+  /* Buffered output would be written again by every child */
+  fflush(NULL);
+
+  for (; started < partition->parts && status == 0; started++) {
+    pid_t pid = fork();
+
+    if (pid == 0) {
+      /* Neighbouring parts share rings, they are kept on one node */
+      if (topology != NULL) {
+        logic_topology_pin(logic_topology_cpu(topology, started, false));
+      }
+
+      _exit(logic_part_worker(&run, started, stimulus, steps) == 0 ? 0 : 1);
+    }
+
+    if (pid < 0) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Failed to fork part (%d).", started);
+      status = -1;
+      break;
+    }
+
+    pids[started] = pid;
+  }
+
+  /* A part that died leaves its peers waiting on their rings forever */
+  for (int running = started; running > 0 && status == 0;) {
+    for (int p = 0; p < started; p++) {
+      int child_status = 0;
+
+      if (pids[p] <= 0 || waitpid(pids[p], &child_status, WNOHANG) == 0) {
+        continue;
+      }
+
+      pids[p] = 0;
+      running -= 1;
+
+      if (!WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0) {
+        LOG_SIM_DEBUG_PRINT(stderr, "Part (%d) failed.", p);
+        status = -1;
+      }
+    }
+
+    if (running > 0 && status == 0) {
+      usleep(100);
+    }
+  }
+
+  for (int p = 0; p < started && pids != NULL; p++) {
+    if (pids[p] > 0) {
+      kill(pids[p], SIGKILL);
+      waitpid(pids[p], NULL, 0);
+    }
+  }
+
+  if (status == 0) {
+    memcpy(responses, run.responses,
+           (size_t)steps * circuit->outputs * sizeof(logic_word_t));
+  }
+
+  free(pids);
+  logic_topology_free(topology);
+  logic_part_run_free(&run);
+
+  return status;
+}
+
+void logic_partition_print(const logic_partition_t *partition, FILE *stream) {
+  if (partition == NULL || stream == NULL) {
+    return;
+  }
+
+  int heaviest = 0;
+  long total = 0;
+
+  for (int p = 0; p < partition->parts; p++) {
+    total += partition->part_weights[p];
+    heaviest = partition->part_weights[p] > heaviest
+                   ? partition->part_weights[p]
+                   : heaviest;
+  }
+
+  fprintf(stream, "+-----------------+------------+\n");
+  fprintf(stream, "| Parts           | %-10d |\n", partition->parts);
+  fprintf(stream, "| Boundary nets   | %-10d |\n", partition->boundary_nets);
+  fprintf(stream, "| Words per step  | %-10d |\n", partition->messages);
+  fprintf(stream, "| Imbalance       | %-9.3f%% |\n",
+          total > 0 ? 100.0 * ((double)heaviest * partition->parts / total - 1)
+                    : 0.0);
+  fprintf(stream, "+-----------------+------------+\n");
+}
+
+void logic_partition_free(logic_partition_t *partition) {
+  if (partition == NULL) {
+    return;
+  }
+
+  free(partition->gate_parts);
+  free(partition->part_weights);
+  free(partition);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,283 @@
+/**
+ * @file logsimpower.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Toggle activity and switching power estimation.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimpower.h"
+#include "../include/utils.h"
+
+/*************** Structures ***************/
+
+typedef struct logic_power_net {
+  int net;
+  double weight;
+} logic_power_net_t;
+
+/*************** Function Definitions ***************/
+
+/* Capacitance of every net, by the type of the gate driving it */
+static double *logic_power_weights(const logic_circuit_t *circuit,
+                                   const logic_power_options_t *options) {
+  double *weights = malloc(circuit->nets * sizeof(double));
+
+  if (weights == NULL) {
+    return NULL;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    weights[n] = options != NULL ? options->input_capacitance : 1.0;
+  }
+
+  weights[LOGIC_NET_CONST0] = 0.0;
+  weights[LOGIC_NET_CONST1] = 0.0;
+
+  for (int g = 0; g < circuit->gates && options != NULL; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int b = 0; b < gate->width; b++) {
+      weights[gate->output + b] = options->capacitance[gate->logic_block_type];
+    }
+  }
+
+  return weights;
+}
+
+static int logic_power_compare(const void *a, const void *b) {
+  const logic_power_net_t *net_a = a;
+  const logic_power_net_t *net_b = b;
+
+  if (net_a->weight != net_b->weight) {
+    return net_a->weight < net_b->weight ? 1 : -1;
+  }
+
+  return net_a->net - net_b->net;
+}
+
+logic_activity_t *logic_activity_create(const logic_circuit_t *circuit,
+                                        logic_activity_mode_t mode) {
+  if (circuit == NULL) {
+    return NULL;
+  }
+
+  logic_activity_t *activity = calloc(1, sizeof(logic_activity_t));
+
+  if (activity == NULL) {
+    return NULL;
+  }
+
+  activity->circuit = circuit;
+  activity->mode = mode;
+  activity->previous = calloc(circuit->nets, sizeof(logic_word_t));
+  activity->toggles = calloc(circuit->nets, sizeof(uint64_t));
+
+  if (activity->previous == NULL || activity->toggles == NULL) {
+    logic_activity_free(activity);
+    return NULL;
+  }
+
+  return activity;
+}
+
+int logic_activity_run(logic_activity_t *activity,
+                       const logic_vm_program_t *program, logic_word_t *values) {
+  if (activity == NULL || program == NULL || values == NULL) {
+    return -1;
+  }
+
+  const logic_circuit_t *circuit = activity->circuit;
+  long transitions = LOGIC_LANES;
+
+  if (!activity->primed) {
+    if (logic_vm_run(program, values) < 0) {
+      return -1;
+    }
+
+    /* Nothing precedes the first vector, so it cannot toggle */
+    for (int n = 0; n < circuit->nets; n++) {
+      activity->previous[n] = activity->mode == LOGIC_ACTIVITY_LANES
+                                  ? values[n] << (LOGIC_LANES - 1)
+                                  : values[n];
+    }
+
+    activity->primed = true;
+
+    /* Only the lanes of the first run follow each other, in lanes mode */
+    transitions = activity->mode == LOGIC_ACTIVITY_LANES ? LOGIC_LANES - 1 : 0;
+  }
+
+  for (int i = 0; i < circuit->primary_inputs; i++) {
+    logic_activity_count(activity, LOGIC_INPUT_NET(i),
+                         values[LOGIC_INPUT_NET(i)]);
+  }
+
+  if (logic_vm_run_activity(program, values, activity) < 0) {
+    return -1;
+  }
+
+  activity->transitions += transitions;
+
+  return 0;
+}
+
+int logic_activity_merge(logic_activity_t *activity,
+                         const logic_activity_t *other) {
+  if (activity == NULL || other == NULL ||
+      activity->circuit->nets != other->circuit->nets) {
+    return -1;
+  }
+
+  for (int n = 0; n < activity->circuit->nets; n++) {
+    activity->toggles[n] += other->toggles[n];
+  }
+
+  activity->transitions += other->transitions;
+
+  return 0;
+}
+
+int logic_power_estimate(const logic_activity_t *activity,
+                         const logic_power_options_t *options,
+                         logic_power_report_t *report) {
+  if (activity == NULL || report == NULL) {
+    return -1;
+  }
+
+  double *weights = logic_power_weights(activity->circuit, options);
+
+  if (weights == NULL) {
+    return -1;
+  }
+
+  double switched = 0.0;
+
+  report->transitions = activity->transitions;
+  report->toggles = 0;
+
+  for (int n = 0; n < activity->circuit->nets; n++) {
+    report->toggles += activity->toggles[n];
+    switched += weights[n] * (double)activity->toggles[n];
+  }
+
+  report->switched_capacitance =
+      activity->transitions > 0 ? switched / activity->transitions : 0.0;
+
+  /* P = 1/2 C V^2 f, with C the load switched per vector */
+  report->power = options != NULL ? 0.5 * report->switched_capacitance *
+                                        options->voltage * options->voltage *
+                                        options->frequency
+                                  : 0.0;
+
+  free(weights);
+
+  return 0;
+}
+
+void logic_power_print_hottest(const logic_activity_t *activity,
+                               const logic_power_options_t *options,
+                               int count, FILE *stream) {
+  if (activity == NULL || stream == NULL) {
+    return;
+  }
+
+  const logic_circuit_t *circuit = activity->circuit;
+  double *weights = logic_power_weights(circuit, options);
+  logic_power_net_t *nets = malloc(circuit->nets * sizeof(logic_power_net_t));
+
+  if (weights == NULL || nets == NULL) {
+    free(weights);
+    free(nets);
+    return;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    nets[n].net = n;
+    nets[n].weight = weights[n] * (double)activity->toggles[n];
+  }
+
+  qsort(nets, circuit->nets, sizeof(logic_power_net_t), logic_power_compare);
+
+  /* Net to gate, for the block names */
+  int *drivers = malloc(circuit->nets * sizeof(int));
+
+  if (drivers == NULL) {
+    free(weights);
+    free(nets);
+    return;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    drivers[n] = -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    for (int b = 0; b < circuit->gate_list[g].width; b++) {
+      drivers[circuit->gate_list[g].output + b] = g;
+    }
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+----------+");
+  LOG_SIM_FILE_PRINT(stream, "|   NET           | TOGGLES    | RATE     |");
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+----------+");
+
+  for (int i = 0; i < count && i < circuit->nets; i++) {
+    int n = nets[i].net;
+    double rate = activity->transitions > 0
+                      ? (double)activity->toggles[n] / activity->transitions
+                      : 0.0;
+    char name[BUFFER];
+
+    if (nets[i].weight <= 0.0) {
+      break;
+    }
+
+    if (drivers[n] >= 0) {
+      const logic_gate_t *gate = &circuit->gate_list[drivers[n]];
+      const logic_block_t *logic_block = circuit->block_list[gate->block];
+
+      if (gate->width > 1) {
+        snprintf(name, sizeof(name), "%s[%d] (%s)", logic_block->name,
+                 n - gate->output,
+                 logic_block->prefix ? logic_block->prefix : "");
+      } else {
+        snprintf(name, sizeof(name), "%s (%s)", logic_block->name,
+                 logic_block->prefix ? logic_block->prefix : "");
+      }
+    } else {
+      snprintf(name, sizeof(name), "input %d", n - LOGIC_NET_RESERVED);
+    }
+
+    LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10llu | %-8.4f |", name,
+                       (unsigned long long)activity->toggles[n], rate);
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+----------+");
+
+  free(weights);
+  free(nets);
+  free(drivers);
+}
+
+void logic_activity_free(logic_activity_t *activity) {
+  if (activity == NULL) {
+    return;
+  }
+
+  free(activity->previous);
+  free(activity->toggles);
+  free(activity);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,616 @@
+/**
+ * @file logsimstream.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief File driven simulation with prefetched stimulus and background
+ * response writes.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimstream.h"
+#include "../include/logsimvm.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+/* Buffer of the stdio stream, reads and writes reach the file this large */
+#define LOGIC_STREAM_IO_SIZE (1 << 20)
+
+/*************** Structures ***************/
+
+typedef struct logic_stream_buffer {
+  logic_word_t *words;
+  long records;
+  long vectors;
+
+  bool full; /* Owned by the consumer while set, by the producer otherwise */
+  bool last;
+} logic_stream_buffer_t;
+
+/* One file and the thread moving its records, buffers are used in turn */
+typedef struct logic_stream {
+  FILE *file;
+  logic_stream_format_t format;
+  int columns;
+  long batch;
+
+  logic_stream_buffer_t buffers[2];
+
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t changed_cond;
+  bool opened; /* Mutex and condition initialised */
+  bool started;
+  bool stop;
+  int status;
+
+  /* Stimulus vectors not read yet, -1 until the end of the file */
+  long vectors_left;
+  long line_number;
+
+  char *line;
+  size_t line_size;
+} logic_stream_t;
+
+/*************** Function Definitions ***************/
+
+static int logic_stream_read_binary(logic_stream_t *stream,
+                                    logic_stream_buffer_t *buffer) {
+  long records = stream->batch;
+
+  if (stream->vectors_left >= 0 && records > (stream->vectors_left + 63) / 64) {
+    records = (stream->vectors_left + 63) / 64;
+  }
+
+  size_t record_size = stream->columns * sizeof(logic_word_t);
+  size_t read = fread(buffer->words, record_size, records, stream->file);
+
+  if (read < (size_t)records && ferror(stream->file)) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to read the stimulus.");
+    return -1;
+  }
+
+  buffer->records = read;
+  buffer->vectors = read * 64;
+
+  if (stream->vectors_left < 0) {
+    buffer->last = read < (size_t)records;
+    return 0;
+  }
+
+  if (read < (size_t)records) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Stimulus ends before (%ld) more vectors.",
+                        stream->vectors_left);
+    return -1;
+  }
+
+  if (buffer->vectors > stream->vectors_left) {
+    buffer->vectors = stream->vectors_left;
+  }
+
+  stream->vectors_left -= buffer->vectors;
+  buffer->last = stream->vectors_left == 0;
+
+  return 0;
+}
+
+static int logic_stream_read_text(logic_stream_t *stream,
+                                  logic_stream_buffer_t *buffer) {
+  long capacity = stream->batch * 64;
+  long vector = 0;
+
+  memset(buffer->words, 0,
+         stream->batch * stream->columns * sizeof(logic_word_t));
+
+  buffer->last = false;
+
+  while (vector < capacity) {
+    if (getline(&stream->line, &stream->line_size, stream->file) < 0) {
+      if (ferror(stream->file)) {
+        LOG_SIM_DEBUG_PRINT(stderr, "Failed to read the stimulus.");
+        return -1;
+      }
+
+      buffer->last = true;
+      break;
+    }
+
+    stream->line_number += 1;
+
+    logic_word_t *record = &buffer->words[vector / 64 * stream->columns];
+    logic_word_t bit = (logic_word_t)1 << (vector % 64);
+    int column = 0;
+
+    for (char *c = stream->line; *c != '\0' && *c != '#'; c++) {
+      if (*c == ' ' || *c == '\t' || *c == '_' || *c == '\r' || *c == '\n') {
+        continue;
+      }
+
+      if ((*c != '0' && *c != '1') || column == stream->columns) {
+        LOG_SIM_DEBUG_PRINT(stderr, "Stimulus line (%ld) is not a vector.",
+                            stream->line_number);
+        return -1;
+      }
+
+      if (*c == '1') {
+        record[column] |= bit;
+      }
+
+      column += 1;
+    }
+
+    /* Blank and comment lines */
+    if (column == 0) {
+      continue;
+    }
+
+    if (column != stream->columns) {
+      LOG_SIM_DEBUG_PRINT(stderr,
+                          "Stimulus line (%ld) has (%d) columns, expected "
+                          "(%d).",
+                          stream->line_number, column, stream->columns);
+      return -1;
+    }
+
+    vector += 1;
+  }
+
+  buffer->vectors = vector;
+  buffer->records = (vector + 63) / 64;
+
+  return 0;
+}
+
+static int logic_stream_write_buffer(logic_stream_t *stream,
+                                     const logic_stream_buffer_t *buffer) {
+  if (stream->format == LOGIC_STREAM_BINARY) {
+    size_t record_size = stream->columns * sizeof(logic_word_t);
+
+    if (fwrite(buffer->words, record_size, buffer->records, stream->file) !=
+        (size_t)buffer->records) {
+      return -1;
+    }
+
+    return 0;
+  }
+
+  for (long vector = 0; vector < buffer->vectors; vector++) {
+    const logic_word_t *record =
+        &buffer->words[vector / 64 * stream->columns];
+
+    for (int column = 0; column < stream->columns; column++) {
+      stream->line[column] = (record[column] >> (vector % 64)) & 1 ? '1' : '0';
+    }
+
+    stream->line[stream->columns] = '\n';
+
+    if (fwrite(stream->line, 1, stream->columns + 1, stream->file) !=
+        (size_t)stream->columns + 1) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/* Prefetch the stimulus, one buffer ahead of the simulation */
+static void *logic_stream_reader_main(void *argument) {
+  logic_stream_t *stream = argument;
+
+  for (int k = 0;; k ^= 1) {
+    logic_stream_buffer_t *buffer = &stream->buffers[k];
+
+    pthread_mutex_lock(&stream->mutex);
+
+    while (buffer->full && !stream->stop) {
+      pthread_cond_wait(&stream->changed_cond, &stream->mutex);
+    }
+
+    bool stop = stream->stop;
+
+    pthread_mutex_unlock(&stream->mutex);
+
+    if (stop) {
+      break;
+    }
+
+    int status = stream->format == LOGIC_STREAM_BINARY
+                     ? logic_stream_read_binary(stream, buffer)
+                     : logic_stream_read_text(stream, buffer);
+
+    pthread_mutex_lock(&stream->mutex);
+
+    if (status != 0) {
+      stream->status = -1;
+      buffer->last = true;
+    }
+
+    buffer->full = true;
+
+    pthread_cond_broadcast(&stream->changed_cond);
+    pthread_mutex_unlock(&stream->mutex);
+
+    if (buffer->last) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+/* Drain the responses while the simulation fills the other buffer */
+static void *logic_stream_writer_main(void *argument) {
+  logic_stream_t *stream = argument;
+
+  for (int k = 0;; k ^= 1) {
+    logic_stream_buffer_t *buffer = &stream->buffers[k];
+
+    pthread_mutex_lock(&stream->mutex);
+
+    while (!buffer->full && !stream->stop) {
+      pthread_cond_wait(&stream->changed_cond, &stream->mutex);
+    }
+
+    /* Stopping still writes the buffers already handed over */
+    bool full = buffer->full;
+
+    pthread_mutex_unlock(&stream->mutex);
+
+    if (!full) {
+      break;
+    }
+
+    int status = logic_stream_write_buffer(stream, buffer);
+    bool last = buffer->last;
+
+    pthread_mutex_lock(&stream->mutex);
+
+    if (status != 0) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Failed to write the responses.");
+      stream->status = -1;
+    } else {
+      buffer->full = false;
+    }
+
+    pthread_cond_broadcast(&stream->changed_cond);
+    pthread_mutex_unlock(&stream->mutex);
+
+    if (status != 0 || last) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+/* Wait for buffer k to be full or free, NULL once the thread failed */
+static logic_stream_buffer_t *
+logic_stream_wait(logic_stream_t *stream, int k, bool full, long *stalls) {
+  logic_stream_buffer_t *buffer = &stream->buffers[k];
+
+  pthread_mutex_lock(&stream->mutex);
+
+  if (buffer->full != full && stream->status == 0) {
+    *stalls += 1;
+  }
+
+  while (buffer->full != full && stream->status == 0) {
+    pthread_cond_wait(&stream->changed_cond, &stream->mutex);
+  }
+
+  int status = stream->status;
+
+  pthread_mutex_unlock(&stream->mutex);
+
+  return status == 0 ? buffer : NULL;
+}
+
+static void logic_stream_release(logic_stream_t *stream, int k, bool full) {
+  pthread_mutex_lock(&stream->mutex);
+
+  stream->buffers[k].full = full;
+
+  pthread_cond_broadcast(&stream->changed_cond);
+  pthread_mutex_unlock(&stream->mutex);
+}
+
+static int logic_stream_open(logic_stream_t *stream, const char *path,
+                             const char *mode, logic_stream_format_t format,
+                             int columns, long batch) {
+  stream->format = format;
+  stream->columns = columns;
+  stream->batch = batch;
+  stream->vectors_left = -1;
+
+  pthread_mutex_init(&stream->mutex, NULL);
+  pthread_cond_init(&stream->changed_cond, NULL);
+  stream->opened = true;
+
+  for (int k = 0; k < 2; k++) {
+    stream->buffers[k].words =
+        calloc(batch * (columns > 0 ? columns : 1), sizeof(logic_word_t));
+
+    if (stream->buffers[k].words == NULL) {
+      return -1;
+    }
+  }
+
+  /* Text lines are written from the line buffer */
+  if (format == LOGIC_STREAM_TEXT) {
+    stream->line_size = columns + 2;
+    stream->line = malloc(stream->line_size);
+
+    if (stream->line == NULL) {
+      return -1;
+    }
+  }
+
+  stream->file = fopen(path, mode);
+
+  if (stream->file == NULL) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to open (%s).", path);
+    return -1;
+  }
+
+  setvbuf(stream->file, NULL, _IOFBF, LOGIC_STREAM_IO_SIZE);
+
+  return 0;
+}
+
+static int logic_stream_start(logic_stream_t *stream,
+                              void *(*thread_main)(void *)) {
+  if (pthread_create(&stream->thread, NULL, thread_main, stream) != 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Failed to start the I/O thread.");
+    return -1;
+  }
+
+  stream->started = true;
+
+  return 0;
+}
+
+static int logic_stream_join(logic_stream_t *stream) {
+  if (stream->started) {
+    pthread_mutex_lock(&stream->mutex);
+    stream->stop = true;
+    pthread_cond_broadcast(&stream->changed_cond);
+    pthread_mutex_unlock(&stream->mutex);
+
+    pthread_join(stream->thread, NULL);
+
+    stream->started = false;
+  }
+
+  return stream->status;
+}
+
+static int logic_stream_close(logic_stream_t *stream) {
+  int status = logic_stream_join(stream);
+
+  if (stream->file != NULL && fclose(stream->file) != 0) {
+    status = -1;
+  }
+
+  /* Streams never opened hold no pthread objects */
+  if (stream->opened) {
+    pthread_cond_destroy(&stream->changed_cond);
+    pthread_mutex_destroy(&stream->mutex);
+    stream->opened = false;
+  }
+
+  free(stream->buffers[0].words);
+  free(stream->buffers[1].words);
+  free(stream->line);
+
+  return status;
+}
+
+/* Simulate every record of the stimulus, one buffer at a time */
+static int logic_stream_run(logic_circuit_t *circuit,
+                            const logic_vm_program_t *program,
+                            logic_word_t *values, logic_stream_t *reader,
+                            logic_stream_t *writer,
+                            logic_stream_report_t *report) {
+  for (int k = 0;; k ^= 1) {
+    logic_stream_buffer_t *in =
+        logic_stream_wait(reader, k, true, &report->read_stalls);
+    logic_stream_buffer_t *out =
+        in != NULL ? logic_stream_wait(writer, k, false, &report->write_stalls)
+                   : NULL;
+
+    if (out == NULL) {
+      return -1;
+    }
+
+    for (long r = 0; r < in->records; r++) {
+      memcpy(&values[LOGIC_INPUT_NET(0)], &in->words[r * reader->columns],
+             reader->columns * sizeof(logic_word_t));
+
+      int status = logic_vm_run(program, values);
+
+      if (status < 0) {
+        return -1;
+      }
+
+      report->oscillating += status > 0;
+
+      /* Lanes past the last vector are cleared */
+      long lanes = in->vectors - r * 64;
+      logic_word_t mask = lanes >= 64 ? ~(logic_word_t)0
+                                      : ((logic_word_t)1 << lanes) - 1;
+
+      for (int i = 0; i < circuit->outputs; i++) {
+        out->words[r * writer->columns + i] =
+            values[circuit->output_nets[i]] & mask;
+      }
+    }
+
+    out->records = in->records;
+    out->vectors = in->vectors;
+    out->last = in->last;
+
+    report->records += in->records;
+    report->vectors += in->vectors;
+
+    bool last = in->last;
+
+    logic_stream_release(writer, k, true);
+    logic_stream_release(reader, k, false);
+
+    if (last) {
+      return 0;
+    }
+  }
+}
+
+int logic_stream_simulate(logic_circuit_t *circuit, const char *stimulus_path,
+                          const char *response_path,
+                          const logic_stream_options_t *options,
+                          logic_stream_report_t *report) {
+  if (circuit == NULL || stimulus_path == NULL || response_path == NULL) {
+    return -1;
+  }
+
+  logic_stream_options_t run_options = {LOGIC_STREAM_BINARY,
+                                        LOGIC_STREAM_BINARY, 0};
+
+  if (options != NULL) {
+    run_options = *options;
+  }
+
+  if (run_options.batch <= 0) {
+    run_options.batch = LOGIC_STREAM_BATCH;
+  }
+
+  logic_stream_report_t run_report = {0};
+  logic_stream_t reader = {0};
+  logic_stream_t writer = {0};
+
+  logic_vm_program_t *program = logic_vm_compile(circuit);
+  logic_word_t *values = malloc(circuit->nets * sizeof(logic_word_t));
+
+  int status = program != NULL && values != NULL ? 0 : -1;
+
+  if (status == 0) {
+    /* Loops start from the state held by the circuit, like logic_vm_run */
+    memcpy(values, circuit->values, circuit->nets * sizeof(logic_word_t));
+
+    status = logic_stream_open(&reader, stimulus_path, "r",
+                               run_options.stimulus_format,
+                               circuit->primary_inputs, run_options.batch);
+  }
+
+  if (status == 0 && reader.format == LOGIC_STREAM_BINARY) {
+    logic_stream_header_t header;
+
+    if (fread(&header, sizeof(header), 1, reader.file) != 1 ||
+        memcmp(header.magic, LOGIC_STREAM_MAGIC, 4) != 0 ||
+        header.columns != (uint32_t)circuit->primary_inputs) {
+      LOG_SIM_DEBUG_PRINT(stderr, "Stimulus (%s) does not match the circuit.",
+                          stimulus_path);
+      status = -1;
+    } else if (header.vectors > 0) {
+      reader.vectors_left = header.vectors;
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fileno(reader.file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  }
+
+  if (status == 0) {
+    status = logic_stream_open(&writer, response_path, "w",
+                               run_options.response_format, circuit->outputs,
+                               run_options.batch);
+  }
+
+  /* The vector count is filled in once known */
+  logic_stream_header_t header = {{0}, (uint32_t)circuit->outputs, 0};
+
+  memcpy(header.magic, LOGIC_STREAM_MAGIC, 4);
+
+  if (status == 0 && writer.format == LOGIC_STREAM_BINARY &&
+      fwrite(&header, sizeof(header), 1, writer.file) != 1) {
+    status = -1;
+  }
+
+  if (status == 0) {
+    status = logic_stream_start(&reader, logic_stream_reader_main);
+  }
+
+  if (status == 0) {
+    status = logic_stream_start(&writer, logic_stream_writer_main);
+  }
+
+  if (status == 0) {
+    status = logic_stream_run(circuit, program, values, &reader, &writer,
+                              &run_report);
+  }
+
+  /* The writer drains the buffers handed over before it stops */
+  if (logic_stream_join(&writer) != 0) {
+    status = -1;
+  }
+
+  /* Responses written to a pipe keep the unknown count */
+  if (status == 0 && writer.format == LOGIC_STREAM_BINARY &&
+      fseek(writer.file, 0, SEEK_SET) == 0) {
+    header.vectors = run_report.vectors;
+
+    if (fwrite(&header, sizeof(header), 1, writer.file) != 1) {
+      status = -1;
+    }
+  }
+
+  if (logic_stream_close(&reader) != 0) {
+    status = -1;
+  }
+
+  if (logic_stream_close(&writer) != 0) {
+    status = -1;
+  }
+
+  logic_vm_free(program);
+  free(values);
+
+  if (report != NULL) {
+    *report = run_report;
+  }
+
+  return status;
+}
+
+void logic_stream_print_report(const logic_stream_report_t *report,
+                               FILE *stream) {
+  if (report == NULL || stream == NULL) {
+    return;
+  }
+
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+  LOG_SIM_FILE_PRINT(stream, "|   STREAM        | VALUE      |");
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10ld |", "Vectors", report->vectors);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10ld |", "Records", report->records);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10ld |", "Read stalls",
+                     report->read_stalls);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10ld |", "Write stalls",
+                     report->write_stalls);
+  LOG_SIM_FILE_PRINT(stream, "| %-15s | %-10ld |", "Oscillating",
+                     report->oscillating);
+  LOG_SIM_FILE_PRINT(stream, "+-----------------+------------+");
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
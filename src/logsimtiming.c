@@ -0,0 +1,670 @@
+/**
+ * @file logsimtiming.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Event driven timing simulation over a hierarchical timing wheel.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimtiming.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_TIMING_SLOT_BITS 8
+#define LOGIC_TIMING_SLOT_MASK (LOGIC_TIMING_SLOTS - 1)
+
+/* Ticks covered by the wheels up to and including wheel w */
+#define LOGIC_TIMING_SPAN(w)                                                   \
+  ((uint64_t)1 << (LOGIC_TIMING_SLOT_BITS * ((w) + 1)))
+
+/*************** Function Definitions ***************/
+
+static int logic_timing_find_slot(const uint64_t *bits, int start) {
+  for (int word = start >> 6; word < LOGIC_TIMING_SLOTS / 64; word++) {
+    uint64_t mask = bits[word];
+
+    if (word == start >> 6) {
+      mask &= ~(uint64_t)0 << (start & 63);
+    }
+
+    if (mask != 0) {
+      return (word << 6) + __builtin_ctzll(mask);
+    }
+  }
+
+  return -1;
+}
+
+static int logic_timing_alloc_event(logic_timing_t *timing) {
+  if (timing->free_list == -1) {
+    int capacity = timing->capacity * 2;
+    logic_timing_event_t *event_list = realloc(
+        timing->event_list, capacity * sizeof(logic_timing_event_t));
+
+    if (event_list == NULL) {
+      return -1;
+    }
+
+    for (int e = capacity - 1; e >= timing->capacity; e--) {
+      event_list[e].next = timing->free_list;
+      timing->free_list = e;
+    }
+
+    timing->event_list = event_list;
+    timing->capacity = capacity;
+  }
+
+  int id = timing->free_list;
+
+  timing->free_list = timing->event_list[id].next;
+  timing->events += 1;
+
+  return id;
+}
+
+static void logic_timing_release_event(logic_timing_t *timing, int id) {
+  timing->event_list[id].next = timing->free_list;
+  timing->free_list = id;
+  timing->events -= 1;
+}
+
+static void logic_timing_insert(logic_timing_t *timing, int id) {
+  logic_timing_event_t *event = &timing->event_list[id];
+  uint64_t distance = event->time ^ timing->now;
+
+  event->next = -1;
+
+  for (int w = 0; w < LOGIC_TIMING_WHEELS; w++) {
+    if (distance >= LOGIC_TIMING_SPAN(w)) {
+      continue;
+    }
+
+    int slot = (int)(event->time >> (LOGIC_TIMING_SLOT_BITS * w)) &
+               LOGIC_TIMING_SLOT_MASK;
+
+    /* Slots stay in scheduling order so later changes win at equal times */
+    if (timing->slot_tails[w][slot] == -1) {
+      timing->slot_heads[w][slot] = id;
+      timing->slot_bits[w][slot >> 6] |= (uint64_t)1 << (slot & 63);
+    } else {
+      timing->event_list[timing->slot_tails[w][slot]].next = id;
+    }
+
+    timing->slot_tails[w][slot] = id;
+    return;
+  }
+
+  if (timing->overflow_tail == -1) {
+    timing->overflow_head = id;
+  } else {
+    timing->event_list[timing->overflow_tail].next = id;
+  }
+
+  timing->overflow_tail = id;
+}
+
+/* Detach the list of a slot, clearing it */
+static int logic_timing_take_slot(logic_timing_t *timing, int wheel,
+                                  int slot) {
+  int head = timing->slot_heads[wheel][slot];
+
+  timing->slot_heads[wheel][slot] = -1;
+  timing->slot_tails[wheel][slot] = -1;
+  timing->slot_bits[wheel][slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+
+  return head;
+}
+
+/* Move the events of a list into the wheels relative to the current time */
+static void logic_timing_cascade(logic_timing_t *timing, int head) {
+  while (head != -1) {
+    int next = timing->event_list[head].next;
+
+    if (timing->event_list[head].cancelled) {
+      logic_timing_release_event(timing, head);
+    } else {
+      logic_timing_insert(timing, head);
+    }
+
+    head = next;
+  }
+}
+
+/* Advance to the earliest pending time not after until, 0 when none is due */
+static int logic_timing_advance(logic_timing_t *timing, uint64_t until) {
+  for (;;) {
+    int slot = logic_timing_find_slot(
+        timing->slot_bits[0], (int)(timing->now & LOGIC_TIMING_SLOT_MASK));
+
+    if (slot != -1) {
+      uint64_t time = (timing->now & ~(uint64_t)LOGIC_TIMING_SLOT_MASK) |
+                      (uint64_t)slot;
+
+      if (time > until) {
+        return 0;
+      }
+
+      timing->now = time;
+      return 1;
+    }
+
+    int wheel = 1;
+
+    for (; wheel < LOGIC_TIMING_WHEELS; wheel++) {
+      int shift = LOGIC_TIMING_SLOT_BITS * wheel;
+      int current = (int)(timing->now >> shift) & LOGIC_TIMING_SLOT_MASK;
+
+      slot = logic_timing_find_slot(timing->slot_bits[wheel], current + 1);
+
+      if (slot != -1) {
+        break;
+      }
+    }
+
+    if (wheel < LOGIC_TIMING_WHEELS) {
+      /* Jump to the start of the slot, the wheels below it are empty */
+      int shift = LOGIC_TIMING_SLOT_BITS * wheel;
+      uint64_t start = (timing->now & ~(LOGIC_TIMING_SPAN(wheel) - 1)) |
+                       ((uint64_t)slot << shift);
+
+      if (start > until) {
+        return 0;
+      }
+
+      timing->now = start;
+      logic_timing_cascade(timing, logic_timing_take_slot(timing, wheel, slot));
+      continue;
+    }
+
+    if (timing->overflow_head == -1) {
+      return 0;
+    }
+
+    uint64_t earliest = UINT64_MAX;
+
+    for (int e = timing->overflow_head; e != -1;
+         e = timing->event_list[e].next) {
+      if (!timing->event_list[e].cancelled &&
+          timing->event_list[e].time < earliest) {
+        earliest = timing->event_list[e].time;
+      }
+    }
+
+    if (earliest != UINT64_MAX && earliest > until) {
+      return 0;
+    }
+
+    int head = timing->overflow_head;
+
+    if (earliest != UINT64_MAX) {
+      timing->now = earliest;
+    }
+
+    timing->overflow_head = -1;
+    timing->overflow_tail = -1;
+    logic_timing_cascade(timing, head);
+  }
+}
+
+static void logic_timing_cancel(logic_timing_t *timing, int id) {
+  logic_timing_event_t *event = &timing->event_list[id];
+
+  event->cancelled = true;
+  timing->pending[event->gate] = event->previous_pending;
+  timing->cancelled += 1;
+
+  if (event->previous_pending != -1) {
+    timing->event_list[event->previous_pending].next_pending = -1;
+  }
+}
+
+static int logic_timing_schedule(logic_timing_t *timing, int g, uint8_t value) {
+  int net = timing->circuit->gate_list[g].output;
+  uint64_t time = timing->now + (value ? timing->delays[g].rise
+                                       : timing->delays[g].fall);
+
+  if (timing->options.mode == LOGIC_DELAY_INERTIAL) {
+    int tail = timing->pending[g];
+
+    if (tail != -1 && timing->event_list[tail].value == value) {
+      return 0;
+    }
+
+    /* A new value before the pending one matured swallows the pulse */
+    while (timing->pending[g] != -1) {
+      logic_timing_cancel(timing, timing->pending[g]);
+    }
+
+    if (timing->values[net] == value) {
+      return 0;
+    }
+  } else {
+    /* Transactions at or after the new one are overridden by it */
+    while (timing->pending[g] != -1 &&
+           timing->event_list[timing->pending[g]].time >= time) {
+      logic_timing_cancel(timing, timing->pending[g]);
+    }
+
+    int tail = timing->pending[g];
+    uint8_t projected =
+        tail != -1 ? timing->event_list[tail].value : timing->values[net];
+
+    if (projected == value) {
+      return 0;
+    }
+  }
+
+  int id = logic_timing_alloc_event(timing);
+
+  if (id == -1) {
+    return -1;
+  }
+
+  logic_timing_event_t *event = &timing->event_list[id];
+
+  event->time = time;
+  event->net = net;
+  event->gate = g;
+  event->value = value;
+  event->cancelled = false;
+  event->previous_pending = timing->pending[g];
+  event->next_pending = -1;
+
+  if (timing->pending[g] != -1) {
+    timing->event_list[timing->pending[g]].next_pending = id;
+  }
+
+  timing->pending[g] = id;
+  logic_timing_insert(timing, id);
+
+  return 0;
+}
+
+static uint8_t logic_timing_evaluate(const logic_timing_t *timing, int g) {
+  const logic_gate_t *gate = &timing->circuit->gate_list[g];
+  const int *fanins = &timing->circuit->fanins[gate->fanin];
+  const uint8_t *values = timing->values;
+  uint8_t value = 0;
+
+  switch (gate->logic_block_type) {
+  case AND: {
+    value = 1;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      value &= values[fanins[j]];
+    }
+
+    break;
+  }
+  case OR: {
+    for (int j = 0; j < gate->inputs; j++) {
+      value |= values[fanins[j]];
+    }
+
+    break;
+  }
+  case XOR: {
+    for (int j = 0; j < gate->inputs; j++) {
+      value ^= values[fanins[j]];
+    }
+
+    break;
+  }
+  case NOT: {
+    value = gate->inputs > 0 ? !values[fanins[gate->inputs - 1]] : 1;
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+
+  return value;
+}
+
+/* Loops start from the state held by the circuit, lane 0 */
+static int logic_timing_settle(logic_timing_t *timing,
+                               const logic_loop_t *loop) {
+  const logic_circuit_t *circuit = timing->circuit;
+  bool changed = true;
+
+  for (int g = loop->first; g < loop->first + loop->gates; g++) {
+    int out = circuit->gate_list[g].output;
+
+    timing->values[out] = (uint8_t)(circuit->values[out] & 1);
+  }
+
+  for (int i = 0; i < loop->gates + 2 && changed; i++) {
+    changed = false;
+
+    for (int g = loop->first; g < loop->first + loop->gates; g++) {
+      int out = circuit->gate_list[g].output;
+      uint8_t value = logic_timing_evaluate(timing, g);
+
+      changed = changed || value != timing->values[out];
+      timing->values[out] = value;
+    }
+  }
+
+  /* An oscillating loop keeps running on the wheel, with its real delays */
+  for (int g = loop->first; g < loop->first + loop->gates && changed; g++) {
+    uint8_t value = logic_timing_evaluate(timing, g);
+
+    if (value != timing->values[circuit->gate_list[g].output] &&
+        logic_timing_schedule(timing, g, value) != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int logic_timing_build_fanouts(logic_timing_t *timing) {
+  const logic_circuit_t *circuit = timing->circuit;
+
+  timing->fanout_offsets = calloc(circuit->nets + 1, sizeof(int));
+
+  if (timing->fanout_offsets == NULL) {
+    return -1;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      timing->fanout_offsets[circuit->fanins[gate->fanin + j] + 1] += 1;
+    }
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    timing->fanout_offsets[n + 1] += timing->fanout_offsets[n];
+  }
+
+  int *fill = malloc((circuit->nets + 1) * sizeof(int));
+
+  timing->fanout_list =
+      malloc((timing->fanout_offsets[circuit->nets] + 1) * sizeof(int));
+
+  if (fill == NULL || timing->fanout_list == NULL) {
+    free(fill);
+    return -1;
+  }
+
+  memcpy(fill, timing->fanout_offsets, circuit->nets * sizeof(int));
+
+  for (int g = 0; g < circuit->gates; g++) {
+    const logic_gate_t *gate = &circuit->gate_list[g];
+
+    for (int j = 0; j < gate->inputs; j++) {
+      int net = circuit->fanins[gate->fanin + j];
+
+      /* A gate reading a net twice is queued once anyway */
+      timing->fanout_list[fill[net]++] = g;
+    }
+  }
+
+  free(fill);
+
+  return 0;
+}
+
+logic_timing_t *logic_timing_create(logic_circuit_t *circuit,
+                                    const logic_timing_options_t *options) {
+  if (circuit == NULL) {
+    return NULL;
+  }
+
+  /* Delays are per gate type and per bit, cells have neither */
+  if (circuit->cells > 0) {
+    return NULL;
+  }
+
+  logic_timing_t *timing = calloc(1, sizeof(logic_timing_t));
+
+  if (timing == NULL) {
+    return NULL;
+  }
+
+  timing->circuit = circuit;
+
+  if (options != NULL) {
+    timing->options = *options;
+  } else {
+    timing->options.mode = LOGIC_DELAY_INERTIAL;
+  }
+
+  for (int t = 0; t < 4; t++) {
+    logic_delay_t *delay = &timing->options.type_delays[t];
+
+    delay->rise = delay->rise > 0 ? delay->rise : 1;
+    delay->fall = delay->fall > 0 ? delay->fall : 1;
+  }
+
+  timing->capacity = circuit->gates * 2 > 1024 ? circuit->gates * 2 : 1024;
+  timing->free_list = -1;
+  timing->overflow_head = -1;
+  timing->overflow_tail = -1;
+
+  timing->values = calloc(circuit->nets, sizeof(uint8_t));
+  timing->delays = malloc((circuit->gates + 1) * sizeof(logic_delay_t));
+  timing->pending = malloc((circuit->gates + 1) * sizeof(int));
+  timing->queue = malloc((circuit->gates + 1) * sizeof(int));
+  timing->gate_stamps = calloc(circuit->gates + 1, sizeof(uint32_t));
+  timing->event_list = malloc(timing->capacity * sizeof(logic_timing_event_t));
+
+  if (timing->values == NULL || timing->delays == NULL ||
+      timing->pending == NULL || timing->queue == NULL ||
+      timing->gate_stamps == NULL || timing->event_list == NULL ||
+      logic_timing_build_fanouts(timing) != 0) {
+    logic_timing_free(timing);
+    return NULL;
+  }
+
+  for (int e = timing->capacity - 1; e >= 0; e--) {
+    timing->event_list[e].next = timing->free_list;
+    timing->free_list = e;
+  }
+
+  for (int w = 0; w < LOGIC_TIMING_WHEELS; w++) {
+    for (int s = 0; s < LOGIC_TIMING_SLOTS; s++) {
+      timing->slot_heads[w][s] = -1;
+      timing->slot_tails[w][s] = -1;
+    }
+  }
+
+  /* Settle on the data blocks, as if they had been applied long ago */
+  timing->values[LOGIC_NET_CONST1] = 1;
+
+  for (int i = 0; i < circuit->primary_inputs; i++) {
+    timing->values[LOGIC_INPUT_NET(i)] = circuit->input_list[i]->data != 0;
+  }
+
+  for (int g = 0; g < circuit->gates; g++) {
+    timing->delays[g] =
+        timing->options.type_delays[circuit->gate_list[g].logic_block_type];
+    timing->pending[g] = -1;
+  }
+
+  int loop = 0;
+
+  for (int g = 0; g < circuit->gates; g++) {
+    if (loop < circuit->loops && circuit->loop_list[loop].first == g) {
+      if (logic_timing_settle(timing, &circuit->loop_list[loop]) != 0) {
+        logic_timing_free(timing);
+        return NULL;
+      }
+
+      g += circuit->loop_list[loop].gates - 1;
+      loop += 1;
+      continue;
+    }
+
+    timing->values[circuit->gate_list[g].output] =
+        logic_timing_evaluate(timing, g);
+  }
+
+  return timing;
+}
+
+int logic_timing_set_delay(logic_timing_t *timing, int gate,
+                           logic_delay_t delay) {
+  if (timing == NULL || gate < 0 || gate >= timing->circuit->gates) {
+    return -1;
+  }
+
+  timing->delays[gate].rise = delay.rise > 0 ? delay.rise : 1;
+  timing->delays[gate].fall = delay.fall > 0 ? delay.fall : 1;
+
+  return 0;
+}
+
+int logic_timing_set_input(logic_timing_t *timing, int input, int value,
+                           uint64_t time) {
+  if (timing == NULL || input < 0 ||
+      input >= timing->circuit->primary_inputs || time < timing->now) {
+    return -1;
+  }
+
+  int id = logic_timing_alloc_event(timing);
+
+  if (id == -1) {
+    return -1;
+  }
+
+  logic_timing_event_t *event = &timing->event_list[id];
+
+  event->time = time;
+  event->net = LOGIC_INPUT_NET(input);
+  event->gate = -1;
+  event->value = value != 0;
+  event->cancelled = false;
+  event->previous_pending = -1;
+  event->next_pending = -1;
+
+  logic_timing_insert(timing, id);
+
+  return 0;
+}
+
+int logic_timing_run(logic_timing_t *timing, uint64_t until) {
+  if (timing == NULL) {
+    return -1;
+  }
+
+  while (logic_timing_advance(timing, until)) {
+    int slot = (int)(timing->now & LOGIC_TIMING_SLOT_MASK);
+    int head = logic_timing_take_slot(timing, 0, slot);
+    int queued = 0;
+
+    timing->stamp += 1;
+
+    if (timing->stamp == 0) {
+      memset(timing->gate_stamps, 0, timing->circuit->gates * sizeof(uint32_t));
+      timing->stamp = 1;
+    }
+
+    /* Apply every change of this time step before evaluating any gate */
+    while (head != -1) {
+      logic_timing_event_t *event = &timing->event_list[head];
+      int next = event->next;
+
+      if (!event->cancelled) {
+        if (event->gate >= 0) {
+          /* The oldest pending event of a gate always matures first */
+          if (event->next_pending != -1) {
+            timing->event_list[event->next_pending].previous_pending = -1;
+          } else {
+            timing->pending[event->gate] = -1;
+          }
+        }
+
+        if (timing->values[event->net] != event->value) {
+          timing->values[event->net] = event->value;
+          timing->applied += 1;
+
+          if (timing->options.on_change != NULL) {
+            timing->options.on_change(timing->options.user, event->net,
+                                      event->value, timing->now);
+          }
+
+          for (int f = timing->fanout_offsets[event->net];
+               f < timing->fanout_offsets[event->net + 1]; f++) {
+            int g = timing->fanout_list[f];
+
+            if (timing->gate_stamps[g] != timing->stamp) {
+              timing->gate_stamps[g] = timing->stamp;
+              timing->queue[queued++] = g;
+            }
+          }
+        }
+      }
+
+      logic_timing_release_event(timing, head);
+      head = next;
+    }
+
+    for (int q = 0; q < queued; q++) {
+      int g = timing->queue[q];
+
+      timing->evaluations += 1;
+
+      if (logic_timing_schedule(timing, g, logic_timing_evaluate(timing, g)) !=
+          0) {
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+int logic_timing_value(const logic_timing_t *timing, int net) {
+  if (timing == NULL || net < 0 || net >= timing->circuit->nets) {
+    return -1;
+  }
+
+  return timing->values[net];
+}
+
+int logic_timing_write_back(logic_timing_t *timing) {
+  if (timing == NULL) {
+    return -1;
+  }
+
+  logic_circuit_t *circuit = timing->circuit;
+
+  for (int n = 0; n < circuit->nets; n++) {
+    circuit->values[n] = timing->values[n] ? ~(logic_word_t)0 : 0;
+  }
+
+  return logic_circuit_write_back(circuit, 0);
+}
+
+void logic_timing_free(logic_timing_t *timing) {
+  if (timing == NULL) {
+    return;
+  }
+
+  free(timing->values);
+  free(timing->delays);
+  free(timing->fanout_offsets);
+  free(timing->fanout_list);
+  free(timing->pending);
+  free(timing->queue);
+  free(timing->gate_stamps);
+  free(timing->event_list);
+  free(timing);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,883 @@
+/**
+ * @file logsimvm.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Register based bytecode for compiled circuits.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimlib.h"
+#include "../include/logsimmemory.h"
+#include "../include/logsimnuma.h"
+#include "../include/logsimpower.h"
+#include "../include/logsimvm.h"
+#include "../include/logsimword.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_VM_LAST_DST 1
+#define LOGIC_VM_LAST_C 2
+
+/* Loops up to this many nets keep their previous values on the stack */
+#define LOGIC_VM_LOOP_NETS 64
+
+/*************** Function Definitions ***************/
+
+static logic_vm_opcode_t logic_vm_binary_opcode(logic_block_type_t type) {
+  switch (type) {
+  case AND:
+    return LOGIC_VM_AND2;
+  case OR:
+    return LOGIC_VM_OR2;
+  case XOR:
+    return LOGIC_VM_XOR2;
+  case NOT:
+    return LOGIC_VM_NOT;
+  default:
+    return LOGIC_VM_HALT;
+  }
+}
+
+static logic_vm_opcode_t logic_vm_inverted_opcode(logic_vm_opcode_t opcode) {
+  switch (opcode) {
+  case LOGIC_VM_AND2:
+    return LOGIC_VM_ANDN;
+  case LOGIC_VM_OR2:
+    return LOGIC_VM_ORN;
+  case LOGIC_VM_XOR2:
+    return LOGIC_VM_XNOR2;
+  default:
+    return opcode;
+  }
+}
+
+static void logic_vm_emit(logic_vm_program_t *program, logic_vm_opcode_t opcode,
+                          int dst, int a, int b) {
+  logic_vm_instruction_t *instruction =
+      &program->instruction_list[program->instructions++];
+
+  instruction->opcode = opcode;
+  instruction->dst = (uint32_t)dst;
+  instruction->a = (uint32_t)a;
+  instruction->b = (uint32_t)b;
+  instruction->c = 0;
+}
+
+/* Fold adjacent instruction pairs into single dispatch superinstructions */
+static void logic_vm_fuse(logic_vm_program_t *program) {
+  logic_vm_instruction_t *list = program->instruction_list;
+  int count = 0;
+
+  for (int i = 0; i < program->instructions; i++) {
+    logic_vm_instruction_t current = list[i];
+
+    if (i + 1 < program->instructions) {
+      logic_vm_instruction_t next = list[i + 1];
+      bool binary = current.opcode == LOGIC_VM_AND2 ||
+                    current.opcode == LOGIC_VM_OR2 ||
+                    current.opcode == LOGIC_VM_XOR2;
+
+      /* dst = a op b; dst = dst op c */
+      if (binary && next.opcode == current.opcode &&
+          next.dst == current.dst && next.a == current.dst) {
+        current.opcode = current.opcode + (LOGIC_VM_AND3 - LOGIC_VM_AND2);
+        current.c = next.b;
+
+        list[count++] = current;
+        program->fused += 1;
+        i += 1;
+
+        continue;
+      }
+
+      /* dst = a op b; c = ~dst */
+      if (binary && next.opcode == LOGIC_VM_NOT && next.a == current.dst) {
+        current.opcode = current.opcode + (LOGIC_VM_AND2_NOT - LOGIC_VM_AND2);
+        current.c = next.dst;
+
+        list[count++] = current;
+        program->fused += 1;
+        i += 1;
+
+        continue;
+      }
+    }
+
+    list[count++] = current;
+  }
+
+  program->instructions = count;
+}
+
+/* Wide gates write their net once per fold, only the last write counts */
+static int logic_vm_mark_last_writes(logic_vm_program_t *program, int nets) {
+  bool *written = calloc(nets + 1, sizeof(bool));
+
+  program->last_writes = calloc(program->instructions + 1, sizeof(uint8_t));
+
+  if (written == NULL || program->last_writes == NULL) {
+    free(written);
+    return -1;
+  }
+
+  for (int i = program->instructions - 1; i >= 0; i--) {
+    const logic_vm_instruction_t *instruction = &program->instruction_list[i];
+
+    /* Cells write their whole bus once, their nets are counted as is */
+    if (instruction->opcode == LOGIC_VM_HALT ||
+        instruction->opcode == LOGIC_VM_LOOP ||
+        instruction->opcode == LOGIC_VM_CELL) {
+      continue;
+    }
+
+    if (instruction->opcode >= LOGIC_VM_AND2_NOT && !written[instruction->c]) {
+      written[instruction->c] = true;
+      program->last_writes[i] |= LOGIC_VM_LAST_C;
+    }
+
+    if (!written[instruction->dst]) {
+      written[instruction->dst] = true;
+      program->last_writes[i] |= LOGIC_VM_LAST_DST;
+    }
+  }
+
+  free(written);
+
+  return 0;
+}
+
+static void logic_vm_emit_fold(logic_vm_program_t *program,
+                               logic_vm_opcode_t opcode, int out,
+                               const int *fanins, int inputs,
+                               const int *not_source) {
+  if (inputs == 1) {
+    logic_vm_emit(program, LOGIC_VM_COPY, out, fanins[0], 0);
+    return;
+  }
+
+  int a = fanins[0];
+  int b = fanins[1];
+
+  /* Read an inverted operand straight from its source net */
+  if (not_source != NULL && not_source[b] == -1 && not_source[a] != -1) {
+    a = fanins[1];
+    b = fanins[0];
+  }
+
+  if (not_source != NULL && not_source[b] != -1) {
+    logic_vm_emit(program, logic_vm_inverted_opcode(opcode), out, a,
+                  not_source[b]);
+  } else {
+    logic_vm_emit(program, opcode, out, a, b);
+  }
+
+  for (int j = 2; j < inputs; j++) {
+    logic_vm_emit(program, opcode, out, out, fanins[j]);
+  }
+}
+
+/* The fold reuses the output net, a gate reading itself does so first */
+static int logic_vm_emit_feedback(logic_vm_program_t *program,
+                                  const logic_gate_t *gate,
+                                  const int *fanins) {
+  int *order = malloc(gate->inputs * sizeof(int));
+  int reads = 0;
+  int count = 1;
+
+  if (order == NULL) {
+    return -1;
+  }
+
+  for (int j = 0; j < gate->inputs; j++) {
+    if (fanins[j] == gate->output) {
+      reads += 1;
+    } else {
+      order[count++] = fanins[j];
+    }
+  }
+
+  /* Repeated reads fold away, x & x is x and x ^ x is 0 */
+  int first = 1;
+
+  if (gate->logic_block_type != XOR || reads % 2 == 1) {
+    order[0] = gate->output;
+    first = 0;
+  }
+
+  if (count - first == 0) {
+    logic_vm_emit(program, LOGIC_VM_CONST0, gate->output, 0, 0);
+  } else {
+    logic_vm_emit_fold(program,
+                       logic_vm_binary_opcode(gate->logic_block_type),
+                       gate->output, &order[first], count - first, NULL);
+  }
+
+  free(order);
+
+  return 0;
+}
+
+/* Native instruction for a one operation micro-program, HALT when none */
+static logic_vm_opcode_t logic_vm_lut_opcode(const logic_lut_op_t *op,
+                                             int *a, int *b) {
+  bool zero_high = op->high == 0;
+  bool zero_low = op->low == 0;
+
+  *a = op->select;
+  *b = 0;
+
+  switch (op->invert) {
+  case 0:
+    if (zero_low && !zero_high) {
+      *b = op->high;
+      return LOGIC_VM_AND2;
+    }
+
+    if (zero_high && !zero_low) {
+      *a = op->low;
+      *b = op->select;
+      return LOGIC_VM_ANDN;
+    }
+
+    break;
+  case LOGIC_LUT_INVERT_HIGH:
+    if (zero_high && !zero_low) {
+      *b = op->low;
+      return LOGIC_VM_OR2;
+    }
+
+    if (op->high == op->low) {
+      *b = op->low;
+      return LOGIC_VM_XOR2;
+    }
+
+    break;
+  case LOGIC_LUT_INVERT_LOW:
+    if (zero_low && zero_high) {
+      return op->select == 0 ? LOGIC_VM_CONST1 : LOGIC_VM_NOT;
+    }
+
+    if (zero_low) {
+      *a = op->high;
+      *b = op->select;
+      return LOGIC_VM_ORN;
+    }
+
+    break;
+  default:
+    break;
+  }
+
+  return LOGIC_VM_HALT;
+}
+
+/* A table whose micro-program is one operation on its inputs becomes it */
+static int logic_vm_emit_lut(logic_vm_program_t *program,
+                             const logic_gate_t *gate, const int *fanins) {
+  logic_lut_op_t op_list[LOGIC_LUT_OPS];
+  int result = 0;
+  int ops =
+      logic_lut_compile(gate->truth_table, gate->inputs, op_list, &result);
+
+  if (ops < 0) {
+    return -1;
+  }
+
+  /* Register 0 holds 0, the next ones the inputs */
+  if (ops == 0) {
+    logic_vm_emit(program, result == 0 ? LOGIC_VM_CONST0 : LOGIC_VM_COPY,
+                  gate->output, result == 0 ? 0 : fanins[result - 1], 0);
+    return 0;
+  }
+
+  int a = 0;
+  int b = 0;
+  logic_vm_opcode_t opcode =
+      ops == 1 ? logic_vm_lut_opcode(&op_list[0], &a, &b) : LOGIC_VM_HALT;
+
+  if (opcode != LOGIC_VM_HALT) {
+    logic_vm_emit(program, opcode, gate->output, a > 0 ? fanins[a - 1] : 0,
+                  b > 0 ? fanins[b - 1] : 0);
+    return 0;
+  }
+
+  logic_vm_lut_t *lut = &program->lut_list[program->luts];
+
+  lut->inputs = gate->inputs;
+  lut->first = program->lut_ops;
+  lut->ops = ops;
+  lut->result = result;
+
+  for (int j = 0; j < gate->inputs; j++) {
+    lut->fanins[j] = fanins[j];
+  }
+
+  for (int i = 0; i < ops; i++) {
+    program->lut_op_list[program->lut_ops++] = op_list[i];
+  }
+
+  logic_vm_emit(program, LOGIC_VM_LUT, gate->output, program->luts++, 0);
+
+  return 0;
+}
+
+/* Inside loops not_source is NULL, a NOT may be stale until the loop settles */
+static int logic_vm_emit_gate(logic_vm_program_t *program,
+                              const logic_circuit_t *circuit, int g,
+                              int *not_source) {
+  logic_gate_t *gate = &circuit->gate_list[g];
+  int *fanins = &circuit->fanins[gate->fanin];
+  int out = gate->output;
+
+  if (gate->logic_block_type == LUT) {
+    return logic_vm_emit_lut(program, gate, fanins);
+  }
+
+  if (LOGIC_IS_CELL(gate->logic_block_type)) {
+    logic_gate_t *cell = &program->cell_list[program->cells];
+
+    *cell = *gate;
+    cell->fanin = program->cells > 0 ? cell[-1].fanin + cell[-1].inputs : 0;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      program->cell_fanins[cell->fanin + j] = fanins[j];
+    }
+
+    logic_vm_emit(program, LOGIC_VM_CELL, out, program->cells++, 0);
+    return 0;
+  }
+
+  if (gate->inputs == 0) {
+    /* Unconnected gates keep their initialization value */
+    logic_vm_emit(program,
+                  logic_get_initalization_value(gate->logic_block_type)
+                      ? LOGIC_VM_CONST1
+                      : LOGIC_VM_CONST0,
+                  out, 0, 0);
+    return 0;
+  }
+
+  if (gate->logic_block_type == NOT) {
+    /* Folding the inputs leaves the inverse of the last one */
+    int in = fanins[gate->inputs - 1];
+
+    logic_vm_emit(program, LOGIC_VM_NOT, out, in, 0);
+
+    if (not_source != NULL) {
+      not_source[out] = in;
+    }
+
+    return 0;
+  }
+
+  for (int j = 0; j < gate->inputs && not_source == NULL; j++) {
+    if (fanins[j] == out) {
+      return logic_vm_emit_feedback(program, gate, fanins);
+    }
+  }
+
+  logic_vm_emit_fold(program, logic_vm_binary_opcode(gate->logic_block_type),
+                     out, fanins, gate->inputs, not_source);
+
+  return 0;
+}
+
+static int logic_vm_compile_loops(logic_vm_program_t *program,
+                                  const logic_circuit_t *circuit) {
+  program->loops = circuit->loops;
+  program->loop_list = calloc(circuit->loops + 1, sizeof(logic_vm_loop_t));
+
+  if (program->loop_list == NULL) {
+    return -1;
+  }
+
+  for (int l = 0; l < circuit->loops; l++) {
+    const logic_loop_t *loop = &circuit->loop_list[l];
+    logic_vm_loop_t *vm_loop = &program->loop_list[l];
+
+    vm_loop->iterations = loop->gates + 2;
+
+    for (int g = loop->first; g < loop->first + loop->gates; g++) {
+      vm_loop->nets += circuit->gate_list[g].width;
+    }
+
+    vm_loop->net_list = malloc(vm_loop->nets * sizeof(int));
+
+    if (vm_loop->net_list == NULL) {
+      return -1;
+    }
+
+    /* Every bit a cell of the loop drives */
+    for (int g = loop->first, n = 0; g < loop->first + loop->gates; g++) {
+      for (int b = 0; b < circuit->gate_list[g].width; b++) {
+        vm_loop->net_list[n++] = circuit->gate_list[g].output + b;
+      }
+    }
+  }
+
+  return 0;
+}
+
+logic_vm_program_t *logic_vm_compile(logic_circuit_t *circuit) {
+  if (circuit == NULL) {
+    return NULL;
+  }
+
+  logic_vm_program_t *program = calloc(1, sizeof(logic_vm_program_t));
+  int *not_source = malloc(circuit->nets * sizeof(int));
+
+  /* A HALT for the main program and one per loop body, plus the loops */
+  int capacity = 1 + 2 * circuit->loops;
+  int cell_fanins = 0;
+  int luts = 0;
+
+  for (int g = 0; g < circuit->gates; g++) {
+    int inputs = circuit->gate_list[g].inputs;
+
+    capacity += inputs > 1 ? inputs - 1 : 1;
+
+    if (circuit->gate_list[g].logic_block_type == LUT) {
+      luts += 1;
+    } else if (LOGIC_IS_CELL(circuit->gate_list[g].logic_block_type)) {
+      cell_fanins += inputs;
+    }
+  }
+
+  if (program != NULL) {
+    /* The array read on every run follows the circuit onto huge pages */
+    program->instruction_list = logic_numa_alloc(
+        capacity * sizeof(logic_vm_instruction_t), circuit->placement);
+    program->cell_list = calloc(circuit->cells + 1, sizeof(logic_gate_t));
+    program->cell_fanins = calloc(cell_fanins + 1, sizeof(int));
+    program->lut_list = calloc(luts + 1, sizeof(logic_vm_lut_t));
+    program->lut_op_list =
+        calloc((size_t)luts * LOGIC_LUT_OPS + 1, sizeof(logic_lut_op_t));
+  }
+
+  if (program == NULL || not_source == NULL ||
+      program->instruction_list == NULL || program->cell_list == NULL ||
+      program->cell_fanins == NULL || program->lut_list == NULL ||
+      program->lut_op_list == NULL ||
+      logic_vm_compile_loops(program, circuit) != 0) {
+    free(not_source);
+    logic_vm_free(program);
+    return NULL;
+  }
+
+  for (int n = 0; n < circuit->nets; n++) {
+    not_source[n] = -1;
+  }
+
+  int loop = 0;
+
+  for (int g = 0; g < circuit->gates; g++) {
+    if (loop < circuit->loops && circuit->loop_list[loop].first == g) {
+      logic_vm_emit(program, LOGIC_VM_LOOP, 0, loop, 0);
+      g += circuit->loop_list[loop].gates - 1;
+      loop += 1;
+      continue;
+    }
+
+    if (logic_vm_emit_gate(program, circuit, g, not_source) != 0) {
+      free(not_source);
+      logic_vm_free(program);
+      return NULL;
+    }
+  }
+
+  logic_vm_emit(program, LOGIC_VM_HALT, 0, 0, 0);
+
+  for (int l = 0; l < circuit->loops; l++) {
+    const logic_loop_t *circuit_loop = &circuit->loop_list[l];
+
+    for (int g = circuit_loop->first;
+         g < circuit_loop->first + circuit_loop->gates; g++) {
+      if (logic_vm_emit_gate(program, circuit, g, NULL) != 0) {
+        free(not_source);
+        logic_vm_free(program);
+        return NULL;
+      }
+    }
+
+    logic_vm_emit(program, LOGIC_VM_HALT, 0, 0, 0);
+  }
+
+  logic_vm_fuse(program);
+
+  /* Fusing moved the bodies, each one starts after the previous HALT */
+  loop = 0;
+
+  for (int i = 0; i < program->instructions && loop < program->loops; i++) {
+    if (program->instruction_list[i].opcode == LOGIC_VM_HALT) {
+      program->loop_list[loop++].body = i + 1;
+    }
+  }
+
+  free(not_source);
+
+  if (logic_vm_mark_last_writes(program, circuit->nets) != 0) {
+    logic_vm_free(program);
+    return NULL;
+  }
+
+  return program;
+}
+
+static int logic_vm_settle(const logic_vm_program_t *program, int loop,
+                           logic_word_t *values);
+
+/* Count the nets an executed instruction left behind as final values */
+static void logic_vm_count(const logic_vm_program_t *program,
+                           const logic_vm_instruction_t *ip,
+                           const logic_word_t *v,
+                           struct logic_activity *activity) {
+  switch (ip->opcode) {
+  case LOGIC_VM_LOOP: {
+    const logic_vm_loop_t *vm_loop = &program->loop_list[ip->a];
+
+    /* Only the settled values count, not the iterations */
+    for (int n = 0; n < vm_loop->nets; n++) {
+      logic_activity_count(activity, vm_loop->net_list[n],
+                           v[vm_loop->net_list[n]]);
+    }
+
+    return;
+  }
+  case LOGIC_VM_CELL: {
+    const logic_gate_t *cell = &program->cell_list[ip->a];
+
+    for (int b = 0; b < cell->width; b++) {
+      logic_activity_count(activity, cell->output + b, v[cell->output + b]);
+    }
+
+    return;
+  }
+  default: {
+    uint8_t last = program->last_writes[ip - program->instruction_list];
+
+    if (last & LOGIC_VM_LAST_DST) {
+      logic_activity_count(activity, ip->dst, v[ip->dst]);
+    }
+
+    if (last & LOGIC_VM_LAST_C) {
+      logic_activity_count(activity, ip->c, v[ip->c]);
+    }
+
+    return;
+  }
+  }
+}
+
+/* A NULL activity runs without counting, loop bodies never count */
+static int logic_vm_execute(const logic_vm_program_t *program, int start,
+                            logic_word_t *values,
+                            struct logic_activity *activity) {
+  const logic_vm_instruction_t *ip = &program->instruction_list[start];
+  logic_word_t *restrict v = values;
+  int oscillating = 0;
+
+#if LOGIC_VM_THREADED
+
+#define LOGIC_VM_OP(opcode) label_##opcode:
+#define LOGIC_VM_NEXT() goto *table[(++ip)->opcode]
+
+  static void *const dispatch[LOGIC_VM_OPCODES] = {
+      [LOGIC_VM_HALT] = &&label_LOGIC_VM_HALT,
+      [LOGIC_VM_LOOP] = &&label_LOGIC_VM_LOOP,
+      [LOGIC_VM_CELL] = &&label_LOGIC_VM_CELL,
+      [LOGIC_VM_LUT] = &&label_LOGIC_VM_LUT,
+      [LOGIC_VM_CONST0] = &&label_LOGIC_VM_CONST0,
+      [LOGIC_VM_CONST1] = &&label_LOGIC_VM_CONST1,
+      [LOGIC_VM_COPY] = &&label_LOGIC_VM_COPY,
+      [LOGIC_VM_NOT] = &&label_LOGIC_VM_NOT,
+      [LOGIC_VM_AND2] = &&label_LOGIC_VM_AND2,
+      [LOGIC_VM_OR2] = &&label_LOGIC_VM_OR2,
+      [LOGIC_VM_XOR2] = &&label_LOGIC_VM_XOR2,
+      [LOGIC_VM_ANDN] = &&label_LOGIC_VM_ANDN,
+      [LOGIC_VM_ORN] = &&label_LOGIC_VM_ORN,
+      [LOGIC_VM_XNOR2] = &&label_LOGIC_VM_XNOR2,
+      [LOGIC_VM_AND3] = &&label_LOGIC_VM_AND3,
+      [LOGIC_VM_OR3] = &&label_LOGIC_VM_OR3,
+      [LOGIC_VM_XOR3] = &&label_LOGIC_VM_XOR3,
+      [LOGIC_VM_AND2_NOT] = &&label_LOGIC_VM_AND2_NOT,
+      [LOGIC_VM_OR2_NOT] = &&label_LOGIC_VM_OR2_NOT,
+      [LOGIC_VM_XOR2_NOT] = &&label_LOGIC_VM_XOR2_NOT,
+  };
+
+  /* Counting detours every dispatch through the count of the previous op */
+  static void *const counted[LOGIC_VM_OPCODES] = {
+      [0 ... LOGIC_VM_OPCODES - 1] = &&label_count,
+  };
+
+  void *const *table = activity != NULL ? counted : dispatch;
+
+  goto *dispatch[ip->opcode];
+
+label_count:
+  logic_vm_count(program, ip - 1, v, activity);
+  goto *dispatch[ip->opcode];
+
+#else
+
+#define LOGIC_VM_OP(opcode) case opcode:
+#define LOGIC_VM_NEXT()                                                        \
+  if (activity != NULL) {                                                      \
+    logic_vm_count(program, ip, v, activity);                                  \
+  }                                                                            \
+  ip++;                                                                        \
+  goto dispatch
+
+dispatch:
+  switch (ip->opcode) {
+
+#endif
+
+  LOGIC_VM_OP(LOGIC_VM_HALT) { return oscillating; }
+
+  LOGIC_VM_OP(LOGIC_VM_LOOP) {
+    int status = logic_vm_settle(program, (int)ip->a, v);
+
+    if (status < 0) {
+      return -1;
+    }
+
+    oscillating += status;
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_CELL) {
+    const logic_gate_t *cell = &program->cell_list[ip->a];
+
+    logic_word_evaluate(cell, &program->cell_fanins[cell->fanin], v);
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_LUT) {
+    const logic_vm_lut_t *lut = &program->lut_list[ip->a];
+
+    v[ip->dst] = logic_lut_run(&program->lut_op_list[lut->first], lut->ops,
+                               lut->result, lut->inputs, lut->fanins, v);
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_CONST0) {
+    v[ip->dst] = 0;
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_CONST1) {
+    v[ip->dst] = ~(logic_word_t)0;
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_COPY) {
+    v[ip->dst] = v[ip->a];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_NOT) {
+    v[ip->dst] = ~v[ip->a];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_AND2) {
+    v[ip->dst] = v[ip->a] & v[ip->b];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_OR2) {
+    v[ip->dst] = v[ip->a] | v[ip->b];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_XOR2) {
+    v[ip->dst] = v[ip->a] ^ v[ip->b];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_ANDN) {
+    v[ip->dst] = v[ip->a] & ~v[ip->b];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_ORN) {
+    v[ip->dst] = v[ip->a] | ~v[ip->b];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_XNOR2) {
+    v[ip->dst] = v[ip->a] ^ ~v[ip->b];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_AND3) {
+    v[ip->dst] = v[ip->a] & v[ip->b] & v[ip->c];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_OR3) {
+    v[ip->dst] = v[ip->a] | v[ip->b] | v[ip->c];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_XOR3) {
+    v[ip->dst] = v[ip->a] ^ v[ip->b] ^ v[ip->c];
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_AND2_NOT) {
+    logic_word_t word = v[ip->a] & v[ip->b];
+
+    v[ip->dst] = word;
+    v[ip->c] = ~word;
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_OR2_NOT) {
+    logic_word_t word = v[ip->a] | v[ip->b];
+
+    v[ip->dst] = word;
+    v[ip->c] = ~word;
+    LOGIC_VM_NEXT();
+  }
+
+  LOGIC_VM_OP(LOGIC_VM_XOR2_NOT) {
+    logic_word_t word = v[ip->a] ^ v[ip->b];
+
+    v[ip->dst] = word;
+    v[ip->c] = ~word;
+    LOGIC_VM_NEXT();
+  }
+
+#if !LOGIC_VM_THREADED
+  }
+
+  return -1;
+#endif
+
+#undef LOGIC_VM_OP
+#undef LOGIC_VM_NEXT
+}
+
+/* Iterate a loop body until no lane changes, 1 when the bound is reached */
+static int logic_vm_settle(const logic_vm_program_t *program, int loop,
+                           logic_word_t *values) {
+  const logic_vm_loop_t *vm_loop = &program->loop_list[loop];
+  logic_word_t local[LOGIC_VM_LOOP_NETS];
+  logic_word_t *previous = local;
+
+  if (vm_loop->nets > LOGIC_VM_LOOP_NETS) {
+    previous = malloc(vm_loop->nets * sizeof(logic_word_t));
+
+    if (previous == NULL) {
+      return -1;
+    }
+  }
+
+  logic_word_t changed = 0;
+  int status = 0;
+
+  for (int i = 0; i < vm_loop->iterations; i++) {
+    for (int n = 0; n < vm_loop->nets; n++) {
+      previous[n] = values[vm_loop->net_list[n]];
+    }
+
+    status = logic_vm_execute(program, vm_loop->body, values, NULL);
+
+    if (status < 0) {
+      break;
+    }
+
+    changed = 0;
+
+    for (int n = 0; n < vm_loop->nets; n++) {
+      changed |= previous[n] ^ values[vm_loop->net_list[n]];
+    }
+
+    if (changed == 0) {
+      break;
+    }
+  }
+
+  if (previous != local) {
+    free(previous);
+  }
+
+  return status < 0 ? -1 : changed != 0;
+}
+
+/* Memories take the writes of a run once every loop has settled */
+static int logic_vm_commit(const logic_vm_program_t *program) {
+  int status = 0;
+
+  for (int c = 0; c < program->cells; c++) {
+    if (program->cell_list[c].logic_block_type == MEM_WRITE &&
+        logic_memory_commit(program->cell_list[c].memory) != 0) {
+      status = -1;
+    }
+  }
+
+  return status;
+}
+
+int logic_vm_run(const logic_vm_program_t *program, logic_word_t *values) {
+  if (program == NULL || values == NULL) {
+    return -1;
+  }
+
+  int oscillating = logic_vm_execute(program, 0, values, NULL);
+
+  if (oscillating < 0 || logic_vm_commit(program) != 0) {
+    return -1;
+  }
+
+  return oscillating;
+}
+
+int logic_vm_run_activity(const logic_vm_program_t *program,
+                          logic_word_t *values,
+                          struct logic_activity *activity) {
+  if (program == NULL || values == NULL || activity == NULL) {
+    return -1;
+  }
+
+  int oscillating = logic_vm_execute(program, 0, values, activity);
+
+  if (oscillating < 0 || logic_vm_commit(program) != 0) {
+    return -1;
+  }
+
+  return oscillating;
+}
+
+void logic_vm_free(logic_vm_program_t *program) {
+  if (program == NULL) {
+    return;
+  }
+
+  for (int l = 0; l < program->loops && program->loop_list != NULL; l++) {
+    free(program->loop_list[l].net_list);
+  }
+
+  logic_numa_free(program->instruction_list);
+  free(program->cell_list);
+  free(program->cell_fanins);
+  free(program->lut_list);
+  free(program->lut_op_list);
+  free(program->last_writes);
+  free(program->loop_list);
+  free(program);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
@@ -0,0 +1,269 @@
+/**
+ * @file logsimword.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Word level cells on multi-bit buses.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimlib.h"
+#include "../include/logsimlut.h"
+#include "../include/logsimmemory.h"
+#include "../include/logsimword.h"
+#include "../include/utils.h"
+
+/*************** Function Definitions ***************/
+
+logic_block_t *logic_create_word_cell(logic_sim_t *sim,
+                                      logic_block_type_t logic_block_type,
+                                      int width, int operand, const char *name,
+                                      const char *prefix) {
+  if (sim == NULL || width < 1 || operand < 0) {
+    return NULL;
+  }
+
+  int inputs = 0;
+  int outputs = width;
+
+  switch (logic_block_type) {
+  case ADD:
+  case SUB: {
+    inputs = 2 * width;
+    break;
+  }
+  case MUX: {
+    inputs = 1 + 2 * width;
+    break;
+  }
+  case EQ:
+  case LT: {
+    inputs = 2 * width;
+    outputs = 1;
+    break;
+  }
+  case SHL:
+  case SHR: {
+    inputs = width + operand;
+    break;
+  }
+  case CONCAT: {
+    inputs = width;
+    break;
+  }
+  case SLICE: {
+    inputs = operand + width;
+    break;
+  }
+  default: {
+    LOG_SIM_DEBUG_PRINT(stderr, "Block type (%d) is not a word level cell.",
+                        logic_block_type);
+    return NULL;
+  }
+  }
+
+  logic_block_t *logic_block = logic_create_logic_block(
+      sim, logic_block_type, inputs, outputs, name, prefix);
+
+  if (logic_block == NULL) {
+    return NULL;
+  }
+
+  logic_block->width = outputs;
+  logic_block->parameter = operand;
+
+  return logic_block;
+}
+
+int logic_block_bus_connect(logic_block_t *logic_block,
+                            logic_block_t *logic_block_in, int first_bit,
+                            int bits) {
+  if (logic_block == NULL || logic_block_in == NULL || first_bit < 0 ||
+      bits < 0) {
+    return -1;
+  }
+
+  if (first_bit + bits > logic_block_in->width) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Block (%s) drives (%d) bits.",
+                        logic_block_in->path, logic_block_in->width);
+    return -1;
+  }
+
+  if (logic_block->current_input + bits > logic_block->inputs) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Block (%s) has (%d) inputs connected.",
+                        logic_block->path, logic_block->inputs);
+    return -1;
+  }
+
+  for (int i = 0; i < bits; i++) {
+    /* Streams left connected behind a disconnected one are skipped */
+    if (logic_block->current_input >= logic_block->inputs) {
+      return -1;
+    }
+
+    logic_top_block_t *logic_top_block =
+        logic_block->input_streams[logic_block->current_input];
+
+    logic_top_block->logic_top_block_type = LOGIC_BLOCK;
+    logic_top_block->logic_block = logic_block_in;
+    logic_top_block->bit = first_bit + i;
+
+    logic_block_input_connected(logic_block);
+  }
+
+  return 0;
+}
+
+int logic_block_data_bus_connect(logic_block_t *logic_block, int bits,
+                                 logic_data_t **logic_data_list) {
+  if (logic_block == NULL || logic_data_list == NULL ||
+      logic_block->current_input + bits > logic_block->inputs) {
+    return -1;
+  }
+
+  for (int i = 0; i < bits; i++) {
+    if (logic_block_data_connect(logic_block, logic_data_list[i]) != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+void logic_word_evaluate(const logic_gate_t *gate, const int *fanins,
+                         logic_word_t *values) {
+  const logic_word_t *v = values;
+  logic_word_t *out = &values[gate->output];
+  int width = gate->width;
+
+  switch (gate->logic_block_type) {
+  case ADD:
+  case SUB: {
+    /* Ripple carry, subtraction adds the inverse of B plus one */
+    logic_word_t invert = gate->logic_block_type == SUB ? ~(logic_word_t)0 : 0;
+    logic_word_t carry = invert;
+
+    for (int i = 0; i < width; i++) {
+      logic_word_t a = v[fanins[i]];
+      logic_word_t b = v[fanins[width + i]] ^ invert;
+
+      out[i] = a ^ b ^ carry;
+      carry = (a & b) | (carry & (a ^ b));
+    }
+
+    break;
+  }
+  case MUX: {
+    logic_word_t select = v[fanins[0]];
+
+    for (int i = 0; i < width; i++) {
+      out[i] =
+          (v[fanins[1 + i]] & ~select) | (v[fanins[1 + width + i]] & select);
+    }
+
+    break;
+  }
+  case EQ:
+  case LT: {
+    int bits = gate->inputs / 2;
+    logic_word_t differ = 0;
+    logic_word_t less = 0;
+
+    /* From the least significant bit, a higher differing bit decides */
+    for (int i = 0; i < bits; i++) {
+      logic_word_t a = v[fanins[i]];
+      logic_word_t b = v[fanins[bits + i]];
+
+      differ |= a ^ b;
+      less = (~a & b) | (~(a ^ b) & less);
+    }
+
+    out[0] = gate->logic_block_type == EQ ? ~differ : less;
+    break;
+  }
+  case SHL:
+  case SHR: {
+    for (int i = 0; i < width; i++) {
+      out[i] = v[fanins[i]];
+    }
+
+    /* Barrel shifter, amount bit k shifts the lanes it is set in by 2^k */
+    for (int k = 0; k < gate->inputs - width; k++) {
+      logic_word_t select = v[fanins[width + k]];
+
+      if (k >= 30 || (1 << k) >= width) {
+        for (int i = 0; i < width; i++) {
+          out[i] &= ~select;
+        }
+
+        continue;
+      }
+
+      int shift = 1 << k;
+
+      if (gate->logic_block_type == SHL) {
+        for (int i = width - 1; i >= 0; i--) {
+          logic_word_t from = i >= shift ? out[i - shift] : 0;
+
+          out[i] = (out[i] & ~select) | (from & select);
+        }
+      } else {
+        for (int i = 0; i < width; i++) {
+          logic_word_t from = i + shift < width ? out[i + shift] : 0;
+
+          out[i] = (out[i] & ~select) | (from & select);
+        }
+      }
+    }
+
+    break;
+  }
+  case CONCAT: {
+    for (int i = 0; i < width; i++) {
+      out[i] = v[fanins[i]];
+    }
+
+    break;
+  }
+  case SLICE: {
+    for (int i = 0; i < width; i++) {
+      out[i] = v[fanins[gate->parameter + i]];
+    }
+
+    break;
+  }
+  case MEM_READ:
+  case MEM_WRITE: {
+    logic_memory_evaluate(gate, fanins, values);
+    break;
+  }
+  case LUT: {
+    out[0] = logic_lut_evaluate(gate->truth_table, gate->inputs, fanins, v);
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+}
+
+uint64_t logic_word_read(const logic_word_t *values, int first_net, int bits,
+                         int lane) {
+  uint64_t value = 0;
+
+  for (int b = 0; b < bits && b < 64; b++) {
+    value |= ((values[first_net + b] >> lane) & 1) << b;
+  }
+
+  return value;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
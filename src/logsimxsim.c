@@ -0,0 +1,330 @@
+/**
+ * @file logsimxsim.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Four valued (0/1/X/Z) simulation over two bit-planes per net.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdlib.h>
+
+/*************** C Custom Headers ***************/
+
+#include "../include/logsimcircuit.h"
+#include "../include/logsimxsim.h"
+#include "../include/utils.h"
+
+/*************** Macros ***************/
+
+#define LOGIC_XWORD_0 ((logic_xword_t){~(logic_word_t)0, 0})
+#define LOGIC_XWORD_1 ((logic_xword_t){0, ~(logic_word_t)0})
+#define LOGIC_XWORD_X ((logic_xword_t){~(logic_word_t)0, ~(logic_word_t)0})
+
+/*************** Function Definitions ***************/
+
+static logic_xword_t logic_xsim_broadcast(int value) {
+  switch (value) {
+  case LOGIC_VALUE_0:
+    return LOGIC_XWORD_0;
+  case LOGIC_VALUE_X:
+    return LOGIC_XWORD_X;
+  case LOGIC_VALUE_Z:
+    return (logic_xword_t){0, 0};
+  }
+
+  return LOGIC_XWORD_1;
+}
+
+/* A gate input left floating reads X */
+static logic_xword_t logic_xsim_fanin(const logic_xword_t *values, int net) {
+  logic_xword_t a = values[net];
+  logic_word_t z = ~(a.zero | a.one);
+
+  return (logic_xword_t){a.zero | z, a.one | z};
+}
+
+logic_xsim_t *logic_xsim_create(logic_circuit_t *circuit) {
+  if (circuit == NULL) {
+    return NULL;
+  }
+
+  /* X propagation is per bit, cells are only evaluated on 0/1 buses */
+  if (circuit->cells > 0) {
+    LOG_SIM_DEBUG_PRINT(stderr, "Circuits with word level cells are not "
+                                "simulated with X propagation.");
+    return NULL;
+  }
+
+  logic_xsim_t *xsim = calloc(1, sizeof(logic_xsim_t));
+
+  if (xsim == NULL) {
+    return NULL;
+  }
+
+  xsim->circuit = circuit;
+  xsim->values = malloc(circuit->nets * sizeof(logic_xword_t));
+
+  if (xsim->values == NULL) {
+    free(xsim);
+    return NULL;
+  }
+
+  /* Nothing is known about a gate before it is evaluated */
+  for (int n = 0; n < circuit->nets; n++) {
+    xsim->values[n] = LOGIC_XWORD_X;
+  }
+
+  /* Loops hold state, they start from the last evaluated value */
+  for (int l = 0; l < circuit->loops; l++) {
+    const logic_loop_t *loop = &circuit->loop_list[l];
+
+    for (int g = loop->first; g < loop->first + loop->gates; g++) {
+      logic_block_t *logic_block =
+          circuit->block_list[circuit->gate_list[g].block];
+      logic_data_t *logic_data =
+          logic_block->outputs > 0 ? logic_block->output_streams[0]->logic_data
+                                   : NULL;
+
+      if (logic_data != NULL && logic_data->status == EVALUATED) {
+        xsim->values[circuit->gate_list[g].output] =
+            logic_xsim_broadcast(logic_data->data);
+      }
+    }
+  }
+
+  logic_xsim_load_inputs(xsim);
+
+  return xsim;
+}
+
+int logic_xsim_load_inputs(logic_xsim_t *xsim) {
+  if (xsim == NULL) {
+    return -1;
+  }
+
+  logic_circuit_t *circuit = xsim->circuit;
+
+  xsim->values[LOGIC_NET_CONST0] = LOGIC_XWORD_0;
+  xsim->values[LOGIC_NET_CONST1] = LOGIC_XWORD_1;
+
+  for (int i = 0; i < circuit->primary_inputs; i++) {
+    xsim->values[LOGIC_INPUT_NET(i)] =
+        logic_xsim_broadcast(circuit->input_list[i]->data);
+  }
+
+  return 0;
+}
+
+int logic_xsim_set_input(logic_xsim_t *xsim, int input, logic_xword_t xword) {
+  if (xsim == NULL || input < 0 || input >= xsim->circuit->primary_inputs) {
+    return -1;
+  }
+
+  xsim->values[LOGIC_INPUT_NET(input)] = xword;
+
+  return 0;
+}
+
+static logic_xword_t logic_xsim_evaluate(const logic_xsim_t *xsim, int g) {
+  const logic_gate_t *gate = &xsim->circuit->gate_list[g];
+  const int *fanins = &xsim->circuit->fanins[gate->fanin];
+  const logic_xword_t *values = xsim->values;
+  logic_xword_t word = LOGIC_XWORD_0;
+
+  switch (gate->logic_block_type) {
+  case AND: {
+    word = gate->floating > 0 ? LOGIC_XWORD_X : LOGIC_XWORD_1;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      logic_xword_t a = logic_xsim_fanin(values, fanins[j]);
+
+      word.zero |= a.zero;
+      word.one &= a.one;
+    }
+
+    break;
+  }
+  case OR: {
+    word = gate->floating > 0 ? LOGIC_XWORD_X : LOGIC_XWORD_0;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      logic_xword_t a = logic_xsim_fanin(values, fanins[j]);
+
+      word.zero &= a.zero;
+      word.one |= a.one;
+    }
+
+    break;
+  }
+  case XOR: {
+    word = gate->floating > 0 ? LOGIC_XWORD_X : LOGIC_XWORD_0;
+
+    for (int j = 0; j < gate->inputs; j++) {
+      logic_xword_t a = logic_xsim_fanin(values, fanins[j]);
+      logic_word_t zero = (word.zero & a.zero) | (word.one & a.one);
+      logic_word_t one = (word.zero & a.one) | (word.one & a.zero);
+
+      word.zero = zero;
+      word.one = one;
+    }
+
+    break;
+  }
+  case NOT: {
+    if (gate->inputs > 0) {
+      logic_xword_t a = logic_xsim_fanin(values, fanins[gate->inputs - 1]);
+
+      word = (logic_xword_t){a.one, a.zero};
+    } else {
+      word = gate->floating > 0 ? LOGIC_XWORD_X : LOGIC_XWORD_1;
+    }
+
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+
+  return word;
+}
+
+/* Gauss-Seidel over the loop gates, lanes still changing at the bound read X */
+static void logic_xsim_settle(logic_xsim_t *xsim, const logic_loop_t *loop) {
+  const logic_circuit_t *circuit = xsim->circuit;
+  logic_word_t changed = 0;
+
+  for (int i = 0; i < loop->gates + 2; i++) {
+    changed = 0;
+
+    for (int g = loop->first; g < loop->first + loop->gates; g++) {
+      int out = circuit->gate_list[g].output;
+      logic_xword_t word = logic_xsim_evaluate(xsim, g);
+
+      changed |= (word.zero ^ xsim->values[out].zero) |
+                 (word.one ^ xsim->values[out].one);
+      xsim->values[out] = word;
+    }
+
+    if (changed == 0) {
+      return;
+    }
+  }
+
+  for (int g = loop->first; g < loop->first + loop->gates; g++) {
+    int out = circuit->gate_list[g].output;
+
+    xsim->values[out].zero |= changed;
+    xsim->values[out].one |= changed;
+  }
+}
+
+int logic_xsim_run(logic_xsim_t *xsim) {
+  if (xsim == NULL) {
+    return -1;
+  }
+
+  const logic_circuit_t *circuit = xsim->circuit;
+  int loop = 0;
+
+  for (int g = 0; g < circuit->gates; g++) {
+    if (loop < circuit->loops && circuit->loop_list[loop].first == g) {
+      logic_xsim_settle(xsim, &circuit->loop_list[loop]);
+      g += circuit->loop_list[loop].gates - 1;
+      loop += 1;
+      continue;
+    }
+
+    xsim->values[circuit->gate_list[g].output] = logic_xsim_evaluate(xsim, g);
+  }
+
+  return 0;
+}
+
+int logic_xsim_value(const logic_xsim_t *xsim, int net, int lane) {
+  if (xsim == NULL || net < 0 || net >= xsim->circuit->nets || lane < 0 ||
+      lane >= LOGIC_LANES) {
+    return -1;
+  }
+
+  int zero = (int)((xsim->values[net].zero >> lane) & 1);
+  int one = (int)((xsim->values[net].one >> lane) & 1);
+
+  if (zero && one) {
+    return LOGIC_VALUE_X;
+  }
+
+  if (!zero && !one) {
+    return LOGIC_VALUE_Z;
+  }
+
+  return one ? LOGIC_VALUE_1 : LOGIC_VALUE_0;
+}
+
+int logic_xsim_write_back(logic_xsim_t *xsim, int lane) {
+  if (xsim == NULL || lane < 0 || lane >= LOGIC_LANES) {
+    return -1;
+  }
+
+  logic_circuit_t *circuit = xsim->circuit;
+  util_map_t driven;
+
+  if (util_map_init(&driven, 64) != 0) {
+    return -1;
+  }
+
+  for (int b = 0; b < circuit->blocks; b++) {
+    logic_block_t *logic_block = circuit->block_list[b];
+
+    if (circuit->block_nets[b] < 0) {
+      continue;
+    }
+
+    int data = logic_xsim_value(xsim, circuit->block_nets[b], lane);
+
+    for (int i = 0; i < logic_block->outputs; i++) {
+      logic_top_block_t *logic_top_block = logic_block->output_streams[i];
+      logic_data_t *logic_data = logic_top_block->logic_data;
+
+      if (logic_top_block->logic_top_block_type != DATA_BLOCK ||
+          logic_data == NULL) {
+        continue;
+      }
+
+      int previous = util_map_get(&driven, logic_data);
+
+      /* Two drivers disagreeing on one data block */
+      if (previous != -1 && previous != data) {
+        data = LOGIC_VALUE_X;
+      }
+
+      if (util_map_put(&driven, logic_data, data) != 0) {
+        util_map_free(&driven);
+        return -1;
+      }
+
+      logic_data->data = data;
+      logic_data->status = EVALUATED;
+    }
+  }
+
+  util_map_free(&driven);
+
+  return 0;
+}
+
+void logic_xsim_free(logic_xsim_t *xsim) {
+  if (xsim == NULL) {
+    return;
+  }
+
+  free(xsim->values);
+  free(xsim);
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
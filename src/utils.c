@@ -7,60 +7,349 @@
  *
  */
 
+/*************** C Standard Headers ***************/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
 /*************** C Custom Headers ***************/
 
 #include "../include/utils.h"
 #include "../include/logsimtypes.h"
 
-/*************** Function Definitions ***************/
+/*************** Variables ***************/
 
-Agnode_t *util_create_edge(char *label, logic_block_type_t type) {
-  Agnode_t *node = agnode(g_graphviz_graph, label, true);
+static const char *const util_block_type_names[LOGIC_BLOCK_TYPES] = {
+    [AND] = "AND", [OR] = "OR",   [NOT] = "NOT", [XOR] = "XOR",
+    [ADD] = "ADD", [SUB] = "SUB", [MUX] = "MUX", [EQ] = "EQ",
+    [LT] = "LT",   [SHL] = "SHL", [SHR] = "SHR", [CONCAT] = "CONCAT",
+    [SLICE] = "SLICE", [MEM_READ] = "READ", [MEM_WRITE] = "WRITE",
+    [LUT] = "LUT"};
 
-  switch (type) {
-  case AND: {
-    agset(node, "label", "AND");
-    break;
-  }
-  case OR: {
-    agset(node, "label", "OR");
-    break;
-  }
-  case XOR: {
-    agset(node, "label", "XOR");
-    break;
-  }
-  case NOT: {
-    agset(node, "label", "NOT");
-    break;
-  }
+/*************** Function Definitions ***************/
+
+const char *util_block_type_name(logic_block_type_t type) {
+  if ((int)type < 0 || type >= LOGIC_BLOCK_TYPES) {
+    return "?";
   }
 
+  return util_block_type_names[type];
+}
+
+Agnode_t *util_create_edge(Agraph_t *graph, const char *label,
+                           logic_block_type_t type) {
+  /* cgraph keys nodes by name and does not keep the pointer */
+  Agnode_t *node = agnode(graph, (char *)label, true);
+
+  agset(node, "label", (char *)util_block_type_name(type));
+
   agset(node, "shape", "rectangle");
 
   return node;
 }
 
-int util_attach_invisible_edge(char *label, int block_index, Agnode_t *node,
+int util_attach_invisible_edge(Agraph_t *graph, const char *label,
+                               int block_index, Agnode_t *node,
                                bool reverse) {
   char data_node_name[1024];
 
   snprintf(data_node_name, sizeof(data_node_name), "%s_%d", label, block_index);
 
-  Agnode_t *invisible_input_node = agnode(g_graphviz_graph, data_node_name, 1);
+  Agnode_t *invisible_input_node = agnode(graph, data_node_name, 1);
 
   agsafeset(invisible_input_node, "style", "invis", "");
 
   if (reverse == true) {
-    agedge(g_graphviz_graph, node, invisible_input_node, NULL, 1);
+    agedge(graph, node, invisible_input_node, NULL, 1);
     return 0;
   }
 
-  agedge(g_graphviz_graph, invisible_input_node, node, NULL, 1);
+  agedge(graph, invisible_input_node, node, NULL, 1);
+
+  return 0;
+}
+
+/**************************************/
+
+static size_t util_map_slot(const util_map_t *map, const void *key) {
+  /* Fibonacci hashing spreads the aligned pointer bits over the table */
+  uint64_t hash = (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ull;
+
+  return (size_t)(hash >> 32) & (map->capacity - 1);
+}
+
+int util_map_init(util_map_t *map, size_t capacity) {
+  size_t slots = 16;
+
+  /* Keep the load factor under one half */
+  while (slots < capacity * 2) {
+    slots <<= 1;
+  }
+
+  map->capacity = slots;
+  map->size = 0;
+  map->keys = calloc(slots, sizeof(void *));
+  map->values = calloc(slots, sizeof(int));
+
+  if (map->keys == NULL || map->values == NULL) {
+    util_map_free(map);
+    return -1;
+  }
+
+  return 0;
+}
+
+int util_map_get(util_map_t *map, const void *key) {
+  size_t slot = util_map_slot(map, key);
+
+  while (map->keys[slot] != NULL) {
+    if (map->keys[slot] == key) {
+      return map->values[slot];
+    }
+
+    slot = (slot + 1) & (map->capacity - 1);
+  }
+
+  return -1;
+}
+
+int util_map_put(util_map_t *map, const void *key, int value) {
+  if ((map->size + 1) * 2 > map->capacity) {
+    util_map_t grown;
+
+    if (util_map_init(&grown, map->capacity) != 0) {
+      return -1;
+    }
+
+    for (size_t i = 0; i < map->capacity; i++) {
+      if (map->keys[i] != NULL) {
+        util_map_put(&grown, map->keys[i], map->values[i]);
+      }
+    }
+
+    util_map_free(map);
+    *map = grown;
+  }
+
+  size_t slot = util_map_slot(map, key);
+
+  while (map->keys[slot] != NULL && map->keys[slot] != key) {
+    slot = (slot + 1) & (map->capacity - 1);
+  }
+
+  if (map->keys[slot] == NULL) {
+    map->keys[slot] = key;
+    map->size += 1;
+  }
+
+  map->values[slot] = value;
 
   return 0;
 }
 
+void util_map_free(util_map_t *map) {
+  free(map->keys);
+  free(map->values);
+
+  map->keys = NULL;
+  map->values = NULL;
+  map->capacity = 0;
+  map->size = 0;
+}
+
+/**************************************/
+
+#define UTIL_ARENA_CHUNK (64 * 1024)
+
+void *util_arena_alloc(util_arena_t *arena, size_t size) {
+  /* Word aligned, so structures may be placed in the arena as well */
+  size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+  util_arena_chunk_t *chunk = arena->chunks;
+
+  if (chunk == NULL || chunk->size - chunk->used < size) {
+    size_t chunk_size = size > UTIL_ARENA_CHUNK ? size : UTIL_ARENA_CHUNK;
+
+    chunk = malloc(sizeof(util_arena_chunk_t) + chunk_size);
+
+    if (chunk == NULL) {
+      return NULL;
+    }
+
+    chunk->next = arena->chunks;
+    chunk->used = 0;
+    chunk->size = chunk_size;
+
+    arena->chunks = chunk;
+  }
+
+  void *memory = chunk->data + chunk->used;
+
+  chunk->used += size;
+
+  return memory;
+}
+
+void util_arena_free(util_arena_t *arena) {
+  while (arena->chunks != NULL) {
+    util_arena_chunk_t *next = arena->chunks->next;
+
+    free(arena->chunks);
+    arena->chunks = next;
+  }
+}
+
+/**************************************/
+
+static uint64_t util_string_hash(const char *string) {
+  /* FNV-1a */
+  uint64_t hash = 0xCBF29CE484222325ull;
+
+  for (; *string != '\0'; string++) {
+    hash = (hash ^ (unsigned char)*string) * 0x100000001B3ull;
+  }
+
+  return hash;
+}
+
+static int util_interner_grow(util_interner_t *interner, size_t capacity) {
+  int *slots = calloc(capacity, sizeof(int));
+
+  if (slots == NULL) {
+    return -1;
+  }
+
+  /* Rehash from the stored hashes, the strings are not read again */
+  for (int id = 0; id < interner->strings; id++) {
+    size_t slot = (size_t)(interner->hash_list[id] >> 32) & (capacity - 1);
+
+    while (slots[slot] != 0) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+
+    slots[slot] = id + 1;
+  }
+
+  free(interner->slots);
+
+  interner->slots = slots;
+  interner->capacity = capacity;
+
+  return 0;
+}
+
+int util_interner_init(util_interner_t *interner, size_t capacity) {
+  size_t slots = 16;
+
+  while (slots < capacity * 2) {
+    slots <<= 1;
+  }
+
+  memset(interner, 0, sizeof(util_interner_t));
+
+  return util_interner_grow(interner, slots);
+}
+
+static int util_interner_lookup(const util_interner_t *interner,
+                                const char *string, uint64_t hash,
+                                size_t *slot) {
+  *slot = (size_t)(hash >> 32) & (interner->capacity - 1);
+
+  while (interner->slots[*slot] != 0) {
+    int id = interner->slots[*slot] - 1;
+
+    if (interner->hash_list[id] == hash &&
+        strcmp(interner->string_list[id], string) == 0) {
+      return id;
+    }
+
+    *slot = (*slot + 1) & (interner->capacity - 1);
+  }
+
+  return -1;
+}
+
+int util_intern(util_interner_t *interner, const char *string) {
+  uint64_t hash = util_string_hash(string);
+  size_t slot;
+  int id = util_interner_lookup(interner, string, hash, &slot);
+
+  if (id != -1) {
+    return id;
+  }
+
+  if (interner->strings == interner->string_capacity) {
+    int capacity =
+        interner->string_capacity > 0 ? interner->string_capacity * 2 : 64;
+    const char **string_list =
+        realloc(interner->string_list, capacity * sizeof(char *));
+    uint64_t *hash_list =
+        realloc(interner->hash_list, capacity * sizeof(uint64_t));
+
+    interner->string_list =
+        string_list != NULL ? string_list : interner->string_list;
+    interner->hash_list = hash_list != NULL ? hash_list : interner->hash_list;
+
+    if (string_list == NULL || hash_list == NULL) {
+      return -1;
+    }
+
+    interner->string_capacity = capacity;
+  }
+
+  size_t length = strlen(string) + 1;
+  char *copy = util_arena_alloc(&interner->arena, length);
+
+  if (copy == NULL) {
+    return -1;
+  }
+
+  memcpy(copy, string, length);
+
+  id = interner->strings;
+
+  interner->string_list[id] = copy;
+  interner->hash_list[id] = hash;
+  interner->strings += 1;
+  interner->slots[slot] = id + 1;
+
+  /* Keep the load factor under one half */
+  if ((size_t)interner->strings * 2 > interner->capacity &&
+      util_interner_grow(interner, interner->capacity * 2) != 0) {
+    interner->slots[slot] = 0;
+    interner->strings -= 1;
+    return -1;
+  }
+
+  return id;
+}
+
+int util_interner_find(const util_interner_t *interner, const char *string) {
+  size_t slot;
+
+  return util_interner_lookup(interner, string, util_string_hash(string),
+                              &slot);
+}
+
+const char *util_interner_string(const util_interner_t *interner, int id) {
+  if (id < 0 || id >= interner->strings) {
+    return NULL;
+  }
+
+  return interner->string_list[id];
+}
+
+void util_interner_free(util_interner_t *interner) {
+  util_arena_free(&interner->arena);
+
+  free(interner->slots);
+  free(interner->string_list);
+  free(interner->hash_list);
+
+  memset(interner, 0, sizeof(util_interner_t));
+}
+
 /************************************************/
 /*                EOF                           */
 /************************************************/
@@ -0,0 +1,296 @@
+/**
+ * @file test_eco.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Test of edits evaluated in place against a fresh compile and run.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimcircuit.h"
+#include "logsimeco.h"
+#include "logsimlib.h"
+#include "logsimmemory.h"
+#include "logsimvm.h"
+#include "logsimword.h"
+
+/*************** Macros ***************/
+
+#define TEST_SEEDS 8
+#define TEST_EDITS 20
+#define TEST_INPUTS 8
+#define TEST_GATES 120
+#define TEST_OUTPUTS 4
+#define TEST_BLOCKS (TEST_INPUTS + TEST_GATES + 2 * TEST_EDITS)
+
+#define TEST_WIDTH 8
+#define TEST_ADDRESS_BITS 4
+
+/*************** Structures ***************/
+
+/*
+ * Sources keep a rank, a block only reads lower ranks so no edit closes a
+ * loop. Inputs added by the edits rank below everything.
+ */
+typedef struct {
+  logic_data_t *data;
+  logic_block_t *block;
+  double rank;
+} test_source_t;
+
+/*************** Variables ***************/
+
+static uint64_t state;
+
+/*************** Function Definitions ***************/
+
+static uint64_t next_random() {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+
+  return state;
+}
+
+/* Any source ranked below rank */
+static int pick_below(const test_source_t *source_list, int sources,
+                      double rank) {
+  int picked;
+
+  do {
+    picked = (int)(next_random() % sources);
+  } while (source_list[picked].rank >= rank);
+
+  return picked;
+}
+
+static void connect_source(logic_block_t *logic_block,
+                           const test_source_t *source) {
+  if (source->block != NULL) {
+    logic_block_block_connect(logic_block, source->block);
+  } else {
+    logic_block_data_connect(logic_block, source->data);
+  }
+}
+
+static logic_word_t input_word(const test_source_t *source_list, int sources,
+                               const logic_data_t *data) {
+  for (int s = 0; s < sources; s++) {
+    if (source_list[s].data == data) {
+      return (logic_word_t)(s + 1) * 0x9E3779B97F4A7C15ull;
+    }
+  }
+
+  return 0;
+}
+
+static void set_inputs(logic_circuit_t *circuit, int first,
+                       const test_source_t *source_list, int sources) {
+  for (int i = first; i < circuit->primary_inputs; i++) {
+    logic_circuit_set_input(
+        circuit, i, input_word(source_list, sources, circuit->input_list[i]));
+  }
+}
+
+static int test_seed(int seed) {
+  logic_sim_t *sim = logic_sim_create();
+  test_source_t source_list[TEST_BLOCKS];
+  logic_block_t *output_list[TEST_OUTPUTS];
+  int sources = 0;
+  int failures = 0;
+
+  state = (uint64_t)seed * 0x9E3779B97F4A7C15ull + 1;
+
+  for (int i = 0; i < TEST_INPUTS; i++, sources++) {
+    source_list[sources].data = logic_create_data_block(sim, INPUT, 0);
+    source_list[sources].block = NULL;
+    source_list[sources].rank = sources;
+  }
+
+  for (int g = 0; g < TEST_GATES; g++, sources++) {
+    logic_block_type_t type = (logic_block_type_t)(next_random() % 4);
+    int inputs = type == NOT ? 1 : 2 + (int)(next_random() % 2);
+    logic_block_t *gate =
+        logic_create_logic_block(sim, type, inputs, 1, NULL, NULL);
+
+    for (int j = 0; j < inputs; j++) {
+      connect_source(gate, &source_list[pick_below(source_list, sources,
+                                                   sources)]);
+    }
+
+    source_list[sources].data = NULL;
+    source_list[sources].block = gate;
+    source_list[sources].rank = sources;
+  }
+
+  for (int o = 0; o < TEST_OUTPUTS; o++) {
+    output_list[o] = source_list[sources - 1 - o * 7].block;
+  }
+
+  logic_circuit_t *circuit = logic_circuit_compile(TEST_OUTPUTS, output_list);
+  logic_vm_program_t *program = logic_vm_compile(circuit);
+
+  set_inputs(circuit, 0, source_list, sources);
+  logic_vm_run(program, circuit->values);
+  logic_vm_free(program);
+
+  for (int e = 0; e < TEST_EDITS; e++) {
+    int target;
+
+    do {
+      target = (int)(next_random() % sources);
+    } while (source_list[target].block == NULL);
+
+    logic_block_t *reader = source_list[target].block;
+    int input = (int)(next_random() % reader->inputs);
+    double rank = source_list[target].rank;
+
+    logic_block_disconnect(reader, input);
+
+    if (next_random() % 2 == 0) {
+      /* Rewire the input to another source ranked below the reader */
+      connect_source(reader, &source_list[pick_below(source_list, sources,
+                                                     rank)]);
+    } else {
+      /* Insert a gate reading a new input in front of the reader */
+      int below = pick_below(source_list, sources, rank);
+      logic_block_t *inserted = logic_create_logic_block(
+          sim, next_random() % 2 ? AND : XOR, 2, 1, NULL, NULL);
+
+      source_list[sources].data = logic_create_data_block(sim, INPUT, 0);
+      source_list[sources].block = NULL;
+      source_list[sources].rank = -1;
+
+      logic_block_data_connect(inserted, source_list[sources].data);
+      connect_source(inserted, &source_list[below]);
+      logic_block_block_connect(reader, inserted);
+
+      source_list[sources + 1].data = NULL;
+      source_list[sources + 1].block = inserted;
+      source_list[sources + 1].rank = (source_list[below].rank + rank) / 2;
+      sources += 2;
+    }
+
+    int inputs = circuit->primary_inputs;
+
+    if (logic_circuit_update(circuit, NULL) != 0) {
+      printf("FAIL: seed (%d) edit (%d) not updated.\n", seed, e);
+      failures++;
+      break;
+    }
+
+    set_inputs(circuit, inputs, source_list, sources);
+
+    if (logic_circuit_evaluate_edits(circuit) < 0) {
+      printf("FAIL: seed (%d) edit (%d) not evaluated.\n", seed, e);
+      failures++;
+      break;
+    }
+
+    logic_circuit_t *fresh = logic_circuit_compile(TEST_OUTPUTS, output_list);
+
+    program = logic_vm_compile(fresh);
+    set_inputs(fresh, 0, source_list, sources);
+    logic_vm_run(program, fresh->values);
+    logic_vm_free(program);
+
+    for (int o = 0; o < circuit->outputs; o++) {
+      if (circuit->values[circuit->output_nets[o]] !=
+          fresh->values[fresh->output_nets[o]]) {
+        printf("FAIL: seed (%d) edit (%d) output (%d) differs.\n", seed, e,
+               o);
+        failures++;
+      }
+    }
+
+    logic_circuit_free(fresh);
+  }
+
+  logic_circuit_free(circuit);
+  logic_sim_free(sim);
+
+  return failures;
+}
+
+/* A write port evaluated again writes its new data */
+static int test_write_port(void) {
+  logic_sim_t *sim = logic_sim_create();
+  logic_memory_t *ram =
+      logic_memory_create(LOGIC_MEMORY_RAM, TEST_WIDTH, 1 << TEST_ADDRESS_BITS);
+  logic_data_t *enable = logic_create_data_block(sim, INPUT, 1);
+  logic_data_t *address[TEST_ADDRESS_BITS];
+  logic_data_t *data[TEST_WIDTH];
+  int failures = 0;
+
+  for (int b = 0; b < TEST_ADDRESS_BITS; b++) {
+    address[b] = logic_create_data_block(sim, INPUT, (5 >> b) & 1);
+  }
+
+  for (int b = 0; b < TEST_WIDTH; b++) {
+    data[b] = logic_create_data_block(sim, INPUT, (0xA7 >> b) & 1);
+  }
+
+  logic_block_t *write = logic_create_memory_write(sim, ram, "write", "ram");
+
+  logic_block_data_bus_connect(write, 1, &enable);
+  logic_block_data_bus_connect(write, TEST_ADDRESS_BITS, address);
+  logic_block_data_bus_connect(write, TEST_WIDTH, data);
+
+  logic_circuit_t *circuit = logic_circuit_compile(1, &write);
+  logic_vm_program_t *program = logic_vm_compile(circuit);
+  uint64_t word = 0;
+
+  logic_circuit_load_inputs(circuit);
+  logic_vm_run(program, circuit->values);
+  logic_vm_free(program);
+
+  /* Data bit 0 now reads a new input held low */
+  logic_block_disconnect(write, 1 + TEST_ADDRESS_BITS);
+  logic_block_data_connect(write, logic_create_data_block(sim, INPUT, 0));
+
+  int inputs = circuit->primary_inputs;
+
+  if (logic_circuit_update(circuit, NULL) != 0) {
+    printf("FAIL: write port edit not updated.\n");
+    failures++;
+  } else {
+    logic_circuit_set_input(circuit, inputs, 0);
+
+    if (logic_circuit_evaluate_edits(circuit) < 0 ||
+        logic_memory_read(ram, 5, &word) != 0 || word != 0xA6) {
+      printf("FAIL: write port edit wrote (0x%02X).\n", (unsigned)word);
+      failures++;
+    }
+  }
+
+  logic_circuit_free(circuit);
+  logic_memory_free(ram);
+  logic_sim_free(sim);
+
+  return failures;
+}
+
+int main() {
+  int failures = test_write_port();
+
+  for (int seed = 1; seed <= TEST_SEEDS; seed++) {
+    failures += test_seed(seed);
+  }
+
+  printf("%s: test_eco\n", failures == 0 ? "PASS" : "FAIL");
+
+  return failures == 0 ? 0 : 1;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
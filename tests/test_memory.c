@@ -0,0 +1,215 @@
+/**
+ * @file test_memory.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Test of RAM writes read back across runs and of a ROM image.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimcircuit.h"
+#include "logsimlib.h"
+#include "logsimmemory.h"
+#include "logsimvm.h"
+#include "logsimword.h"
+
+/*************** Macros ***************/
+
+#define TEST_WIDTH 8
+#define TEST_ADDRESS_BITS 4
+
+/*************** Function Definitions ***************/
+
+static void set_bus(logic_data_t **bus, int bits, int value) {
+  for (int b = 0; b < bits; b++) {
+    bus[b]->data = (value >> b) & 1;
+  }
+}
+
+/* Word on lane 0 of the first width output nets */
+static int read_bus(const logic_circuit_t *circuit, int first, int width) {
+  int value = 0;
+
+  for (int b = 0; b < width; b++) {
+    value |= (int)(circuit->values[circuit->output_nets[first + b]] & 1) << b;
+  }
+
+  return value;
+}
+
+static int run(logic_circuit_t *circuit, const logic_vm_program_t *program) {
+  logic_circuit_load_inputs(circuit);
+
+  return logic_vm_run(program, circuit->values);
+}
+
+static int test_ram(logic_sim_t *sim) {
+  logic_memory_t *ram =
+      logic_memory_create(LOGIC_MEMORY_RAM, TEST_WIDTH, 1 << TEST_ADDRESS_BITS);
+  logic_data_t *enable = logic_create_data_block(sim, INPUT, 0);
+  logic_data_t *address[TEST_ADDRESS_BITS];
+  logic_data_t *data[TEST_WIDTH];
+  int failures = 0;
+
+  for (int b = 0; b < TEST_ADDRESS_BITS; b++) {
+    address[b] = logic_create_data_block(sim, INPUT, 0);
+  }
+
+  for (int b = 0; b < TEST_WIDTH; b++) {
+    data[b] = logic_create_data_block(sim, INPUT, 0);
+  }
+
+  /* Both ports share the address, the write port is a root of its own */
+  logic_block_t *port_list[2] = {
+      logic_create_memory_read(sim, ram, "read", "ram"),
+      logic_create_memory_write(sim, ram, "write", "ram"),
+  };
+
+  logic_block_data_bus_connect(port_list[0], TEST_ADDRESS_BITS, address);
+  logic_block_data_bus_connect(port_list[1], 1, &enable);
+  logic_block_data_bus_connect(port_list[1], TEST_ADDRESS_BITS, address);
+  logic_block_data_bus_connect(port_list[1], TEST_WIDTH, data);
+
+  logic_circuit_t *circuit = logic_circuit_compile(2, port_list);
+  logic_vm_program_t *program =
+      circuit != NULL ? logic_vm_compile(circuit) : NULL;
+
+  if (program == NULL) {
+    printf("FAIL: RAM not compiled.\n");
+    logic_circuit_free(circuit);
+    logic_memory_free(ram);
+    return 1;
+  }
+
+  /* A run reads the memory as it was before its own writes */
+  enable->data = 1;
+  set_bus(address, TEST_ADDRESS_BITS, 5);
+  set_bus(data, TEST_WIDTH, 0xA7);
+
+  if (run(circuit, program) < 0 || read_bus(circuit, 0, TEST_WIDTH) != 0) {
+    printf("FAIL: RAM read its own write in the same run.\n");
+    failures++;
+  }
+
+  enable->data = 0;
+  set_bus(data, TEST_WIDTH, 0x11);
+
+  if (run(circuit, program) < 0 ||
+      read_bus(circuit, 0, TEST_WIDTH) != 0xA7) {
+    printf("FAIL: RAM write not read back in the next run.\n");
+    failures++;
+  }
+
+  /* Disabled writes leave the word as it was */
+  if (run(circuit, program) < 0 ||
+      read_bus(circuit, 0, TEST_WIDTH) != 0xA7) {
+    printf("FAIL: RAM written with enable low.\n");
+    failures++;
+  }
+
+  set_bus(address, TEST_ADDRESS_BITS, 6);
+
+  if (run(circuit, program) < 0 || read_bus(circuit, 0, TEST_WIDTH) != 0) {
+    printf("FAIL: RAM write landed on another address.\n");
+    failures++;
+  }
+
+  logic_vm_free(program);
+  logic_circuit_free(circuit);
+  logic_memory_free(ram);
+
+  return failures;
+}
+
+static int test_rom(logic_sim_t *sim) {
+  char path[] = "/tmp/logsim_romXXXXXX";
+  int fd = mkstemp(path);
+  int failures = 0;
+
+  if (fd < 0) {
+    printf("FAIL: ROM image not created.\n");
+    return 1;
+  }
+
+  FILE *image = fdopen(fd, "w");
+
+  fprintf(image, "// boot image\n3c 00\n@4 5a # skips to 4\nff\n");
+  fclose(image);
+
+  logic_memory_t *rom =
+      logic_memory_create(LOGIC_MEMORY_ROM, TEST_WIDTH, 1 << TEST_ADDRESS_BITS);
+
+  if (logic_memory_load(rom, path, LOGIC_MEMORY_HEX) != 0) {
+    printf("FAIL: ROM image not loaded.\n");
+    failures++;
+  }
+
+  unlink(path);
+
+  if (logic_create_memory_write(sim, rom, "write", "rom") != NULL) {
+    printf("FAIL: write port created on a ROM.\n");
+    failures++;
+  }
+
+  logic_data_t *address[TEST_ADDRESS_BITS];
+
+  for (int b = 0; b < TEST_ADDRESS_BITS; b++) {
+    address[b] = logic_create_data_block(sim, INPUT, 0);
+  }
+
+  logic_block_t *fetch = logic_create_memory_read(sim, rom, "fetch", "rom");
+
+  logic_block_data_bus_connect(fetch, TEST_ADDRESS_BITS, address);
+
+  logic_circuit_t *circuit = logic_circuit_compile(1, &fetch);
+  logic_vm_program_t *program =
+      circuit != NULL ? logic_vm_compile(circuit) : NULL;
+
+  if (program == NULL) {
+    printf("FAIL: ROM not compiled.\n");
+    logic_circuit_free(circuit);
+    logic_memory_free(rom);
+    return failures + 1;
+  }
+
+  static const int expected[6] = {0x3C, 0x00, 0x00, 0x00, 0x5A, 0xFF};
+
+  for (int a = 0; a < 6; a++) {
+    set_bus(address, TEST_ADDRESS_BITS, a);
+
+    if (run(circuit, program) < 0 ||
+        read_bus(circuit, 0, TEST_WIDTH) != expected[a]) {
+      printf("FAIL: ROM word (%d) is not (0x%02X).\n", a, expected[a]);
+      failures++;
+    }
+  }
+
+  logic_vm_free(program);
+  logic_circuit_free(circuit);
+  logic_memory_free(rom);
+
+  return failures;
+}
+
+int main() {
+  logic_sim_t *sim = logic_sim_create();
+  int failures = test_ram(sim) + test_rom(sim);
+
+  logic_sim_free(sim);
+
+  printf("%s: test_memory\n", failures == 0 ? "PASS" : "FAIL");
+
+  return failures == 0 ? 0 : 1;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/
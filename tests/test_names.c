@@ -0,0 +1,75 @@
+/**
+ * @file test_names.c
+ * @author Suraj Kareppagol (surajkareppagol.dev@gmail.com)
+ * @brief Test of block lookups by path once the interner outgrows the
+ * name table.
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+/*************** C Standard Headers ***************/
+
+#include <stdio.h>
+
+/*************** C Custom Headers ***************/
+
+#include "logsimlib.h"
+
+/*************** Function Definitions ***************/
+
+int main() {
+  logic_sim_t *sim = logic_sim_create();
+  logic_block_t *block_list[32];
+  int failures = 0;
+
+  /* Plain names and scope paths are interned next to the block paths */
+  logic_sim_enter(sim, "s");
+
+  for (int i = 0; i < 32; i++) {
+    char name[16];
+
+    snprintf(name, sizeof(name), "b%d", i);
+    block_list[i] = logic_create_logic_block(sim, AND, 2, 1, name, NULL);
+  }
+
+  logic_sim_leave(sim);
+
+  for (int i = 0; i < 32; i++) {
+    char name[16];
+    char path[16];
+
+    snprintf(name, sizeof(name), "b%d", i);
+    snprintf(path, sizeof(path), "s/b%d", i);
+
+    /* The plain name was interned but names no block outside the scope */
+    if (logic_find_block(sim, name) != NULL) {
+      printf("FAIL: (%s) found outside its scope.\n", name);
+      failures++;
+    }
+
+    if (logic_find_block(sim, path) != block_list[i]) {
+      printf("FAIL: (%s) not found.\n", path);
+      failures++;
+    }
+  }
+
+  /* A root block may take a name interned by a scoped block */
+  logic_block_t *root = logic_create_logic_block(sim, OR, 2, 1, "b31", NULL);
+
+  if (logic_find_block(sim, "b31") != root ||
+      logic_find_block(sim, "b31#2") != NULL) {
+    printf("FAIL: (b31) not created at the root.\n");
+    failures++;
+  }
+
+  logic_sim_free(sim);
+
+  printf("%s: test_names\n", failures == 0 ? "PASS" : "FAIL");
+
+  return failures == 0 ? 0 : 1;
+}
+
+/************************************************/
+/*                EOF                           */
+/************************************************/